@@ -0,0 +1,257 @@
+#!/usr/bin/env python3
+#
+#  Copyright (C) 2026 Team Kodi
+#  This file is part of Kodi - https://kodi.tv
+#
+#  SPDX-License-Identifier: GPL-2.0-or-later
+#  See LICENSES/README.md for more information.
+#
+
+"""Decode and filter a binary Kodi log (kodi.binlog).
+
+The file is written by CBinaryLogSink when advancedsettings.xml contains
+<log><format>binary</format></log> (or "both"). The output uses the same line
+layout as kodi.log.
+
+Examples:
+  binlog.py kodi.binlog
+  binlog.py --level warning kodi.binlog
+  binlog.py --component video --thread 1234 --grep "Opening .*mkv" kodi.binlog
+  binlog.py --since "2026-10-18 12:00:00" --until "2026-10-18 12:05:00" kodi.binlog
+"""
+
+import argparse
+import datetime
+import re
+import struct
+import sys
+
+MAGIC = b'KODIBLOG'
+VERSION = 1
+
+RECORD_STRING = 1
+RECORD_MESSAGE = 2
+
+ARG_NONE = 0
+ARG_INT = 1
+ARG_UINT = 2
+ARG_BOOL = 3
+ARG_CHAR = 4
+ARG_DOUBLE = 5
+ARG_STRING = 6
+ARG_POINTER = 7
+
+LEVELS = ['TRACE', 'DEBUG', 'INFO', 'WARNING', 'ERROR', 'FATAL', 'OFF']
+
+
+class FormatError(Exception):
+    pass
+
+
+class Bool:
+    """Formats like fmt, "true" and "false" instead of "True" and "False"."""
+
+    def __init__(self, value):
+        self.value = value
+
+    def __format__(self, spec):
+        if spec and spec[-1] in 'bcdoxX':
+            return format(int(self.value), spec)
+        return format('true' if self.value else 'false', spec)
+
+
+class Double:
+    """Formats like fmt, "{}" of 1.0 is "1"."""
+
+    def __init__(self, value):
+        self.value = value
+
+    def __format__(self, spec):
+        if not spec:
+            text = repr(self.value)
+            return text[:-2] if text.endswith('.0') else text
+        return format(self.value, spec)
+
+
+class Pointer:
+    def __init__(self, value):
+        self.value = value
+
+    def __format__(self, spec):
+        return format('0x{:x}'.format(self.value), spec)
+
+
+class Reader:
+    def __init__(self, data):
+        self.data = data
+        self.pos = 0
+
+    def at_end(self):
+        return self.pos >= len(self.data)
+
+    def byte(self):
+        if self.pos >= len(self.data):
+            raise FormatError('unexpected end of file')
+        value = self.data[self.pos]
+        self.pos += 1
+        return value
+
+    def varint(self):
+        value = 0
+        shift = 0
+        while True:
+            byte = self.byte()
+            value |= (byte & 0x7f) << shift
+            if not byte & 0x80:
+                return value
+            shift += 7
+
+    def signed(self):
+        value = self.varint()
+        return (value >> 1) ^ -(value & 1)
+
+    def bytes(self, count):
+        if self.pos + count > len(self.data):
+            raise FormatError('unexpected end of file')
+        value = self.data[self.pos:self.pos + count]
+        self.pos += count
+        return value
+
+    def string(self):
+        return self.bytes(self.varint()).decode('utf-8', errors='replace')
+
+    def arg(self):
+        tag = self.byte()
+        if tag == ARG_NONE:
+            return None
+        if tag == ARG_INT:
+            return self.signed()
+        if tag == ARG_UINT:
+            return self.varint()
+        if tag == ARG_BOOL:
+            return Bool(self.byte() != 0)
+        if tag == ARG_CHAR:
+            return chr(self.byte())
+        if tag == ARG_DOUBLE:
+            return Double(struct.unpack('<d', self.bytes(8))[0])
+        if tag == ARG_STRING:
+            return self.string()
+        if tag == ARG_POINTER:
+            return Pointer(self.varint())
+        raise FormatError('unknown argument type {}'.format(tag))
+
+
+class Message:
+    def __init__(self, time, thread, level, component, format, args):
+        self.time = time
+        self.thread = thread
+        self.level = level
+        self.component = component
+        self.format = format
+        self.args = args
+
+    def text(self):
+        try:
+            return self.format.format(*self.args)
+        except (IndexError, KeyError, ValueError, TypeError):
+            # fmt only syntax, show the format and the arguments
+            return '{} [{}]'.format(self.format, ', '.join(format(arg, '') for arg in self.args))
+
+
+def read_messages(data):
+    if data[:len(MAGIC)] != MAGIC:
+        raise FormatError('not a binary Kodi log')
+    reader = Reader(data)
+    reader.pos = len(MAGIC)
+    version = reader.byte()
+    if version != VERSION:
+        raise FormatError('unsupported version {}'.format(version))
+
+    strings = {}
+    time = 0
+    while not reader.at_end():
+        record = reader.byte()
+        if record == RECORD_STRING:
+            string_id = reader.varint()
+            strings[string_id] = reader.string()
+        elif record == RECORD_MESSAGE:
+            time += reader.signed()
+            thread = reader.varint()
+            level = reader.byte()
+            component = strings.get(reader.varint(), '?')
+            format = strings.get(reader.varint(), '')
+            args = [reader.arg() for _ in range(reader.varint())]
+            yield Message(time, thread, level, component, format, args)
+        else:
+            raise FormatError('unknown record type {}'.format(record))
+
+
+def parse_level(value):
+    name = value.upper()
+    if name not in LEVELS:
+        raise argparse.ArgumentTypeError('unknown level {}'.format(value))
+    return LEVELS.index(name)
+
+
+def parse_time(value):
+    try:
+        return int(datetime.datetime.fromisoformat(value).timestamp() * 1000000)
+    except ValueError:
+        raise argparse.ArgumentTypeError('invalid time {}'.format(value))
+
+
+def format_line(message, text):
+    time = datetime.datetime.fromtimestamp(message.time / 1000000)
+    level = LEVELS[message.level] if message.level < len(LEVELS) else str(message.level)
+    # same layout as the text log
+    return '{}.{:03d} T:{:<5} {:>7} <{}>: {}'.format(
+        time.strftime('%Y-%m-%d %H:%M:%S'), time.microsecond // 1000, message.thread, level,
+        message.component, text)
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Decode and filter a binary Kodi log.')
+    parser.add_argument('file', help='binary log file, usually kodi.binlog')
+    parser.add_argument('--level', type=parse_level, default=0,
+                        help='minimum level, one of ' + ', '.join(LEVELS[:-1]).lower())
+    parser.add_argument('--component', action='append',
+                        help='only messages of this component (logger name), repeatable')
+    parser.add_argument('--thread', type=int, action='append',
+                        help='only messages of this thread id, repeatable')
+    parser.add_argument('--grep', type=re.compile,
+                        help='only messages matching this regular expression')
+    parser.add_argument('--since', type=parse_time, help='only messages at or after this time')
+    parser.add_argument('--until', type=parse_time, help='only messages before this time')
+    options = parser.parse_args()
+
+    with open(options.file, 'rb') as file:
+        data = file.read()
+
+    try:
+        for message in read_messages(data):
+            if message.level < options.level:
+                continue
+            if options.component and message.component not in options.component:
+                continue
+            if options.thread and message.thread not in options.thread:
+                continue
+            if options.since is not None and message.time < options.since:
+                continue
+            if options.until is not None and message.time >= options.until:
+                continue
+            text = message.text()
+            if options.grep and not options.grep.search(text):
+                continue
+            for line in text.split('\n'):
+                print(format_line(message, line))
+    except FormatError as error:
+        # a log of a crashed process may end in a partial record
+        print('{}: {}'.format(options.file, error), file=sys.stderr)
+        return 1
+    except BrokenPipeError:
+        pass
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -11,6 +11,7 @@
 #include "ServiceBroker.h"
 #include "TextureDatabase.h"
 #include "addons/AddonDatabase.h"
+#include "dbwrappers/DatabaseQueryStats.h"
 #include "music/MusicDatabase.h"
 #include "pvr/PVRDatabase.h"
 #include "pvr/epg/EpgDatabase.h"
@@ -21,6 +22,7 @@
 #include "view/ViewDatabase.h"
 
 #include <algorithm>
+#include <chrono>
 #include <mutex>
 #include <stdexcept>
 
@@ -29,13 +31,18 @@ using namespace PVR;
 CDatabaseManager::CDatabaseManager() :
   m_bIsUpgrading(false)
 {
+  ConfigureQueryStats();
+
   // Initialize the addon database (must be before the addon manager is init'd)
   ADDON::CAddonDatabase db;
   if (!UpdateDatabase(db))
     throw std::runtime_error("unable to initialize the Add-On database");
 }
 
-CDatabaseManager::~CDatabaseManager() = default;
+CDatabaseManager::~CDatabaseManager()
+{
+  CDatabaseQueryStats::GetInstance().LogSummary();
+}
 
 bool CDatabaseManager::Initialize()
 {
@@ -44,6 +51,8 @@ bool CDatabaseManager::Initialize()
   if (m_initialized)
     return false;
 
+  ConfigureQueryStats();
+
   const bool rc = InitializeInternal();
 
   m_bIsUpgrading = false;
@@ -62,6 +71,16 @@ void CDatabaseManager::Deinitialize()
   m_dbStatus.clear();
 }
 
+void CDatabaseManager::ConfigureQueryStats()
+{
+  const std::shared_ptr<CAdvancedSettings> advancedSettings =
+      CServiceBroker::GetSettingsComponent()->GetAdvancedSettings();
+
+  CDatabaseQueryStats::GetInstance().Configure(
+      advancedSettings->m_databaseQueryStats,
+      std::chrono::milliseconds(advancedSettings->m_databaseSlowQueryThreshold));
+}
+
 bool CDatabaseManager::InitializeInternal()
 {
   CLog::LogF(LOGDEBUG, "updating databases...");
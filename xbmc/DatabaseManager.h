@@ -86,6 +86,7 @@ private:
   bool Update(CDatabase &db, const DatabaseSettings &settings);
   bool UpdateVersion(CDatabase &db, const std::string &dbName);
   bool InitializeInternal();
+  void ConfigureQueryStats();
 
   CCriticalSection            m_section;     ///< Critical section protecting m_dbStatus.
   std::map<std::string, DBStatus> m_dbStatus; ///< Our database status map.
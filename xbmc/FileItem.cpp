@@ -69,8 +69,10 @@
 #include "video/VideoInfoTag.h"
 #include "video/VideoUtils.h"
 
+#include <algorithm>
 #include <cstdlib>
 #include <memory>
+#include <mutex>
 
 using namespace KODI;
 using namespace XFILE;
@@ -523,7 +525,7 @@ void CFileItem::Archive(CArchive& ar)
     ar << m_lockInfo.GetCode();
     ar << m_lockInfo.GetBadPasswordCount();
     ar << m_bCanQueue;
-    ar << m_mimetype;
+    ar << m_mimetype.Get();
     ar << m_extrainfo;
     ar << static_cast<int>(m_specialSort);
     ar << m_doContentLookup;
@@ -561,7 +563,9 @@ void CFileItem::Archive(CArchive& ar)
   {
     ar >> m_bIsParentFolder;
     ar >> m_bLabelPreformatted;
-    ar >> m_strPath;
+    std::string path;
+    ar >> path;
+    SetPath(std::move(path));
     ar >> m_strDynPath;
     ar >> m_bIsShareOrDrive;
     int dtype;
@@ -585,7 +589,8 @@ void CFileItem::Archive(CArchive& ar)
     ar >> temp;
     m_lockInfo.SetBadPasswordCount(temp);
     ar >> m_bCanQueue;
-    ar >> m_mimetype;
+    ar >> tempstr;
+    m_mimetype = tempstr;
     ar >> m_extrainfo;
     ar >> temp;
     m_specialSort = static_cast<SortSpecial>(temp);
@@ -622,7 +627,7 @@ void CFileItem::Serialize(CVariant& value) const
   value["size"] = m_dwSize;
   value["DVDLabel"] = m_strDVDLabel;
   value["title"] = m_strTitle;
-  value["mimetype"] = m_mimetype;
+  value["mimetype"] = m_mimetype.Get();
   value["extrainfo"] = m_extrainfo;
 
   if (m_musicInfoTag)
@@ -855,7 +860,7 @@ bool CFileItem::IsGame() const
 
 bool CFileItem::IsPicture() const
 {
-  if (StringUtils::StartsWithNoCase(m_mimetype, "image/"))
+  if (StringUtils::StartsWithNoCase(m_mimetype.Get(), "image/"))
     return true;
 
   if (HasPictureInfoTag())
@@ -1165,10 +1170,11 @@ void CFileItem::FillInMimeType(bool lookup /*= true*/)
   //! @todo adapt this to use CMime::GetMimeType()
   if (m_mimetype.empty())
   {
+    std::string mimeType;
     if (IsFolder())
-      m_mimetype = "x-directory/normal";
+      mimeType = "x-directory/normal";
     else if (HasPVRChannelInfoTag())
-      m_mimetype = GetPVRChannelInfoTag()->MimeType();
+      mimeType = GetPVRChannelInfoTag()->MimeType();
     else if (StringUtils::StartsWithNoCase(GetDynPath(), "shout://") ||
              StringUtils::StartsWithNoCase(GetDynPath(), "http://") ||
              StringUtils::StartsWithNoCase(GetDynPath(), "https://"))
@@ -1177,32 +1183,34 @@ void CFileItem::FillInMimeType(bool lookup /*= true*/)
       if (!lookup)
         return;
 
-      CCurlFile::GetMimeType(GetDynURL(), m_mimetype);
+      CCurlFile::GetMimeType(GetDynURL(), mimeType);
 
       // try to get mime-type again but with an NSPlayer User-Agent
       // in order for server to provide correct mime-type.  Allows us
       // to properly detect an MMS stream
-      if (StringUtils::StartsWithNoCase(m_mimetype, "video/x-ms-"))
-        CCurlFile::GetMimeType(GetDynURL(), m_mimetype, "NSPlayer/11.00.6001.7000");
+      if (StringUtils::StartsWithNoCase(mimeType, "video/x-ms-"))
+        CCurlFile::GetMimeType(GetDynURL(), mimeType, "NSPlayer/11.00.6001.7000");
 
       // make sure there are no options set in mime-type
       // mime-type can look like "video/x-ms-asf ; charset=utf8"
-      size_t i = m_mimetype.find(';');
+      size_t i = mimeType.find(';');
       if (i != std::string::npos)
-        m_mimetype.erase(i, m_mimetype.length() - i);
-      StringUtils::Trim(m_mimetype);
+        mimeType.erase(i, mimeType.length() - i);
+      StringUtils::Trim(mimeType);
     }
     else
-      m_mimetype = CMime::GetMimeType(*this);
+      mimeType = CMime::GetMimeType(*this);
 
     // if it's still empty set to an unknown type
-    if (m_mimetype.empty())
-      m_mimetype = "application/octet-stream";
+    if (mimeType.empty())
+      mimeType = "application/octet-stream";
+
+    m_mimetype = mimeType;
   }
 
   // change protocol to mms for the following mime-type.  Allows us to create proper FileMMS.
-  if(StringUtils::StartsWithNoCase(m_mimetype, "application/vnd.ms.wms-hdr.asfv1") ||
-     StringUtils::StartsWithNoCase(m_mimetype, "application/x-mms-framed"))
+  if (StringUtils::StartsWithNoCase(m_mimetype.Get(), "application/vnd.ms.wms-hdr.asfv1") ||
+      StringUtils::StartsWithNoCase(m_mimetype.Get(), "application/x-mms-framed"))
   {
     if (m_strDynPath.empty())
       SetDynPath(m_strPath);
@@ -1385,7 +1393,7 @@ void CFileItem::UpdateInfo(const CFileItem &item, bool replaceLabels /*=true*/)
   AppendProperties(item);
 
   SetContentLookup(item.m_doContentLookup);
-  SetMimeType(item.m_mimetype);
+  SetMimeType(item.GetMimeType());
   UpdateMimeType(m_doContentLookup);
 }
 
@@ -1463,7 +1471,7 @@ void CFileItem::MergeInfo(const CFileItem& item)
   AppendProperties(item);
 
   SetContentLookup(item.m_doContentLookup);
-  SetMimeType(item.m_mimetype);
+  SetMimeType(item.GetMimeType());
   UpdateMimeType(m_doContentLookup);
 }
 
@@ -1616,10 +1624,44 @@ const std::string& CFileItem::GetPath() const
   return m_strPath;
 }
 
+namespace
+{
+// an item may be indexed by lists used from different threads
+std::mutex pathIndexesLock;
+} // unnamed namespace
+
 void CFileItem::SetPath(std::string path)
 {
+  if (path == m_strPath)
+    return;
+
   m_strPath = std::move(path);
   m_urlPath.reset();
+  if (m_indexedByPath.load(std::memory_order_relaxed))
+    OnIndexedPathChanged();
+}
+
+void CFileItem::AddPathIndex(const std::shared_ptr<std::atomic<bool>>& indexStale) const
+{
+  std::unique_lock lock(pathIndexesLock);
+  std::erase_if(m_pathIndexes, [](const auto& index) { return index.expired(); });
+  if (std::ranges::none_of(m_pathIndexes, [&indexStale](const auto& index)
+                           { return index.lock() == indexStale; }))
+    m_pathIndexes.emplace_back(indexStale);
+  m_indexedByPath = true;
+}
+
+void CFileItem::OnIndexedPathChanged() const
+{
+  std::unique_lock lock(pathIndexesLock);
+  std::erase_if(m_pathIndexes,
+                [](const auto& index)
+                {
+                  const auto indexStale = index.lock();
+                  if (indexStale)
+                    *indexStale = true;
+                  return !indexStale;
+                });
 }
 
 void CFileItem::SetURL(const CURL& url)
@@ -1630,7 +1672,7 @@ void CFileItem::SetURL(const CURL& url)
 const CURL& CFileItem::GetURL() const
 {
   if (!m_urlPath)
-    m_urlPath = CURL(m_strPath);
+    m_urlPath = std::make_unique<CURL>(m_strPath);
   return *m_urlPath;
 }
 
@@ -1654,13 +1696,13 @@ const CURL& CFileItem::GetDynURL() const
   if (!m_strDynPath.empty())
   {
     if (!m_urlDynPath)
-      m_urlDynPath = CURL(m_strDynPath);
+      m_urlDynPath = std::make_unique<CURL>(m_strDynPath);
     return *m_urlDynPath;
   }
   else
   {
     if (!m_urlPath)
-      m_urlPath = CURL(m_strPath);
+      m_urlPath = std::make_unique<CURL>(m_strPath);
     return *m_urlPath;
   }
 }
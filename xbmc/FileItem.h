@@ -20,14 +20,16 @@
 #include "utils/IArchivable.h"
 #include "utils/ISerializable.h"
 #include "utils/ISortable.h"
+#include "utils/InternedString.h"
 #include "utils/LockInfo.h"
 #include "utils/SortUtils.h"
 #include "utils/XTimeUtils.h"
 
+#include <atomic>
 #include <memory>
-#include <optional>
 #include <string>
 #include <string_view>
+#include <vector>
 
 class CAlbum;
 class CArtist;
@@ -440,7 +442,7 @@ public:
   bool LoadDetails();
 
   /* Returns the content type of this item if known */
-  const std::string& GetMimeType() const { return m_mimetype; }
+  const std::string& GetMimeType() const { return m_mimetype.Get(); }
 
   /* sets the mime-type if known beforehand */
   void SetMimeType(std::string_view mimetype) { m_mimetype = mimetype; }
@@ -556,8 +558,20 @@ private:
    */
   void FillMusicInfoTag(const std::shared_ptr<const PVR::CPVREpgInfoTag>& tag);
 
-  mutable std::optional<CURL> m_urlPath;
-  mutable std::optional<CURL> m_urlDynPath;
+  friend class CFileItemList;
+
+  /*! \brief Registers the stale flag of a CFileItemList index this item was added to.
+   The flag is set when the path of the item changes in place, so the list rebuilds its index.
+   */
+  void AddPathIndex(const std::shared_ptr<std::atomic<bool>>& indexStale) const;
+  void OnIndexedPathChanged() const;
+
+  mutable std::vector<std::weak_ptr<std::atomic<bool>>> m_pathIndexes; // guarded by a static lock
+  mutable std::atomic<bool> m_indexedByPath{false};
+
+  // parsed on demand, most items never need them and a CURL is large
+  mutable std::unique_ptr<CURL> m_urlPath;
+  mutable std::unique_ptr<CURL> m_urlDynPath;
   std::string m_strPath;            ///< complete path to item
   std::string m_strDynPath;
 
@@ -577,7 +591,7 @@ private:
   bool m_bIsParentFolder{false};
   bool m_bCanQueue{true};
   bool m_bLabelPreformatted{false};
-  std::string m_mimetype;
+  CInternedString m_mimetype;
   std::string m_extrainfo;
   bool m_doContentLookup{true};
   MUSIC_INFO::CMusicInfoTag* m_musicInfoTag{nullptr};
@@ -34,13 +34,20 @@
 #include "video/VideoUtils.h"
 
 #include <algorithm>
-#include <map>
 #include <ranges>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 using namespace KODI;
 using namespace XFILE;
 
+namespace
+{
+// below this a linear search is cheaper than maintaining the index
+constexpr size_t MIN_INDEXED_ITEMS = 16;
+} // unnamed namespace
+
 CFileItemList::CFileItemList() : CFileItem("", true)
 {
 }
@@ -66,39 +73,111 @@ CFileItemPtr CFileItemList::operator[](const std::string& strPath) const
 
 void CFileItemList::SetIgnoreURLOptions(bool ignoreURLOptions)
 {
-  m_ignoreURLOptions = ignoreURLOptions;
+  std::unique_lock lock(m_lock);
 
-  if (m_fastLookup)
-  {
-    m_fastLookup = false; // Force SetFastlookup to clear map
-    SetFastLookup(true); // and regenerate map
-  }
+  m_ignoreURLOptions = ignoreURLOptions;
+  InvalidateIndex();
 }
 
 void CFileItemList::SetFastLookup(bool fastLookup)
 {
   std::unique_lock lock(m_lock);
 
-  if (fastLookup && !m_fastLookup)
-  { // generate the map
-    m_map.clear();
-    AddFastLookupItems(m_items);
-  }
-  if (!fastLookup && m_fastLookup)
-    m_map.clear();
   m_fastLookup = fastLookup;
+  if (!UseIndex())
+    InvalidateIndex();
 }
 
 bool CFileItemList::Contains(const std::string& fileName) const
 {
   std::unique_lock lock(m_lock);
 
-  const std::string fname = m_ignoreURLOptions ? CURL(fileName).GetWithoutOptions() : fileName;
-  if (m_fastLookup)
-    return m_map.contains(fname);
+  return Find(fileName) != nullptr;
+}
+
+std::string CFileItemList::GetLookupKey(const std::string& path) const
+{
+  return m_ignoreURLOptions ? CURL(path).GetWithoutOptions() : path;
+}
+
+bool CFileItemList::MatchesKey(const CFileItem& item, std::string_view key) const
+{
+  return m_ignoreURLOptions ? item.GetURL().GetWithoutOptions() == key : item.GetPath() == key;
+}
+
+CFileItemPtr CFileItemList::Find(const std::string& path) const
+{
+  const std::string key = GetLookupKey(path);
+  if (!UseIndex())
+  {
+    const auto it = std::ranges::find_if(m_items, [this, &key](const auto& item)
+                                         { return MatchesKey(*item, key); });
+    return it != m_items.end() ? *it : CFileItemPtr();
+  }
+
+  // the path of one of our items was changed in place
+  if (!m_indexValid || m_indexStale->load())
+    BuildIndex();
+
+  const auto it = m_index.find(key);
+  return it != m_index.end() ? it->second : CFileItemPtr();
+}
+
+bool CFileItemList::UseIndex() const
+{
+  return m_fastLookup || m_items.size() >= MIN_INDEXED_ITEMS;
+}
+
+void CFileItemList::BuildIndex() const
+{
+  InvalidateIndex();
+  m_index.reserve(m_items.size());
+  m_indexValid = true;
+  *m_indexStale = false;
+  for (const auto& item : m_items)
+    IndexItem(item);
+}
+
+void CFileItemList::IndexItem(const CFileItemPtr& item) const
+{
+  if (!m_indexValid)
+    return;
 
-  // slow method...
-  return std::ranges::any_of(m_items, [&fname](const auto& pItem) { return pItem->IsPath(fname); });
+  item->AddPathIndex(m_indexStale);
+  const std::string key = m_ignoreURLOptions ? item->GetURL().GetWithoutOptions() : item->GetPath();
+  if (!m_index.try_emplace(key, item).second)
+    m_indexHasDuplicates = true;
+}
+
+void CFileItemList::UnindexItem(const CFileItem& item)
+{
+  if (!m_indexValid)
+    return;
+
+  const auto it =
+      m_index.find(m_ignoreURLOptions ? item.GetURL().GetWithoutOptions() : item.GetPath());
+  if (it == m_index.end() || it->second.get() != &item)
+    return;
+
+  // another item with the same path may have to take its place
+  if (m_indexHasDuplicates)
+    InvalidateIndex();
+  else
+    m_index.erase(it);
+}
+
+void CFileItemList::InvalidateIndex() const
+{
+  m_index.clear();
+  m_indexValid = false;
+  m_indexHasDuplicates = false;
+}
+
+void CFileItemList::OnItemsReordered()
+{
+  // the index refers to the first item of each path
+  if (m_indexHasDuplicates)
+    InvalidateIndex();
 }
 
 void CFileItemList::Clear()
@@ -123,26 +202,13 @@ void CFileItemList::ClearItems()
   FreeMemory();
   std::ranges::for_each(m_items, [](const auto& item) { item->FreeMemory(); });
   m_items.clear();
-  m_map.clear();
-}
-
-void CFileItemList::AddFastLookupItem(const CFileItemPtr& item)
-{
-  m_map.try_emplace(m_ignoreURLOptions ? item->GetURL().GetWithoutOptions() : item->GetPath(),
-                    item);
-}
-
-void CFileItemList::AddFastLookupItems(const std::vector<CFileItemPtr>& items)
-{
-  for (const auto& item : items)
-    AddFastLookupItem(item);
+  InvalidateIndex();
 }
 
 void CFileItemList::Add(CFileItemPtr pItem)
 {
   std::unique_lock lock(m_lock);
-  if (m_fastLookup)
-    AddFastLookupItem(pItem);
+  IndexItem(pItem);
   m_items.emplace_back(std::move(pItem));
 }
 
@@ -150,8 +216,7 @@ void CFileItemList::Add(CFileItem&& item)
 {
   std::unique_lock lock(m_lock);
   auto ptr = std::make_shared<CFileItem>(std::move(item));
-  if (m_fastLookup)
-    AddFastLookupItem(ptr);
+  IndexItem(ptr);
   m_items.emplace_back(std::move(ptr));
 }
 
@@ -159,8 +224,7 @@ void CFileItemList::AddItems(const std::vector<CFileItemPtr>& items)
 {
   std::unique_lock lock(m_lock);
 
-  if (m_fastLookup)
-    AddFastLookupItems(items);
+  std::ranges::for_each(items, [this](const auto& item) { IndexItem(item); });
 
   m_items.reserve(m_items.size() + items.size());
   std::ranges::copy(items, std::back_inserter(m_items));
@@ -170,8 +234,7 @@ void CFileItemList::AddItems(std::vector<CFileItemPtr>&& items)
 {
   std::unique_lock lock(m_lock);
 
-  if (m_fastLookup)
-    AddFastLookupItems(items);
+  std::ranges::for_each(items, [this](const auto& item) { IndexItem(item); });
 
   m_items.reserve(m_items.size() + items.size());
   std::ranges::move(items, std::back_inserter(m_items));
@@ -189,8 +252,8 @@ void CFileItemList::AddFront(const CFileItemPtr& pItem, int itemPosition)
     m_items.insert(m_items.begin() + (m_items.size() + itemPosition), pItem);
   }
 
-  if (m_fastLookup)
-    AddFastLookupItem(pItem);
+  IndexItem(pItem);
+  OnItemsReordered();
 }
 
 void CFileItemList::Remove(const CFileItem* pItem)
@@ -200,17 +263,15 @@ void CFileItemList::Remove(const CFileItem* pItem)
       std::ranges::find_if(m_items, [pItem](const auto& item) { return item.get() == pItem; });
   if (it != m_items.end())
   {
+    UnindexItem(*pItem);
     m_items.erase(it);
-    if (m_fastLookup)
-    {
-      m_map.erase(m_ignoreURLOptions ? pItem->GetURL().GetWithoutOptions() : pItem->GetPath());
-    }
   }
 }
 
 CFileItemList::Iterator CFileItemList::erase(Iterator first, Iterator last)
 {
   std::unique_lock lock(m_lock);
+  InvalidateIndex();
   return m_items.erase(first, last);
 }
 
@@ -220,20 +281,21 @@ void CFileItemList::Remove(int iItem)
 
   if (iItem >= 0 && iItem < Size())
   {
-    CFileItemPtr pItem = *(m_items.begin() + iItem);
-    if (m_fastLookup)
-    {
-      m_map.erase(m_ignoreURLOptions ? pItem->GetURL().GetWithoutOptions() : pItem->GetPath());
-    }
+    UnindexItem(*m_items[iItem]);
     m_items.erase(m_items.begin() + iItem);
   }
 }
 
-void CFileItemList::Append(const CFileItemList& itemlist)
+void CFileItemList::Append(const CFileItemList& itemlist, bool skipDuplicates /* = false */)
 {
   std::unique_lock lock(m_lock);
 
-  std::ranges::for_each(itemlist, [this](const auto& item) { Add(item); });
+  m_items.reserve(m_items.size() + itemlist.m_items.size());
+  for (const auto& item : itemlist)
+  {
+    if (!skipDuplicates || !Find(item->GetPath()))
+      Add(item);
+  }
 }
 
 void CFileItemList::Assign(const CFileItemList& itemlist, bool append)
@@ -297,19 +359,7 @@ CFileItemPtr CFileItemList::Get(const std::string& strPath) const
 {
   std::unique_lock lock(m_lock);
 
-  if (m_fastLookup)
-  {
-    const auto it = m_map.find(m_ignoreURLOptions ? CURL(strPath).GetWithoutOptions() : strPath);
-    if (it != m_map.end())
-      return it->second;
-
-    return {};
-  }
-  // slow method...
-  const std::string fname = m_ignoreURLOptions ? CURL(strPath).GetWithoutOptions() : strPath;
-  const auto it =
-      std::ranges::find_if(m_items, [&fname](const auto& pItem) { return pItem->IsPath(fname); });
-  return it != m_items.end() ? *it : CFileItemPtr();
+  return Find(strPath);
 }
 
 int CFileItemList::Size() const
@@ -402,12 +452,14 @@ void CFileItemList::Sort(SortDescription sortDescription)
 
   // replace the current list with the re-ordered one
   m_items = std::move(sortedFileItems);
+  OnItemsReordered();
 }
 
 void CFileItemList::Randomize()
 {
   std::unique_lock lock(m_lock);
   KODI::UTILS::RandomShuffle(m_items.begin(), m_items.end());
+  OnItemsReordered();
 }
 
 void CFileItemList::Archive(CArchive& ar)
@@ -575,7 +627,9 @@ void CFileItemList::FilterCueItems()
 {
   std::unique_lock lock(m_lock);
   // Handle .CUE sheet files...
-  std::vector<std::string> itemstodelete;
+  std::unordered_set<std::string> itemstodelete; // lower case paths
+  // lower case path -> items, built with the first media file found
+  std::unordered_multimap<std::string, CFileItem*> itemsByPath;
   for (const auto& pItem : m_items)
   {
     if (!pItem->IsFolder())
@@ -635,26 +689,31 @@ void CFileItemList::FilterCueItems()
             {
               cuesheet->UpdateMediaFile(fileFromCue, strMediaFile);
               // apply CUE for later processing
-              for (const auto& inner_item : m_items)
+              if (itemsByPath.empty())
               {
-                if (StringUtils::CompareNoCase(inner_item->GetPath(), strMediaFile) == 0)
-                  inner_item->SetCueDocument(cuesheet);
+                itemsByPath.reserve(m_items.size());
+                for (const auto& inner_item : m_items)
+                  itemsByPath.emplace(StringUtils::ToLower(inner_item->GetPath()),
+                                      inner_item.get());
               }
+              std::string mediaFileKey = strMediaFile;
+              StringUtils::ToLower(mediaFileKey);
+              const auto [first, last] = itemsByPath.equal_range(mediaFileKey);
+              for (const auto& [path, inner_item] : std::ranges::subrange(first, last))
+                inner_item->SetCueDocument(cuesheet);
             }
           }
         }
-        itemstodelete.emplace_back(pItem->GetPath());
+        itemstodelete.emplace(StringUtils::ToLower(pItem->GetPath()));
       }
     }
   }
   // now delete the .CUE files.
-  for (const auto& delItem : itemstodelete)
+  if (!itemstodelete.empty())
   {
-    const auto it = std::ranges::find_if(
-        m_items, [&delItem](const auto& pItem)
-        { return StringUtils::CompareNoCase(pItem->GetPath(), delItem) == 0; });
-    if (it != m_items.end())
-      m_items.erase(it);
+    std::erase_if(m_items, [&itemstodelete](const auto& pItem)
+                  { return itemstodelete.contains(StringUtils::ToLower(pItem->GetPath())); });
+    InvalidateIndex();
   }
 }
 
@@ -705,6 +764,7 @@ void CFileItemList::Stack()
 
   // Convert folder paths containing disc images to files (INDEX.BDMV or VIDEO_TS.IFO)
   ConvertDiscFoldersToFiles(m_items);
+  InvalidateIndex();
 
   // Cannot stack a single item
   if (m_items.size() == 1)
@@ -816,29 +876,30 @@ void CFileItemList::Stack()
   // Sort stack candidates
   std::ranges::sort(stackCandidates);
 
-  // Count stack candidates
-  std::map<CountedStackCandidate, int> countedCandidates;
-  for (const auto& s : stackCandidates)
-    ++countedCandidates[{s.type, s.title}];
-
-  // Find stacks
-  std::vector<int> deleteItems;
-  for (const auto& [candidate, count] :
-       countedCandidates | std::views::filter([](const auto& c) { return c.second > 1; }))
+  // Find stacks, the sorted candidates of a stack are adjacent
+  std::vector<bool> deleteItems(m_items.size(), false);
+  bool stacked{false};
+  for (auto first = stackCandidates.begin(); first != stackCandidates.end();)
   {
+    const auto candidate = first;
+    const auto last =
+        std::find_if(first, stackCandidates.end(), [&candidate](const auto& item)
+                     { return item.type != candidate->type || item.title != candidate->title; });
+    first = last;
+    if (std::distance(candidate, last) < 2)
+      continue;
+
     // Find all items in this stack
     std::vector<int> stack;
     int64_t size{0};
-    for (const auto& stackItem :
-         stackCandidates |
-             std::views::filter([type = candidate.type, title = candidate.title](const auto& item)
-                                { return item.type == type && item.title == title; }))
+    for (const auto& stackItem : std::ranges::subrange(candidate, last))
     {
       stack.emplace_back(stackItem.index);
       size += stackItem.size;
       if (stack.size() > 1)
-        deleteItems.emplace_back(stackItem.index); // delete all but first item in stack
+        deleteItems[stackItem.index] = true; // delete all but first item in stack
     }
+    stacked = true;
 
     // Generate combined stack path
     // @todo - why is RAR a special case here? a RAR file could be part of a stack.
@@ -848,7 +909,7 @@ void CFileItemList::Stack()
                                     : CStackDirectory::ConstructStackPath(*this, stack)};
 
     // First item in stack becomes the stack
-    std::string stackName{candidate.title};
+    std::string stackName{candidate->title};
     if (!CServiceBroker::GetSettingsComponent()->GetSettings()->GetBool(
             CSettings::SETTING_FILELISTS_SHOWEXTENSIONS))
       URIUtils::RemoveExtension(stackName);
@@ -859,11 +920,18 @@ void CFileItemList::Stack()
     baseItem->SetSize(size);
   }
 
-  // Delete unneeded items
-  // Sort and delete from last to first (otherwise index is no longer correct)
-  std::ranges::sort(deleteItems, std::greater());
-  for (int i : deleteItems)
-    Remove(i);
+  if (!stacked)
+    return;
+
+  // Delete unneeded items in one pass
+  size_t kept{0};
+  for (size_t i = 0; i < m_items.size(); ++i)
+  {
+    if (!deleteItems[i])
+      m_items[kept++] = std::move(m_items[i]);
+  }
+  m_items.resize(kept);
+  InvalidateIndex();
 }
 
 bool CFileItemList::Load(int windowID)
@@ -985,7 +1053,10 @@ bool CFileItemList::AlwaysCache() const
 void CFileItemList::Swap(unsigned int item1, unsigned int item2)
 {
   if (item1 != item2 && item1 < m_items.size() && item2 < m_items.size())
+  {
     std::swap(m_items[item1], m_items[item2]);
+    OnItemsReordered();
+  }
 }
 
 bool CFileItemList::UpdateItem(const CFileItem* item)
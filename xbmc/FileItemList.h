@@ -16,10 +16,12 @@
 #include "FileItem.h"
 #include "threads/CriticalSection.h"
 
+#include <atomic>
 #include <compare>
-#include <map>
+#include <memory>
 #include <string>
 #include <string_view>
+#include <unordered_map>
 #include <vector>
 
 /*!
@@ -53,14 +55,6 @@ public:
     auto operator<=>(const StackCandidate&) const = default;
   };
 
-  struct CountedStackCandidate
-  {
-    StackCandidateType type;
-    std::string title;
-
-    auto operator<=>(const CountedStackCandidate& other) const = default;
-  };
-
   CFileItemList();
   explicit CFileItemList(const std::string& strPath);
   ~CFileItemList() override;
@@ -81,7 +75,11 @@ public:
   CFileItemPtr Get(const std::string& strPath) const;
   int Size() const;
   bool IsEmpty() const;
-  void Append(const CFileItemList& itemlist);
+  /*! \brief Add the items of another list to the end of this one.
+   \param itemlist the list to add the items of.
+   \param skipDuplicates skip items whose path is already in the list, compared like Contains().
+   */
+  void Append(const CFileItemList& itemlist, bool skipDuplicates = false);
   void Assign(const CFileItemList& itemlist, bool append = false);
   bool Copy(const CFileItemList& item, bool copyItems = true);
   void Reserve(size_t iCount);
@@ -103,7 +101,16 @@ public:
   void FilterCueItems();
   void RemoveExtensions();
   void SetIgnoreURLOptions(bool ignoreURLOptions);
+  /*! \brief Always index the items by path, regardless of the size of the list.
+   Lists with more than a few items are indexed with the first path lookup anyway.
+   \sa Contains, Get
+   */
   void SetFastLookup(bool fastLookup);
+  /*! \brief Check whether the list contains an item with the given path.
+   Paths are compared exactly, without URL options if SetIgnoreURLOptions() is set. Items are
+   looked up by a hash index that the list keeps up to date as items are added, removed or
+   reordered. The index is rebuilt after the path of an indexed item was changed with SetPath().
+   */
   bool Contains(const std::string& fileName) const;
   bool GetFastLookup() const { return m_fastLookup; }
 
@@ -211,11 +218,34 @@ public:
 private:
   std::string GetDiscFileCache(int windowID) const;
 
-  void AddFastLookupItem(const CFileItemPtr& item);
-  void AddFastLookupItems(const std::vector<CFileItemPtr>& items);
+  std::string GetLookupKey(const std::string& path) const;
+  bool MatchesKey(const CFileItem& item, std::string_view key) const;
+  CFileItemPtr Find(const std::string& path) const;
+
+  bool UseIndex() const;
+  void BuildIndex() const;
+  void IndexItem(const CFileItemPtr& item) const;
+  void UnindexItem(const CFileItem& item);
+  void InvalidateIndex() const;
+  void OnItemsReordered();
+
+  struct StringHash
+  {
+    using is_transparent = void; // Enables heterogeneous operations.
+    std::size_t operator()(std::string_view sv) const
+    {
+      std::hash<std::string_view> hasher;
+      return hasher(sv);
+    }
+  };
+  using PathIndex = std::unordered_map<std::string, CFileItemPtr, StringHash, std::equal_to<>>;
 
   std::vector<std::shared_ptr<CFileItem>> m_items;
-  std::map<std::string, std::shared_ptr<CFileItem>, std::less<>> m_map;
+  mutable PathIndex m_index; // lookup key -> first item with that key, built on demand
+  // set by our items when their path changes in place
+  std::shared_ptr<std::atomic<bool>> m_indexStale = std::make_shared<std::atomic<bool>>(false);
+  mutable bool m_indexValid = false;
+  mutable bool m_indexHasDuplicates = false;
   bool m_ignoreURLOptions = false;
   bool m_fastLookup = false;
   SortDescription m_sortDescription;
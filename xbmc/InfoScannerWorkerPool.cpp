@@ -0,0 +1,123 @@
+/*
+ *  Copyright (C) 2026 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "InfoScannerWorkerPool.h"
+
+#include "URL.h"
+#include "threads/Thread.h"
+#include "utils/log.h"
+
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+
+using namespace std::chrono_literals;
+
+CInfoScannerWorkerPool::CInfoScannerWorkerPool(const std::string& name,
+                                               unsigned int threads,
+                                               unsigned int threadsPerShare)
+  : m_name(name),
+    m_threadsPerShare(std::max(threadsPerShare, 1U))
+{
+  threads = std::max(threads, 1U);
+  m_threads.reserve(threads);
+  for (unsigned int i = 0; i < threads; ++i)
+  {
+    m_threads.emplace_back(
+        std::make_unique<CThread>(static_cast<IRunnable*>(this), m_name.c_str()));
+    m_threads.back()->Create();
+  }
+}
+
+CInfoScannerWorkerPool::~CInfoScannerWorkerPool()
+{
+  {
+    std::unique_lock lock(m_section);
+    m_stop = true;
+    m_tasks.clear();
+  }
+  m_taskAvailable.notifyAll();
+
+  for (const auto& thread : m_threads)
+    thread->StopThread(true);
+}
+
+std::string CInfoScannerWorkerPool::GetShareKey(const std::string& path)
+{
+  const CURL url(path);
+  return url.GetProtocol() + "://" + url.GetHostName();
+}
+
+void CInfoScannerWorkerPool::Submit(const std::string& path, std::function<void()> task)
+{
+  {
+    std::unique_lock lock(m_section);
+    m_tasks.emplace_back(GetShareKey(path), std::move(task));
+  }
+  m_taskAvailable.notifyAll();
+}
+
+void CInfoScannerWorkerPool::Cancel()
+{
+  std::unique_lock lock(m_section);
+  m_tasks.clear();
+}
+
+void CInfoScannerWorkerPool::Run()
+{
+  std::unique_lock lock(m_section);
+  while (!m_stop)
+  {
+    // take the first task of a share that is below its limit
+    const auto task = std::ranges::find_if(
+        m_tasks,
+        [this](const Task& task)
+        {
+          const auto running = m_running.find(task.share);
+          return running == m_running.end() || running->second < m_threadsPerShare;
+        });
+    if (task == m_tasks.end())
+    {
+      m_taskAvailable.wait(lock);
+      continue;
+    }
+
+    const std::string share = task->share;
+    const std::function<void()> function = std::move(task->function);
+    m_tasks.erase(task);
+    m_running[share]++;
+
+    lock.unlock();
+    try
+    {
+      function();
+    }
+    catch (...)
+    {
+      CLog::Log(LOGERROR, "{}: unhandled exception in task for {}", m_name,
+                CURL::GetRedacted(share));
+    }
+    lock.lock();
+
+    if (--m_running[share] == 0)
+      m_running.erase(share);
+
+    // a task of this share may be waiting for the slot
+    m_taskAvailable.notifyAll();
+  }
+}
+
+bool CInfoScannerPrefetch::Wait(const std::function<bool()>& stopped)
+{
+  while (!m_done.Wait(100ms))
+  {
+    if (stopped())
+      return false;
+  }
+  return true;
+}
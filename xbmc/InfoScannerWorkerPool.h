@@ -0,0 +1,106 @@
+/*
+ *  Copyright (C) 2026 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "threads/Condition.h"
+#include "threads/CriticalSection.h"
+#include "threads/Event.h"
+#include "threads/IRunnable.h"
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+class CThread;
+
+/*!
+ \brief Bounded pool of worker threads for the I/O bound stages of library scanning.
+
+ Reading tags and listing directories on network shares is dominated by latency, so the
+ scanners hand those tasks to this pool and keep writing to the database on their own thread.
+ Tasks are keyed by the share they access (see GetShareKey()) and at most a configurable number
+ of tasks per share run at the same time, so a single slow server isn't flooded with requests
+ and can't occupy all workers.
+ */
+class CInfoScannerWorkerPool : private IRunnable
+{
+public:
+  /*!
+   \param name name of the worker threads.
+   \param threads number of worker threads.
+   \param threadsPerShare maximum number of tasks run at once for the same share.
+   */
+  CInfoScannerWorkerPool(const std::string& name, unsigned int threads, unsigned int threadsPerShare);
+  ~CInfoScannerWorkerPool() override;
+
+  /*! \brief Queue a task.
+   \param path path accessed by the task, used to apply the per share limit.
+   \param task the task to run on one of the workers.
+   */
+  void Submit(const std::string& path, std::function<void()> task);
+
+  /*! \brief Drop all queued tasks, tasks that are running are finished. */
+  void Cancel();
+
+  /*! \brief Get the key used to group tasks by share, protocol and host of the path. */
+  static std::string GetShareKey(const std::string& path);
+
+private:
+  struct Task
+  {
+    std::string share;
+    std::function<void()> function;
+  };
+
+  void Run() override;
+
+  const std::string m_name;
+  const unsigned int m_threadsPerShare;
+  std::vector<std::unique_ptr<CThread>> m_threads;
+
+  CCriticalSection m_section;
+  XbmcThreads::ConditionVariable m_taskAvailable;
+  std::deque<Task> m_tasks;
+  std::map<std::string, unsigned int, std::less<>> m_running;
+  bool m_stop{false};
+};
+
+/*!
+ \brief Claim on a task that was submitted ahead of time, e.g. to read a directory listing ahead.
+
+ The worker and the scanner thread both call Start() before running the task, and only the first
+ one runs it. This way the scanner never waits for a task that is still queued behind others or
+ that was dropped by CInfoScannerWorkerPool::Cancel(), it runs the task itself instead. A task that
+ is no longer needed is claimed without running it, so the worker skips it.
+ */
+class CInfoScannerPrefetch
+{
+public:
+  /*! \brief Claim the task.
+   \return true if the caller has to run the task, false if it was claimed before.
+   */
+  bool Start() { return !m_started.exchange(true); }
+
+  /*! \brief Mark the task as finished, called by whoever claimed it. */
+  void Finish() { m_done.Set(); }
+
+  /*! \brief Wait for a task that was claimed by a worker.
+   \param stopped checked periodically, waiting is given up once it returns true.
+   \return true if the task finished, false if waiting was given up.
+   */
+  bool Wait(const std::function<bool()>& stopped);
+
+private:
+  std::atomic<bool> m_started{false};
+  CEvent m_done{true};
+};
@@ -0,0 +1,259 @@
+/*
+ *  Copyright (C) 2026 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "LibraryChangeJournal.h"
+
+#include "ServiceBroker.h"
+#include "URL.h"
+#include "filesystem/File.h"
+#include "filesystem/IDirectoryWatcher.h"
+#include "settings/AdvancedSettings.h"
+#include "settings/SettingsComponent.h"
+#include "utils/StringUtils.h"
+#include "utils/URIUtils.h"
+#include "utils/XBMCTinyXML.h"
+#include "utils/XMLUtils.h"
+#include "utils/log.h"
+
+#if defined(TARGET_LINUX) && !defined(TARGET_ANDROID)
+#include "platform/linux/InotifyDirectoryWatcher.h"
+#endif
+
+#include <mutex>
+#include <utility>
+
+namespace
+{
+constexpr const char* JOURNAL_FILE = "special://masterprofile/librarychangejournal.xml";
+constexpr int JOURNAL_VERSION = 1;
+
+std::unique_ptr<XFILE::IDirectoryWatcher> CreateWatcher(
+    XFILE::IDirectoryWatcher::ChangedCallback changed, XFILE::IDirectoryWatcher::LostCallback lost)
+{
+#if defined(TARGET_LINUX) && !defined(TARGET_ANDROID)
+  return std::make_unique<CInotifyDirectoryWatcher>(std::move(changed), std::move(lost));
+#else
+  return {};
+#endif
+}
+
+bool IsLocalDirectory(const std::string& path)
+{
+  // the watchers work on native paths only
+  return URIUtils::HasSlashAtEnd(path) && CURL(path).GetProtocol().empty() &&
+         URIUtils::IsHD(path);
+}
+
+int64_t GetModificationTime(const std::string& directory)
+{
+  struct __stat64 buffer;
+  if (XFILE::CFile::Stat(directory, &buffer) != 0)
+    return 0;
+  return buffer.st_mtime ? buffer.st_mtime : buffer.st_ctime;
+}
+} // unnamed namespace
+
+CLibraryChangeJournal::CLibraryChangeJournal() = default;
+
+CLibraryChangeJournal::~CLibraryChangeJournal()
+{
+  // stop the watcher thread before the journal goes away
+  m_watcher.reset();
+  Save();
+}
+
+void CLibraryChangeJournal::Watch(const std::string& path)
+{
+  if (!CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_libraryChangeJournal ||
+      !IsLocalDirectory(path))
+    return;
+
+  XFILE::IDirectoryWatcher* watcher = nullptr;
+  {
+    std::unique_lock lock(m_section);
+    if (!m_loaded)
+      Load();
+
+    if (!m_watcher)
+    {
+      m_watcher = CreateWatcher([this](const std::string& directory, bool tree)
+                                { OnChanged(directory, tree); },
+                                [this]() { OnLost(); });
+      if (!m_watcher)
+        return;
+    }
+    watcher = m_watcher.get();
+  }
+
+  // may walk a large tree, don't block the change events meanwhile
+  if (!watcher->IsWatched(path) && !watcher->Watch(path))
+    CLog::Log(LOGDEBUG, "CLibraryChangeJournal: {} is not fully watched, using hashes for the rest",
+              path);
+}
+
+uint64_t CLibraryChangeJournal::GetSequence() const
+{
+  std::unique_lock lock(m_section);
+  return m_sequence;
+}
+
+bool CLibraryChangeJournal::GetUnchanged(const std::string& directory, DirectoryState& state)
+{
+  std::unique_lock lock(m_section);
+  if (!m_watcher || !m_watcher->IsWatched(directory))
+    return false;
+
+  const auto it = m_entries.find(directory);
+  if (it == m_entries.end())
+    return false;
+
+  if (!it->second.verified)
+  {
+    // restored from disk, the folder may have changed while it wasn't watched
+    const int64_t mtime = GetModificationTime(directory);
+    if (mtime == 0 || mtime != it->second.mtime)
+    {
+      m_entries.erase(it);
+      m_modified = true;
+      return false;
+    }
+    it->second.verified = true;
+  }
+
+  state = it->second.state;
+  return true;
+}
+
+void CLibraryChangeJournal::SetScanned(const std::string& directory,
+                                       uint64_t sequence,
+                                       DirectoryState state)
+{
+  std::unique_lock lock(m_section);
+  if (!m_watcher || !m_watcher->IsWatched(directory) || sequence < m_lostSequence)
+    return;
+
+  const auto change = m_changes.find(directory);
+  if (change != m_changes.end())
+  {
+    // changed while it was being scanned
+    if (change->second > sequence)
+      return;
+    m_changes.erase(change);
+  }
+
+  Entry& entry = m_entries[directory];
+  entry.state = std::move(state);
+  entry.mtime = GetModificationTime(directory);
+  entry.verified = true;
+  m_modified = true;
+}
+
+void CLibraryChangeJournal::OnChanged(const std::string& directory, bool tree)
+{
+  std::unique_lock lock(m_section);
+  const uint64_t sequence = ++m_sequence;
+  m_changes[directory] = sequence;
+  if (m_entries.erase(directory))
+    m_modified = true;
+
+  if (!tree)
+    return;
+
+  // a moved tree may come back under the same path later, forget everything below it
+  for (auto it = m_entries.lower_bound(directory);
+       it != m_entries.end() && it->first.starts_with(directory);)
+  {
+    m_changes[it->first] = sequence;
+    it = m_entries.erase(it);
+    m_modified = true;
+  }
+}
+
+void CLibraryChangeJournal::OnLost()
+{
+  std::unique_lock lock(m_section);
+  m_lostSequence = ++m_sequence;
+  m_changes.clear();
+  m_entries.clear();
+  m_modified = true;
+}
+
+void CLibraryChangeJournal::Load()
+{
+  m_loaded = true;
+  if (!XFILE::CFile::Exists(JOURNAL_FILE))
+    return;
+
+  CXBMCTinyXML doc;
+  if (!doc.LoadFile(JOURNAL_FILE))
+  {
+    CLog::Log(LOGWARNING, "CLibraryChangeJournal: unable to load {}: {} at line {}", JOURNAL_FILE,
+              doc.ErrorDesc(), doc.ErrorRow());
+    return;
+  }
+
+  const TiXmlElement* root = doc.RootElement();
+  int version = 0;
+  if (!root || root->ValueStr() != "librarychangejournal" ||
+      root->QueryIntAttribute("version", &version) != TIXML_SUCCESS || version != JOURNAL_VERSION)
+    return;
+
+  for (const TiXmlElement* directory = root->FirstChildElement("directory"); directory;
+       directory = directory->NextSiblingElement("directory"))
+  {
+    const char* path = directory->Attribute("path");
+    if (!path)
+      continue;
+
+    Entry entry;
+    entry.state.hash = XMLUtils::GetAttribute(directory, "hash");
+    entry.mtime =
+        static_cast<int64_t>(StringUtils::ToUint64(XMLUtils::GetAttribute(directory, "mtime")));
+    entry.state.files = static_cast<unsigned int>(
+        StringUtils::ToUint64(XMLUtils::GetAttribute(directory, "files")));
+    for (const TiXmlElement* subdirectory = directory->FirstChildElement("subdirectory");
+         subdirectory; subdirectory = subdirectory->NextSiblingElement("subdirectory"))
+    {
+      if (subdirectory->FirstChild())
+        entry.state.subdirectories.emplace_back(subdirectory->FirstChild()->ValueStr());
+    }
+    m_entries.insert_or_assign(path, std::move(entry));
+  }
+
+  CLog::Log(LOGDEBUG, "CLibraryChangeJournal: loaded {} folders", m_entries.size());
+}
+
+void CLibraryChangeJournal::Save()
+{
+  std::unique_lock lock(m_section);
+  if (!m_modified)
+    return;
+
+  CXBMCTinyXML doc;
+  TiXmlElement root("librarychangejournal");
+  root.SetAttribute("version", JOURNAL_VERSION);
+  for (const auto& [path, entry] : m_entries)
+  {
+    TiXmlElement directory("directory");
+    directory.SetAttribute("path", path);
+    directory.SetAttribute("hash", entry.state.hash);
+    directory.SetAttribute("mtime", std::to_string(entry.mtime));
+    directory.SetAttribute("files", std::to_string(entry.state.files));
+    for (const auto& subdirectory : entry.state.subdirectories)
+      XMLUtils::SetString(&directory, "subdirectory", subdirectory);
+    root.InsertEndChild(directory);
+  }
+  doc.InsertEndChild(root);
+
+  if (!doc.SaveFile(JOURNAL_FILE))
+  {
+    CLog::Log(LOGERROR, "CLibraryChangeJournal: unable to save {}", JOURNAL_FILE);
+    return;
+  }
+  m_modified = false;
+}
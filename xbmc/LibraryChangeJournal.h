@@ -0,0 +1,111 @@
+/*
+ *  Copyright (C) 2026 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "threads/CriticalSection.h"
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace XFILE
+{
+class IDirectoryWatcher;
+}
+
+/*!
+ \brief Journal of the library folders that didn't change since they were last scanned.
+
+ Library updates normally list every folder of a source (or stat it for the fast hash) to find out
+ whether it changed. For local sources the journal watches the folders for changes instead, so the
+ scanners can skip folders without touching the filesystem at all. Folders on network shares, or
+ on platforms without a directory watcher, are never reported unchanged and are checked by hash.
+
+ The journal is persisted across restarts. Changes that happen while Kodi isn't running can't be
+ seen, so a folder restored from disk is checked once against the modification time it had when it
+ was scanned before it's trusted again.
+
+ Usage by a scanner:
+ \code
+ const uint64_t sequence = journal.GetSequence();
+ CLibraryChangeJournal::DirectoryState state;
+ if (journal.GetUnchanged(path, state) && state.hash == dbHash)
+   ... // skip the folder, recurse into state.subdirectories
+ else
+ {
+   ... // list and scan the folder
+   journal.SetScanned(path, sequence, {hash, subdirectories, files});
+ }
+ \endcode
+ */
+class CLibraryChangeJournal
+{
+public:
+  struct DirectoryState
+  {
+    std::string hash; //!< path hash stored in the library for the folder
+    std::vector<std::string> subdirectories; //!< subfolders to scan
+    unsigned int files{0}; //!< number of media files in the folder
+  };
+
+  CLibraryChangeJournal();
+  ~CLibraryChangeJournal();
+
+  /*! \brief Start watching a library source for changes.
+   Does nothing unless enabled in advancedsettings.xml, or if the path isn't a local folder.
+   \param path path of the source or of one of its folders.
+   */
+  void Watch(const std::string& path);
+
+  /*! \brief Get the current change sequence number.
+   Must be taken before a folder is listed and passed to SetScanned() afterwards.
+   */
+  uint64_t GetSequence() const;
+
+  /*! \brief Get the recorded state of a folder that didn't change since it was last scanned.
+   \param directory the path of the folder.
+   \param state [out] the state recorded by SetScanned().
+   \return true if the folder is known to be unchanged, false otherwise.
+   */
+  bool GetUnchanged(const std::string& directory, DirectoryState& state);
+
+  /*! \brief Record the state of a scanned folder.
+   Ignored if the folder isn't watched or changed after the given sequence number.
+   \param directory the path of the folder.
+   \param sequence the sequence number taken before the folder was listed.
+   \param state the state of the folder.
+   */
+  void SetScanned(const std::string& directory, uint64_t sequence, DirectoryState state);
+
+  /*! \brief Write the journal to disk if it changed. */
+  void Save();
+
+private:
+  struct Entry
+  {
+    DirectoryState state;
+    int64_t mtime{0};
+    bool verified{false};
+  };
+
+  void Load();
+  void OnChanged(const std::string& directory, bool tree);
+  void OnLost();
+
+  mutable CCriticalSection m_section;
+  std::unique_ptr<XFILE::IDirectoryWatcher> m_watcher;
+  std::map<std::string, Entry, std::less<>> m_entries;
+  std::map<std::string, uint64_t, std::less<>> m_changes; // last change of a folder
+  uint64_t m_sequence{0};
+  uint64_t m_lostSequence{0};
+  bool m_loaded{false};
+  bool m_modified{false};
+};
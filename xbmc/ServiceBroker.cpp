@@ -273,6 +273,11 @@ CDatabaseManager& CServiceBroker::GetDatabaseManager()
   return g_application.m_ServiceManager->GetDatabaseManager();
 }
 
+CLibraryChangeJournal& CServiceBroker::GetLibraryChangeJournal()
+{
+  return g_application.m_ServiceManager->GetLibraryChangeJournal();
+}
+
 CSlideShowDelegator& CServiceBroker::GetSlideShowDelegator()
 {
   return g_application.m_ServiceManager->GetSlideShowDelegator();
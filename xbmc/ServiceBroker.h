@@ -68,6 +68,7 @@ class CPowerManager;
 class CWeatherManager;
 class CPlayerCoreFactory;
 class CDatabaseManager;
+class CLibraryChangeJournal;
 class CEventLog;
 class CGUIComponent;
 class CResourcesComponent;
@@ -182,6 +183,7 @@ public:
   static CWeatherManager& GetWeatherManager();
   static CPlayerCoreFactory& GetPlayerCoreFactory();
   static CDatabaseManager& GetDatabaseManager();
+  static CLibraryChangeJournal& GetLibraryChangeJournal();
   static CEventLog* GetEventLog();
   static CMediaManager& GetMediaManager();
   static CComponentContainer<IApplicationComponent>& GetAppComponents();
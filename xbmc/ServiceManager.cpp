@@ -10,6 +10,7 @@
 
 #include "ContextMenuManager.h"
 #include "DatabaseManager.h"
+#include "LibraryChangeJournal.h"
 #include "PlayListPlayer.h"
 #include "addons/AddonManager.h"
 #include "addons/BinaryAddonCache.h"
@@ -188,6 +189,8 @@ bool CServiceManager::InitStageTwo(const std::string& profilesUserDataFolder)
   m_mediaManager = std::make_unique<CMediaManager>();
   m_mediaManager->Initialize();
 
+  m_libraryChangeJournal = std::make_unique<CLibraryChangeJournal>();
+
 #if !defined(TARGET_WINDOWS) && defined(HAS_OPTICAL_DRIVE)
   m_DetectDVDType = std::make_unique<MEDIA_DETECT::CDetectDVDMedia>();
 #endif
@@ -271,6 +274,7 @@ void CServiceManager::DeinitStageTwo()
   m_WSDiscovery.reset();
 #endif
 
+  m_libraryChangeJournal.reset();
   m_weatherManager.reset();
   m_powerManager.reset();
   m_fileExtensionProvider.reset();
@@ -457,6 +461,11 @@ CDatabaseManager& CServiceManager::GetDatabaseManager()
   return *m_databaseManager;
 }
 
+CLibraryChangeJournal& CServiceManager::GetLibraryChangeJournal()
+{
+  return *m_libraryChangeJournal;
+}
+
 CMediaManager& CServiceManager::GetMediaManager()
 {
   return *m_mediaManager;
@@ -87,6 +87,7 @@ class CInputManager;
 class CFileExtensionProvider;
 class CPlayerCoreFactory;
 class CDatabaseManager;
+class CLibraryChangeJournal;
 class CProfileManager;
 class CEventLog;
 class CMediaManager;
@@ -129,6 +130,7 @@ public:
    *   - Input and game controller support, plus peripheral object construction
    *   - Retro player render and retro engine service construction
    *   - File extension, power, weather, media, and locale helpers
+   *   - Library change journal
    *   - Subtag registry manager initialization
    *   - Optional optical media detection object creation and SMB discovery backends
    *   - Platform stage 2 initialization
@@ -214,6 +216,8 @@ public:
 
   CDatabaseManager& GetDatabaseManager();
 
+  CLibraryChangeJournal& GetLibraryChangeJournal();
+
   CMediaManager& GetMediaManager();
 
 #if !defined(TARGET_WINDOWS) && defined(HAS_OPTICAL_DRIVE)
@@ -253,6 +257,7 @@ protected:
   std::unique_ptr<CWeatherManager> m_weatherManager;
   std::unique_ptr<CPlayerCoreFactory> m_playerCoreFactory;
   std::unique_ptr<CDatabaseManager> m_databaseManager;
+  std::unique_ptr<CLibraryChangeJournal> m_libraryChangeJournal;
   std::unique_ptr<CMediaManager> m_mediaManager;
 #if !defined(TARGET_WINDOWS) && defined(HAS_OPTICAL_DRIVE)
   std::unique_ptr<MEDIA_DETECT::CDetectDVDMedia> m_DetectDVDType;
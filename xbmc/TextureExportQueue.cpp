@@ -0,0 +1,66 @@
+/*
+ *  Copyright (C) 2026 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "TextureExportQueue.h"
+
+#include "ServiceBroker.h"
+#include "TextureCache.h"
+#include "jobs/JobManager.h"
+#include "utils/XTimeUtils.h"
+
+using namespace std::chrono_literals;
+
+namespace
+{
+// Upper bound for queued exports, keeps the export from running too far ahead of the copies
+constexpr unsigned int MAX_PENDING_EXPORTS = 256;
+} // unnamed namespace
+
+CTextureExportQueue::CTextureExportQueue(unsigned int jobsAtOnce /* = 4 */)
+  : CJobQueue(false, jobsAtOnce, CJob::PRIORITY_NORMAL)
+{
+}
+
+CTextureExportQueue::~CTextureExportQueue()
+{
+  Wait();
+}
+
+void CTextureExportQueue::Export(const std::string& image,
+                                 const std::string& destination,
+                                 bool overwrite)
+{
+  if (!CServiceBroker::GetJobManager()->IsRunning())
+  {
+    if (CServiceBroker::GetTextureCache()->Export(image, destination, overwrite))
+      m_state->exported++;
+    else
+      m_state->skipped++;
+    return;
+  }
+
+  while (m_state->pending >= MAX_PENDING_EXPORTS && IsProcessing())
+    KODI::TIME::Sleep(1ms);
+
+  m_state->pending++;
+  Submit(
+      [state = m_state, image, destination, overwrite]()
+      {
+        if (CServiceBroker::GetTextureCache()->Export(image, destination, overwrite))
+          state->exported++;
+        else
+          state->skipped++;
+        state->pending--;
+      });
+}
+
+void CTextureExportQueue::Wait()
+{
+  while (IsProcessing())
+    KODI::TIME::Sleep(5ms);
+}
@@ -0,0 +1,67 @@
+/*
+ *  Copyright (C) 2026 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "jobs/JobQueue.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+/*!
+ \ingroup textures
+ \brief Queue for exporting cached images to files in parallel.
+
+ Library exports copy one or more images per item out of the texture cache. Queueing the copies
+ here lets them run on several job manager workers while the caller continues with the next item.
+ Call Wait() before relying on the exported files or the counters.
+
+ \sa CTextureCache::Export
+ */
+class CTextureExportQueue : public CJobQueue
+{
+public:
+  /*!
+   \param jobsAtOnce maximum number of images exported concurrently.
+   */
+  explicit CTextureExportQueue(unsigned int jobsAtOnce = 4);
+  ~CTextureExportQueue() override;
+
+  /*! \brief Queue export of a (possibly) cached image to a file
+   Blocks while too many exports are pending. Falls back to exporting directly when the job
+   manager is not running.
+   \param image url of the original image
+   \param destination url of the destination file, excluding extension.
+   \param overwrite whether to overwrite the destination if it exists
+   */
+  void Export(const std::string& image, const std::string& destination, bool overwrite);
+
+  /*! \brief Wait until all queued exports have been processed
+   */
+  void Wait();
+
+  /*! \brief Number of images that have been exported successfully */
+  uint64_t GetExportedCount() const { return m_state->exported; }
+
+  /*! \brief Number of images that weren't exported as they are not cached, already exist at the
+   destination or copying failed */
+  uint64_t GetSkippedCount() const { return m_state->skipped; }
+
+private:
+  // shared with the queued jobs, which may outlive the queue if it is destroyed while exporting
+  struct State
+  {
+    std::atomic<uint64_t> exported{0};
+    std::atomic<uint64_t> skipped{0};
+    std::atomic<unsigned int> pending{0};
+  };
+
+  std::shared_ptr<State> m_state{std::make_shared<State>()};
+};
@@ -9,6 +9,7 @@
 #include "Database.h"
 
 #include "DatabaseManager.h"
+#include "DatabaseQueryStats.h"
 #include "DbUrl.h"
 #include "ServiceBroker.h"
 #include "filesystem/SpecialProtocol.h"
@@ -624,6 +625,9 @@ CDatabase::ConnectionState CDatabase::Connect(const std::string& dbName,
   // database name is always required
   m_pDB->setDatabase(dbName.c_str());
 
+  // query statistics are only gathered while enabled in advancedsettings.xml
+  m_pDB->setQueryStats(&CDatabaseQueryStats::GetInstance());
+
   // set configuration regardless if any are empty
   m_pDB->setConfig(dbSettings.key.c_str(), dbSettings.cert.c_str(), dbSettings.ca.c_str(),
                    dbSettings.capath.c_str(), dbSettings.ciphers.c_str(), dbSettings.connecttimeout,
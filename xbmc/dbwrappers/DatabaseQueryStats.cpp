@@ -0,0 +1,236 @@
+/*
+ *  Copyright (C) 2026 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "DatabaseQueryStats.h"
+
+#include "utils/StringUtils.h"
+#include "utils/Variant.h"
+#include "utils/log.h"
+
+#include <algorithm>
+#include <cctype>
+#include <mutex>
+
+namespace
+{
+// Upper bound for the number of distinct query templates we keep track of. Queries with
+// dynamically built WHERE clauses can produce a lot of templates, don't grow unbounded.
+constexpr size_t MAX_QUERY_TEMPLATES = 2000;
+
+bool IsIdentifierChar(char c)
+{
+  return std::isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '.' || c == '`';
+}
+
+double ToMilliseconds(std::chrono::microseconds duration)
+{
+  return static_cast<double>(duration.count()) / 1000.0;
+}
+} // unnamed namespace
+
+CDatabaseQueryStats& CDatabaseQueryStats::GetInstance()
+{
+  static CDatabaseQueryStats sQueryStats;
+  return sQueryStats;
+}
+
+void CDatabaseQueryStats::Configure(bool enabled, std::chrono::milliseconds slowQueryThreshold)
+{
+  std::unique_lock lock(m_critSection);
+  m_enabled = enabled;
+  m_slowQueryThreshold = slowQueryThreshold;
+}
+
+std::string CDatabaseQueryStats::NormalizeQuery(std::string_view sql)
+{
+  std::string result;
+  result.reserve(sql.size());
+
+  const auto appendPlaceholder = [&result]()
+  {
+    // collapse value lists like "IN (?, ?, ?)" into "IN (?)"
+    std::string_view current{result};
+    if (current.ends_with("?, "))
+      result.resize(result.size() - 2);
+    else if (current.ends_with("?,"))
+      result.pop_back();
+    else
+      result += '?';
+  };
+
+  for (size_t i = 0; i < sql.size(); ++i)
+  {
+    const char c = sql[i];
+    if (c == '\'' || c == '"')
+    {
+      // skip the quoted literal, quotes are escaped by doubling them
+      size_t end = i + 1;
+      while (end < sql.size())
+      {
+        if (sql[end] == c)
+        {
+          if (end + 1 < sql.size() && sql[end + 1] == c)
+          {
+            end += 2;
+            continue;
+          }
+          break;
+        }
+        ++end;
+      }
+      i = end;
+      appendPlaceholder();
+    }
+    else if (std::isdigit(static_cast<unsigned char>(c)) &&
+             (result.empty() || !IsIdentifierChar(result.back())))
+    {
+      while (i + 1 < sql.size() &&
+             (std::isdigit(static_cast<unsigned char>(sql[i + 1])) || sql[i + 1] == '.'))
+        ++i;
+      appendPlaceholder();
+    }
+    else if (std::isspace(static_cast<unsigned char>(c)))
+    {
+      if (!result.empty() && result.back() != ' ')
+        result += ' ';
+    }
+    else
+      result += c;
+  }
+
+  StringUtils::TrimRight(result);
+  return result;
+}
+
+std::string CDatabaseQueryStats::GetKey(std::string_view database, std::string_view queryTemplate)
+{
+  std::string key{database};
+  key += '\n';
+  key += queryTemplate;
+  return key;
+}
+
+bool CDatabaseQueryStats::Record(std::string_view database,
+                                 std::string_view sql,
+                                 std::chrono::microseconds duration,
+                                 uint64_t rows)
+{
+  if (!m_enabled)
+    return false;
+
+  const std::string queryTemplate = NormalizeQuery(sql);
+  const std::string key = GetKey(database, queryTemplate);
+
+  std::unique_lock lock(m_critSection);
+
+  auto it = m_stats.find(key);
+  if (it == m_stats.end())
+  {
+    if (m_stats.size() >= MAX_QUERY_TEMPLATES)
+    {
+      m_droppedTemplates++;
+      return false;
+    }
+
+    QueryStat stat;
+    stat.database = database;
+    stat.query = queryTemplate;
+    it = m_stats.emplace(key, std::move(stat)).first;
+  }
+
+  QueryStat& stat = it->second;
+  stat.count++;
+  stat.rows += rows;
+  stat.totalTime += duration;
+  stat.maxTime = std::max(stat.maxTime, duration);
+
+  if (m_slowQueryThreshold.count() > 0 && duration > m_slowQueryThreshold)
+  {
+    CLog::Log(LOGWARNING, "CDatabaseQueryStats: slow query ({:.1f} ms, {} rows) on {}: {}{}{}",
+              ToMilliseconds(duration), rows, database, sql, stat.plan.empty() ? "" : " | plan: ",
+              stat.plan);
+  }
+
+  return stat.count == 1 && stat.plan.empty();
+}
+
+void CDatabaseQueryStats::SetQueryPlan(std::string_view database,
+                                       std::string_view sql,
+                                       std::string plan)
+{
+  const std::string key = GetKey(database, NormalizeQuery(sql));
+
+  std::unique_lock lock(m_critSection);
+  auto it = m_stats.find(key);
+  if (it != m_stats.end())
+    it->second.plan = std::move(plan);
+}
+
+void CDatabaseQueryStats::Reset()
+{
+  std::unique_lock lock(m_critSection);
+  m_stats.clear();
+  m_droppedTemplates = 0;
+}
+
+std::vector<const CDatabaseQueryStats::QueryStat*> CDatabaseQueryStats::GetSortedStats(
+    size_t limit) const
+{
+  std::vector<const QueryStat*> stats;
+  stats.reserve(m_stats.size());
+  for (const auto& [_, stat] : m_stats)
+    stats.emplace_back(&stat);
+
+  std::ranges::sort(stats, [](const QueryStat* lhs, const QueryStat* rhs)
+                    { return lhs->totalTime > rhs->totalTime; });
+
+  if (limit > 0 && stats.size() > limit)
+    stats.resize(limit);
+
+  return stats;
+}
+
+void CDatabaseQueryStats::Serialize(CVariant& value, size_t limit /* = 0 */) const
+{
+  std::unique_lock lock(m_critSection);
+
+  value = CVariant(CVariant::VariantTypeArray);
+  for (const QueryStat* stat : GetSortedStats(limit))
+  {
+    CVariant entry(CVariant::VariantTypeObject);
+    entry["database"] = stat->database;
+    entry["query"] = stat->query;
+    entry["plan"] = stat->plan;
+    entry["count"] = stat->count;
+    entry["rows"] = stat->rows;
+    entry["totaltime"] = ToMilliseconds(stat->totalTime);
+    entry["maxtime"] = ToMilliseconds(stat->maxTime);
+    entry["averagetime"] = ToMilliseconds(stat->totalTime) / static_cast<double>(stat->count);
+    value.push_back(std::move(entry));
+  }
+}
+
+void CDatabaseQueryStats::LogSummary(size_t limit /* = 20 */) const
+{
+  std::unique_lock lock(m_critSection);
+
+  if (m_stats.empty())
+    return;
+
+  CLog::Log(LOGINFO, "CDatabaseQueryStats: {} query templates recorded ({} dropped), top {}:",
+            m_stats.size(), m_droppedTemplates, std::min(limit, m_stats.size()));
+  for (const QueryStat* stat : GetSortedStats(limit))
+  {
+    CLog::Log(LOGINFO, "  {:.1f} ms total, {} calls, {:.2f} ms avg, {:.1f} ms max, {} rows [{}] {}",
+              ToMilliseconds(stat->totalTime), stat->count,
+              ToMilliseconds(stat->totalTime) / static_cast<double>(stat->count),
+              ToMilliseconds(stat->maxTime), stat->rows, stat->database, stat->query);
+    if (!stat->plan.empty())
+      CLog::Log(LOGINFO, "    plan: {}", stat->plan);
+  }
+}
@@ -0,0 +1,116 @@
+/*
+ *  Copyright (C) 2026 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "threads/CriticalSection.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class CVariant;
+
+/*!
+ \ingroup database
+ \brief Opt-in, in-memory aggregation of database query execution statistics.
+
+ Queries are grouped by their template, i.e. the SQL text with all literal values
+ replaced by placeholders, so that e.g. all "SELECT * FROM movie_view WHERE idMovie=N"
+ queries end up in a single bucket. For each template the number of executions, the
+ accumulated and maximum execution time and the number of returned rows are recorded.
+ Database backends that support it (SQLite) additionally attach the query plan the
+ first time a template is seen, which makes missing indexes easy to spot.
+
+ Enabled through the \<databasequerystats\> advanced setting.
+ */
+class CDatabaseQueryStats
+{
+public:
+  static CDatabaseQueryStats& GetInstance();
+
+  struct QueryStat
+  {
+    std::string database;
+    std::string query;
+    std::string plan;
+    uint64_t count{0};
+    uint64_t rows{0};
+    std::chrono::microseconds totalTime{0};
+    std::chrono::microseconds maxTime{0};
+  };
+
+  /*! \brief Configure the statistics collector.
+   \param enabled whether query statistics should be collected.
+   \param slowQueryThreshold queries taking longer than this are logged with their plan,
+          zero disables slow query logging.
+   */
+  void Configure(bool enabled, std::chrono::milliseconds slowQueryThreshold);
+
+  bool IsEnabled() const { return m_enabled; }
+
+  /*! \brief Record a single query execution.
+   \param database the name of the database the query was executed on.
+   \param sql the executed SQL statement.
+   \param duration the time it took to execute the query and fetch its results.
+   \param rows the number of rows returned by the query.
+   \return true if this is the first execution of the query's template and no plan has
+           been attached yet, false otherwise.
+   \sa SetQueryPlan
+   */
+  bool Record(std::string_view database,
+              std::string_view sql,
+              std::chrono::microseconds duration,
+              uint64_t rows);
+
+  /*! \brief Attach the query plan to the template of the given query.
+   \param database the name of the database the query was executed on.
+   \param sql the executed SQL statement.
+   \param plan human readable representation of the query plan.
+   */
+  void SetQueryPlan(std::string_view database, std::string_view sql, std::string plan);
+
+  /*! \brief Drop all recorded statistics. */
+  void Reset();
+
+  /*! \brief Serialize the recorded statistics, most expensive templates first.
+   \param value the variant to fill with an array of statistic objects.
+   \param limit maximum number of templates to serialize, zero for all.
+   */
+  void Serialize(CVariant& value, size_t limit = 0) const;
+
+  /*! \brief Write a summary of the most expensive query templates to the log.
+   \param limit maximum number of templates to log.
+   */
+  void LogSummary(size_t limit = 20) const;
+
+  /*! \brief Turn a SQL statement into its template by replacing literal strings and numbers
+   with '?' placeholders, collapsing value lists and whitespace.
+   \param sql the SQL statement.
+   \return the normalized query template.
+   */
+  static std::string NormalizeQuery(std::string_view sql);
+
+private:
+  CDatabaseQueryStats() = default;
+  CDatabaseQueryStats(const CDatabaseQueryStats&) = delete;
+  CDatabaseQueryStats& operator=(const CDatabaseQueryStats&) = delete;
+
+  static std::string GetKey(std::string_view database, std::string_view queryTemplate);
+  std::vector<const QueryStat*> GetSortedStats(size_t limit) const;
+
+  mutable CCriticalSection m_critSection;
+  std::atomic<bool> m_enabled{false};
+  std::chrono::milliseconds m_slowQueryThreshold{0};
+  std::map<std::string, QueryStat, std::less<>> m_stats;
+  uint64_t m_droppedTemplates{0};
+};
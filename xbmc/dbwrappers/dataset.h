@@ -22,6 +22,8 @@
 #include <string_view>
 #include <unordered_map>
 
+class CDatabaseQueryStats;
+
 namespace dbiplus
 {
 class Dataset;
@@ -65,6 +67,7 @@ protected:
   std::string capath;
   std::string ciphers; // SSL - Encryption info
   unsigned int connect_timeout; // seconds
+  CDatabaseQueryStats* query_stats{nullptr}; // Query statistics collector, if any
 
 public:
   /* constructor */
@@ -116,6 +119,11 @@ public:
     compression = newCompression;
   }
 
+  /* sets the collector used to gather query statistics, nullptr to disable */
+  void setQueryStats(CDatabaseQueryStats* stats) { query_stats = stats; }
+  /* gets the query statistics collector */
+  CDatabaseQueryStats* getQueryStats() const { return query_stats; }
+
   /* virtual methods that must be overloaded in derived classes */
 
   virtual int init() { return DB_COMMAND_OK; }
@@ -10,6 +10,7 @@
 
 #include "ServiceBroker.h"
 #include "Util.h"
+#include "dbwrappers/DatabaseQueryStats.h"
 #include "network/DNSNameCache.h"
 #include "network/WakeOnAccess.h"
 #include "utils/StringUtils.h"
@@ -1950,6 +1951,7 @@ int MysqlDataset::exec(const std::string& sql)
   }
   else
   {
+    record_query_stats(qry, start, 0);
     //! @todo collect results and store in exec_res
     return res;
   }
@@ -1984,6 +1986,8 @@ bool MysqlDataset::query(const std::string& query)
 
   MYSQL_RES* stmt = nullptr;
 
+  const auto start = std::chrono::steady_clock::now();
+
   if (static_cast<MysqlDatabase*>(db)->setErr(
           static_cast<MysqlDatabase*>(db)->query_with_reconnect(qry.c_str()), qry.c_str()) !=
       MYSQL_OK)
@@ -2072,12 +2076,26 @@ bool MysqlDataset::query(const std::string& query)
     result.records.push_back(res);
   }
   mysql_free_result(stmt);
+  record_query_stats(qry, start, result.records.size());
   active = true;
   ds_state = dsSelect;
   this->first();
   return true;
 }
 
+void MysqlDataset::record_query_stats(const std::string& query,
+                                      std::chrono::steady_clock::time_point start,
+                                      uint64_t rows)
+{
+  CDatabaseQueryStats* stats = db->getQueryStats();
+  if (!stats || !stats->IsEnabled())
+    return;
+
+  const auto duration = std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - start);
+  stats->Record(db->getDatabase(), query, duration, rows);
+}
+
 void MysqlDataset::open(const std::string& sql)
 {
   set_select_sql(sql);
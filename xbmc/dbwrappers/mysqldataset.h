@@ -10,6 +10,8 @@
 
 #include "dataset.h"
 
+#include <chrono>
+#include <cstdint>
 #include <string>
 
 #ifdef HAS_MYSQL
@@ -108,6 +110,10 @@ protected:
   void fill_fields() override;
   /* Changing field values during dataset navigation */
   virtual void free_row(); // free the memory allocated for the current row
+  /* Passes execution statistics of a query on to the database's query statistics collector */
+  void record_query_stats(const std::string& query,
+                          std::chrono::steady_clock::time_point start,
+                          uint64_t rows);
 
 public:
   /* constructor */
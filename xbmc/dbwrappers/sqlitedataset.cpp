@@ -12,6 +12,7 @@
 
 #include "sqlitedataset.h"
 
+#include "dbwrappers/DatabaseQueryStats.h"
 #include "utils/Map.h"
 #include "utils/StringUtils.h"
 #include "utils/URIUtils.h"
@@ -909,6 +910,7 @@ int SqliteDataset::exec(const std::string& sql)
 
   if (res == SQLITE_OK)
   {
+    record_query_stats(qry, start, exec_res.records.size());
     return res;
   }
   else
@@ -953,6 +955,8 @@ bool SqliteDataset::query(const std::string& query)
 
   close();
 
+  const auto start = std::chrono::steady_clock::now();
+
   sqlite3_stmt* stmt = nullptr;
   if (db->setErr(sqlite3_prepare_v2(handle(), query.c_str(), -1, &stmt, nullptr), query.c_str()) !=
       SQLITE_OK)
@@ -999,6 +1003,7 @@ bool SqliteDataset::query(const std::string& query)
   }
   if (db->setErr(sqlite3_finalize(stmt), query.c_str()) == SQLITE_OK)
   {
+    record_query_stats(query, start, result.records.size());
     active = true;
     ds_state = dsSelect;
     this->first();
@@ -1010,6 +1015,53 @@ bool SqliteDataset::query(const std::string& query)
   }
 }
 
+std::string SqliteDataset::explain_query_plan(const std::string& query)
+{
+  std::string plan;
+
+  sqlite3_stmt* stmt = nullptr;
+  const std::string explain = "EXPLAIN QUERY PLAN " + query;
+  if (sqlite3_prepare_v2(handle(), explain.c_str(), -1, &stmt, nullptr) != SQLITE_OK)
+  {
+    sqlite3_finalize(stmt);
+    return plan;
+  }
+
+  // columns are: id, parent, notused, detail
+  while (sqlite3_step(stmt) == SQLITE_ROW)
+  {
+    const auto* detail = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 3));
+    if (!detail)
+      continue;
+
+    if (!plan.empty())
+      plan += "; ";
+    plan += detail;
+  }
+  sqlite3_finalize(stmt);
+
+  return plan;
+}
+
+void SqliteDataset::record_query_stats(const std::string& query,
+                                       std::chrono::steady_clock::time_point start,
+                                       uint64_t rows)
+{
+  CDatabaseQueryStats* stats = db->getQueryStats();
+  if (!stats || !stats->IsEnabled())
+    return;
+
+  const auto duration = std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - start);
+
+  // only DML statements can be explained, skip schema changes and pragmas
+  if (stats->Record(db->getDatabase(), query, duration, rows) &&
+      (StringUtils::StartsWithNoCase(query, "select") ||
+       StringUtils::StartsWithNoCase(query, "update") ||
+       StringUtils::StartsWithNoCase(query, "delete")))
+    stats->SetQueryPlan(db->getDatabase(), query, explain_query_plan(query));
+}
+
 void SqliteDataset::open(const std::string& sql)
 {
   set_select_sql(sql);
@@ -14,6 +14,8 @@
 
 #include "dataset.h"
 
+#include <chrono>
+#include <cstdint>
 #include <string>
 
 struct sqlite3;
@@ -110,6 +112,12 @@ protected:
   void fill_fields() override;
   /* Changing field values during dataset navigation */
   virtual void free_row(); // free the memory allocated for the current row
+  /* Returns the EXPLAIN QUERY PLAN output for the given statement */
+  std::string explain_query_plan(const std::string& query);
+  /* Passes execution statistics of a query on to the database's query statistics collector */
+  void record_query_stats(const std::string& query,
+                          std::chrono::steady_clock::time_point start,
+                          uint64_t rows);
 
 public:
   /* constructor */
@@ -0,0 +1,94 @@
+/*
+ *  Copyright (C) 2026 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "dbwrappers/DatabaseQueryStats.h"
+#include "utils/Variant.h"
+
+#include <chrono>
+
+#include <gtest/gtest.h>
+
+using namespace std::chrono_literals;
+
+namespace
+{
+class TestDatabaseQueryStats : public testing::Test
+{
+protected:
+  TestDatabaseQueryStats()
+  {
+    CDatabaseQueryStats::GetInstance().Configure(true, 0ms);
+    CDatabaseQueryStats::GetInstance().Reset();
+  }
+
+  ~TestDatabaseQueryStats() override
+  {
+    CDatabaseQueryStats::GetInstance().Reset();
+    CDatabaseQueryStats::GetInstance().Configure(false, 0ms);
+  }
+};
+} // namespace
+
+TEST_F(TestDatabaseQueryStats, NormalizeQuery)
+{
+  EXPECT_EQ("SELECT * FROM movie_view WHERE idMovie=?",
+            CDatabaseQueryStats::NormalizeQuery("SELECT * FROM movie_view WHERE idMovie=42"));
+  EXPECT_EQ("SELECT idPath FROM path WHERE strPath=?",
+            CDatabaseQueryStats::NormalizeQuery(
+                "SELECT idPath FROM path WHERE strPath='smb://nas/it''s here/'"));
+  EXPECT_EQ("DELETE FROM song WHERE idSong IN (?)",
+            CDatabaseQueryStats::NormalizeQuery("DELETE FROM song WHERE idSong IN (1, 2,3,  4)"));
+  EXPECT_EQ("SELECT c00, c12 FROM movie LIMIT ?",
+            CDatabaseQueryStats::NormalizeQuery("SELECT c00, c12\n  FROM movie\tLIMIT 10\n"));
+  EXPECT_EQ("SELECT * FROM version WHERE x=?",
+            CDatabaseQueryStats::NormalizeQuery("SELECT * FROM version WHERE x=1.5"));
+}
+
+TEST_F(TestDatabaseQueryStats, Record)
+{
+  CDatabaseQueryStats& stats = CDatabaseQueryStats::GetInstance();
+
+  EXPECT_TRUE(stats.Record("MyVideos", "SELECT * FROM movie WHERE idMovie=1", 10ms, 1));
+  EXPECT_FALSE(stats.Record("MyVideos", "SELECT * FROM movie WHERE idMovie=2", 30ms, 1));
+  EXPECT_TRUE(stats.Record("MyMusic", "SELECT * FROM song", 5ms, 100));
+  stats.SetQueryPlan("MyVideos", "SELECT * FROM movie WHERE idMovie=3",
+                     "SEARCH movie USING INTEGER PRIMARY KEY (rowid=?)");
+
+  CVariant result;
+  stats.Serialize(result);
+  ASSERT_TRUE(result.isArray());
+  ASSERT_EQ(2u, result.size());
+
+  // most expensive template first
+  EXPECT_EQ("MyVideos", result[0]["database"].asString());
+  EXPECT_EQ("SELECT * FROM movie WHERE idMovie=?", result[0]["query"].asString());
+  EXPECT_EQ("SEARCH movie USING INTEGER PRIMARY KEY (rowid=?)", result[0]["plan"].asString());
+  EXPECT_EQ(2u, result[0]["count"].asUnsignedInteger());
+  EXPECT_EQ(2u, result[0]["rows"].asUnsignedInteger());
+  EXPECT_DOUBLE_EQ(40.0, result[0]["totaltime"].asDouble());
+  EXPECT_DOUBLE_EQ(30.0, result[0]["maxtime"].asDouble());
+  EXPECT_DOUBLE_EQ(20.0, result[0]["averagetime"].asDouble());
+
+  EXPECT_EQ("MyMusic", result[1]["database"].asString());
+  EXPECT_EQ(100u, result[1]["rows"].asUnsignedInteger());
+
+  stats.Serialize(result, 1);
+  EXPECT_EQ(1u, result.size());
+}
+
+TEST_F(TestDatabaseQueryStats, Disabled)
+{
+  CDatabaseQueryStats& stats = CDatabaseQueryStats::GetInstance();
+  stats.Configure(false, 0ms);
+
+  EXPECT_FALSE(stats.Record("MyVideos", "SELECT * FROM movie", 10ms, 1));
+
+  CVariant result;
+  stats.Serialize(result);
+  EXPECT_EQ(0u, result.size());
+}
@@ -21,6 +21,7 @@
 #include "guilib/GUIWindowManager.h"
 #include "jobs/Job.h"
 #include "jobs/JobManager.h"
+#include "jobs/LambdaJob.h"
 #include "messaging/ApplicationMessenger.h"
 #include "music/MusicFileItemClassify.h"
 #include "playlists/PlayListFileItemClassify.h"
@@ -30,6 +31,9 @@
 #include "utils/log.h"
 #include "video/VideoFileItemClassify.h"
 
+#include <iterator>
+#include <utility>
+
 using namespace KODI;
 using namespace XFILE;
 using namespace std::chrono_literals;
@@ -172,9 +176,27 @@ bool CDirectory::GetDirectory(const CURL& url,
       return false;
 
     // check our cache for this path
+    bool revalidate = false;
     if (g_directoryCache.GetDirectory(realURL, items,
                                       (hints.flags & DIR_FLAG_READ_CACHE) == DIR_FLAG_READ_CACHE))
       items.SetURL(url);
+    else if ((hints.flags & DIR_FLAG_PERSISTENT_CACHE) && !(hints.flags & DIR_FLAG_BYPASS_CACHE) &&
+             g_directoryCache.GetPersistentDirectory(realURL, items, revalidate))
+    {
+      items.SetURL(url);
+      if (revalidate)
+      {
+        // list it again in the background, the refreshed listing is used next time
+        CHints refresh = hints;
+        refresh.flags = (hints.flags | DIR_FLAG_BYPASS_CACHE) & ~DIR_FLAG_ALLOW_PROMPT;
+        CServiceBroker::GetJobManager()->Submit(
+            [url, refresh]()
+            {
+              CFileItemList refreshed;
+              CDirectory::GetDirectory(url, refreshed, refresh);
+            });
+      }
+    }
     else
     {
       // need to clear the cache (in case the directory fetch fails)
@@ -252,6 +274,8 @@ bool CDirectory::GetDirectory(const CURL& url,
       // cache the directory, if necessary
       if (!(hints.flags & DIR_FLAG_BYPASS_CACHE))
         g_directoryCache.SetDirectory(realURL, items, pDirectory->GetCacheType(url));
+      if (hints.flags & DIR_FLAG_PERSISTENT_CACHE)
+        g_directoryCache.SetPersistentDirectory(realURL, items);
     }
 
     // now filter for allowed files
@@ -308,6 +332,114 @@ bool CDirectory::GetDirectory(const CURL& url,
   return false;
 }
 
+CDirectory::CAsyncListing::CAsyncListing(std::shared_ptr<IDirectory> directory)
+  : m_directory(std::move(directory)), m_items(std::make_unique<CFileItemList>())
+{
+}
+
+CDirectory::CAsyncListing::~CAsyncListing() = default;
+
+std::vector<std::shared_ptr<CFileItem>> CDirectory::CAsyncListing::TakeItems()
+{
+  std::unique_lock lock(m_section);
+  return std::exchange(m_pending, {});
+}
+
+bool CDirectory::CAsyncListing::IsDone() const
+{
+  return m_done.Signaled();
+}
+
+void CDirectory::CAsyncListing::Cancel()
+{
+  {
+    std::unique_lock lock(m_section);
+    m_cancelled = true;
+    m_pending.clear();
+  }
+  if (m_directory && !IsDone())
+    m_directory->CancelDirectory();
+}
+
+bool CDirectory::CAsyncListing::GetResult(CFileItemList& items) const
+{
+  if (!IsDone())
+    return false;
+
+  std::unique_lock lock(m_section);
+  if (!m_result)
+    return false;
+
+  items.Copy(*m_items);
+  return true;
+}
+
+void CDirectory::CAsyncListing::Run(const CURL& url, const CHints& hints)
+{
+  bool result = false;
+  if (m_directory && !m_cancelled)
+  {
+    const bool showHidden =
+        (hints.flags & DIR_FLAG_GET_HIDDEN) ||
+        CServiceBroker::GetSettingsComponent()->GetSettings()->GetBool(
+            CSettings::SETTING_FILELISTS_SHOWHIDDEN);
+
+    m_directory->SetPartialItemsCallback(
+        [this, &hints, showHidden](std::span<const std::shared_ptr<CFileItem>> items)
+        { return AddItems(items, hints.mask, showHidden); });
+    result = CDirectory::GetDirectory(url, m_directory, *m_items, hints);
+    m_directory->SetPartialItemsCallback({});
+  }
+
+  {
+    std::unique_lock lock(m_section);
+    m_result = result && !m_cancelled;
+  }
+  m_done.Set();
+}
+
+bool CDirectory::CAsyncListing::AddItems(std::span<const std::shared_ptr<CFileItem>> items,
+                                         const std::string& mask,
+                                         bool showHidden)
+{
+  if (m_cancelled)
+    return false;
+
+  // copies, the directory may still change its items before returning the listing
+  const bool filterMask = !mask.empty() && !m_directory->AllowAll();
+  std::vector<std::shared_ptr<CFileItem>> copies;
+  copies.reserve(items.size());
+  for (const auto& item : items)
+  {
+    if (filterMask && !item->IsFolder() && !URIUtils::HasExtension(item->GetPath(), mask))
+      continue;
+    if (!showHidden && item->GetProperty("file:hidden").asBoolean())
+      continue;
+    copies.emplace_back(std::make_shared<CFileItem>(*item));
+  }
+
+  std::unique_lock lock(m_section);
+  if (m_cancelled)
+    return false;
+  m_pending.insert(m_pending.end(), std::make_move_iterator(copies.begin()),
+                   std::make_move_iterator(copies.end()));
+  return true;
+}
+
+std::shared_ptr<CDirectory::CAsyncListing> CDirectory::GetDirectoryAsync(
+    const CURL& url, std::shared_ptr<IDirectory> pDirectory, const CHints& hints)
+{
+  if (!pDirectory)
+    pDirectory.reset(CDirectoryFactory::Create(URIUtils::SubstitutePath(url)));
+
+  auto listing = std::make_shared<CAsyncListing>(std::move(pDirectory));
+  auto run = [listing, url, hints]() { listing->Run(url, hints); };
+  if (CServiceBroker::GetJobManager()->AddJob(new CLambdaJob(run), nullptr, CJob::PRIORITY_HIGH) ==
+      0)
+    run(); // job manager not running
+  return listing;
+}
+
 bool CDirectory::EnumerateDirectory(
     const std::string& path,
     const DirectoryEnumerationCallback& callback,
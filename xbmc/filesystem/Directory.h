@@ -9,10 +9,14 @@
 #pragma once
 
 #include "IDirectory.h"
+#include "threads/CriticalSection.h"
+#include "threads/Event.h"
 
+#include <atomic>
 #include <functional>
 #include <memory>
 #include <string>
+#include <vector>
 
 class CFileItem;
 
@@ -49,6 +53,74 @@ public:
                            , CFileItemList &items
                            , const CHints &hints);
 
+  /*!
+   \brief A listing read in the background, handing out its items while they arrive.
+
+   Directories reading their listing in several steps (plugins, local folders) pass the items
+   they read so far, which can be taken with TakeItems() and shown while the rest is still being
+   read. These items are copies, filtered by mask and hidden state only. The final listing as
+   returned by GetDirectory is available with GetResult() once the listing is done.
+   \sa GetDirectoryAsync
+   */
+  class CAsyncListing
+  {
+  public:
+    explicit CAsyncListing(std::shared_ptr<IDirectory> directory);
+    ~CAsyncListing();
+
+    /*!
+     \brief Take the items that arrived since the last call, in listing order.
+     */
+    std::vector<std::shared_ptr<CFileItem>> TakeItems();
+
+    /*!
+     \brief Event set once the listing is done, whether it succeeded or not.
+     */
+    CEvent& GetDoneEvent() { return m_done; }
+    bool IsDone() const;
+
+    /*!
+     \brief Ask the listing to stop. The directory is asked to cancel, and reading stops at the
+     next batch of items for directories that report them.
+     */
+    void Cancel();
+    bool IsCancelled() const { return m_cancelled; }
+
+    /*!
+     \brief Get the complete listing.
+     \param items [out] the listing.
+     \return false if the listing failed, was cancelled or is not done yet, true otherwise.
+     */
+    bool GetResult(CFileItemList& items) const;
+
+  private:
+    friend class CDirectory;
+
+    void Run(const CURL& url, const CHints& hints);
+    bool AddItems(std::span<const std::shared_ptr<CFileItem>> items,
+                  const std::string& mask,
+                  bool showHidden);
+
+    const std::shared_ptr<IDirectory> m_directory;
+    mutable CCriticalSection m_section;
+    std::vector<std::shared_ptr<CFileItem>> m_pending;
+    std::unique_ptr<CFileItemList> m_items;
+    bool m_result{false};
+    std::atomic_bool m_cancelled{false};
+    mutable CEvent m_done{true};
+  };
+
+  /*!
+   \brief Read a directory in the background.
+   \param url the directory to read.
+   \param pDirectory the directory implementation to use, created from the url if empty.
+   \param hints mask and flags, as for GetDirectory.
+   \return the running listing, never empty.
+   \sa CAsyncListing
+   */
+  static std::shared_ptr<CAsyncListing> GetDirectoryAsync(
+      const CURL& url, std::shared_ptr<IDirectory> pDirectory, const CHints& hints);
+
   static bool Create(const CURL& url);
   static bool Exists(const CURL& url, bool bUseCache = true);
   static bool Remove(const CURL& url);
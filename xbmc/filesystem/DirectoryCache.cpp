@@ -11,18 +11,26 @@
 #include "Directory.h"
 #include "FileItem.h"
 #include "FileItemList.h"
+#include "PersistentDirectoryCache.h"
+#include "ServiceBroker.h"
 #include "URL.h"
+#include "settings/AdvancedSettings.h"
+#include "settings/SettingsComponent.h"
 #include "utils/StringUtils.h"
 #include "utils/URIUtils.h"
 #include "utils/log.h"
 
 #include <algorithm>
+#include <chrono>
 #include <climits>
 #include <mutex>
 
 // Maximum number of directories to keep in our cache
 #define MAX_CACHED_DIRS 50
 
+// Folder of the listings kept across restarts
+#define PERSISTENT_CACHE_FOLDER "special://temp/dircache/"
+
 using namespace XFILE;
 
 namespace
@@ -44,6 +52,59 @@ std::string getDirKey(const CURL& url)
   return dirPath;
 }
 
+std::string getPersistentKey(const CURL& url, bool parent = false)
+{
+  // never write credentials to disk
+  CURL key(url);
+  key.SetOptions("");
+  key.SetProtocolOptions("");
+  if (parent)
+    key.SetFileName(URIUtils::GetDirectory(key.GetFileName()));
+  std::string path = key.GetWithoutUserDetails();
+  URIUtils::RemoveSlashAtEnd(path);
+  return path;
+}
+
+bool hasUserDetails(const CURL& url)
+{
+  return !url.GetUserName().empty() || !url.GetPassWord().empty() || !url.GetDomain().empty();
+}
+
+std::string stripUserDetails(const std::string& path)
+{
+  if (path.empty())
+    return path;
+
+  const CURL url(path);
+  return hasUserDetails(url) ? url.GetWithoutUserDetails() : path;
+}
+
+std::string restoreUserDetails(const std::string& path, const CURL& source)
+{
+  if (path.empty())
+    return path;
+
+  CURL url(path);
+  if (hasUserDetails(url) || !url.IsProtocol(source.GetProtocol()) ||
+      !StringUtils::EqualsNoCase(url.GetHostName(), source.GetHostName()))
+    return path;
+
+  url.SetDomain(source.GetDomain());
+  url.SetUserName(source.GetUserName());
+  url.SetPassword(source.GetPassWord());
+  return url.Get();
+}
+
+bool isPersistent()
+{
+  const auto settingsComponent = CServiceBroker::GetSettingsComponent();
+  if (!settingsComponent)
+    return false;
+
+  const auto advancedSettings = settingsComponent->GetAdvancedSettings();
+  return advancedSettings && advancedSettings->m_persistentDirCacheSize > 0;
+}
+
 } // Unnamed namespace
 
 CDirectoryCache::CDir::CDir(CacheType cacheType) : m_Items(std::make_unique<CFileItemList>())
@@ -62,12 +123,11 @@ void CDirectoryCache::CDir::SetLastAccess(unsigned int &accessCounter)
 }
 
 CDirectoryCache::CDirectoryCache(void)
+  : m_persistent(std::make_unique<CPersistentDirectoryCache>(PERSISTENT_CACHE_FOLDER))
 {
   m_accessCounter = 0;
-#ifdef _DEBUG
   m_cacheHits = 0;
   m_cacheMisses = 0;
-#endif
 }
 
 CDirectoryCache::~CDirectoryCache(void) = default;
@@ -86,12 +146,11 @@ bool CDirectoryCache::GetDirectory(const CURL& url, CFileItemList& items, bool r
     {
       items.Copy(*dir.m_Items);
       dir.SetLastAccess(m_accessCounter);
-#ifdef _DEBUG
       m_cacheHits += items.Size();
-#endif
       return true;
     }
   }
+  m_cacheMisses++;
   return false;
 }
 
@@ -124,42 +183,148 @@ void CDirectoryCache::SetDirectory(const CURL& url, const CFileItemList& items,
   m_cache.emplace(storedPath, std::move(dir));
 }
 
+bool CDirectoryCache::GetPersistentDirectory(const CURL& url,
+                                             CFileItemList& items,
+                                             bool& revalidate)
+{
+  revalidate = false;
+  const int64_t timeToLive = GetPersistentTimeToLive(url);
+  if (timeToLive < 0)
+    return false;
+
+  const std::string storedPath = getPersistentKey(url);
+  int64_t storedTime = 0;
+  if (!m_persistent->Get(storedPath, items, storedTime))
+  {
+    std::unique_lock lock(m_cs);
+    m_persistentMisses++;
+    return false;
+  }
+
+  // the items were stored without the credentials of the source, take them from the request
+  if (hasUserDetails(url))
+  {
+    for (const auto& item : items)
+    {
+      const bool hasDynPath = item->GetDynPath() != item->GetPath();
+      if (hasDynPath)
+        item->SetDynPath(restoreUserDetails(item->GetDynPath(), url));
+      item->SetPath(restoreUserDetails(item->GetPath(), url));
+    }
+  }
+
+  // serve stale listings right away, the caller refreshes them in the background
+  const int64_t now = std::chrono::duration_cast<std::chrono::seconds>(
+                          std::chrono::system_clock::now().time_since_epoch())
+                          .count();
+  const bool stale = now - storedTime >= timeToLive;
+  if (stale)
+    revalidate = m_persistent->StartRevalidation(storedPath, now, std::max<int64_t>(timeToLive, 1));
+
+  std::unique_lock lock(m_cs);
+  if (stale)
+    m_persistentStaleHits++;
+  else
+    m_persistentHits++;
+  return true;
+}
+
+void CDirectoryCache::SetPersistentDirectory(const CURL& url, const CFileItemList& items)
+{
+  if (GetPersistentTimeToLive(url) < 0)
+    return;
+
+  const uint64_t maxSize = static_cast<uint64_t>(CServiceBroker::GetSettingsComponent()
+                                                     ->GetAdvancedSettings()
+                                                     ->m_persistentDirCacheSize) *
+                           1024 * 1024;
+
+  // archiving needs a non const list, the item paths must not carry any credentials either as
+  // they are written to disk
+  CFileItemList copy;
+  copy.Copy(items, false);
+  copy.SetPath(stripUserDetails(items.GetPath()));
+  for (const auto& item : items)
+  {
+    auto stored = std::make_shared<CFileItem>(*item);
+    if (item->GetDynPath() != item->GetPath())
+      stored->SetDynPath(stripUserDetails(item->GetDynPath()));
+    stored->SetPath(stripUserDetails(item->GetPath()));
+    copy.Add(std::move(stored));
+  }
+  m_persistent->Set(getPersistentKey(url), copy, maxSize);
+}
+
+int64_t CDirectoryCache::GetPersistentTimeToLive(const CURL& url) const
+{
+  if (!isPersistent())
+    return -1;
+
+  const auto advancedSettings = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings();
+  const auto it = advancedSettings->m_persistentDirCacheTTL.find(url.GetProtocol());
+  if (it == advancedSettings->m_persistentDirCacheTTL.end())
+    return -1;
+
+  return it->second;
+}
+
+CDirectoryCache::Stats CDirectoryCache::GetStats() const
+{
+  std::unique_lock lock(m_cs);
+  return {m_cacheHits, m_cacheMisses, m_persistentHits, m_persistentStaleHits, m_persistentMisses};
+}
+
 void CDirectoryCache::ClearFile(const CURL& url)
 {
   const std::string dirPath = getDirKey(url);
-  m_cache.erase(dirPath);
+  {
+    std::unique_lock lock(m_cs);
+    m_cache.erase(dirPath);
+  }
+  if (isPersistent())
+    m_persistent->Remove(getPersistentKey(url, true));
 }
 
 void CDirectoryCache::ClearDirectory(const CURL& url)
 {
-  std::unique_lock lock(m_cs);
-
   const std::string storedPath = getKey(url);
-  m_cache.erase(storedPath);
+  {
+    std::unique_lock lock(m_cs);
+    m_cache.erase(storedPath);
+  }
+  if (isPersistent())
+    m_persistent->Remove(getPersistentKey(url));
 }
 
 void CDirectoryCache::ClearSubPaths(const CURL& url)
 {
-  std::unique_lock lock(m_cs);
-
   const std::string storedPath = getKey(url);
-  std::erase_if(m_cache, [&storedPath](const auto& i)
-                { return URIUtils::PathHasParent(i.first, storedPath); });
+  {
+    std::unique_lock lock(m_cs);
+    std::erase_if(m_cache, [&storedPath](const auto& i)
+                  { return URIUtils::PathHasParent(i.first, storedPath); });
+  }
+  if (isPersistent())
+    m_persistent->RemoveSubPaths(getPersistentKey(url));
 }
 
 void CDirectoryCache::AddFile(const CURL& url)
 {
-  std::unique_lock lock(m_cs);
-
   const std::string dirPath = getDirKey(url);
-
-  const auto i{m_cache.find(dirPath)};
-  if (i != m_cache.cend())
   {
-    CDir& dir{i->second};
-    dir.m_Items->Add(std::make_shared<CFileItem>(url.Get(), false));
-    dir.SetLastAccess(m_accessCounter);
+    std::unique_lock lock(m_cs);
+
+    const auto i{m_cache.find(dirPath)};
+    if (i != m_cache.cend())
+    {
+      CDir& dir{i->second};
+      dir.m_Items->Add(std::make_shared<CFileItem>(url.Get(), false));
+      dir.SetLastAccess(m_accessCounter);
+    }
   }
+  // the stored listing is refreshed with the next listing of the directory
+  if (isPersistent())
+    m_persistent->Remove(getPersistentKey(url, true));
 }
 
 bool CDirectoryCache::FileExists(const CURL& url, bool& foundInCache)
@@ -176,22 +341,23 @@ bool CDirectoryCache::FileExists(const CURL& url, bool& foundInCache)
     foundInCache = true;
     CDir& dir = i->second;
     dir.SetLastAccess(m_accessCounter);
-#ifdef _DEBUG
     m_cacheHits++;
-#endif
     return (URIUtils::PathEquals(filePath, dirPath) || dir.m_Items->Contains(url.Get()));
   }
-#ifdef _DEBUG
   m_cacheMisses++;
-#endif
   return false;
 }
 
 void CDirectoryCache::Clear()
 {
   // this routine clears everything
-  std::unique_lock lock(m_cs);
-  m_cache.clear();
+  {
+    std::unique_lock lock(m_cs);
+    m_cache.clear();
+  }
+  // keep the stored listings, but revalidate them on next use
+  if (isPersistent())
+    m_persistent->Invalidate();
 }
 
 void CDirectoryCache::InitCache(const std::set<std::string>& dirs)
@@ -237,6 +403,10 @@ void CDirectoryCache::PrintStats() const
   std::unique_lock lock(m_cs);
   CLog::Log(LOGDEBUG, "{} - total of {} cache hits, and {} cache misses", __FUNCTION__, m_cacheHits,
             m_cacheMisses);
+  CLog::Log(LOGDEBUG,
+            "{} - persistent cache: {} hits, {} stale hits, {} misses, {} bytes on disk",
+            __FUNCTION__, m_persistentHits, m_persistentStaleHits, m_persistentMisses,
+            m_persistent->GetSize());
   // run through and find the oldest and the number of items cached
   unsigned int oldest = UINT_MAX;
   unsigned int numItems = 0;
@@ -11,6 +11,7 @@
 #include "IDirectory.h"
 #include "threads/CriticalSection.h"
 
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <set>
@@ -20,6 +21,8 @@ class CURL;
 
 namespace XFILE
 {
+  class CPersistentDirectoryCache;
+
   class CDirectoryCache
   {
     class CDir
@@ -42,10 +45,33 @@ namespace XFILE
       unsigned int m_lastAccess;
     };
   public:
+    struct Stats
+    {
+      unsigned int hits{0};
+      unsigned int misses{0};
+      unsigned int persistentHits{0}; ///< fresh listings read from disk
+      unsigned int persistentStaleHits{0}; ///< stale listings read from disk and revalidated
+      unsigned int persistentMisses{0};
+    };
+
     CDirectoryCache(void);
     virtual ~CDirectoryCache(void);
     bool GetDirectory(const CURL& url, CFileItemList& items, bool retrieveAll = false);
     void SetDirectory(const CURL& url, const CFileItemList& items, CacheType cacheType);
+
+    /*! \brief Get a listing stored on disk by this or an earlier session.
+     Only listings of protocols with a time to live in advancedsettings.xml are stored.
+     \param url the directory to get the listing of.
+     \param items [out] the listing.
+     \param revalidate [out] true if the listing is older than the time to live and the caller
+     should list the directory again (and store the result with SetPersistentDirectory()).
+     \return true if a listing was found, false otherwise.
+     \sa DIR_FLAG_PERSISTENT_CACHE
+     */
+    bool GetPersistentDirectory(const CURL& url, CFileItemList& items, bool& revalidate);
+    void SetPersistentDirectory(const CURL& url, const CFileItemList& items);
+
+    Stats GetStats() const;
     void ClearDirectory(const CURL& url);
     void ClearFile(const CURL& url);
     void ClearSubPaths(const CURL& url);
@@ -59,6 +85,7 @@ namespace XFILE
     void InitCache(const std::set<std::string>& dirs);
     void ClearCache(std::set<std::string>& dirs);
     void CheckIfFull();
+    int64_t GetPersistentTimeToLive(const CURL& url) const;
 
     struct StringHash
     {
@@ -76,10 +103,14 @@ namespace XFILE
 
     unsigned int m_accessCounter;
 
-#ifdef _DEBUG
     unsigned int m_cacheHits;
     unsigned int m_cacheMisses;
-#endif
+    unsigned int m_persistentHits{0};
+    unsigned int m_persistentStaleHits{0};
+    unsigned int m_persistentMisses{0};
+
+    // has its own lock, never call it with m_cs held
+    std::unique_ptr<CPersistentDirectoryCache> m_persistent;
   };
 }
 extern XFILE::CDirectoryCache g_directoryCache;
@@ -12,9 +12,13 @@
 #include "URL.h"
 #include "guilib/GUIKeyboardFactory.h"
 #include "messaging/helpers/DialogOKHelper.h"
+#include "threads/CriticalSection.h"
 #include "utils/StringUtils.h"
 #include "utils/URIUtils.h"
 
+#include <mutex>
+#include <utility>
+
 using namespace KODI::MESSAGING;
 using namespace XFILE;
 
@@ -116,6 +120,28 @@ void IDirectory::SetFlags(int flags)
   m_flags = flags;
 }
 
+void IDirectory::SetPartialItemsCallback(PartialItemsCallback callback)
+{
+  std::unique_lock lock(m_partialItemsSection);
+  m_partialItemsCallback = std::move(callback);
+}
+
+bool IDirectory::ReportItems(std::span<const std::shared_ptr<CFileItem>> items) const
+{
+  if (items.empty())
+    return true;
+
+  // the callback may be replaced while it is running so call a copy of it outside of the lock
+  PartialItemsCallback callback;
+  {
+    std::unique_lock lock(m_partialItemsSection);
+    callback = m_partialItemsCallback;
+  }
+  if (!callback)
+    return true;
+  return callback(items);
+}
+
 bool IDirectory::ProcessRequirements()
 {
   std::string type = m_requirements["type"].asString();
@@ -8,8 +8,12 @@
 
 #pragma once
 
+#include "threads/CriticalSection.h"
 #include "utils/Variant.h"
 
+#include <functional>
+#include <memory>
+#include <span>
 #include <string>
 
 class CFileItemList;
@@ -45,7 +49,9 @@ enum DIR_FLAG
   DIR_FLAG_GET_HIDDEN = (2 << 3), ///< Get hidden files
   DIR_FLAG_READ_CACHE = (2 << 4), ///< Force reading from the directory cache (if available)
   DIR_FLAG_BYPASS_CACHE =
-      (2 << 5) ///< Completely bypass the directory cache (no reading, no writing)
+      (2 << 5), ///< Completely bypass the directory cache (no reading, no writing)
+  DIR_FLAG_PERSISTENT_CACHE =
+      (2 << 6) ///< Use listings kept on disk across restarts, possibly stale (for browsing only)
 };
 /*!
  \ingroup filesystem
@@ -63,6 +69,15 @@ public:
 
   IDirectory();
   virtual ~IDirectory(void);
+
+  /*!
+   \brief Receives items of a listing while GetDirectory is still reading it.
+   \return false to ask the directory to stop reading, true otherwise.
+   \sa SetPartialItemsCallback
+   */
+  using PartialItemsCallback =
+      std::function<bool(std::span<const std::shared_ptr<CFileItem>> items)>;
+
   /*!
    \brief Get the \e items of the directory \e strPath.
    \param url Directory to read.
@@ -139,6 +154,15 @@ public:
   void SetMask(const std::string& strMask);
   void SetFlags(int flags);
 
+  /*!
+   \brief Set a callback receiving the items of a listing while it is being read.
+   Only directories reading their listing in several steps call it. The items passed to it are
+   still returned by GetDirectory, the callback only allows showing them earlier.
+   \param callback the callback, or an empty function to remove it.
+   \sa ReportItems
+   */
+  void SetPartialItemsCallback(PartialItemsCallback callback);
+
   /*! \brief Process additional requirements before the directory fetch is performed.
    Some directory fetches may require authentication, keyboard input etc.  The IDirectory subclass
    should call GetKeyboardInput, SetErrorDialog or RequireAuthentication and then return false
@@ -187,6 +211,15 @@ protected:
    */
   void RequireAuthentication(const CURL& url);
 
+  /*! \brief Pass items just added to a listing to the partial items callback.
+   Call this method from the GetDirectory method of directories that read their listing in
+   several steps, e.g. page by page.
+   \param items the items added since the last call.
+   \return false if GetDirectory should stop reading and return false, true otherwise.
+   \sa SetPartialItemsCallback
+   */
+  bool ReportItems(std::span<const std::shared_ptr<CFileItem>> items) const;
+
   static const CProfileManager *m_profileManager;
 
   std::string m_strFileMask;  ///< Holds the file mask specified by SetMask()
@@ -194,5 +227,9 @@ protected:
   int m_flags; ///< Directory flags - see DIR_FLAG
 
   CVariant m_requirements;
+
+private:
+  mutable CCriticalSection m_partialItemsSection;
+  PartialItemsCallback m_partialItemsCallback;
 };
 }
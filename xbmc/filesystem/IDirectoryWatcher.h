@@ -0,0 +1,49 @@
+/*
+ *  Copyright (C) 2026 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include <functional>
+#include <string>
+
+namespace XFILE
+{
+/*!
+ \brief Interface for watching local directory trees for changes.
+
+ Implementations report every directory whose entries changed (files created, deleted, renamed or
+ written) through the changed callback. A directory that was moved away is reported as a tree, as
+ nothing below its old path can be relied on any longer. If events may have been lost, e.g. because the kernel
+ event queue overflowed, the lost callback is called and nothing reported before can be relied on.
+ Both callbacks are called from the watcher's own thread.
+ */
+class IDirectoryWatcher
+{
+public:
+  /*! \brief Called with the path (with trailing slash) of a directory whose entries changed.
+   \p tree is set if all directories below it changed as well.
+   */
+  using ChangedCallback = std::function<void(const std::string& directory, bool tree)>;
+  /*! \brief Called when change events have been lost. */
+  using LostCallback = std::function<void()>;
+
+  virtual ~IDirectoryWatcher() = default;
+
+  /*! \brief Watch a local directory and all directories below it.
+   \param path the native path of the directory, with trailing slash.
+   \return true if the whole tree is watched, false otherwise.
+   */
+  virtual bool Watch(const std::string& path) = 0;
+
+  /*! \brief Check whether changes in the given directory are reported.
+   \param directory the native path of the directory, with trailing slash.
+   \return true if the directory itself is watched, false otherwise.
+   */
+  virtual bool IsWatched(const std::string& directory) const = 0;
+};
+} // namespace XFILE
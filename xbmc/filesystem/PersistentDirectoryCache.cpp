@@ -0,0 +1,319 @@
+/*
+ *  Copyright (C) 2026 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "PersistentDirectoryCache.h"
+
+#include "Directory.h"
+#include "File.h"
+#include "FileItem.h"
+#include "FileItemList.h"
+#include "URL.h"
+#include "utils/Archive.h"
+#include "utils/Crc32.h"
+#include "utils/StringUtils.h"
+#include "utils/URIUtils.h"
+#include "utils/log.h"
+
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+
+using namespace XFILE;
+
+namespace
+{
+constexpr int CACHE_VERSION = 1;
+constexpr const char* CACHE_EXTENSION = ".fi";
+constexpr const char* INVALIDATION_FILE = "invalidated";
+
+int64_t Now()
+{
+  return std::chrono::duration_cast<std::chrono::seconds>(
+             std::chrono::system_clock::now().time_since_epoch())
+      .count();
+}
+} // unnamed namespace
+
+CPersistentDirectoryCache::CPersistentDirectoryCache(std::string folder)
+  : m_folder(std::move(folder))
+{
+}
+
+bool CPersistentDirectoryCache::Get(const std::string& key,
+                                    CFileItemList& items,
+                                    int64_t& storedTime)
+{
+  std::unique_lock lock(m_section);
+  if (!m_loaded)
+    LoadIndex();
+
+  const auto it = m_entries.find(key);
+  if (it == m_entries.end())
+    return false;
+
+  CFile file;
+  if (!file.Open(m_folder + it->second.file))
+  {
+    RemoveEntry(it);
+    return false;
+  }
+
+  try
+  {
+    CArchive ar(&file, CArchive::load);
+    int version = 0;
+    std::string storedKey;
+    int64_t time = 0;
+    ar >> version;
+    ar >> storedKey;
+    ar >> time;
+    // another key with the same hash may have replaced the file
+    if (version != CACHE_VERSION || storedKey != key)
+    {
+      ar.Close();
+      file.Close();
+      m_size -= it->second.size;
+      m_entries.erase(it);
+      return false;
+    }
+    ar >> items;
+    ar.Close();
+  }
+  catch (const std::out_of_range&)
+  {
+    CLog::Log(LOGERROR, "CPersistentDirectoryCache: corrupt listing for {}",
+              CURL::GetRedacted(key));
+    file.Close();
+    RemoveEntry(it);
+    return false;
+  }
+
+  storedTime = it->second.storedTime;
+  it->second.lastUse = ++m_useCounter;
+  return true;
+}
+
+void CPersistentDirectoryCache::Set(const std::string& key, CFileItemList& items, uint64_t maxSize)
+{
+  std::unique_lock lock(m_section);
+  if (!m_loaded)
+    LoadIndex();
+
+  if (const auto it = m_entries.find(key); it != m_entries.end())
+    RemoveEntry(it);
+
+  Entry entry;
+  entry.file = StringUtils::Format("{:08x}{}", Crc32::Compute(key), CACHE_EXTENSION);
+  // listings stored in the second of an invalidation must not look stale after a restart
+  entry.storedTime = std::max(Now(), m_invalidatedTime + 1);
+  entry.lastUse = ++m_useCounter;
+
+  // a listing with the same hash is replaced
+  std::erase_if(m_entries,
+                [this, &entry](const auto& e)
+                {
+                  if (e.second.file != entry.file)
+                    return false;
+                  m_size -= e.second.size;
+                  return true;
+                });
+
+  const std::string path = m_folder + entry.file;
+  CFile file;
+  if (!file.OpenForWrite(path, true))
+  {
+    CLog::Log(LOGDEBUG, "CPersistentDirectoryCache: unable to write {}", path);
+    return;
+  }
+
+  CArchive ar(&file, CArchive::store);
+  ar << CACHE_VERSION;
+  ar << key;
+  ar << entry.storedTime;
+  ar << items;
+  ar.Close();
+  entry.size = static_cast<uint64_t>(std::max<int64_t>(file.GetLength(), 0));
+  file.Close();
+
+  m_size += entry.size;
+  m_entries.insert_or_assign(key, std::move(entry));
+  Trim(maxSize);
+}
+
+bool CPersistentDirectoryCache::StartRevalidation(const std::string& key,
+                                                  int64_t now,
+                                                  int64_t interval)
+{
+  std::unique_lock lock(m_section);
+  const auto it = m_entries.find(key);
+  if (it == m_entries.end() || now - it->second.revalidationTime < interval)
+    return false;
+
+  it->second.revalidationTime = now;
+  return true;
+}
+
+void CPersistentDirectoryCache::Remove(const std::string& key)
+{
+  std::unique_lock lock(m_section);
+  if (!m_loaded)
+    LoadIndex();
+
+  if (const auto it = m_entries.find(key); it != m_entries.end())
+    RemoveEntry(it);
+}
+
+void CPersistentDirectoryCache::RemoveSubPaths(const std::string& key)
+{
+  std::unique_lock lock(m_section);
+  if (!m_loaded)
+    LoadIndex();
+
+  for (auto it = m_entries.begin(); it != m_entries.end();)
+  {
+    const auto current = it++;
+    if (URIUtils::PathHasParent(current->first, key))
+      RemoveEntry(current);
+  }
+}
+
+void CPersistentDirectoryCache::Invalidate()
+{
+  std::unique_lock lock(m_section);
+  if (!m_loaded)
+    LoadIndex();
+
+  for (auto& [key, entry] : m_entries)
+    entry.storedTime = 0;
+
+  m_invalidatedTime = Now();
+  const std::string path = m_folder + INVALIDATION_FILE;
+  CFile file;
+  if (!file.OpenForWrite(path, true))
+  {
+    CLog::Log(LOGDEBUG, "CPersistentDirectoryCache: unable to write {}", path);
+    return;
+  }
+
+  CArchive ar(&file, CArchive::store);
+  ar << CACHE_VERSION;
+  ar << m_invalidatedTime;
+  ar.Close();
+  file.Close();
+}
+
+uint64_t CPersistentDirectoryCache::GetSize() const
+{
+  std::unique_lock lock(m_section);
+  return m_size;
+}
+
+void CPersistentDirectoryCache::LoadIndex()
+{
+  m_loaded = true;
+
+  CFileItemList files;
+  if (!CDirectory::GetDirectory(m_folder, files, CACHE_EXTENSION,
+                                DIR_FLAG_BYPASS_CACHE | DIR_FLAG_NO_FILE_DIRS))
+  {
+    CDirectory::Create(m_folder);
+    return;
+  }
+
+  LoadInvalidationTime();
+
+  for (const auto& item : files)
+  {
+    if (item->IsFolder())
+      continue;
+
+    const std::string name = URIUtils::GetFileName(item->GetPath());
+    CFile file;
+    if (!file.Open(item->GetPath()))
+      continue;
+
+    try
+    {
+      CArchive ar(&file, CArchive::load);
+      int version = 0;
+      std::string key;
+      Entry entry;
+      ar >> version;
+      ar >> key;
+      ar >> entry.storedTime;
+      ar.Close();
+      file.Close();
+      if (version == CACHE_VERSION && !key.empty())
+      {
+        if (entry.storedTime <= m_invalidatedTime)
+          entry.storedTime = 0;
+        entry.file = name;
+        entry.size = static_cast<uint64_t>(item->GetSize());
+        m_size += entry.size;
+        m_entries.insert_or_assign(key, std::move(entry));
+        continue;
+      }
+    }
+    catch (const std::out_of_range&)
+    {
+      file.Close();
+    }
+    CFile::Delete(item->GetPath());
+  }
+
+  CLog::Log(LOGDEBUG, "CPersistentDirectoryCache: {} listings, {} bytes", m_entries.size(),
+            m_size);
+}
+
+void CPersistentDirectoryCache::LoadInvalidationTime()
+{
+  const std::string path = m_folder + INVALIDATION_FILE;
+  CFile file;
+  if (!file.Open(path))
+    return;
+
+  try
+  {
+    CArchive ar(&file, CArchive::load);
+    int version = 0;
+    int64_t time = 0;
+    ar >> version;
+    ar >> time;
+    ar.Close();
+    if (version == CACHE_VERSION)
+      m_invalidatedTime = time;
+  }
+  catch (const std::out_of_range&)
+  {
+    CLog::Log(LOGERROR, "CPersistentDirectoryCache: corrupt {}", path);
+  }
+  file.Close();
+}
+
+void CPersistentDirectoryCache::RemoveEntry(std::map<std::string, Entry, std::less<>>::iterator it)
+{
+  CFile::Delete(m_folder + it->second.file);
+  m_size -= it->second.size;
+  m_entries.erase(it);
+}
+
+void CPersistentDirectoryCache::Trim(uint64_t maxSize)
+{
+  while (m_size > maxSize && !m_entries.empty())
+  {
+    auto oldest = m_entries.begin();
+    for (auto it = m_entries.begin(); it != m_entries.end(); ++it)
+    {
+      if (it->second.lastUse < oldest->second.lastUse)
+        oldest = it;
+    }
+    RemoveEntry(oldest);
+  }
+}
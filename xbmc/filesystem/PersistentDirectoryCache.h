@@ -0,0 +1,104 @@
+/*
+ *  Copyright (C) 2026 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "threads/CriticalSection.h"
+
+#include <cstdint>
+#include <map>
+#include <string>
+
+class CFileItemList;
+
+namespace XFILE
+{
+/*!
+ \brief Directory listings stored on disk, so they survive a restart.
+
+ Every listing is archived to its own file in the cache folder, together with the key it was
+ stored under and the time it was stored. The index of the stored listings is built from the
+ files on first use. When the cache grows beyond its size limit the least recently used listings
+ are removed.
+
+ This class only stores listings, deciding whether a listing is still fresh is up to the caller.
+ \sa CDirectoryCache::GetPersistentDirectory
+ */
+class CPersistentDirectoryCache
+{
+public:
+  /*!
+   \param folder the folder to store the listings in, with trailing slash.
+   */
+  explicit CPersistentDirectoryCache(std::string folder);
+
+  /*!
+   \brief Get a stored listing.
+   \param key the key the listing was stored under.
+   \param items [out] the listing.
+   \param storedTime [out] when the listing was stored, in seconds since the epoch. 0 if the
+   listing has been invalidated.
+   \return true if a listing was found, false otherwise.
+   */
+  bool Get(const std::string& key, CFileItemList& items, int64_t& storedTime);
+
+  /*!
+   \brief Store a listing, replacing a previous one with the same key.
+   \param key the key to store the listing under.
+   \param items the listing.
+   \param maxSize the maximum size of the cache in bytes.
+   */
+  void Set(const std::string& key, CFileItemList& items, uint64_t maxSize);
+
+  /*!
+   \brief Remember that a stale listing is being revalidated.
+   \param key the key of the listing.
+   \param now the current time in seconds since the epoch.
+   \param interval the minimum time between two revalidations in seconds.
+   \return true if the caller should revalidate the listing, false if that was already started
+   less than interval seconds ago.
+   */
+  bool StartRevalidation(const std::string& key, int64_t now, int64_t interval);
+
+  void Remove(const std::string& key);
+  void RemoveSubPaths(const std::string& key);
+
+  /*!
+   \brief Mark all listings as stale without removing them.
+   The time of the invalidation is stored in the cache folder, so listings stored before it are
+   still stale after a restart.
+   */
+  void Invalidate();
+
+  uint64_t GetSize() const;
+
+private:
+  struct Entry
+  {
+    std::string file;
+    uint64_t size{0};
+    int64_t storedTime{0};
+    int64_t revalidationTime{0};
+    uint64_t lastUse{0};
+  };
+
+  void LoadIndex();
+  void LoadInvalidationTime();
+  void RemoveEntry(std::map<std::string, Entry, std::less<>>::iterator it);
+  void Trim(uint64_t maxSize);
+
+  const std::string m_folder;
+  mutable CCriticalSection m_section;
+  std::map<std::string, Entry, std::less<>> m_entries;
+  uint64_t m_size{0};
+  uint64_t m_useCounter{0};
+  //! when all listings were last invalidated, in seconds since the epoch
+  int64_t m_invalidatedTime{0};
+  bool m_loaded{false};
+};
+} // namespace XFILE
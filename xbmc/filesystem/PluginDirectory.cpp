@@ -27,6 +27,7 @@
 #include "video/VideoInfoTag.h"
 
 #include <mutex>
+#include <span>
 
 using namespace XFILE;
 using namespace ADDON;
@@ -175,7 +176,7 @@ bool CPluginDirectory::AddItem(int handle, const CFileItem *item, int totalItems
   dir->m_listItems->Add(pItem);
   dir->m_totalItems = totalItems;
 
-  return !dir->m_cancelled;
+  return dir->ReportItems({&pItem, 1}) && !dir->m_cancelled;
 }
 
 bool CPluginDirectory::AddItems(int handle, const CFileItemList *items, int totalItems)
@@ -190,7 +191,8 @@ bool CPluginDirectory::AddItems(int handle, const CFileItemList *items, int tota
   dir->m_listItems->Append(pItemList);
   dir->m_totalItems = totalItems;
 
-  return !dir->m_cancelled;
+  return dir->ReportItems(std::span<const CFileItemPtr>(pItemList.cbegin(), pItemList.cend())) &&
+         !dir->m_cancelled;
 }
 
 void CPluginDirectory::EndOfDirectory(int handle, bool success, bool replaceListing, bool cacheToDisc)
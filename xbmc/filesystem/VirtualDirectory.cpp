@@ -88,6 +88,24 @@ bool CVirtualDirectory::GetDirectory(const CURL& url, CFileItemList &items, bool
   return dir.GetDirectory(shares, items);
 }
 
+std::shared_ptr<CDirectory::CAsyncListing> CVirtualDirectory::GetDirectoryAsync(
+    const CURL& url, bool bUseFileDirectories)
+{
+  const std::string strPath = url.Get();
+  if (strPath.empty() || strPath == "files://")
+    return {};
+
+  CDirectory::CHints hints;
+  hints.mask = m_strFileMask;
+  hints.flags = m_flags;
+  if (!bUseFileDirectories)
+    hints.flags |= DIR_FLAG_NO_FILE_DIRS;
+
+  if (!m_pDir)
+    m_pDir.reset(CDirectoryFactory::Create(URIUtils::SubstitutePath(url)));
+  return CDirectory::GetDirectoryAsync(url, m_pDir, hints);
+}
+
 void CVirtualDirectory::CancelDirectory()
 {
   if (m_pDir)
@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include "Directory.h"
 #include "IDirectory.h"
 #include "MediaSource.h"
 #include "threads/IRunnable.h"
@@ -30,6 +31,16 @@ namespace XFILE
     bool GetDirectory(const CURL& url, CFileItemList &items) override;
     void CancelDirectory() override;
     bool GetDirectory(const CURL& url, CFileItemList &items, bool bUseFileDirectories, bool keepImpl);
+
+    /*!
+     \brief Read the content of a directory in the background.
+     The directory implementation is kept until ReleaseDirImpl() is called.
+     \return the running listing, or an empty pointer for the source listing, which has to be read
+     with GetDirectory.
+     \sa CDirectory::GetDirectoryAsync
+     */
+    std::shared_ptr<CDirectory::CAsyncListing> GetDirectoryAsync(const CURL& url,
+                                                                 bool bUseFileDirectories);
     void SetSources(const std::vector<CMediaSource>& sources);
     inline unsigned int GetNumberOfSources() { return static_cast<uint32_t>(m_sources.size()); }
 
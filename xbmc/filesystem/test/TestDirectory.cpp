@@ -8,16 +8,68 @@
 
 #include "FileItem.h"
 #include "FileItemList.h"
+#include "URL.h"
 #include "filesystem/Directory.h"
 #include "filesystem/DirectoryFactory.h"
 #include "filesystem/IDirectory.h"
 #include "filesystem/SpecialProtocol.h"
 #include "test/TestUtils.h"
+#include "threads/Event.h"
 #include "utils/URIUtils.h"
 #include "video/VideoInfoTag.h"
 
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
 #include <gtest/gtest.h>
 
+using namespace std::chrono_literals;
+
+namespace
+{
+// reads its listing in batches, waiting for Continue() between them
+class CBatchedDirectory : public XFILE::IDirectory
+{
+public:
+  explicit CBatchedDirectory(bool waitForContinue) : m_waitForContinue(waitForContinue) {}
+
+  bool GetDirectory(const CURL& url, CFileItemList& items) override
+  {
+    const std::vector<std::vector<std::string>> batches{{"a.mkv", "b.mkv"},
+                                                        {".hidden.mkv", "c.txt", "d.mkv"}};
+    for (const auto& batch : batches)
+    {
+      std::vector<CFileItemPtr> added;
+      for (const auto& name : batch)
+      {
+        auto item = std::make_shared<CFileItem>(name);
+        item->SetPath(url.Get() + name);
+        item->SetFolder(false);
+        if (name.starts_with('.'))
+          item->SetProperty("file:hidden", true);
+        added.emplace_back(item);
+        items.Add(item);
+      }
+      if (!ReportItems(added))
+        return false;
+      // there is nothing to wait for after the last batch
+      if (m_waitForContinue && &batch != &batches.back() && !m_continue.Wait(5s))
+        return false;
+    }
+    return true;
+  }
+
+  void CancelDirectory() override { m_continue.Set(); }
+  void Continue() { m_continue.Set(); }
+
+private:
+  const bool m_waitForContinue;
+  CEvent m_continue;
+};
+} // unnamed namespace
+
 TEST(TestDirectory, General)
 {
   std::string tmppath1, tmppath2, tmppath3;
@@ -58,6 +110,57 @@ TEST(TestDirectory, CreateRecursive)
   EXPECT_TRUE(XFILE::CDirectory::RemoveRecursive(path1));
 }
 
+TEST(TestDirectory, GetDirectoryAsync)
+{
+  XFILE::CDirectory::CHints hints;
+  hints.mask = ".mkv";
+  hints.flags = XFILE::DIR_FLAG_NO_FILE_DIRS | XFILE::DIR_FLAG_BYPASS_CACHE;
+  auto directory = std::make_shared<CBatchedDirectory>(true);
+  auto listing =
+      XFILE::CDirectory::GetDirectoryAsync(CURL("test://async/"), directory, hints);
+
+  // the first batch arrives before the listing is done
+  std::vector<CFileItemPtr> items;
+  for (int i = 0; i < 500 && items.empty(); ++i)
+  {
+    items = listing->TakeItems();
+    if (items.empty())
+      std::this_thread::sleep_for(10ms);
+  }
+  ASSERT_EQ(2u, items.size());
+  EXPECT_EQ("test://async/a.mkv", items[0]->GetPath());
+  EXPECT_FALSE(listing->IsDone());
+
+  directory->Continue();
+  ASSERT_TRUE(listing->GetDoneEvent().Wait(5s));
+
+  // hidden files and files not matching the mask are left out
+  items = listing->TakeItems();
+  ASSERT_EQ(1u, items.size());
+  EXPECT_EQ("test://async/d.mkv", items[0]->GetPath());
+
+  CFileItemList result;
+  EXPECT_TRUE(listing->GetResult(result));
+  EXPECT_EQ(3, result.Size());
+}
+
+TEST(TestDirectory, GetDirectoryAsyncCancel)
+{
+  XFILE::CDirectory::CHints hints;
+  hints.flags = XFILE::DIR_FLAG_NO_FILE_DIRS | XFILE::DIR_FLAG_BYPASS_CACHE;
+  auto directory = std::make_shared<CBatchedDirectory>(true);
+  auto listing =
+      XFILE::CDirectory::GetDirectoryAsync(CURL("test://cancel/"), directory, hints);
+
+  listing->Cancel();
+  ASSERT_TRUE(listing->GetDoneEvent().Wait(5s));
+  EXPECT_TRUE(listing->IsCancelled());
+
+  CFileItemList result;
+  EXPECT_FALSE(listing->GetResult(result));
+  EXPECT_TRUE(listing->TakeItems().empty());
+}
+
 #ifdef HAVE_LIBBLURAY
 TEST(TestDirectory, BlurayResolve)
 {
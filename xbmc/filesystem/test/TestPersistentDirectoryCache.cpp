@@ -0,0 +1,145 @@
+/*
+ *  Copyright (C) 2026 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "FileItem.h"
+#include "FileItemList.h"
+#include "filesystem/Directory.h"
+#include "filesystem/PersistentDirectoryCache.h"
+#include "filesystem/SpecialProtocol.h"
+#include "utils/URIUtils.h"
+
+#include <memory>
+#include <string>
+
+#include <gtest/gtest.h>
+
+using namespace XFILE;
+
+class TestPersistentDirectoryCache : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    m_folder = URIUtils::AddFileToFolder(CSpecialProtocol::TranslatePath("special://temp/"),
+                                         "TestPersistentDirectoryCache/");
+    CDirectory::RemoveRecursive(m_folder);
+    ASSERT_TRUE(CDirectory::Create(m_folder));
+  }
+
+  void TearDown() override { CDirectory::RemoveRecursive(m_folder); }
+
+  static void Fill(CFileItemList& items, int count)
+  {
+    for (int i = 0; i < count; ++i)
+      items.Add(std::make_shared<CFileItem>("smb://server/share/file" + std::to_string(i) + ".mkv",
+                                            false));
+  }
+
+  std::string m_folder;
+};
+
+TEST_F(TestPersistentDirectoryCache, SetAndGet)
+{
+  CFileItemList items;
+  Fill(items, 3);
+
+  {
+    CPersistentDirectoryCache cache(m_folder);
+    cache.Set("smb://server/share", items, 1024 * 1024);
+    EXPECT_GT(cache.GetSize(), 0u);
+  }
+
+  // a new instance finds the listing on disk
+  CPersistentDirectoryCache cache(m_folder);
+  CFileItemList stored;
+  int64_t storedTime = 0;
+  ASSERT_TRUE(cache.Get("smb://server/share", stored, storedTime));
+  EXPECT_GT(storedTime, 0);
+  ASSERT_EQ(3, stored.Size());
+  EXPECT_EQ("smb://server/share/file1.mkv", stored[1]->GetPath());
+
+  EXPECT_FALSE(cache.Get("smb://server/other", stored, storedTime));
+}
+
+TEST_F(TestPersistentDirectoryCache, RemoveAndInvalidate)
+{
+  CPersistentDirectoryCache cache(m_folder);
+  CFileItemList items;
+  Fill(items, 1);
+  cache.Set("smb://server/share", items, 1024 * 1024);
+  cache.Set("smb://server/share/sub", items, 1024 * 1024);
+  cache.Set("smb://server/other", items, 1024 * 1024);
+
+  CFileItemList stored;
+  int64_t storedTime = 0;
+  cache.Invalidate();
+  ASSERT_TRUE(cache.Get("smb://server/other", stored, storedTime));
+  EXPECT_EQ(0, storedTime);
+
+  cache.RemoveSubPaths("smb://server/share");
+  EXPECT_FALSE(cache.Get("smb://server/share/sub", stored, storedTime));
+
+  cache.Remove("smb://server/other");
+  EXPECT_FALSE(cache.Get("smb://server/other", stored, storedTime));
+  EXPECT_TRUE(cache.Get("smb://server/share", stored, storedTime));
+}
+
+TEST_F(TestPersistentDirectoryCache, InvalidateSurvivesRestart)
+{
+  CFileItemList items;
+  Fill(items, 1);
+
+  {
+    CPersistentDirectoryCache cache(m_folder);
+    cache.Set("smb://server/share", items, 1024 * 1024);
+    cache.Invalidate();
+    cache.Set("smb://server/other", items, 1024 * 1024);
+  }
+
+  // a new instance still knows which listings were stored before the invalidation
+  CPersistentDirectoryCache cache(m_folder);
+  CFileItemList stored;
+  int64_t storedTime = -1;
+  ASSERT_TRUE(cache.Get("smb://server/share", stored, storedTime));
+  EXPECT_EQ(0, storedTime);
+  ASSERT_TRUE(cache.Get("smb://server/other", stored, storedTime));
+  EXPECT_GT(storedTime, 0);
+}
+
+TEST_F(TestPersistentDirectoryCache, Revalidation)
+{
+  CPersistentDirectoryCache cache(m_folder);
+  CFileItemList items;
+  Fill(items, 1);
+  cache.Set("smb://server/share", items, 1024 * 1024);
+
+  EXPECT_TRUE(cache.StartRevalidation("smb://server/share", 1000, 300));
+  EXPECT_FALSE(cache.StartRevalidation("smb://server/share", 1100, 300));
+  EXPECT_TRUE(cache.StartRevalidation("smb://server/share", 1300, 300));
+  EXPECT_FALSE(cache.StartRevalidation("smb://server/unknown", 1300, 300));
+}
+
+TEST_F(TestPersistentDirectoryCache, SizeLimit)
+{
+  CPersistentDirectoryCache cache(m_folder);
+  CFileItemList items;
+  Fill(items, 100);
+  cache.Set("smb://server/a", items, 1024 * 1024);
+  const uint64_t size = cache.GetSize();
+
+  // keeps the most recently used listings within the limit
+  CFileItemList stored;
+  int64_t storedTime = 0;
+  cache.Set("smb://server/b", items, 1024 * 1024);
+  ASSERT_TRUE(cache.Get("smb://server/a", stored, storedTime));
+  cache.Set("smb://server/c", items, size * 2);
+  EXPECT_LE(cache.GetSize(), size * 2);
+  EXPECT_TRUE(cache.Get("smb://server/a", stored, storedTime));
+  EXPECT_FALSE(cache.Get("smb://server/b", stored, storedTime));
+  EXPECT_TRUE(cache.Get("smb://server/c", stored, storedTime));
+}
@@ -201,7 +201,7 @@ CGUIListItem& CGUIListItem::operator =(const CGUIListItem& item)
   m_bSelected = item.m_bSelected;
   m_overlayIcon = item.m_overlayIcon;
   m_bIsFolder = item.m_bIsFolder;
-  m_mapProperties = item.m_mapProperties;
+  SetProperties(item.GetProperties());
   m_art = item.m_art;
   m_artFallbacks = item.m_artFallbacks;
   m_currentItem = item.m_currentItem;
@@ -219,8 +219,9 @@ void CGUIListItem::Archive(CArchive &ar)
     ar << m_sortLabel;
     ar << m_bSelected;
     ar << m_overlayIcon;
-    ar << static_cast<int>(m_mapProperties.size());
-    for (const auto& [name, value] : m_mapProperties)
+    const PropertyMap& properties = GetProperties();
+    ar << static_cast<int>(properties.size());
+    for (const auto& [name, value] : properties)
     {
       ar << name;
       ar << value;
@@ -291,7 +292,7 @@ void CGUIListItem::Serialize(CVariant& value) const
   value["sortLabel"] = m_sortLabel;
   value["selected"] = m_bSelected;
 
-  for (const auto& [propname, propvalue] : m_mapProperties)
+  for (const auto& [propname, propvalue] : GetProperties())
     value["properties"][propname] = propvalue;
 
   for (const auto& [type, url] : m_art)
@@ -352,10 +353,13 @@ void CGUIListItem::SetInvalid()
 
 void CGUIListItem::SetProperty(const std::string &strKey, const CVariant &value)
 {
-  const auto iter = m_mapProperties.find(strKey);
-  if (iter == m_mapProperties.end())
+  if (!m_mapProperties)
+    m_mapProperties = std::make_unique<PropertyMap>();
+
+  const auto iter = m_mapProperties->find(strKey);
+  if (iter == m_mapProperties->end())
   {
-    m_mapProperties.try_emplace(strKey, value);
+    m_mapProperties->try_emplace(strKey, value);
     SetInvalid();
   }
   else if (iter->second != value)
@@ -369,33 +373,44 @@ const CVariant &CGUIListItem::GetProperty(const std::string &strKey) const
 {
   static CVariant nullVariant{CVariant::VariantTypeNull};
 
-  const auto iter = m_mapProperties.find(strKey);
-  if (iter == m_mapProperties.end())
+  if (!m_mapProperties)
+    return nullVariant;
+
+  const auto iter = m_mapProperties->find(strKey);
+  if (iter == m_mapProperties->end())
     return nullVariant;
 
   return iter->second;
 }
 
+bool CGUIListItem::HasProperties() const
+{
+  return m_mapProperties && !m_mapProperties->empty();
+}
+
 bool CGUIListItem::HasProperty(const std::string &strKey) const
 {
-  return m_mapProperties.contains(strKey);
+  return m_mapProperties && m_mapProperties->contains(strKey);
 }
 
 void CGUIListItem::ClearProperty(const std::string &strKey)
 {
-  const auto iter = m_mapProperties.find(strKey);
-  if (iter != m_mapProperties.end())
+  if (!m_mapProperties)
+    return;
+
+  const auto iter = m_mapProperties->find(strKey);
+  if (iter != m_mapProperties->end())
   {
-    m_mapProperties.erase(iter);
+    m_mapProperties->erase(iter);
     SetInvalid();
   }
 }
 
 void CGUIListItem::ClearProperties()
 {
-  if (!m_mapProperties.empty())
+  if (HasProperties())
   {
-    m_mapProperties.clear();
+    m_mapProperties.reset();
     SetInvalid();
   }
 }
@@ -423,13 +438,25 @@ void CGUIListItem::IncrementProperty(const std::string &strKey, double dVal)
 
 void CGUIListItem::AppendProperties(const CGUIListItem &item)
 {
-  for (const auto& [propname, propvalue] : item.m_mapProperties)
+  for (const auto& [propname, propvalue] : item.GetProperties())
     SetProperty(propname, propvalue);
 }
 
+const CGUIListItem::PropertyMap& CGUIListItem::GetProperties() const
+{
+  static const PropertyMap emptyProperties;
+
+  return m_mapProperties ? *m_mapProperties : emptyProperties;
+}
+
 void CGUIListItem::SetProperties(const PropertyMap& props)
 {
-  m_mapProperties = props;
+  if (props.empty())
+    m_mapProperties.reset();
+  else if (m_mapProperties)
+    *m_mapProperties = props;
+  else
+    m_mapProperties = std::make_unique<PropertyMap>(props);
 }
 
 void CGUIListItem::SetCurrentItem(unsigned int position)
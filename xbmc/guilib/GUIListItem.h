@@ -158,7 +158,7 @@ public:
   void Serialize(CVariant& value) const;
 
   bool HasProperty(const std::string& strKey) const;
-  bool HasProperties() const { return !m_mapProperties.empty(); }
+  bool HasProperties() const;
   void ClearProperty(const std::string& strKey);
 
   const CVariant &GetProperty(const std::string &strKey) const;
@@ -170,7 +170,7 @@ public:
   };
 
   using PropertyMap = std::map<std::string, CVariant, CaseInsensitiveCompare>;
-  const PropertyMap& GetProperties() const { return m_mapProperties; }
+  const PropertyMap& GetProperties() const;
 
   void SetProperties(const PropertyMap& props);
 
@@ -199,7 +199,7 @@ private:
   bool m_bSelected{false}; // item is selected or not
   unsigned int m_currentItem{1}; // current item number within container (starting at 1)
 
-  PropertyMap m_mapProperties;
+  std::unique_ptr<PropertyMap> m_mapProperties; // allocated with the first property
 
   KODI::ART::Artwork m_art;
   KODI::ART::Artwork m_artFallbacks;
@@ -41,6 +41,7 @@
 #include <map>
 #include <memory>
 #include <string.h>
+#include <utility>
 
 using namespace MUSIC_INFO;
 using namespace JSONRPC;
@@ -498,9 +499,9 @@ void CFileItemHandler::HandleFileItem(const char* ID,
   if (resultname)
   {
     if (append)
-      result[resultname].append(object);
+      result[resultname].append(std::move(object));
     else
-      result[resultname] = object;
+      result[resultname] = std::move(object);
   }
 }
 
@@ -24,18 +24,31 @@
 #include "input/WindowTranslator.h"
 #include "input/actions/ActionTranslator.h"
 #include "interfaces/AnnouncementManager.h"
+#include "jobs/JobManager.h"
 #include "playlists/SmartPlayList.h"
 #include "settings/AdvancedSettings.h"
 #include "settings/SettingsComponent.h"
+#include "threads/Event.h"
 #include "utils/StringUtils.h"
 #include "utils/Variant.h"
 #include "utils/log.h"
 
+#include <algorithm>
+#include <atomic>
+#include <memory>
 #include <string.h>
+#include <utility>
+#include <vector>
 
 using namespace KODI;
 using namespace JSONRPC;
 
+namespace
+{
+// maximum number of calls of a batch request executed at the same time
+constexpr size_t MAX_PARALLEL_CALLS = 4;
+} // unnamed namespace
+
 bool CJSONRPC::m_initialized = false;
 
 void CJSONRPC::Initialize()
@@ -257,18 +270,7 @@ std::string CJSONRPC::MethodCall(const std::string &inputString, ITransportLayer
         hasResponse = true;
       }
       else
-      {
-        for (CVariant::const_iterator_array itr = inputroot.begin_array();
-             itr != inputroot.end_array(); ++itr)
-        {
-          CVariant response;
-          if (HandleMethodCall(*itr, response, transport, client))
-          {
-            outputroot.append(response);
-            hasResponse = true;
-          }
-        }
-      }
+        hasResponse = HandleBatchCall(inputroot, outputroot, transport, client);
     }
     else
       hasResponse = HandleMethodCall(inputroot, outputroot, transport, client);
@@ -289,24 +291,73 @@ std::string CJSONRPC::MethodCall(const std::string &inputString, ITransportLayer
 
 bool CJSONRPC::HandleMethodCall(const CVariant& request, CVariant& response, ITransportLayer *transport, IClient *client)
 {
-  JSONRPC_STATUS errorCode = OK;
-  CVariant result;
-  bool isNotification = false;
+  CMethodCall call;
+  PrepareMethodCall(request, transport, client, call);
+  ExecuteMethodCall(call, transport, client);
 
-  if (IsProperJSONRPC(request))
+  BuildResponse(request, call.status, std::move(call.result), response);
+
+  return !call.isNotification;
+}
+
+bool CJSONRPC::HandleBatchCall(const CVariant& requests, CVariant& responses, ITransportLayer *transport, IClient *client)
+{
+  std::vector<CMethodCall> calls(requests.size());
+  size_t index = 0;
+  for (CVariant::const_iterator_array itr = requests.begin_array(); itr != requests.end_array();
+       ++itr, ++index)
+    PrepareMethodCall(*itr, transport, client, calls[index]);
+
+  // consecutive calls of methods which only read data are executed in parallel, every other call
+  // is executed after the calls before it have finished
+  for (size_t begin = 0; begin < calls.size();)
   {
-    isNotification = !request.isMember("id");
+    size_t end = begin + 1;
+    if (calls[begin].parallel)
+    {
+      while (end < calls.size() && calls[end].parallel)
+        ++end;
+    }
 
-    std::string methodName = request["method"].asString();
-    StringUtils::ToLower(methodName);
+    if (end - begin > 1)
+      ExecuteMethodCalls(calls, begin, end, transport, client);
+    else
+      ExecuteMethodCall(calls[begin], transport, client);
 
-    JSONRPC::MethodCall method;
-    CVariant params;
+    begin = end;
+  }
+
+  // the responses are in the order of the requests
+  bool hasResponse = false;
+  for (CMethodCall& call : calls)
+  {
+    if (call.isNotification)
+      continue;
+
+    CVariant response;
+    BuildResponse(*call.request, call.status, std::move(call.result), response);
+    responses.append(std::move(response));
+    hasResponse = true;
+  }
 
-    if ((errorCode = CJSONServiceDescription::CheckCall(methodName.c_str(), request["params"], transport, client, isNotification, method, params)) == OK)
-      errorCode = method(methodName, transport, client, params, result);
+  return hasResponse;
+}
+
+void CJSONRPC::PrepareMethodCall(const CVariant& request, ITransportLayer *transport, IClient *client, CMethodCall& call)
+{
+  call.request = &request;
+
+  if (IsProperJSONRPC(request))
+  {
+    call.isNotification = !request.isMember("id");
+
+    call.methodName = request["method"].asString();
+    StringUtils::ToLower(call.methodName);
+
+    if ((call.status = CJSONServiceDescription::CheckCall(call.methodName.c_str(), request["params"], transport, client, call.isNotification, call.method, call.params)) == OK)
+      call.parallel = CJSONServiceDescription::CanExecuteInParallel(call.methodName);
     else
-      result = params;
+      call.result = call.params;
   }
   else
   {
@@ -314,12 +365,51 @@ bool CJSONRPC::HandleMethodCall(const CVariant& request, CVariant& response, ITr
     CJSONVariantWriter::Write(request, str, true);
 
     CLog::Log(LOGERROR, "JSONRPC: Failed to parse '{}'", str);
-    errorCode = InvalidRequest;
+    call.status = InvalidRequest;
   }
+}
+
+void CJSONRPC::ExecuteMethodCall(CMethodCall& call, ITransportLayer *transport, IClient *client)
+{
+  if (call.status == OK && call.method != nullptr)
+    call.status = call.method(call.methodName, transport, client, call.params, call.result);
+}
+
+void CJSONRPC::ExecuteMethodCalls(std::vector<CMethodCall>& calls, size_t begin, size_t end, ITransportLayer *transport, IClient *client)
+{
+  struct CParallelCalls
+  {
+    std::vector<CMethodCall*> calls;
+    std::atomic<size_t> next{0};
+    std::atomic<size_t> finished{0};
+    CEvent done;
+  };
+
+  auto state = std::make_shared<CParallelCalls>();
+  for (size_t index = begin; index < end; ++index)
+    state->calls.push_back(&calls[index]);
+
+  // runs the calls nobody has taken yet, helpers starting after all calls have been taken return
+  // without touching the calls
+  const auto run = [transport, client](CParallelCalls& parallelCalls)
+  {
+    for (size_t index = parallelCalls.next++; index < parallelCalls.calls.size();
+         index = parallelCalls.next++)
+    {
+      ExecuteMethodCall(*parallelCalls.calls[index], transport, client);
+      if (++parallelCalls.finished == parallelCalls.calls.size())
+        parallelCalls.done.Set();
+    }
+  };
 
-  BuildResponse(request, errorCode, result, response);
+  // the calling thread executes calls too, so the batch finishes even if all workers are busy
+  const auto jobManager = CServiceBroker::GetJobManager();
+  const size_t helpers = std::min(state->calls.size(), MAX_PARALLEL_CALLS) - 1;
+  for (size_t helper = 0; jobManager != nullptr && helper < helpers; ++helper)
+    jobManager->Submit([run, state] { run(*state); }, CJob::PRIORITY_NORMAL);
 
-  return !isNotification;
+  run(*state);
+  state->done.Wait();
 }
 
 inline bool CJSONRPC::IsProperJSONRPC(const CVariant& inputroot)
@@ -327,7 +417,7 @@ inline bool CJSONRPC::IsProperJSONRPC(const CVariant& inputroot)
   return inputroot.isMember("jsonrpc") && inputroot["jsonrpc"].isString() && inputroot["jsonrpc"] == CVariant("2.0") && inputroot.isMember("method") && inputroot["method"].isString() && (!inputroot.isMember("params") || inputroot["params"].isArray() || inputroot["params"].isObject());
 }
 
-inline void CJSONRPC::BuildResponse(const CVariant& request, JSONRPC_STATUS code, const CVariant& result, CVariant& response)
+inline void CJSONRPC::BuildResponse(const CVariant& request, JSONRPC_STATUS code, CVariant&& result, CVariant& response)
 {
   response["jsonrpc"] = "2.0";
   response["id"] = request.isMember("id") ? request["id"] : CVariant();
@@ -335,7 +425,8 @@ inline void CJSONRPC::BuildResponse(const CVariant& request, JSONRPC_STATUS code
   switch (code)
   {
     case OK:
-      response["result"] = result;
+      // the result may hold a whole library listing, don't copy it
+      response["result"] = std::move(result);
       break;
     case ACK:
       response["result"] = "OK";
@@ -348,7 +439,7 @@ inline void CJSONRPC::BuildResponse(const CVariant& request, JSONRPC_STATUS code
       response["error"]["code"] = InvalidParams;
       response["error"]["message"] = "Invalid params.";
       if (!result.isNull())
-        response["error"]["data"] = result;
+        response["error"]["data"] = std::move(result);
       break;
     case MethodNotFound:
       response["error"]["code"] = MethodNotFound;
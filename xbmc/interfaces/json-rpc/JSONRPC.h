@@ -10,13 +10,13 @@
 
 #include "JSONRPCUtils.h"
 #include "JSONServiceDescription.h"
+#include "utils/Variant.h"
 
 #include <iostream>
 #include <map>
 #include <stdio.h>
 #include <string>
-
-class CVariant;
+#include <vector>
 
 namespace JSONRPC
 {
@@ -62,10 +62,26 @@ namespace JSONRPC
     static JSONRPC_STATUS NotifyAll(const std::string &method, ITransportLayer *transport, IClient *client, const CVariant& parameterObject, CVariant &result);
 
   private:
+    struct CMethodCall
+    {
+      const CVariant* request = nullptr;
+      std::string methodName;
+      JSONRPC::MethodCall method = nullptr;
+      CVariant params;
+      CVariant result;
+      JSONRPC_STATUS status = OK;
+      bool isNotification = false;
+      bool parallel = false;
+    };
+
     static bool HandleMethodCall(const CVariant& request, CVariant& response, ITransportLayer *transport, IClient *client);
+    static bool HandleBatchCall(const CVariant& requests, CVariant& responses, ITransportLayer *transport, IClient *client);
+    static void PrepareMethodCall(const CVariant& request, ITransportLayer *transport, IClient *client, CMethodCall& call);
+    static void ExecuteMethodCall(CMethodCall& call, ITransportLayer *transport, IClient *client);
+    static void ExecuteMethodCalls(std::vector<CMethodCall>& calls, size_t begin, size_t end, ITransportLayer *transport, IClient *client);
     static inline bool IsProperJSONRPC(const CVariant& inputroot);
 
-    inline static void BuildResponse(const CVariant& request, JSONRPC_STATUS code, const CVariant& result, CVariant& response);
+    inline static void BuildResponse(const CVariant& request, JSONRPC_STATUS code, CVariant&& result, CVariant& response);
 
     static bool m_initialized;
   };
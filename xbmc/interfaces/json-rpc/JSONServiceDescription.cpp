@@ -258,7 +258,8 @@ JsonRpcMethodMap CJSONServiceDescription::m_methodMaps[] = {
 
 // XBMC operations
   { "XBMC.GetInfoLabels",                           CXBMCOperations::GetInfoLabels },
-  { "XBMC.GetInfoBooleans",                         CXBMCOperations::GetInfoBooleans }
+  { "XBMC.GetInfoBooleans",                         CXBMCOperations::GetInfoBooleans },
+  { "XBMC.GetDatabaseQueryStats",                   CXBMCOperations::GetDatabaseQueryStats }
 };
 
 // clang-format on
@@ -1320,6 +1321,14 @@ bool JsonRpcMethod::Parse(const CVariant &value)
   else
     permission = StringToPermission(value.isMember("permission") ? value["permission"].asString() : "");
 
+  parallel = value["parallel"].asBoolean(false);
+  if (parallel && permission != ReadData)
+  {
+    CLog::Log(LOGWARNING, "JSONRPC: Method {} is only allowed to be parallel if it reads data",
+              name);
+    parallel = false;
+  }
+
   description = GetString(value["description"], "");
 
   // Check whether there are parameters defined
@@ -1980,6 +1989,12 @@ JSONRPC_STATUS CJSONServiceDescription::CheckCall(const char* const method, cons
   return MethodNotFound;
 }
 
+bool CJSONServiceDescription::CanExecuteInParallel(const std::string& method)
+{
+  CJsonRpcMethodMap::JsonRpcMethodIterator iter = m_actionMap.find(method);
+  return iter != m_actionMap.end() && iter->second.parallel;
+}
+
 JSONSchemaTypeDefinitionPtr CJSONServiceDescription::GetType(const std::string &identification)
 {
   std::map<std::string, JSONSchemaTypeDefinitionPtr>::iterator iter = m_types.find(identification);
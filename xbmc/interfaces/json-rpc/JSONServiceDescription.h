@@ -251,6 +251,11 @@ namespace JSONRPC
      to execute the method
      */
     OperationPermission permission = ReadData;
+    /*!
+     \brief Whether the method only reads data and can be
+     executed in parallel to other such methods of a batch
+     */
+    bool parallel = false;
     /*!
      \brief Description of the method
      */
@@ -385,6 +390,14 @@ namespace JSONRPC
      */
     static JSONRPC_STATUS CheckCall(const char* method, const CVariant &requestParameters, ITransportLayer *transport, IClient *client, bool notification, MethodCall &methodCall, CVariant &outputParameters);
 
+    /*!
+     \brief Checks whether calls of the given method in a batch request
+     can be executed in parallel to other calls of such methods
+     \param method Called method
+     \return True if the method is marked as "parallel" in its json schema description
+     */
+    static bool CanExecuteInParallel(const std::string& method);
+
     static JSONSchemaTypeDefinitionPtr GetType(const std::string &identification);
 
     static void ResolveReferences();
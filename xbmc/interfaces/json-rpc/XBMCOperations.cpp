@@ -9,6 +9,7 @@
 #include "XBMCOperations.h"
 
 #include "ServiceBroker.h"
+#include "dbwrappers/DatabaseQueryStats.h"
 #include "messaging/ApplicationMessenger.h"
 #include "powermanagement/PowerManager.h"
 #include "utils/Variant.h"
@@ -86,3 +87,25 @@ JSONRPC_STATUS CXBMCOperations::GetInfoBooleans(const std::string &method, ITran
 
   return OK;
 }
+
+JSONRPC_STATUS CXBMCOperations::GetDatabaseQueryStats(const std::string& method,
+                                                      ITransportLayer* transport,
+                                                      IClient* client,
+                                                      const CVariant& parameterObject,
+                                                      CVariant& result)
+{
+  CDatabaseQueryStats& stats = CDatabaseQueryStats::GetInstance();
+
+  const auto limit = static_cast<size_t>(parameterObject["limit"].asUnsignedInteger());
+
+  result["enabled"] = stats.IsEnabled();
+  stats.Serialize(result["queries"], limit);
+
+  if (parameterObject["log"].asBoolean())
+    stats.LogSummary(limit);
+
+  if (parameterObject["reset"].asBoolean())
+    stats.Reset();
+
+  return OK;
+}
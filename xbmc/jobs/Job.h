@@ -76,6 +76,8 @@ public:
    CJob subclasses may optionally implement this function to specify the type of job.
    This is useful for the CJobManager::AddJob() routine, which preempts similar jobs
    with the new job.
+   Jobs of different types (see GetType()) are never compared, CJobManager only looks for equal
+   jobs among the ones of the same type.
 
    \return a unique character string describing the job.
    \sa CJobManager
@@ -13,15 +13,43 @@
 #include "utils/log.h"
 
 #include <algorithm>
-#include <cassert>
 #include <chrono>
+#include <functional>
+#include <iterator>
 #include <mutex>
-#include <optional>
 #include <stdexcept>
+#include <string_view>
 #include <thread>
+#include <vector>
 
 using namespace std::chrono_literals;
 
+namespace
+{
+template<typename Items, typename WorkItemPtr>
+void Append(Items& items, const WorkItemPtr& item)
+{
+  item->m_registryIndex = items.size();
+  items.push_back({item->GetJob(), item});
+}
+
+template<typename Items, typename WorkItem>
+bool Remove(Items& items, const WorkItem& item)
+{
+  // move the last item into the gap
+  const size_t index = item.m_registryIndex;
+  if (index >= items.size() || items[index].m_item.get() != &item)
+    return false;
+  if (index + 1 != items.size())
+  {
+    items[index] = std::move(items.back());
+    items[index].m_item->m_registryIndex = index;
+  }
+  items.pop_back();
+  return true;
+}
+} // unnamed namespace
+
 bool CJob::ShouldCancel(unsigned int progress, unsigned int total) const
 {
   if (m_progressCallback)
@@ -36,10 +64,15 @@ size_t CJob::GetPendingCallbackCount() const
   return 0;
 }
 
+thread_local CJobManager::CJobWorker* CJobManager::s_currentWorker = nullptr;
+
 class CJobManager::CJobWorker : private CThread
 {
 public:
-  explicit CJobWorker(CJobManager& manager) : CThread("JobWorker"), m_jobManager(manager)
+  CJobWorker(CJobManager& manager, CWorkQueue* queue)
+    : CThread("JobWorker"),
+      m_jobManager(manager),
+      m_queue(queue)
   {
     Create(true); // start work immediately, and kill ourselves when we're done
   }
@@ -54,13 +87,15 @@ public:
   void Process() override
   {
     SetPriority(ThreadPriority::LOWEST);
+    s_currentWorker = this;
     while (true)
     {
       // request an item from our manager (this call is blocking)
-      CJob* job{m_jobManager.GetNextJob()};
-      if (!job)
+      m_item = m_jobManager.GetNextItem(*this);
+      if (!m_item)
         break;
 
+      CJob* job = m_item->GetJob();
       bool success{false};
       try
       {
@@ -70,25 +105,72 @@ public:
       {
         CLog::LogF(LOGERROR, "Error processing job {}", job->GetType());
       }
-      m_jobManager.OnJobComplete(success, job);
+      m_jobManager.OnJobComplete(success, m_item);
+      m_item.reset();
     }
+    s_currentWorker = nullptr;
   }
 
+  const CJobManager& GetManager() const { return m_jobManager; }
+  CWorkQueue* GetQueue() const { return m_queue; }
+  CWorkItem* GetItem() const { return m_item.get(); }
+
+  bool m_exiting{false}; // guarded by the section of the manager
+
 private:
   CJobManager& m_jobManager;
+  CWorkQueue* const m_queue;
+  WorkItemPtr m_item;
 };
 
-struct CJobManager::JobFinder
+void CJobManager::CWorkQueue::Push(WorkItemPtr item)
 {
-  explicit JobFinder(const CJob* job) : m_job(job) {}
-  bool operator()(const CWorkItem& workItem) const { return workItem.GetJob() == m_job; }
+  const CJob::PRIORITY priority = item->GetPriority();
+  std::unique_lock lock(m_section);
+  m_items[priority].emplace_back(std::move(item));
+  ++m_sizes[priority];
+}
 
-  const CJob* m_job{nullptr};
-};
+CJobManager::WorkItemPtr CJobManager::CWorkQueue::PopNewest(CJob::PRIORITY priority)
+{
+  std::unique_lock lock(m_section);
+  if (m_items[priority].empty())
+    return {};
 
-bool CJobManager::IsRunning() const
+  WorkItemPtr item = std::move(m_items[priority].back());
+  m_items[priority].pop_back();
+  --m_sizes[priority];
+  return item;
+}
+
+CJobManager::WorkItemPtr CJobManager::CWorkQueue::PopOldest(CJob::PRIORITY priority)
 {
   std::unique_lock lock(m_section);
+  if (m_items[priority].empty())
+    return {};
+
+  WorkItemPtr item = std::move(m_items[priority].front());
+  m_items[priority].pop_front();
+  --m_sizes[priority];
+  return item;
+}
+
+std::vector<CJobManager::WorkItemPtr> CJobManager::CWorkQueue::TakeAll()
+{
+  std::vector<WorkItemPtr> items;
+  std::unique_lock lock(m_section);
+  for (unsigned int priority = CJob::PRIORITY_LOW_PAUSABLE; priority <= CJob::PRIORITY_DEDICATED;
+       ++priority)
+  {
+    std::ranges::move(m_items[priority], std::back_inserter(items));
+    m_items[priority].clear();
+    m_sizes[priority] = 0;
+  }
+  return items;
+}
+
+bool CJobManager::IsRunning() const
+{
   return m_running;
 }
 
@@ -103,33 +185,51 @@ void CJobManager::Restart()
 
 void CJobManager::CancelJobs()
 {
-  std::unique_lock lock(m_section);
-  m_running = false;
-
-  // clear any pending jobs
-  for (unsigned int priority = CJob::PRIORITY_LOW_PAUSABLE; priority <= CJob::PRIORITY_DEDICATED;
-       ++priority)
+  // stop accepting jobs, AddJob checks m_running again under the lock of the job's shard
   {
-    std::ranges::for_each(m_jobQueue[priority],
-                          [](CWorkItem& wi)
-                          {
-                            for (auto* callback : wi.GetCallbacks())
-                              callback->OnJobAbort(wi.GetId(), wi.GetJob());
-                            wi.FreeJob();
-                          });
-    m_jobQueue[priority].clear();
+    std::vector<std::unique_lock<CCriticalSection>> locks;
+    locks.reserve(m_shards.size());
+    for (RegistryShard& shard : m_shards)
+      locks.emplace_back(shard.m_section);
+    m_running = false;
   }
 
-  // cancel any callbacks on jobs still processing
-  std::ranges::for_each(m_processing,
-                        [](CWorkItem& wi)
-                        {
-                          for (auto* callback : wi.GetCallbacks())
-                            callback->OnJobAbort(wi.GetId(), wi.GetJob());
-                          wi.Cancel();
-                        });
+  for (RegistryShard& shard : m_shards)
+  {
+    std::unique_lock lock(shard.m_section);
+    for (auto& [type, entry] : shard.m_entries)
+    {
+      // clear any pending jobs, the queues drop them
+      for (auto& queued : entry.m_queued)
+      {
+        for (const auto& [job, item] : queued)
+        {
+          if (item->CancelQueued())
+          {
+            for (auto* callback : item->GetCallbacks())
+              callback->OnJobAbort(item->GetId(), item->GetJob());
+            item->FreeJob();
+          }
+          else // just taken by a worker
+            Append(entry.m_processing, item);
+        }
+        queued.clear();
+      }
+
+      // cancel any callbacks on jobs still processing
+      for (const auto& [job, item] : entry.m_processing)
+      {
+        if (item->GetState() != CWorkItem::State::PROCESSING)
+          continue;
+        for (auto* callback : item->GetCallbacks())
+          callback->OnJobAbort(item->GetId(), item->GetJob());
+        item->Cancel();
+      }
+    }
+  }
 
   // tell our workers to finish
+  std::unique_lock lock(m_section);
   while (!m_workers.empty())
   {
     lock.unlock();
@@ -137,262 +237,465 @@ void CJobManager::CancelJobs()
     std::this_thread::yield(); // yield after setting the event to give the workers some time to die
     lock.lock();
   }
+
+  lock.unlock();
+
+  // no worker is left to drop the cancelled items, abort the ones added while cancelling
+  std::vector<WorkItemPtr> items = m_injectionQueue.TakeAll();
+  for (size_t i = 0; i < m_workerQueueCount; ++i)
+    std::ranges::move(m_workerQueues[i]->TakeAll(), std::back_inserter(items));
+  for (const WorkItemPtr& item : items)
+  {
+    RegistryShard& shard = GetShard(item->GetId());
+    std::unique_lock shardLock(shard.m_section);
+    if (!item->CancelQueued())
+      continue;
+    for (auto* callback : item->GetCallbacks())
+      callback->OnJobAbort(item->GetId(), item->GetJob());
+    Unregister(shard, *item);
+    item->FreeJob();
+  }
 }
 
-unsigned int CJobManager::AddJob(CJob* job, IJobCallback* callback, CJob::PRIORITY priority)
+CJobManager::RegistryShard& CJobManager::GetShard(const char* type)
 {
-  std::unique_lock lock(m_section);
+  return m_shards[std::hash<std::string_view>{}(type) & ((1 << SHARD_BITS) - 1)];
+}
+
+const CJobManager::RegistryShard& CJobManager::GetShard(const char* type) const
+{
+  return m_shards[std::hash<std::string_view>{}(type) & ((1 << SHARD_BITS) - 1)];
+}
+
+CJobManager::RegistryShard& CJobManager::GetShard(unsigned int jobID)
+{
+  return m_shards[jobID & ((1 << SHARD_BITS) - 1)];
+}
 
+unsigned int CJobManager::AddJob(CJob* job, IJobCallback* callback, CJob::PRIORITY priority)
+{
   if (!m_running)
   {
     delete job;
     return 0;
   }
 
-  // Check if we have this job already in the queue - if so, add callback to existing job
-  auto it = std::ranges::find_if(m_jobQueue[priority],
-                                 [job](const CWorkItem& wi) { return wi.GetJob()->Equals(job); });
-  if (it != m_jobQueue[priority].end())
+  RegistryShard& shard = GetShard(job->GetType());
+  WorkItemPtr work;
   {
-    it->AddCallback(callback);
-    delete job;
-    return it->GetId();
-  }
+    std::unique_lock lock(shard.m_section);
 
-  // Check if an equal job is already processing - if so, add callback to it.
-  // Note: Jobs that have moved to completion phase (removed from m_processing)
-  // won't be found here, causing a new job to be created. This is intentional -
-  // the completing job's results are about to be delivered to existing callbacks.
-  auto procIt = std::ranges::find_if(m_processing, [job](const CWorkItem& wi)
-                                     { return wi.GetJob()->Equals(job); });
-  if (procIt != m_processing.end())
-  {
-    procIt->AddCallback(callback);
-    delete job;
-    return procIt->GetId();
-  }
+    // CancelJobs may have swept the shard since the check above
+    if (!m_running)
+    {
+      delete job;
+      return 0;
+    }
+
+    RegistryShard::Entry& entry = shard.m_entries[job->GetType()];
+
+    // Check if we have this job already in the queue - if so, add callback to existing job
+    auto it = std::ranges::find_if(entry.m_queued[priority],
+                                   [job](const auto& wi) { return wi.m_job->Equals(job); });
+    if (it != entry.m_queued[priority].end())
+    {
+      it->m_item->AddCallback(callback);
+      delete job;
+      return it->m_item->GetId();
+    }
+
+    // Check if an equal job is already processing - if so, add callback to it.
+    // Note: Jobs that have moved to completion phase won't be found here, causing a new job to
+    // be created. This is intentional - the completing job's results are about to be delivered
+    // to existing callbacks.
+    auto procIt = std::ranges::find_if(
+        entry.m_processing, [job](const auto& wi)
+        { return wi.m_item->GetState() == CWorkItem::State::PROCESSING && wi.m_job->Equals(job); });
+    if (procIt != entry.m_processing.end())
+    {
+      procIt->m_item->AddCallback(callback);
+      delete job;
+      return procIt->m_item->GetId();
+    }
+
+    // the id carries the shard, ensuring 0 (invalid job) is never hit
+    const auto shardIndex = static_cast<unsigned int>(&shard - m_shards.data());
+    unsigned int id = 0;
+    while (id == 0)
+      id = (++m_jobCounter << SHARD_BITS) | shardIndex;
 
-  // increment the job counter, ensuring 0 (invalid job) is never hit
-  m_jobCounter++;
-  if (m_jobCounter == 0)
-    m_jobCounter++;
+    // create a work item for this job
+    work = std::make_shared<CWorkItem>(job, id, priority, callback);
+    Append(entry.m_queued[priority], work);
+  }
 
-  // create a work item for this job
-  CWorkItem work(job, m_jobCounter, priority, callback);
-  m_jobQueue[priority].emplace_back(work);
+  // jobs added by our workers stay with them, unless they need a worker of their own
+  const unsigned int id = work->GetId();
+  const CJobWorker* worker = s_currentWorker;
+  if (worker && &worker->GetManager() == this && worker->GetQueue() &&
+      priority != CJob::PRIORITY_DEDICATED)
+    worker->GetQueue()->Push(std::move(work));
+  else
+    m_injectionQueue.Push(std::move(work));
 
   StartWorkers(priority);
-  return work.GetId();
+  return id;
 }
 
 void CJobManager::CancelJob(unsigned int jobID)
 {
-  std::unique_lock lock(m_section);
+  RegistryShard& shard = GetShard(jobID);
+  std::unique_lock lock(shard.m_section);
 
-  // check whether we have this job in the queue
-  for (unsigned int priority = CJob::PRIORITY_LOW_PAUSABLE; priority <= CJob::PRIORITY_DEDICATED;
-       ++priority)
+  const auto hasId = [jobID](const auto& wi) { return wi.m_item->GetId() == jobID; };
+  for (auto& [type, entry] : shard.m_entries)
   {
-    const auto i = std::ranges::find_if(m_jobQueue[priority],
-                                        [jobID](const auto& wi) { return wi.GetId() == jobID; });
-    if (i != m_jobQueue[priority].cend())
+    // check whether we have this job in the queue, the queue drops the cancelled item
+    for (const auto& queued : entry.m_queued)
+    {
+      const auto it = std::ranges::find_if(queued, hasId);
+      if (it != queued.end() && it->m_item->CancelQueued())
+      {
+        const WorkItemPtr item = it->m_item;
+        Unregister(shard, *item);
+        item->FreeJob();
+        return;
+      }
+    }
+
+    // or if we're processing it
+    const auto it = std::ranges::find_if(entry.m_processing, hasId);
+    if (it != entry.m_processing.end())
     {
-      CWorkItem item(std::move(*i));
-      m_jobQueue[priority].erase(i);
-      item.FreeJob();
+      if (it->m_item->GetState() == CWorkItem::State::PROCESSING)
+        it->m_item->Cancel(); // job is in progress, so only thing to do is to remove all callbacks
       return;
     }
   }
-  // or if we're processing it
-  const auto it =
-      std::ranges::find_if(m_processing, [jobID](const auto& wi) { return wi.GetId() == jobID; });
-  if (it != m_processing.cend())
-    it->Cancel(); // job is in progress, so only thing to do is to remove all callbacks
 }
 
 void CJobManager::StartWorkers(CJob::PRIORITY priority)
 {
-  std::unique_lock lock(m_section);
-
   // check how many free threads we have
-  if (m_processing.size() >= GetMaxWorkers(priority))
+  if (m_processing >= GetMaxWorkers(priority))
     return;
 
   // do we have any sleeping threads?
-  if (m_processing.size() < m_workers.size())
+  if (m_idleWorkers > 0)
   {
     m_jobEvent.Set();
     return;
   }
 
-  // everyone is busy - we need more workers
-  m_workers.emplace_back(new CJobWorker(*this));
+  std::unique_lock lock(m_section);
+
+  // workers in between two jobs look at the queues before sleeping
+  if (m_processing < m_workers.size() - m_exitingWorkers)
+    return;
+
+  // everyone is busy - we need more workers, with a queue of their own if one is left
+  CWorkQueue* queue = nullptr;
+  for (size_t i = 0; i < MAX_WORKER_QUEUES && !queue; ++i)
+  {
+    if (m_workerQueueUsed[i])
+      continue;
+    if (i == m_workerQueueCount)
+    {
+      m_workerQueues[i] = std::make_unique<CWorkQueue>();
+      m_workerQueueCount = i + 1;
+    }
+    m_workerQueueUsed[i] = true;
+    queue = m_workerQueues[i].get();
+  }
+  m_workers.emplace_back(new CJobWorker(*this, queue));
+}
+
+bool CJobManager::ReserveWorker(CJob::PRIORITY priority)
+{
+  const unsigned int maxWorkers = GetMaxWorkers(priority);
+  unsigned int processing = m_processing;
+  do
+  {
+    if (processing >= maxWorkers)
+      return false;
+  } while (!m_processing.compare_exchange_weak(processing, processing + 1));
+  return true;
 }
 
-CJob* CJobManager::PopJob()
+bool CJobManager::HasQueuedItems(CJob::PRIORITY priority, const CWorkQueue* queue) const
 {
-  std::unique_lock lock(m_section);
-  for (int priority = CJob::PRIORITY_DEDICATED; priority >= CJob::PRIORITY_LOW_PAUSABLE; --priority)
+  if ((queue && queue->HasItems(priority)) || m_injectionQueue.HasItems(priority))
+    return true;
+
+  const size_t count = m_workerQueueCount;
+  for (size_t i = 0; i < count; ++i)
   {
+    if (m_workerQueues[i]->HasItems(priority))
+      return true;
+  }
+  return false;
+}
+
+CJobManager::WorkItemPtr CJobManager::StealItem(CJob::PRIORITY priority, const CWorkQueue* queue)
+{
+  // start at a different queue for every worker to spread the thieves
+  const size_t count = m_workerQueueCount;
+  const size_t start = std::hash<const void*>{}(queue);
+  for (size_t i = 0; i < count; ++i)
+  {
+    CWorkQueue* victim = m_workerQueues[(start + i) % count].get();
+    if (victim == queue || !victim->HasItems(priority))
+      continue;
+    if (WorkItemPtr item = victim->PopOldest(priority))
+      return item;
+  }
+  return {};
+}
+
+CJobManager::WorkItemPtr CJobManager::PopItem(CWorkQueue* queue)
+{
+  for (int p = CJob::PRIORITY_DEDICATED; p >= CJob::PRIORITY_LOW_PAUSABLE; --p)
+  {
+    const auto priority = static_cast<CJob::PRIORITY>(p);
+
     // Check whether we're pausing pausable jobs
     if (priority == CJob::PRIORITY_LOW_PAUSABLE && m_pauseJobs)
       continue;
 
-    if (!m_jobQueue[priority].empty() &&
-        m_processing.size() < GetMaxWorkers(CJob::PRIORITY(priority)))
+    if (!HasQueuedItems(priority, queue) || !ReserveWorker(priority))
+      continue;
+
+    while (true)
     {
-      // pop the job off the queue
-      const CWorkItem job{m_jobQueue[priority].front()};
-      m_jobQueue[priority].pop_front();
-
-      // add to the processing vector
-      m_processing.emplace_back(job);
-      job.GetJob()->SetProgressCallback(this);
-      return job.GetJob();
+      WorkItemPtr item = queue ? queue->PopNewest(priority) : nullptr;
+      if (!item)
+        item = m_injectionQueue.PopOldest(priority);
+      if (!item)
+        item = StealItem(priority, queue);
+      if (!item)
+        break;
+
+      // items cancelled while queued are dropped here
+      if (item->Start())
+      {
+        SetProcessing(item);
+        item->GetJob()->SetProgressCallback(this);
+        return item;
+      }
     }
+    --m_processing;
   }
-  return nullptr;
+  return {};
 }
 
 void CJobManager::PauseJobs()
 {
-  std::unique_lock lock(m_section);
   m_pauseJobs = true;
 }
 
 void CJobManager::UnPauseJobs()
 {
-  std::unique_lock lock(m_section);
   m_pauseJobs = false;
+  if (m_idleWorkers > 0)
+    m_jobEvent.Set();
 }
 
 bool CJobManager::IsProcessing(const CJob::PRIORITY& priority) const
 {
-  std::unique_lock lock(m_section);
-
   if (m_pauseJobs && priority == CJob::PRIORITY::PRIORITY_LOW_PAUSABLE)
     return false;
 
-  return std::ranges::any_of(m_processing,
-                             [priority](const auto& wi) { return wi.GetPriority() == priority; });
+  return std::ranges::any_of(
+      m_shards,
+      [priority](const RegistryShard& shard)
+      {
+        std::unique_lock lock(shard.m_section);
+        return std::ranges::any_of(shard.m_entries,
+                                   [priority](const auto& entry)
+                                   {
+                                     return std::ranges::any_of(
+                                         entry.second.m_processing,
+                                         [priority](const auto& wi)
+                                         {
+                                           return wi.m_item->GetPriority() == priority &&
+                                                  wi.m_item->GetState() ==
+                                                      CWorkItem::State::PROCESSING;
+                                         });
+                                   });
+      });
 }
 
 int CJobManager::IsProcessing(const std::string& type) const
 {
-  std::unique_lock lock(m_section);
+  const RegistryShard& shard = GetShard(type.c_str());
+  std::unique_lock lock(shard.m_section);
+
+  const auto it = shard.m_entries.find(type);
+  if (it == shard.m_entries.end())
+    return 0;
 
   return static_cast<int>(std::ranges::count_if(
-      m_processing,
-      [this, &type](const auto& wi)
+      it->second.m_processing,
+      [this](const auto& wi)
       {
-        return (!m_pauseJobs || wi.GetPriority() != CJob::PRIORITY::PRIORITY_LOW_PAUSABLE) &&
-               (std::string(wi.GetJob()->GetType()) == type);
+        return (!m_pauseJobs ||
+                wi.m_item->GetPriority() != CJob::PRIORITY::PRIORITY_LOW_PAUSABLE) &&
+               wi.m_item->GetState() == CWorkItem::State::PROCESSING;
       }));
 }
 
-CJob* CJobManager::GetNextJob()
+CJobManager::WorkItemPtr CJobManager::GetNextItem(CJobWorker& worker)
 {
-  std::unique_lock lock(m_section);
   while (m_running)
   {
-    // grab a job off the queue if we have one
-    CJob* job = PopJob();
-    if (job)
-      return job;
+    // grab a job off the queues if we have one
+    if (WorkItemPtr item = PopItem(worker.GetQueue()))
+    {
+      // there may be more for the other sleeping workers
+      if (m_idleWorkers > 0)
+        m_jobEvent.Set();
+      return item;
+    }
+
+    // look again after announcing that we're going to sleep, AddJob() wakes us from now on
+    ++m_idleWorkers;
+    if (WorkItemPtr item = PopItem(worker.GetQueue()))
+    {
+      --m_idleWorkers;
+      return item;
+    }
+
     // no jobs are left - sleep for 30 seconds to allow new jobs to come in
-    lock.unlock();
-    bool newJob = m_jobEvent.Wait(30000ms);
-    lock.lock();
+    const bool newJob = m_jobEvent.Wait(30000ms);
+    --m_idleWorkers;
     if (!newJob)
       break;
   }
-  // ensure no jobs have come in during the period after
-  // timeout and before we held the lock
-  return PopJob();
+
+  // ensure no jobs have come in during the period after timeout, StartWorkers() creates a new
+  // worker for the jobs added once we're marked as exiting
+  std::unique_lock lock(m_section);
+  WorkItemPtr item = m_running ? PopItem(worker.GetQueue()) : nullptr;
+  if (!item)
+  {
+    worker.m_exiting = true;
+    ++m_exitingWorkers;
+  }
+  return item;
+}
+
+CJobManager::CWorkItem* CJobManager::FindItem(const RegistryShard& shard, const CJob* job) const
+{
+  const CJobWorker* worker = s_currentWorker;
+  if (worker && worker->GetItem() && worker->GetItem()->GetJob() == job)
+    return worker->GetItem();
+
+  const auto it = shard.m_entries.find(job->GetType());
+  if (it == shard.m_entries.end())
+    return nullptr;
+
+  const auto& processing = it->second.m_processing;
+  const auto item =
+      std::ranges::find_if(processing, [job](const auto& wi) { return wi.m_job == job; });
+  return item != processing.end() ? item->m_item.get() : nullptr;
+}
+
+void CJobManager::SetProcessing(const WorkItemPtr& item)
+{
+  RegistryShard& shard = GetShard(item->GetJob()->GetType());
+  std::unique_lock lock(shard.m_section);
+  const auto it = shard.m_entries.find(item->GetJob()->GetType());
+  if (it == shard.m_entries.end())
+    return;
+
+  // CancelJobs() moves the items it couldn't cancel itself
+  if (Remove(it->second.m_queued[item->GetPriority()], *item))
+    Append(it->second.m_processing, item);
+}
+
+void CJobManager::Unregister(RegistryShard& shard, const CWorkItem& item)
+{
+  const auto it = shard.m_entries.find(item.GetJob()->GetType());
+  if (it == shard.m_entries.end())
+    return;
+
+  RegistryShard::Entry& entry = it->second;
+  if (!Remove(entry.m_processing, item))
+    Remove(entry.m_queued[item.GetPriority()], item);
+
+  if (entry.m_processing.empty() &&
+      std::ranges::all_of(entry.m_queued, [](const auto& queued) { return queued.empty(); }))
+    shard.m_entries.erase(it);
 }
 
 bool CJobManager::OnJobProgress(unsigned int progress, unsigned int total, const CJob* job) const
 {
-  std::unique_lock lock(m_section);
-  // find the job in the processing queue, and check whether it's cancelled (no callbacks)
-  const auto i = std::ranges::find_if(m_processing, JobFinder(job));
-  if (i != m_processing.cend())
+  const RegistryShard& shard = GetShard(job->GetType());
+  std::unique_lock lock(shard.m_section);
+  // find the job, and check whether it's cancelled (no callbacks)
+  const CWorkItem* item = FindItem(shard, job);
+  if (item && item->GetState() == CWorkItem::State::PROCESSING)
   {
-    CWorkItem item(*i);
+    const unsigned int id = item->GetId();
+    const std::vector<IJobCallback*> callbacks = item->GetCallbacks();
     lock.unlock(); // leave section prior to call
-    if (!item.GetCallbacks().empty())
+    if (!callbacks.empty())
     {
-      for (auto* callback : item.GetCallbacks())
-        callback->OnJobProgress(item.GetId(), progress, total, job);
+      for (auto* callback : callbacks)
+        callback->OnJobProgress(id, progress, total, job);
       return false;
     }
   }
   return true; // couldn't find the job, or it's been cancelled
 }
 
-void CJobManager::OnJobComplete(bool success, CJob* job)
+void CJobManager::OnJobComplete(bool success, const WorkItemPtr& item)
 {
-  std::optional<CWorkItem> item = [&, this]
+  CJob* job = item->GetJob();
+  RegistryShard& shard = GetShard(job->GetType());
+
+  std::vector<IJobCallback*> callbacks;
   {
-    std::unique_lock lock(m_section);
-    std::optional<CWorkItem> item;
-    auto i = std::ranges::find_if(m_processing, JobFinder(job));
-    if (i != m_processing.end())
-    {
-      // Move work item out of m_processing to avoid iterator invalidation
-      // when another thread modifies m_processing during callback execution
-      item.emplace(std::move(*i));
-      m_processing.erase(i);
-    }
-    return item;
-  }();
+    std::unique_lock lock(shard.m_section);
+    // from now on AddJob() and CancelJob() leave the item alone, so the callbacks can be used
+    // without holding the section
+    item->SetState(CWorkItem::State::COMPLETING);
+    callbacks = item->TakeCallbacks();
+    // Track pending callbacks so CJob::IsShared() can query the count.
+    // Last callback (count==1) doesn't need to copy since it's the sole owner.
+    item->SetPendingCallbacks(callbacks.size());
+  }
+  --m_processing;
 
-  if (item.has_value())
+  while (!callbacks.empty())
   {
-    if (!item->GetCallbacks().empty())
+    IJobCallback* callback = callbacks.back();
+    callbacks.pop_back();
+    try
     {
-      // We can safely hold a reference to the counter as we are the ones
-      // controlling the creation and deletion.
-      auto& counter = [&, this]() -> std::atomic<size_t>&
-      {
-        std::unique_lock lock(m_section);
-
-        assert(!m_pendingCallbacks.contains(job));
-
-        // Track pending callbacks so CJob::IsShared() can query the count.
-        // Last callback (count==1) doesn't need to copy since it's the sole owner.
-        return m_pendingCallbacks.insert_or_assign(job, item->GetCallbacks().size()).first->second;
-      }();
-
-      while (IJobCallback* callback = item->PopCallback())
-      {
-        try
-        {
-          callback->OnJobComplete(item->GetId(), success, job);
-        }
-        catch (...)
-        {
-          CLog::LogF(LOGERROR, "Error processing job {}", job->GetType());
-        }
-        // Update pending count for next callback
-        counter = item->GetCallbacks().size();
-      }
-
-      {
-        std::unique_lock lock(m_section);
-        m_pendingCallbacks.erase(job);
-      }
+      callback->OnJobComplete(item->GetId(), success, job);
+    }
+    catch (...)
+    {
+      CLog::LogF(LOGERROR, "Error processing job {}", job->GetType());
     }
+    // Update pending count for next callback
+    item->SetPendingCallbacks(callbacks.size());
+  }
 
-    item->FreeJob();
+  {
+    std::unique_lock lock(shard.m_section);
+    Unregister(shard, *item);
   }
+  item->FreeJob();
 }
 
 size_t CJobManager::GetPendingCallbackCount(const CJob* job) const
 {
-  std::unique_lock lock(m_section);
-  auto it = m_pendingCallbacks.find(job);
-  return it != m_pendingCallbacks.end() ? static_cast<size_t>(it->second) : 0;
+  const RegistryShard& shard = GetShard(job->GetType());
+  std::unique_lock lock(shard.m_section);
+  const CWorkItem* item = FindItem(shard, job);
+  return item && item->GetState() == CWorkItem::State::COMPLETING ? item->GetPendingCallbacks() : 0;
 }
 
 void CJobManager::RemoveWorker(const CJobWorker* worker)
@@ -401,7 +704,18 @@ void CJobManager::RemoveWorker(const CJobWorker* worker)
   // remove our worker
   const auto i = std::ranges::find(m_workers, worker);
   if (i != m_workers.cend())
+  {
+    if (worker->m_exiting)
+      --m_exitingWorkers;
     m_workers.erase(i); // workers auto-delete
+  }
+
+  // hand the queue to the next worker
+  for (size_t j = 0; j < m_workerQueueCount; ++j)
+  {
+    if (m_workerQueues[j].get() == worker->GetQueue())
+      m_workerQueueUsed[j] = false;
+  }
 }
 
 unsigned int CJobManager::GetMaxWorkers(CJob::PRIORITY priority)
@@ -16,8 +16,11 @@
 #include <algorithm>
 #include <array>
 #include <atomic>
-#include <queue>
+#include <cstddef>
+#include <deque>
+#include <memory>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 
@@ -32,6 +35,12 @@ class IJobCallback;
  on priority levels.  Lower priority jobs are executed only if there are sufficient
  spare worker threads free to allow for higher priority jobs that may arise.
 
+ Every worker has its own queue. Jobs added from a worker are pushed to that queue and run by the
+ same worker newest first, jobs added from other threads go to a shared injection queue. Idle
+ workers take the oldest jobs from the injection queue and from the queues of busy workers.
+ Duplicate detection, cancellation and progress reports use a registry that is split by job type,
+ so only jobs of the same type share a lock.
+
  \sa CJob and IJobCallback
  */
 class CJobManager final
@@ -136,15 +145,6 @@ public:
    */
   bool IsProcessing(const CJob::PRIORITY& priority) const;
 
-  /*!
-   \brief Callback from CJobWorker after a job has completed.
-   Calls IJobCallback::OnJobComplete(), and then destroys job.
-   \param job a pointer to the calling subclassed CJob instance.
-   \param success the result from the DoWork call
-   \sa IJobCallback, CJob
-   */
-  void OnJobComplete(bool success, CJob* job);
-
   /*!
    \brief Callback from CJob to report progress and check for cancellation.
    Checks for cancellation, and calls IJobCallback::OnJobProgress().
@@ -156,12 +156,6 @@ public:
    */
   bool OnJobProgress(unsigned int progress, unsigned int total, const CJob* job) const;
 
-  /*!
-   \brief Get a new job to process. Blocks until a new job is available, or a timeout has occurred.
-   \sa CJob
-   */
-  CJob* GetNextJob();
-
   /*!
    \brief Get the number of pending callbacks for a job during completion.
    \param job pointer to the job to check.
@@ -175,11 +169,18 @@ private:
   CJobManager const& operator=(CJobManager const&) = delete;
 
   class CJobWorker;
-  struct JobFinder;
 
   class CWorkItem
   {
   public:
+    enum class State
+    {
+      QUEUED,
+      PROCESSING,
+      COMPLETING, //!< calling back, no longer found by AddJob() and CancelJob()
+      CANCELLED, //!< cancelled while queued, dropped when taken from a queue
+    };
+
     CWorkItem(CJob* job, unsigned int id, CJob::PRIORITY priority, IJobCallback* callback)
       : m_job(job),
         m_id(id),
@@ -195,6 +196,23 @@ private:
       m_job = nullptr;
     }
 
+    /*! \brief Claim a queued item for processing.
+     \return false if the item was cancelled before
+     */
+    bool Start()
+    {
+      State expected = State::QUEUED;
+      return m_state.compare_exchange_strong(expected, State::PROCESSING);
+    }
+    bool CancelQueued()
+    {
+      State expected = State::QUEUED;
+      return m_state.compare_exchange_strong(expected, State::CANCELLED);
+    }
+    State GetState() const { return m_state; }
+    void SetState(State state) { m_state = state; }
+
+    // guarded by the section of the registry shard holding the item
     void Cancel() { m_callbacks.clear(); }
     CJob* GetJob() const { return m_job; }
     unsigned int GetId() const { return m_id; }
@@ -204,47 +222,136 @@ private:
       if (callback && std::ranges::find(m_callbacks, callback) == m_callbacks.end())
         m_callbacks.push_back(callback);
     }
-    IJobCallback* PopCallback()
-    {
-      if (m_callbacks.empty())
-        return nullptr;
-      IJobCallback* callback = m_callbacks.back();
-      m_callbacks.pop_back();
-      return callback;
-    }
+    std::vector<IJobCallback*> TakeCallbacks() { return std::move(m_callbacks); }
     CJob::PRIORITY GetPriority() const { return m_priority; }
+    size_t m_registryIndex{0}; //!< position in its registry list, for constant time removal
+
+    //! Callbacks still waiting to be notified while completing, see CJob::IsShared()
+    size_t GetPendingCallbacks() const { return m_pendingCallbacks; }
+    void SetPendingCallbacks(size_t count) { m_pendingCallbacks = count; }
 
   private:
     CJob* m_job{nullptr};
     unsigned int m_id{0};
     std::vector<IJobCallback*> m_callbacks;
     CJob::PRIORITY m_priority{CJob::PRIORITY::PRIORITY_LOW};
+    std::atomic<State> m_state{State::QUEUED};
+    std::atomic<size_t> m_pendingCallbacks{0};
   };
 
-  /*! \brief Pop a job off the job queue and add to the processing queue ready to process
-   \return the job to process, nullptr if no jobs are available
+  using WorkItemPtr = std::shared_ptr<CWorkItem>;
+
+  /*!
+   \brief Queue of work items per priority.
+   The owning worker takes the newest item, everyone else the oldest.
    */
-  CJob* PopJob();
+  class CWorkQueue
+  {
+  public:
+    void Push(WorkItemPtr item);
+    WorkItemPtr PopNewest(CJob::PRIORITY priority);
+    WorkItemPtr PopOldest(CJob::PRIORITY priority);
+    bool HasItems(CJob::PRIORITY priority) const { return m_sizes[priority] > 0; }
+    std::vector<WorkItemPtr> TakeAll();
+
+  private:
+    CCriticalSection m_section;
+    std::array<std::deque<WorkItemPtr>, CJob::PRIORITY_DEDICATED + 1> m_items;
+    std::array<std::atomic<size_t>, CJob::PRIORITY_DEDICATED + 1> m_sizes{};
+  };
+
+  /*!
+   \brief Part of the registry of queued and processing jobs.
+   CJob::Equals() implementations compare the job types first, so the registry is split by job type
+   and AddJob() only locks and searches the shard of the type of the new job.
+   */
+  struct RegistryShard
+  {
+    struct StringHash
+    {
+      using is_transparent = void; // Enables heterogeneous operations.
+      std::size_t operator()(std::string_view sv) const
+      {
+        std::hash<std::string_view> hasher;
+        return hasher(sv);
+      }
+    };
+
+    struct Item
+    {
+      CJob* m_job; //!< the job of m_item, next to it for quick duplicate searches
+      WorkItemPtr m_item;
+    };
+    using Items = std::vector<Item>;
+
+    //! Jobs of one type
+    struct Entry
+    {
+      std::array<Items, CJob::PRIORITY_DEDICATED + 1> m_queued;
+      Items m_processing; //!< including the completing ones
+    };
+
+    mutable CCriticalSection m_section;
+    std::unordered_map<std::string, Entry, StringHash, std::equal_to<>> m_entries;
+  };
+
+  static constexpr unsigned int SHARD_BITS = 4;
+  static constexpr size_t MAX_WORKER_QUEUES = 16;
+
+  RegistryShard& GetShard(const char* type);
+  const RegistryShard& GetShard(const char* type) const;
+  RegistryShard& GetShard(unsigned int jobID);
+  /*! \brief Find the registered item of a job, fast for the job processed by the calling worker.
+   \note Call with the section of the shard of the job held.
+   */
+  CWorkItem* FindItem(const RegistryShard& shard, const CJob* job) const;
+  void SetProcessing(const WorkItemPtr& item);
+  void Unregister(RegistryShard& shard, const CWorkItem& item);
+
+  /*! \brief Take the next item to process, honouring priorities and worker limits.
+   \param queue the queue of the calling worker, may be nullptr
+   \return the item to process, nullptr if no jobs are available
+   */
+  WorkItemPtr PopItem(CWorkQueue* queue);
+  WorkItemPtr StealItem(CJob::PRIORITY priority, const CWorkQueue* queue);
+  bool HasQueuedItems(CJob::PRIORITY priority, const CWorkQueue* queue) const;
+  bool ReserveWorker(CJob::PRIORITY priority);
+
+  /*! \brief Get a new item to process.
+   Blocks until a new job is available, or a timeout has occurred.
+   */
+  WorkItemPtr GetNextItem(CJobWorker& worker);
+
+  /*! \brief Called by the worker after a job has completed.
+   Calls IJobCallback::OnJobComplete(), and then destroys job.
+   */
+  void OnJobComplete(bool success, const WorkItemPtr& item);
 
   void StartWorkers(CJob::PRIORITY priority);
   void RemoveWorker(const CJobWorker* worker);
   static unsigned int GetMaxWorkers(CJob::PRIORITY priority);
 
-  unsigned int m_jobCounter{0};
+  std::atomic<unsigned int> m_jobCounter{0};
 
-  using JobQueue = std::deque<CWorkItem>;
-  using Processing = std::vector<CWorkItem>;
-  using Workers = std::vector<CJobWorker*>;
+  std::array<RegistryShard, 1 << SHARD_BITS> m_shards;
 
-  std::array<JobQueue, CJob::PRIORITY_DEDICATED + 1> m_jobQueue;
-  bool m_pauseJobs{false};
-  Processing m_processing;
+  CWorkQueue m_injectionQueue; //!< jobs added from threads other than our workers
+  //! queues of the workers, created on demand and reused by later workers
+  std::array<std::unique_ptr<CWorkQueue>, MAX_WORKER_QUEUES> m_workerQueues;
+  std::array<bool, MAX_WORKER_QUEUES> m_workerQueueUsed{};
+  std::atomic<size_t> m_workerQueueCount{0};
+
+  std::atomic_bool m_pauseJobs{false};
+  std::atomic<unsigned int> m_processing{0}; //!< processing jobs, including reserved workers
+  std::atomic<unsigned int> m_idleWorkers{0};
+
+  using Workers = std::vector<CJobWorker*>;
   Workers m_workers;
+  unsigned int m_exitingWorkers{0};
 
-  mutable CCriticalSection m_section;
+  mutable CCriticalSection m_section; //!< guards the workers
   CEvent m_jobEvent;
-  bool m_running{true};
+  std::atomic_bool m_running{true};
 
-  // Tracks pending callback count for jobs in completion phase, used by CJob::IsShared()
-  std::unordered_map<const CJob*, std::atomic<size_t>> m_pendingCallbacks;
+  static thread_local CJobWorker* s_currentWorker;
 };
@@ -17,6 +17,7 @@
 #include "ServiceBroker.h"
 #include "Song.h"
 #include "TextureCache.h"
+#include "TextureExportQueue.h"
 #include "URL.h"
 #include "Util.h"
 #include "addons/Addon.h"
@@ -63,9 +64,12 @@
 #include "utils/Random.h"
 #include "utils/StringUtils.h"
 #include "utils/URIUtils.h"
+#include "utils/XMLStreamReader.h"
+#include "utils/XMLStreamWriter.h"
 #include "utils/XMLUtils.h"
 #include "utils/log.h"
 
+#include <algorithm>
 #include <array>
 #include <chrono>
 #include <inttypes.h>
@@ -722,8 +726,12 @@ void CMusicDatabase::SplitPath(const std::string& strFileNameAndPath,
 
 bool CMusicDatabase::AddAlbum(CAlbum& album, int idSource)
 {
-  BeginTransaction();
-  SetLibraryLastUpdated();
+  // A bulk import wraps all its albums in a single transaction
+  if (!m_bulkImport)
+  {
+    BeginTransaction();
+    SetLibraryLastUpdated();
+  }
 
   album.idAlbum = AddAlbum(album.strAlbum, //
                            album.strMusicBrainzAlbumID, //
@@ -837,6 +845,14 @@ bool CMusicDatabase::AddAlbum(CAlbum& album, int idSource)
     } // while
   }
 
+  // Song links queued by a bulk import are needed by the album queries below. They are dropped
+  // by the flush either way, so a failure has to make the caller roll back the whole import.
+  if (m_bulkImport && !FlushPendingSongLinks())
+  {
+    CLog::LogF(LOGERROR, "failed to add the song artists and genres of album {}", album.idAlbum);
+    return false;
+  }
+
   // Set album duration as total of all songs on album.
   // Folder layout may mean AddAlbum call has added more songs to an existing album
   std::string strSQL;
@@ -902,10 +918,108 @@ bool CMusicDatabase::AddAlbum(CAlbum& album, int idSource)
                       albumdateadded.c_str(), strIDs.c_str(), albumdateadded.c_str());
   m_pDS->exec(strSQL);
 
+  if (!m_bulkImport)
+    CommitTransaction();
+  return true;
+}
+
+bool CMusicDatabase::AddAlbums(std::vector<CAlbum>& albums, int idSource)
+{
+  if (albums.empty())
+    return true;
+
+  if (nullptr == m_pDB || nullptr == m_pDS)
+    return false;
+
+  const auto start = std::chrono::steady_clock::now();
+
+  BeginTransaction();
+  SetLibraryLastUpdated();
+
+  m_bulkImport = true;
+  bool result = true;
+  size_t numSongs = 0;
+  try
+  {
+    for (auto& album : albums)
+    {
+      if (!AddAlbum(album, idSource))
+        result = false;
+      numSongs += album.songs.size();
+    }
+    if (!FlushPendingSongLinks())
+      result = false;
+  }
+  catch (...)
+  {
+    CLog::LogF(LOGERROR, "failed to add {} albums", albums.size());
+    result = false;
+  }
+  m_bulkImport = false;
+  m_artistCache.clear();
+  m_pendingSongArtists.clear();
+  m_pendingSongGenres.clear();
+
+  if (!result)
+  {
+    RollbackTransaction();
+    // the cached genre, path and role ids may have been added by the rolled back transaction
+    EmptyCache();
+    return false;
+  }
+
   CommitTransaction();
+
+  const auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::steady_clock::now() - start);
+  CLog::LogFC(LOGDEBUG, LOGDATABASE, "Added {} albums with {} songs in {} ms", albums.size(),
+              numSongs, duration.count());
   return true;
 }
 
+bool CMusicDatabase::FlushPendingSongLinks()
+{
+  // Keep single statements at a reasonable size
+  constexpr size_t MAX_ROWS_PER_INSERT = 500;
+
+  bool result = true;
+  for (size_t first = 0; first < m_pendingSongArtists.size(); first += MAX_ROWS_PER_INSERT)
+  {
+    const size_t last = std::min(first + MAX_ROWS_PER_INSERT, m_pendingSongArtists.size());
+    std::string strSQL = "REPLACE INTO song_artist (idArtist, idSong, idRole, strArtist, iOrder) "
+                         "VALUES ";
+    for (size_t i = first; i < last; ++i)
+    {
+      const SongArtistLink& link = m_pendingSongArtists[i];
+      if (i > first)
+        strSQL += ", ";
+      strSQL += PrepareSQL("(%i, %i, %i, '%s', %i)", link.idArtist, link.idSong, link.idRole,
+                           link.strArtist.c_str(), link.iOrder);
+    }
+    if (!ExecuteQuery(strSQL))
+      result = false;
+  }
+  m_pendingSongArtists.clear();
+
+  for (size_t first = 0; first < m_pendingSongGenres.size(); first += MAX_ROWS_PER_INSERT)
+  {
+    const size_t last = std::min(first + MAX_ROWS_PER_INSERT, m_pendingSongGenres.size());
+    std::string strSQL = "INSERT INTO song_genre (idGenre, idSong, iOrder) VALUES ";
+    for (size_t i = first; i < last; ++i)
+    {
+      const SongGenreLink& link = m_pendingSongGenres[i];
+      if (i > first)
+        strSQL += ", ";
+      strSQL += PrepareSQL("(%i, %i, %i)", link.idGenre, link.idSong, link.iOrder);
+    }
+    if (!ExecuteQuery(strSQL))
+      result = false;
+  }
+  m_pendingSongGenres.clear();
+
+  return result;
+}
+
 bool CMusicDatabase::UpdateAlbum(CAlbum& album)
 {
   BeginTransaction();
@@ -1826,8 +1940,22 @@ int CMusicDatabase::AddArtist(const std::string& strArtist,
                               const std::string& strSortName,
                               bool bScrapedMBID /* = false*/)
 {
+  // Within a bulk import the same artist is resolved with identical values over and over again,
+  // once done the lookup (and any update of the artist) would not change anything
+  std::string cacheKey;
+  if (m_bulkImport)
+  {
+    cacheKey = StringUtils::Format("{}\x1f{}\x1f{}\x1f{}", strMusicBrainzArtistID,
+                                   StringUtils::ToLower(strArtist), strSortName, bScrapedMBID);
+    const auto it = m_artistCache.find(cacheKey);
+    if (it != m_artistCache.end())
+      return it->second;
+  }
+
   std::string strSQL;
   int idArtist = AddArtist(strArtist, strMusicBrainzArtistID, bScrapedMBID);
+  if (idArtist >= 0 && m_bulkImport)
+    m_artistCache.try_emplace(cacheKey, idArtist);
   if (idArtist < 0 || strSortName.empty())
     return idArtist;
 
@@ -2493,6 +2621,11 @@ int CMusicDatabase::AddRole(std::string_view strRole)
       return -1;
     if (nullptr == m_pDS)
       return -1;
+
+    auto it = m_roleCache.find(strRole);
+    if (it != m_roleCache.end())
+      return it->second;
+
     strSQL = PrepareSQL("SELECT idRole FROM role WHERE strRole LIKE '%s'", strRole.data());
     m_pDS->query(strSQL);
     if (m_pDS->num_rows() > 0)
@@ -2506,6 +2639,7 @@ int CMusicDatabase::AddRole(std::string_view strRole)
       idRole = static_cast<int>(m_pDS->lastinsertid());
       m_pDS->close();
     }
+    m_roleCache.try_emplace(std::string(strRole), idRole);
   }
   catch (...)
   {
@@ -2524,6 +2658,13 @@ bool CMusicDatabase::AddSongArtist(
 bool CMusicDatabase::AddSongArtist(
     int idArtist, int idSong, int idRole, std::string_view strArtist, int iOrder)
 {
+  if (m_bulkImport)
+  {
+    m_pendingSongArtists.emplace_back(
+        SongArtistLink{idArtist, idSong, idRole, std::string(strArtist), iOrder});
+    return true;
+  }
+
   std::string strSQL;
   strSQL = PrepareSQL("REPLACE INTO song_artist (idArtist, idSong, idRole, strArtist, iOrder) "
                       "VALUES(%i, %i, %i,'%s', %i)",
@@ -2550,6 +2691,17 @@ int CMusicDatabase::AddSongContributor(int idSong,
     int idArtist = -1;
     // Add artist. As we only have name (no MBID) first try to identify artist from song
     // as they may have already been added with a different role (including MBID).
+    if (m_bulkImport)
+    {
+      const auto it = std::ranges::find_if(
+          m_pendingSongArtists, [idSong, &strArtist](const SongArtistLink& link)
+          { return link.idSong == idSong && StringUtils::EqualsNoCase(link.strArtist, strArtist); });
+      if (it != m_pendingSongArtists.end())
+      {
+        AddSongArtist(it->idArtist, idSong, strRole, strArtist, 0);
+        return it->idArtist;
+      }
+    }
     strSQL =
         PrepareSQL("SELECT idArtist FROM song_artist WHERE idSong = %i AND strArtist LIKE '%s' ",
                    idSong, strArtist.c_str());
@@ -2670,6 +2822,8 @@ bool CMusicDatabase::GetRolesByArtist(int idArtist, CFileItem* item)
 
 bool CMusicDatabase::DeleteSongArtistsBySong(int idSong)
 {
+  std::erase_if(m_pendingSongArtists,
+                [idSong](const SongArtistLink& link) { return link.idSong == idSong; });
   return ExecuteQuery(PrepareSQL("DELETE FROM song_artist WHERE idSong = %i", idSong));
 }
 
@@ -2702,11 +2856,23 @@ bool CMusicDatabase::AddSongGenres(int idSong, const std::vector<std::string>& g
     strSQL = PrepareSQL("DELETE FROM song_genre WHERE idSong = %i", idSong);
     if (!ExecuteQuery(strSQL))
       return false;
+    std::erase_if(m_pendingSongGenres,
+                  [idSong](const SongGenreLink& link) { return link.idSong == idSong; });
     unsigned int index = 0;
     std::vector<std::string> modgenres = genres;
     for (auto& strGenre : modgenres)
     {
       int idGenre = AddGenre(strGenre); // Genre string trimmed and matched case-insensitively
+      if (m_bulkImport)
+      {
+        // Skip duplicates, the link table only allows one entry per song and genre
+        if (std::ranges::none_of(m_pendingSongGenres,
+                                 [idSong, idGenre](const SongGenreLink& link)
+                                 { return link.idSong == idSong && link.idGenre == idGenre; }))
+          m_pendingSongGenres.emplace_back(
+              SongGenreLink{idGenre, idSong, static_cast<int>(index++)});
+        continue;
+      }
       strSQL = PrepareSQL("INSERT INTO song_genre (idGenre, idSong, iOrder) VALUES(%i,%i,%i)",
                           idGenre, idSong, index++);
       if (!ExecuteQuery(strSQL))
@@ -4129,6 +4295,7 @@ void CMusicDatabase::EmptyCache()
 {
   m_genreCache.erase(m_genreCache.begin(), m_genreCache.end());
   m_pathCache.erase(m_pathCache.begin(), m_pathCache.end());
+  m_roleCache.erase(m_roleCache.begin(), m_roleCache.end());
 }
 
 bool CMusicDatabase::Search(const std::string& search, CFileItemList& items)
@@ -4557,6 +4724,7 @@ bool CMusicDatabase::CleanupRoles()
     std::string strSQL = "DELETE FROM role "
                          "WHERE idRole > 1 AND idRole NOT IN (SELECT idRole FROM song_artist)";
     m_pDS->exec(strSQL);
+    m_roleCache.clear();
     return true;
   }
   catch (...)
@@ -11857,6 +12025,31 @@ void CMusicDatabase::ExportToXML(const CLibExportSettings& settings,
     if (nullptr == m_pDS2)
       return;
 
+    // The single file export is written incrementally, each item is flushed once it's complete
+    std::string xmlFile;
+    CXMLStreamWriter xmlWriter;
+    if (settings.IsSingleFile())
+    {
+      xmlFile = URIUtils::AddFileToFolder(
+          strFolder, "kodi_musicdb" + CDateTime::GetCurrentDateTime().GetAsDBDate() + ".xml");
+      if (CFile::Exists(xmlFile))
+        xmlFile = URIUtils::AddFileToFolder(
+            strFolder, "kodi_musicdb" + CDateTime::GetCurrentDateTime().GetAsSaveString() + ".xml");
+      if (!xmlWriter.Open(xmlFile, "musicdb"))
+      {
+        CGUIDialogKaiToast::QueueNotification(
+            CGUIDialogKaiToast::Error,
+            CServiceBroker::GetResourcesComponent().GetLocalizeStrings().Get(20302),
+            CURL::GetRedacted(xmlFile));
+        return;
+      }
+    }
+
+    // Artwork is copied out of the texture cache in the background
+    CTextureExportQueue artQueue;
+    const auto startTime = std::chrono::steady_clock::now();
+    unsigned int itemCount = 0;
+
     // Create our xml document
     CXBMCTinyXML xmlDoc;
     TiXmlDeclaration decl("1.0", "UTF-8", "yes");
@@ -11906,6 +12099,8 @@ void CMusicDatabase::ExportToXML(const CLibExportSettings& settings,
         {
           // Save album to xml, including album path
           album.Save(pMain, "album", strAlbumPath);
+          xmlWriter.Flush(*pMain);
+          itemCount++;
         }
         else
         { // Separate files and artwork
@@ -11966,6 +12161,7 @@ void CMusicDatabase::ExportToXML(const CLibExportSettings& settings,
             {
               // Save album to NFO, including album path
               album.Save(pMain, "album", strAlbumPath);
+              itemCount++;
               std::string nfoFile = URIUtils::AddFileToFolder(strPath, "album.nfo");
               if (settings.IsOverwrite() || !CFile::Exists(nfoFile))
               {
@@ -11994,8 +12190,7 @@ void CMusicDatabase::ExportToXML(const CLibExportSettings& settings,
                     savedArtfile = URIUtils::AddFileToFolder(strPath, "folder");
                   else
                     savedArtfile = URIUtils::AddFileToFolder(strPath, type);
-                  CServiceBroker::GetTextureCache()->Export(url, savedArtfile,
-                                                            settings.IsOverwrite());
+                  artQueue.Export(url, savedArtfile, settings.IsOverwrite());
                 }
               }
             }
@@ -12018,7 +12213,7 @@ void CMusicDatabase::ExportToXML(const CLibExportSettings& settings,
     // Export song playback history to single file only
     if (settings.IsSingleFile() && settings.IsItemExported(ELIBEXPORT_SONGS))
     {
-      if (!ExportSongHistory(pMain, progressDialog))
+      if (!ExportSongHistory(pMain, progressDialog, &xmlWriter))
         return;
     }
 
@@ -12088,6 +12283,8 @@ void CMusicDatabase::ExportToXML(const CLibExportSettings& settings,
               XMLUtils::SetString(&additionalNode, type.c_str(), url);
             pMain->LastChild()->InsertEndChild(additionalNode);
           }
+          xmlWriter.Flush(*pMain);
+          itemCount++;
         }
         else
         { // Separate files: artist.nfo and artwork in strFolder/<artist name>
@@ -12110,6 +12307,7 @@ void CMusicDatabase::ExportToXML(const CLibExportSettings& settings,
               if (!settings.IsSkipNfo())
               {
                 artist.Save(pMain, "artist", strPath);
+                itemCount++;
                 std::string nfoFile = URIUtils::AddFileToFolder(strPath, "artist.nfo");
                 if (settings.IsOverwrite() || !CFile::Exists(nfoFile))
                 {
@@ -12135,8 +12333,7 @@ void CMusicDatabase::ExportToXML(const CLibExportSettings& settings,
                       savedArtfile = URIUtils::AddFileToFolder(strPath, "folder");
                     else
                       savedArtfile = URIUtils::AddFileToFolder(strPath, type);
-                    CServiceBroker::GetTextureCache()->Export(url, savedArtfile,
-                                                              settings.IsOverwrite());
+                    artQueue.Export(url, savedArtfile, settings.IsOverwrite());
                   }
                 }
               }
@@ -12156,14 +12353,23 @@ void CMusicDatabase::ExportToXML(const CLibExportSettings& settings,
       }
     }
 
+    artQueue.Wait();
+    const std::chrono::duration<double> elapsed{std::chrono::steady_clock::now() - startTime};
+    const double seconds = std::max(elapsed.count(), 0.001);
+    CLog::Log(LOGINFO,
+              "Music library export: {} items, {} images exported ({} skipped), {} bytes of XML "
+              "in {:.1f} s ({:.1f} items/s, {:.2f} MB/s)",
+              itemCount, artQueue.GetExportedCount(), artQueue.GetSkippedCount(),
+              xmlWriter.GetBytesWritten(), elapsed.count(), itemCount / seconds,
+              xmlWriter.GetBytesWritten() / 1048576.0 / seconds);
+
     if (settings.IsSingleFile())
     {
-      std::string xmlFile = URIUtils::AddFileToFolder(
-          strFolder, "kodi_musicdb" + CDateTime::GetCurrentDateTime().GetAsDBDate() + ".xml");
-      if (CFile::Exists(xmlFile))
-        xmlFile = URIUtils::AddFileToFolder(
-            strFolder, "kodi_musicdb" + CDateTime::GetCurrentDateTime().GetAsSaveString() + ".xml");
-      xmlDoc.SaveFile(xmlFile);
+      if (!xmlWriter.Close())
+      {
+        CLog::LogF(LOGERROR, "Music library export failed! ('{}')", xmlFile);
+        iFailCount++;
+      }
 
       CVariant data;
       data["file"] = xmlFile;
@@ -12189,7 +12395,9 @@ void CMusicDatabase::ExportToXML(const CLibExportSettings& settings,
             CServiceBroker::GetResourcesComponent().GetLocalizeStrings().Get(15011), iFailCount)});
 }
 
-bool CMusicDatabase::ExportSongHistory(TiXmlNode* pNode, CGUIDialogProgress* progressDialog)
+bool CMusicDatabase::ExportSongHistory(TiXmlNode* pNode,
+                                       CGUIDialogProgress* progressDialog /* = nullptr */,
+                                       CXMLStreamWriter* writer /* = nullptr */)
 {
   try
   {
@@ -12234,6 +12442,8 @@ bool CMusicDatabase::ExportSongHistory(TiXmlNode* pNode, CGUIDialogProgress* pro
       auto* userrating = XMLUtils::SetInt(song, "userrating", m_pDS->fv("userrating").get_asInt());
       if (userrating)
         userrating->ToElement()->SetAttribute("max", 10);
+      if (writer)
+        writer->Flush(*pNode);
 
       if ((current % 100) == 0 && progressDialog)
       {
@@ -12268,37 +12478,24 @@ void CMusicDatabase::ImportFromXML(const std::string& xmlFile, CGUIDialogProgres
     if (nullptr == m_pDS)
       return;
 
-    CXBMCTinyXML xmlDoc;
-    if (!xmlDoc.LoadFile(xmlFile) && progressDialog)
+    // Read the file one top level element at a time instead of loading it as a whole
+    CXMLStreamReader reader;
+    if (!reader.Open(xmlFile))
     {
-      HELPERS::ShowOKDialogLines(CVariant{20197}, CVariant{38354}); //"Unable to read xml file"
+      if (progressDialog)
+        HELPERS::ShowOKDialogLines(CVariant{20197}, CVariant{38354}); //"Unable to read xml file"
       return;
     }
 
-    TiXmlElement* root = xmlDoc.RootElement();
-    if (!root)
-      return;
-
-    TiXmlElement* entry = root->FirstChildElement();
+    CXBMCTinyXML xmlDoc;
+    const auto startTime = std::chrono::steady_clock::now();
     int current = 0;
-    int total = 0;
     int songtotal = 0;
-    // Count the number of artists, albums and songs
-    while (entry)
-    {
-      if (StringUtils::CompareNoCase(entry->Value(), "artist", 6) == 0 ||
-          StringUtils::CompareNoCase(entry->Value(), "album", 5) == 0)
-        total++;
-      else if (StringUtils::CompareNoCase(entry->Value(), "song", 4) == 0)
-        songtotal++;
-
-      entry = entry->NextSiblingElement();
-    }
 
     BeginTransaction();
-    entry = root->FirstChildElement();
-    while (entry)
+    while (reader.ReadNextElement(xmlDoc))
     {
+      const TiXmlElement* entry = xmlDoc.RootElement();
       std::string strTitle;
       if (StringUtils::CompareNoCase(entry->Value(), "artist", 6) == 0)
       {
@@ -12340,10 +12537,13 @@ void CMusicDatabase::ImportFromXML(const std::string& xmlFile, CGUIDialogProgres
 
         current++;
       }
-      entry = entry->NextSiblingElement();
-      if (progressDialog && total)
+      else if (StringUtils::CompareNoCase(entry->Value(), "song", 4) == 0)
+        songtotal++;
+
+      if (progressDialog && reader.GetLength() > 0)
       {
-        progressDialog->SetPercentage(current * 100 / total);
+        progressDialog->SetPercentage(
+            static_cast<int>(reader.GetPosition() * 100 / reader.GetLength()));
         progressDialog->SetLine(2, CVariant{std::move(strTitle)});
         progressDialog->Progress();
         if (progressDialog->IsCanceled())
@@ -12353,8 +12553,21 @@ void CMusicDatabase::ImportFromXML(const std::string& xmlFile, CGUIDialogProgres
         }
       }
     }
+    if (reader.HasError())
+    {
+      RollbackTransaction();
+      if (progressDialog)
+        HELPERS::ShowOKDialogLines(CVariant{20197}, CVariant{38354}); //"Unable to read xml file"
+      return;
+    }
     CommitTransaction();
 
+    const std::chrono::duration<double> elapsed{std::chrono::steady_clock::now() - startTime};
+    CLog::Log(LOGINFO,
+              "Music library import: {} items, {} bytes of XML in {:.1f} s ({:.1f} items/s)",
+              current, reader.GetPosition(), elapsed.count(),
+              current / std::max(elapsed.count(), 0.001));
+
     // Import song playback history <song> entries found
     if (songtotal > 0)
       if (!ImportSongHistory(xmlFile, songtotal, progressDialog))
@@ -12383,12 +12596,8 @@ bool CMusicDatabase::ImportSongHistory(const std::string& xmlFile,
   bool bHistSongExists = false;
   try
   {
-    CXBMCTinyXML xmlDoc;
-    if (!xmlDoc.LoadFile(xmlFile))
-      return false;
-
-    TiXmlElement* root = xmlDoc.RootElement();
-    if (!root)
+    CXMLStreamReader reader;
+    if (!reader.Open(xmlFile))
       return false;
 
     if (progressDialog)
@@ -12401,9 +12610,10 @@ bool CMusicDatabase::ImportSongHistory(const std::string& xmlFile,
     // Convert xml entries into a SQL bulk insert statement
     std::string strSQL;
     int current = 0;
-    TiXmlElement* entry = root->FirstChildElement();
-    while (entry)
+    CXBMCTinyXML xmlDoc;
+    while (reader.ReadNextElement(xmlDoc, "song"))
     {
+      const TiXmlElement* entry = xmlDoc.RootElement();
       std::string strArtistDisp;
       std::string strTitle;
       int iTrack;
@@ -12483,8 +12693,6 @@ bool CMusicDatabase::ImportSongHistory(const std::string& xmlFile,
         current++;
       }
 
-      entry = entry->NextSiblingElement();
-
       if ((current % 100) == 0 && progressDialog)
       {
         progressDialog->SetPercentage(current * 100 / total);
@@ -12494,6 +12702,8 @@ bool CMusicDatabase::ImportSongHistory(const std::string& xmlFile,
           return false;
       }
     }
+    if (reader.HasError())
+      return false;
 
     CLog::Log(LOGINFO, "Create temporary HistSong table and insert {} records", total);
     /* Can not use CREATE TEMPORARY TABLE as MySQL does not support updates of
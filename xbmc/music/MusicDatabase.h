@@ -36,6 +36,7 @@ class CMediaSource;
 class CMusicDbUrl;
 class CMusicRole;
 class CSong;
+class CXMLStreamWriter;
 enum class ReleaseType;
 class ReplayGain;
 class TiXmlNode;
@@ -265,6 +266,15 @@ public:
   */
   bool AddAlbum(CAlbum& album, int idSource);
 
+  /*! \brief Add a batch of albums (e.g. all albums found in a folder) and their songs
+  Everything is written in a single transaction, artist lookups are cached for the duration
+  of the batch and song artist and genre links are written using multi-row inserts.
+  \param albums the albums to add, on return the album, song and artist ids are set
+  \param idSource the music source id
+  \return true if all albums were added
+  */
+  bool AddAlbums(std::vector<CAlbum>& albums, int idSource);
+
   /*! \brief Update an album and all its nested entities (artists, songs etc)
    \param album the album to update
    \return true or false
@@ -702,7 +712,9 @@ public:
   /////////////////////////////////////////////////
   void ExportToXML(const CLibExportSettings& settings,
                    CGUIDialogProgress* progressDialog = nullptr);
-  bool ExportSongHistory(TiXmlNode* pNode, CGUIDialogProgress* progressDialog = nullptr);
+  bool ExportSongHistory(TiXmlNode* pNode,
+                         CGUIDialogProgress* progressDialog = nullptr,
+                         CXMLStreamWriter* writer = nullptr);
   void ImportFromXML(const std::string& xmlFile, CGUIDialogProgress* progressDialog = nullptr);
   bool ImportSongHistory(const std::string& xmlFile,
                          const int total,
@@ -974,8 +986,36 @@ private:
   */
   bool MigrateSources();
 
+  /*! \brief Write the song artist and song genre links queued during a bulk import
+  \return true if all queued links were written
+  \sa AddAlbums
+  */
+  bool FlushPendingSongLinks();
+
+  struct SongArtistLink
+  {
+    int idArtist;
+    int idSong;
+    int idRole;
+    std::string strArtist;
+    int iOrder;
+  };
+
+  struct SongGenreLink
+  {
+    int idGenre;
+    int idSong;
+    int iOrder;
+  };
+
   std::map<std::string, int, std::less<>> m_genreCache;
   std::map<std::string, int, std::less<>> m_pathCache;
+  std::map<std::string, int, std::less<>> m_roleCache;
+
+  bool m_bulkImport{false}; ///< True while AddAlbums() is adding a batch of albums
+  std::map<std::string, int, std::less<>> m_artistCache; ///< Artist ids resolved by the batch
+  std::vector<SongArtistLink> m_pendingSongArtists;
+  std::vector<SongGenreLink> m_pendingSongGenres;
   bool m_translateBlankArtist{true};
 
   // Fields should be ordered as they
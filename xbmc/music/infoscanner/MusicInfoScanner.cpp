@@ -12,6 +12,8 @@
 #include "FileItemList.h"
 #include "GUIInfoManager.h"
 #include "GUIUserMessages.h"
+#include "InfoScannerWorkerPool.h"
+#include "LibraryChangeJournal.h"
 #include "MusicAlbumInfo.h"
 #include "MusicInfoScraper.h"
 #include "NfoFile.h"
@@ -50,6 +52,7 @@
 #include "settings/AdvancedSettings.h"
 #include "settings/Settings.h"
 #include "settings/SettingsComponent.h"
+#include "threads/Event.h"
 #include "utils/Digest.h"
 #include "utils/FileExtensionProvider.h"
 #include "utils/FileUtils.h"
@@ -59,6 +62,8 @@
 #include "utils/log.h"
 
 #include <algorithm>
+#include <atomic>
+#include <memory>
 #include <string_view>
 #include <utility>
 
@@ -69,6 +74,18 @@ using namespace MUSICDATABASEDIRECTORY;
 using namespace MUSIC_GRABBER;
 using namespace ADDON;
 using KODI::UTILITY::CDigest;
+using namespace std::chrono_literals;
+
+namespace
+{
+// Upper bound for directory listings read ahead of the scan
+constexpr size_t MAX_PREFETCHED_DIRECTORIES = 256;
+} // unnamed namespace
+
+struct CMusicInfoScanner::DirectoryListing : CInfoScannerPrefetch
+{
+  CFileItemList items;
+};
 
 CMusicInfoScanner::CMusicInfoScanner()
 : m_fileCountReader(this, "MusicFileCounter")
@@ -120,6 +137,20 @@ void CMusicInfoScanner::Process()
       // Reset progress vars
       m_currentItem=0;
       m_itemCount=-1;
+      m_filesRead = 0;
+      m_directoriesListed = 0;
+
+      // Directory listings and tag reading are latency bound on network shares, run them on a
+      // pool of workers. The database is only written from this thread.
+      const auto& advancedSettings = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings();
+      m_workers = std::make_unique<CInfoScannerWorkerPool>(
+          "MusicScanWorker", advancedSettings->m_musicLibraryScannerThreads,
+          advancedSettings->m_musicLibraryScannerThreadsPerShare);
+
+      // watch local sources, so the next update only needs to look at folders that changed
+      CLibraryChangeJournal& journal = CServiceBroker::GetLibraryChangeJournal();
+      for (const auto& path : m_pathsToScan)
+        journal.Watch(path);
 
       // Create the thread to count all files to be scanned
       if (m_handle)
@@ -200,14 +231,18 @@ void CMusicInfoScanner::Process()
       }
 
       m_fileCountReader.StopThread();
+      m_workers.reset();
+      m_prefetchedDirs.clear();
+      journal.Save();
 
       m_musicDatabase.EmptyCache();
 
-      auto elapsed =
-          std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now() - tick);
+      const std::chrono::duration<double> elapsed{std::chrono::steady_clock::now() - tick};
       CLog::Log(LOGINFO,
-                "My Music: Scanning for music info using worker thread, operation took {}s",
-                elapsed.count());
+                "My Music: Scanning for music info using worker thread, operation took {:.0f}s, "
+                "{} directories listed, {} files read ({:.1f} files/s)",
+                elapsed.count(), m_directoriesListed, m_filesRead,
+                m_filesRead / std::max(elapsed.count(), 0.001));
     }
     if (m_scanType == 1) // load album info
     {
@@ -501,22 +536,58 @@ bool CMusicInfoScanner::DoScan(const std::string& strDirectory)
     return true;
 
   if (HasNoMedia(strDirectory))
+  {
+    ReleasePrefetchedListing(strDirectory);
     return true;
+  }
 
-  // load subfolder
-  CFileItemList items;
-  CDirectory::GetDirectory(strDirectory, items, CServiceBroker::GetFileExtensionProvider().GetMusicExtensions() + "|.jpg|.tbn|.lrc|.cdg", DIR_FLAG_DEFAULTS);
+  CLibraryChangeJournal& journal = CServiceBroker::GetLibraryChangeJournal();
+  const uint64_t sequence = journal.GetSequence();
 
-  // sort and get the path hash.  Note that we don't filter .cue sheet items here as we want
-  // to detect changes in the .cue sheet as well.  The .cue sheet items only need filtering
-  // if we have a changed hash.
-  items.Sort(SortBy::LABEL, SortOrder::ASCENDING);
+  CFileItemList items;
   std::string hash;
-  GetPathHash(items, hash);
+  std::string dbHash;
+  const bool hasDbHash = m_musicDatabase.GetPathHash(strDirectory, dbHash);
+
+  CLibraryChangeJournal::DirectoryState state;
+  const bool unchanged = !(m_flags & SCAN_RESCAN) && hasDbHash &&
+                         journal.GetUnchanged(strDirectory, state) &&
+                         StringUtils::EqualsNoCase(state.hash, dbHash);
+  if (unchanged)
+  {
+    // not changed since it was last scanned - no need to touch the folder
+    ReleasePrefetchedListing(strDirectory);
+    hash = dbHash;
+    for (const auto& subdirectory : state.subdirectories)
+      items.Add(std::make_shared<CFileItem>(subdirectory, true));
+  }
+  else
+  {
+    // load subfolder
+    if (!GetDirectory(strDirectory, items))
+      return false;
+
+    // sort and get the path hash.  Note that we don't filter .cue sheet items here as we want
+    // to detect changes in the .cue sheet as well.  The .cue sheet items only need filtering
+    // if we have a changed hash.
+    items.Sort(SortBy::LABEL, SortOrder::ASCENDING);
+    GetPathHash(items, hash);
+
+    CLibraryChangeJournal::DirectoryState scanned{
+        hash, {}, static_cast<unsigned int>(CountFiles(items, false))};
+    for (const auto& pItem : items)
+    {
+      if (pItem->IsFolder() && !pItem->IsParentFolder() && !PLAYLIST::IsPlayList(*pItem))
+        scanned.subdirectories.emplace_back(pItem->GetPath());
+    }
+    state = std::move(scanned);
+  }
+
+  // start reading the listings of the subfolders while this one is processed
+  PrefetchDirectories(items);
 
   // check whether we need to rescan or not
-  std::string dbHash;
-  if ((m_flags & SCAN_RESCAN) || !m_musicDatabase.GetPathHash(strDirectory, dbHash) || !StringUtils::EqualsNoCase(dbHash, hash))
+  if ((m_flags & SCAN_RESCAN) || !hasDbHash || !StringUtils::EqualsNoCase(dbHash, hash))
   { // path has changed - rescan
     if (dbHash.empty())
       CLog::Log(LOGDEBUG, "{} Scanning dir '{}' as not in the database", __FUNCTION__,
@@ -545,9 +616,9 @@ bool CMusicInfoScanner::DoScan(const std::string& strDirectory)
   }
   else
   { // path is the same - no need to rescan
-    CLog::Log(LOGDEBUG, "{} Skipping dir '{}' due to no change", __FUNCTION__,
-              CURL::GetRedacted(strDirectory));
-    m_currentItem += CountFiles(items, false);  // false for non-recursive
+    CLog::Log(LOGDEBUG, "{} Skipping dir '{}' due to no change{}", __FUNCTION__,
+              CURL::GetRedacted(strDirectory), unchanged ? " (journal)" : "");
+    m_currentItem += state.files;
 
     // updated the dialog with our progress
     if (m_handle)
@@ -558,6 +629,9 @@ bool CMusicInfoScanner::DoScan(const std::string& strDirectory)
     }
   }
 
+  if (!unchanged && !m_bStop)
+    journal.SetScanned(strDirectory, sequence, std::move(state));
+
   // now scan the subfolders
   for (int i = 0; i < items.Size(); ++i)
   {
@@ -584,11 +658,11 @@ CInfoScanner::InfoRet CMusicInfoScanner::ScanTags(const CFileItemList& items,
   std::vector<std::string> regexps =
       CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_audioExcludeFromScanRegExps;
 
+  // Select the files to read tags from
+  std::vector<CFileItemPtr> files;
+  files.reserve(items.Size());
   for (int i = 0; i < items.Size(); ++i)
   {
-    if (m_bStop)
-      return InfoRet::CANCELLED;
-
     CFileItemPtr pItem = items[i];
 
     if (CUtil::ExcludeFileOrFolder(pItem->GetPath(), regexps, &m_regexpCache))
@@ -598,21 +672,69 @@ CInfoScanner::InfoRet CMusicInfoScanner::ScanTags(const CFileItemList& items,
         MUSIC::IsLyrics(*pItem))
       continue;
 
-    m_currentItem++;
+    files.emplace_back(std::move(pItem));
+  }
+
+  // Read the tags concurrently. Forced rescan must re-read tags from disk even if the item
+  // arrives with tag.Loaded() already true (e.g. DB-enriched directory listings). The
+  // folder-level SCAN_RESCAN check in DoScan bypasses the path-hash skip, but without this
+  // check ScanTags would still reuse cached tag state on a per-file basis, defeating "Do full
+  // tag scan even when unchanged".
+  struct TagReads
+  {
+    std::atomic<int> pending{0};
+    std::atomic<int> completed{0};
+    CEvent done{true};
+  };
+  const auto reads = std::make_shared<TagReads>();
+  for (const auto& pItem : files)
+  {
+    if (pItem->GetMusicInfoTag()->Loaded() && !(m_flags & SCAN_RESCAN))
+      continue;
+
+    if (!m_workers)
+    {
+      LoadTag(*pItem);
+      continue;
+    }
+
+    reads->pending++;
+    m_workers->Submit(pItem->GetPath(),
+                      [reads, pItem]()
+                      {
+                        LoadTag(*pItem);
+                        reads->completed++;
+                        if (--reads->pending == 0)
+                          reads->done.Set();
+                      });
+  }
 
-    CMusicInfoTag& tag = *pItem->GetMusicInfoTag();
-    // Forced rescan must re-read tags from disk even if the item arrives with
-    // tag.Loaded() already true (e.g. DB-enriched directory listings). The
-    // folder-level SCAN_RESCAN check above (line 521) bypasses the path-hash
-    // skip, but without this check ScanTags would still reuse cached tag
-    // state on a per-file basis, defeating "Do full tag scan even when
-    // unchanged".
-    if (!tag.Loaded() || (m_flags & SCAN_RESCAN))
+  if (reads->pending > 0)
+  {
+    while (!reads->done.Wait(100ms))
     {
-      std::unique_ptr<IMusicInfoTagLoader> pLoader (CMusicInfoTagLoaderFactory::CreateLoader(*pItem));
-      if (nullptr != pLoader)
-        pLoader->Load(pItem->GetPath(), tag);
+      if (m_bStop)
+      {
+        m_workers->Cancel();
+        return InfoRet::CANCELLED;
+      }
+
+      if (m_handle && m_itemCount > 0)
+        m_handle->SetPercentage(static_cast<float>((m_currentItem + reads->completed) * 100) /
+                                static_cast<float>(m_itemCount));
     }
+  }
+  m_filesRead += files.size();
+
+  // Collect the results in directory order
+  for (const auto& pItem : files)
+  {
+    if (m_bStop)
+      return InfoRet::CANCELLED;
+
+    m_currentItem++;
+
+    const CMusicInfoTag& tag = *pItem->GetMusicInfoTag();
 
     if (m_handle && m_itemCount>0)
       m_handle->SetPercentage(static_cast<float>(m_currentItem * 100) / static_cast<float>(m_itemCount));
@@ -636,6 +758,96 @@ CInfoScanner::InfoRet CMusicInfoScanner::ScanTags(const CFileItemList& items,
   return InfoRet::ADDED;
 }
 
+void CMusicInfoScanner::LoadTag(CFileItem& item)
+{
+  std::unique_ptr<IMusicInfoTagLoader> pLoader(CMusicInfoTagLoaderFactory::CreateLoader(item));
+  if (nullptr != pLoader)
+    pLoader->Load(item.GetPath(), *item.GetMusicInfoTag());
+}
+
+bool CMusicInfoScanner::GetDirectory(const std::string& strDirectory, CFileItemList& items)
+{
+  m_directoriesListed++;
+
+  const auto it = m_prefetchedDirs.find(strDirectory);
+  if (it != m_prefetchedDirs.end())
+  {
+    const std::shared_ptr<DirectoryListing> listing = it->second;
+    m_prefetchedDirs.erase(it);
+
+    // read it here if no worker got to it yet
+    if (!listing->Start())
+    {
+      if (!listing->Wait([this]() { return m_bStop; }))
+        return false;
+      items.Assign(listing->items);
+      return true;
+    }
+  }
+
+  CDirectory::GetDirectory(strDirectory, items,
+                           CServiceBroker::GetFileExtensionProvider().GetMusicExtensions() +
+                               "|.jpg|.tbn|.lrc|.cdg",
+                           DIR_FLAG_DEFAULTS);
+  return true;
+}
+
+void CMusicInfoScanner::ReleasePrefetchedListing(const std::string& strDirectory)
+{
+  const auto it = m_prefetchedDirs.find(strDirectory);
+  if (it == m_prefetchedDirs.end())
+    return;
+
+  // a worker that didn't start reading it yet skips it
+  it->second->Start();
+  m_prefetchedDirs.erase(it);
+}
+
+void CMusicInfoScanner::PrefetchDirectories(const CFileItemList& items)
+{
+  if (!m_workers)
+    return;
+
+  const std::vector<std::string>& regexps =
+      CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_audioExcludeFromScanRegExps;
+  const std::string extensions =
+      CServiceBroker::GetFileExtensionProvider().GetMusicExtensions() + "|.jpg|.tbn|.lrc|.cdg";
+
+  for (const auto& pItem : items)
+  {
+    if (m_prefetchedDirs.size() >= MAX_PREFETCHED_DIRECTORIES)
+      break;
+
+    if (!pItem->IsFolder() || pItem->IsParentFolder() || PLAYLIST::IsPlayList(*pItem))
+      continue;
+
+    const std::string& path = pItem->GetPath();
+    if (m_seenPaths.contains(path) || m_prefetchedDirs.contains(path) ||
+        CUtil::ExcludeFileOrFolder(path, regexps, &m_regexpCache))
+      continue;
+
+    // the listing is only needed if the folder changed since the last scan
+    std::string dbHash;
+    CLibraryChangeJournal::DirectoryState state;
+    if (!(m_flags & SCAN_RESCAN) && m_musicDatabase.GetPathHash(path, dbHash) &&
+        CServiceBroker::GetLibraryChangeJournal().GetUnchanged(path, state) &&
+        StringUtils::EqualsNoCase(state.hash, dbHash))
+      continue;
+
+    auto listing = std::make_shared<DirectoryListing>();
+    m_prefetchedDirs.try_emplace(path, listing);
+    m_workers->Submit(path,
+                      [listing, path, extensions]()
+                      {
+                        if (!listing->Start())
+                          return;
+                        CDirectory::GetDirectory(path, listing->items, extensions,
+                                                 DIR_FLAG_DEFAULTS);
+                        listing->Finish();
+                      });
+  }
+}
+
 static bool SortSongsByTrack(const CSong& song, const CSong& song2)
 {
   return song.iTrack < song2.iTrack;
@@ -979,22 +1191,27 @@ int CMusicInfoScanner::RetrieveMusicInfo(const std::string& strDirectory, CFileI
   the library also means that the user can use their library to select music to play sooner.
   */
 
-  int numAdded = 0;
+  if (m_bStop)
+    return 0;
 
-  // Add all albums to the library, and hence any new song or album artists or other contributors
   for (auto& album : albums)
   {
-    if (m_bStop)
-      break;
-
     // mark albums without a title as singles
     if (album.strAlbum.empty())
       album.releaseType = ReleaseType::Single;
 
     album.strPath = strDirectory;
-    m_musicDatabase.AddAlbum(album, m_idSourcePath);
-    m_albumsAdded.insert(album.idAlbum);
+  }
+
+  // Add all albums to the library, and hence any new song or album artists or other contributors,
+  // as one batch so that the whole folder is written in a single transaction
+  if (!m_musicDatabase.AddAlbums(albums, m_idSourcePath))
+    return 0;
 
+  int numAdded = 0;
+  for (const auto& album : albums)
+  {
+    m_albumsAdded.insert(album.idAlbum);
     numAdded += static_cast<int>(album.songs.size());
   }
   return numAdded;
@@ -2380,6 +2597,20 @@ int CMusicInfoScanner::CountFilesRecursively(const std::string& strPath, int dep
     return 0;
   }
 
+  // folders that didn't change since they were last scanned don't need to be listed
+  CLibraryChangeJournal::DirectoryState state;
+  if (CServiceBroker::GetLibraryChangeJournal().GetUnchanged(strPath, state))
+  {
+    int count = static_cast<int>(state.files);
+    for (const auto& subdirectory : state.subdirectories)
+    {
+      if (m_bStop)
+        return 0;
+      count += CountFilesRecursively(subdirectory, depth + 1);
+    }
+    return count;
+  }
+
   // load subfolder
   CFileItemList items;
   CDirectory::GetDirectory(strPath, items,
@@ -14,12 +14,15 @@
 #include "threads/Thread.h"
 #include "utils/RegExp.h"
 
+#include <map>
+#include <memory>
 #include <string>
 
 class CAlbum;
 class CArtist;
 class CFileItemList;
 class CGUIDialogProgressBarHandle;
+class CInfoScannerWorkerPool;
 class CScraperUrl;
 
 namespace MUSIC_GRABBER
@@ -260,6 +263,26 @@ protected:
    \param scannedItems [in] list to populate with the scannedItems
    */
   InfoRet ScanTags(const CFileItemList& items, CFileItemList& scannedItems);
+
+  /*! \brief Read the tag of a music file into the item's music info tag
+   Called from the scan workers, must not touch the scanner state.
+   */
+  static void LoadTag(CFileItem& item);
+
+  /*! \brief Get the listing of a directory to scan
+   Takes the listing read ahead by PrefetchDirectories() when available, otherwise the directory is
+   read directly.
+   \return false if the scan was stopped while waiting for the listing, true otherwise.
+   */
+  bool GetDirectory(const std::string& strDirectory, CFileItemList& items);
+
+  /*! \brief Drop the listing read ahead for a directory that isn't going to be listed
+   */
+  void ReleasePrefetchedListing(const std::string& strDirectory);
+
+  /*! \brief Start reading the listings of the subfolders in the given items on the scan workers
+   */
+  void PrefetchDirectories(const CFileItemList& items);
   int GetPathHash(const CFileItemList &items, std::string &hash);
 
   void Run() override;
@@ -291,5 +314,11 @@ protected:
   int m_flags;
   CThread m_fileCountReader;
   mutable KODI::REGEXP::RegExpCache m_regexpCache;
+
+  struct DirectoryListing;
+  std::unique_ptr<CInfoScannerWorkerPool> m_workers;
+  std::map<std::string, std::shared_ptr<DirectoryListing>, std::less<>> m_prefetchedDirs;
+  unsigned int m_filesRead{0};
+  unsigned int m_directoriesListed{0};
 };
 }
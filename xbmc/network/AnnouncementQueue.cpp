@@ -0,0 +1,193 @@
+/*
+ *  Copyright (C) 2026 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "AnnouncementQueue.h"
+
+#include "utils/JSONVariantWriter.h"
+#include "utils/Variant.h"
+
+#include <algorithm>
+#include <utility>
+
+using namespace JSONRPC;
+
+CAnnouncementQueue::CAnnouncementQueue(bool compactOutput, size_t maxLength, size_t maxBytes)
+  : m_compactOutput(compactOutput),
+    m_maxLength(maxLength),
+    m_maxBytes(maxBytes)
+{
+}
+
+CAnnouncementQueue::CAnnouncementQueue(const CAnnouncementQueue& queue)
+  : m_compactOutput(queue.m_compactOutput),
+    m_maxLength(queue.m_maxLength),
+    m_maxBytes(queue.m_maxBytes)
+{
+  *this = queue;
+}
+
+CAnnouncementQueue& CAnnouncementQueue::operator=(const CAnnouncementQueue& queue)
+{
+  if (this == &queue)
+    return *this;
+
+  m_entries = queue.m_entries;
+  m_bytes = queue.m_bytes;
+  m_droppedSinceResync = queue.m_droppedSinceResync;
+  m_resyncQueued = queue.m_resyncQueued;
+  m_stats = queue.m_stats;
+  m_compactOutput = queue.m_compactOutput;
+  m_maxLength = queue.m_maxLength;
+  m_maxBytes = queue.m_maxBytes;
+
+  // the index refers to the entries of the other queue, rebuild it the way Push() built it
+  m_coalescable.clear();
+  for (auto it = m_entries.begin(); it != m_entries.end(); ++it)
+  {
+    if (it->key.empty())
+      m_coalescable.clear();
+    else
+      m_coalescable[it->key] = it;
+  }
+
+  return *this;
+}
+
+std::string CAnnouncementQueue::GetCoalescingKey(ANNOUNCEMENT::AnnouncementFlag flag,
+                                                 const std::string& sender,
+                                                 const std::string& message,
+                                                 const CVariant& data)
+{
+  // only notifications which carry the complete new state of what they are about
+  bool supersedes = false;
+  switch (flag)
+  {
+    case ANNOUNCEMENT::VideoLibrary:
+    case ANNOUNCEMENT::AudioLibrary:
+      // an update of a newly added item must still tell the client that it was added
+      supersedes = message == "OnUpdate" && !data["added"].asBoolean();
+      break;
+    case ANNOUNCEMENT::Player:
+      supersedes = message == "OnSeek" || message == "OnSpeedChanged";
+      break;
+    case ANNOUNCEMENT::Application:
+      supersedes = message == "OnVolumeChanged";
+      break;
+    default:
+      break;
+  }
+
+  if (!supersedes)
+    return "";
+
+  std::string key = ANNOUNCEMENT::AnnouncementFlagToString(flag);
+  key += '.';
+  key += message;
+  key += '\n';
+  key += sender;
+
+  std::string value;
+  for (const char* member : {"item", "player"})
+  {
+    if (data.isObject() && data.isMember(member) &&
+        CJSONVariantWriter::Write(data[member], value, true))
+    {
+      key += '\n';
+      key += value;
+    }
+  }
+
+  return key;
+}
+
+bool CAnnouncementQueue::Push(const std::string& key,
+                              std::shared_ptr<const std::string> notification)
+{
+  if (key.empty())
+  {
+    // keep the order of the notifications around one which cannot be replaced
+    m_coalescable.clear();
+  }
+  else
+  {
+    const auto it = m_coalescable.find(key);
+    if (it != m_coalescable.end())
+    {
+      m_bytes = m_bytes - it->second->notification->size() + notification->size();
+      it->second->notification = std::move(notification);
+      m_stats.coalesced++;
+      return true;
+    }
+  }
+
+  if (m_entries.size() >= m_maxLength || m_bytes + notification->size() > m_maxBytes)
+  {
+    m_droppedSinceResync++;
+    m_stats.dropped++;
+    Resync();
+    return false;
+  }
+
+  m_bytes += notification->size();
+  m_entries.push_back({key, std::move(notification)});
+  if (!key.empty())
+    m_coalescable.emplace(key, std::prev(m_entries.end()));
+
+  m_stats.maxDepth = std::max(m_stats.maxDepth, m_entries.size());
+  return true;
+}
+
+std::shared_ptr<const std::string> CAnnouncementQueue::Pop()
+{
+  if (m_entries.empty())
+    return nullptr;
+
+  Entry& entry = m_entries.front();
+  const auto it = m_coalescable.find(entry.key);
+  if (it != m_coalescable.end() && it->second == m_entries.begin())
+    m_coalescable.erase(it);
+
+  if (m_resyncQueued)
+  {
+    // the System.OnResync notification is always the first one
+    m_resyncQueued = false;
+    m_droppedSinceResync = 0;
+  }
+
+  std::shared_ptr<const std::string> notification = std::move(entry.notification);
+  m_bytes -= notification->size();
+  m_entries.pop_front();
+
+  return notification;
+}
+
+void CAnnouncementQueue::Resync()
+{
+  const size_t dropped = m_entries.size() - (m_resyncQueued ? 1 : 0);
+  m_droppedSinceResync += dropped;
+  m_stats.dropped += dropped;
+  m_stats.resyncs++;
+
+  m_entries.clear();
+  m_coalescable.clear();
+  m_bytes = 0;
+
+  // same layout as IJSONRPCAnnouncer::AnnouncementToJSONRPC()
+  CVariant root;
+  root["jsonrpc"] = "2.0";
+  root["method"] = "System.OnResync";
+  root["params"]["data"]["dropped"] = m_droppedSinceResync;
+  root["params"]["sender"] = "xbmc";
+
+  auto notification = std::make_shared<std::string>();
+  CJSONVariantWriter::Write(root, *notification, m_compactOutput);
+
+  m_bytes = notification->size();
+  m_entries.push_back({"", std::move(notification)});
+  m_resyncQueued = true;
+}
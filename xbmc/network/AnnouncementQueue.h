@@ -0,0 +1,104 @@
+/*
+ *  Copyright (C) 2026 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "interfaces/IAnnouncer.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+class CVariant;
+
+namespace JSONRPC
+{
+/*!
+ \brief Queue of the JSON-RPC notifications waiting to be sent to one client.
+
+ Notifications only stay in the queue while the client does not read them as fast as they are
+ announced. A notification which supersedes an earlier one for the same item (e.g. a library
+ update or a volume change) replaces the one still waiting in the queue instead of being
+ appended. If the queue grows beyond its limits all waiting notifications are dropped and a single
+ System.OnResync notification tells the client to fetch the current state again.
+ */
+class CAnnouncementQueue
+{
+public:
+  struct Stats
+  {
+    //! largest number of notifications waiting at the same time
+    size_t maxDepth = 0;
+    //! notifications which replaced one waiting in the queue
+    uint64_t coalesced = 0;
+    //! notifications dropped because the queue was full
+    uint64_t dropped = 0;
+    //! number of times the queue was full
+    uint64_t resyncs = 0;
+  };
+
+  static constexpr size_t DEFAULT_MAX_LENGTH = 1024;
+  static constexpr size_t DEFAULT_MAX_BYTES = 4 * 1024 * 1024;
+
+  explicit CAnnouncementQueue(bool compactOutput,
+                              size_t maxLength = DEFAULT_MAX_LENGTH,
+                              size_t maxBytes = DEFAULT_MAX_BYTES);
+  CAnnouncementQueue(const CAnnouncementQueue& queue);
+  CAnnouncementQueue& operator=(const CAnnouncementQueue& queue);
+
+  /*!
+   \brief Returns the key under which a notification replaces an earlier one waiting in the
+   queue, or an empty string if it must not replace any.
+   */
+  static std::string GetCoalescingKey(ANNOUNCEMENT::AnnouncementFlag flag,
+                                      const std::string& sender,
+                                      const std::string& message,
+                                      const CVariant& data);
+
+  /*!
+   \brief Queues a serialized notification.
+   \param key Key returned by GetCoalescingKey() for the notification
+   \param notification The notification, shared between the queues of all clients
+   \return False if the queue was full and the waiting notifications were dropped
+   */
+  bool Push(const std::string& key, std::shared_ptr<const std::string> notification);
+
+  //! Removes the next notification to send from the queue, nullptr if it is empty.
+  std::shared_ptr<const std::string> Pop();
+
+  bool Empty() const { return m_entries.empty(); }
+  size_t Size() const { return m_entries.size(); }
+  size_t Bytes() const { return m_bytes; }
+  const Stats& GetStats() const { return m_stats; }
+
+private:
+  struct Entry
+  {
+    std::string key;
+    std::shared_ptr<const std::string> notification;
+  };
+
+  void Resync();
+
+  std::list<Entry> m_entries;
+  //! waiting notifications which may still be replaced, by their key
+  std::unordered_map<std::string, std::list<Entry>::iterator> m_coalescable;
+  size_t m_bytes = 0;
+  //! dropped notifications the waiting System.OnResync notification reports
+  uint64_t m_droppedSinceResync = 0;
+  bool m_resyncQueued = false;
+  Stats m_stats;
+
+  bool m_compactOutput;
+  size_t m_maxLength;
+  size_t m_maxBytes;
+};
+} // namespace JSONRPC
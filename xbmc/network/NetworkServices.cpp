@@ -698,6 +698,11 @@ bool CNetworkServices::StartWebserver()
     password = m_settings->GetString(CSettings::SETTING_SERVICES_WEBSERVERPASSWORD);
   }
 
+  const auto advancedSettings = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings();
+  m_webserver.SetConnectionHandling(advancedSettings->m_webserverThreadPoolSize,
+                                    advancedSettings->m_webserverConnectionLimit,
+                                    advancedSettings->m_webserverConnectionTimeout);
+
   if (!m_webserver.Start(webPort, username, password))
     return false;
 
@@ -18,14 +18,27 @@
 #include "utils/log.h"
 #include "websocket/WebSocketManager.h"
 
+#include <algorithm>
+#include <array>
+#include <cerrno>
 #include <mutex>
 #include <stdio.h>
 #include <stdlib.h>
+#include <utility>
 
 #include <arpa/inet.h>
 #include <memory.h>
 #include <netinet/in.h>
 
+#if !defined(TARGET_WINDOWS)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#if defined(TARGET_LINUX)
+#include <sys/epoll.h>
+#endif
+
 using namespace std::chrono_literals;
 
 #if defined(TARGET_WINDOWS) || defined(HAVE_LIBBLUETOOTH)
@@ -58,7 +71,17 @@ using namespace JSONRPC;
 namespace
 {
 constexpr size_t maxBufferLength = 64 * 1024;
+
+//! Returns true if the last call on a non-blocking socket failed because it would have blocked.
+bool WouldBlock()
+{
+#ifdef TARGET_WINDOWS
+  return WSAGetLastError() == WSAEWOULDBLOCK;
+#else
+  return errno == EAGAIN || errno == EWOULDBLOCK;
+#endif
 }
+} // unnamed namespace
 
 CTCPServer *CTCPServer::ServerInstance = NULL;
 
@@ -108,124 +131,247 @@ void CTCPServer::Process()
 {
   m_bStop = false;
 
+  std::vector<SocketEvent> events;
   while (!m_bStop)
   {
-    SOCKET          max_fd = 0;
-    fd_set          rfds;
-    struct timeval  to     = {1, 0};
-    FD_ZERO(&rfds);
+    if (!WaitForEvents(events))
+    {
+      CLog::Log(LOGERROR, "JSONRPC Server: Waiting for socket events failed");
+      CThread::Sleep(1000ms);
+      Initialize();
+      continue;
+    }
+
+    // Process the events under lock, accepting and closing connections modifies m_connections.
+    std::unique_lock lock(m_connectionsCritSection);
 
+    for (const SocketEvent& event : events)
     {
-      // Build the fd_set under lock so a concurrent Announce or modification
-      // of m_connections doesn't tear out from under us. Drop the lock for
-      // the select() call below since it sleeps up to 1s and would otherwise
-      // starve Announce.
-      std::unique_lock lock(m_connectionsCritSection);
+      if (std::find(m_servers.begin(), m_servers.end(), event.socket) != m_servers.end())
+      {
+        if (event.readable && !AcceptConnection(event.socket))
+          break;
+        continue;
+      }
 
-      for (auto& it : m_servers)
+      const auto it = std::find_if(m_connections.begin(), m_connections.end(),
+                                   [&event](const CTCPClient* client)
+                                   { return client->m_socket == event.socket; });
+      if (it == m_connections.end())
+        continue;
+
+      const size_t index = it - m_connections.begin();
+      if (event.writable)
+        m_connections[index]->Flush();
+
+      if (event.readable && !ReadConnection(index))
       {
-        FD_SET(it, &rfds);
-        if ((intptr_t)it > (intptr_t)max_fd)
-          max_fd = it;
+        CLog::Log(LOGINFO, "JSONRPC Server: Disconnection detected");
+        CloseConnection(index);
       }
+    }
 
-      for (unsigned int i = 0; i < m_connections.size(); i++)
+    // clients which stopped reading their responses or whose connection broke while sending
+    for (int i = m_connections.size() - 1; i >= 0; i--)
+    {
+      if (m_connections[i]->Failed())
       {
-        FD_SET(m_connections[i]->m_socket, &rfds);
-        if ((intptr_t)m_connections[i]->m_socket > (intptr_t)max_fd)
-          max_fd = m_connections[i]->m_socket;
+        CLog::Log(LOGINFO, "JSONRPC Server: Closing connection which can't be written to");
+        CloseConnection(i);
       }
     }
+  }
+
+  Deinitialize();
+}
+
+bool CTCPServer::WaitForEvents(std::vector<SocketEvent>& events)
+{
+  events.clear();
+
+#if defined(TARGET_LINUX)
+  // The client sockets are edge triggered, so a client which got more data to send than its
+  // socket took is woken up once the socket is writable again, without having to tell this thread.
+  std::array<epoll_event, 64> epollEvents;
+  const int count = epoll_wait(m_epollFd, epollEvents.data(), epollEvents.size(), 1000);
+  if (count < 0)
+    return errno == EINTR;
+
+  for (int i = 0; i < count; i++)
+  {
+    const uint32_t flags = epollEvents[i].events;
+    const bool readable = (flags & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) != 0;
+    events.push_back({epollEvents[i].data.fd, readable, (flags & EPOLLOUT) != 0});
+  }
+
+  return true;
+#else
+  SOCKET          max_fd = 0;
+  fd_set          rfds;
+  fd_set          wfds;
+  struct timeval  to     = {1, 0};
+  FD_ZERO(&rfds);
+  FD_ZERO(&wfds);
+
+  {
+    // Build the fd_set under lock so a concurrent Announce or modification
+    // of m_connections doesn't tear out from under us. Drop the lock for
+    // the select() call below since it sleeps up to 1s and would otherwise
+    // starve Announce.
+    std::unique_lock lock(m_connectionsCritSection);
+
+    for (auto& it : m_servers)
+    {
+      FD_SET(it, &rfds);
+      if ((intptr_t)it > (intptr_t)max_fd)
+        max_fd = it;
+    }
+
+    for (unsigned int i = 0; i < m_connections.size(); i++)
+    {
+      FD_SET(m_connections[i]->m_socket, &rfds);
+      // wait for clients which didn't take all data to take more
+      if (m_connections[i]->HasPendingOutput())
+        FD_SET(m_connections[i]->m_socket, &wfds);
+      if ((intptr_t)m_connections[i]->m_socket > (intptr_t)max_fd)
+        max_fd = m_connections[i]->m_socket;
+    }
+  }
+
+  int res = select((intptr_t)max_fd+1, &rfds, &wfds, NULL, &to);
+  if (res <= 0)
+    return res == 0;
+
+  std::unique_lock lock(m_connectionsCritSection);
+
+  for (auto& it : m_servers)
+  {
+    if (FD_ISSET(it, &rfds))
+      events.push_back({it, true, false});
+  }
+
+  for (unsigned int i = 0; i < m_connections.size(); i++)
+  {
+    const SOCKET socket = m_connections[i]->m_socket;
+    const bool readable = FD_ISSET(socket, &rfds);
+    const bool writable = FD_ISSET(socket, &wfds);
+    if (readable || writable)
+      events.push_back({socket, readable, writable});
+  }
+
+  return true;
+#endif
+}
 
-    int res = select((intptr_t)max_fd+1, &rfds, NULL, NULL, &to);
-    if (res < 0)
+bool CTCPServer::AcceptConnection(SOCKET server)
+{
+  CLog::Log(LOGDEBUG, "JSONRPC Server: New connection detected");
+  CTCPClient *newconnection = new CTCPClient();
+  newconnection->m_socket =
+      accept(server, (sockaddr*)&newconnection->m_cliaddr, &newconnection->m_addrlen);
+
+  if (newconnection->m_socket == INVALID_SOCKET)
+  {
+    CLog::Log(LOGERROR, "JSONRPC Server: Accept of new connection failed: {}", errno);
+    delete newconnection;
+    if (EBADF == errno)
     {
-      CLog::Log(LOGERROR, "JSONRPC Server: Select failed");
       CThread::Sleep(1000ms);
       Initialize();
+      return false;
     }
-    else if (res > 0)
-    {
-      // Re-acquire for the I/O and accept passes; both modify m_connections.
-      std::unique_lock lock(m_connectionsCritSection);
+    return true;
+  }
 
-      for (int i = m_connections.size() - 1; i >= 0; i--)
-      {
-        int socket = m_connections[i]->m_socket;
-        if (FD_ISSET(socket, &rfds))
-        {
-          char buffer[RECEIVEBUFFER] = {};
-          int  nread = 0;
-          nread = recv(socket, (char*)&buffer, RECEIVEBUFFER, 0);
-          bool close = false;
-          if (nread > 0)
-          {
-            std::string response;
-            if (m_connections[i]->IsNew())
-            {
-              CWebSocket *websocket = CWebSocketManager::Handle(buffer, nread, response);
-
-              if (!response.empty())
-                m_connections[i]->Send(response.c_str(), response.size());
-
-              if (websocket != NULL)
-              {
-                // Replace the CTCPClient with a CWebSocketClient
-                CWebSocketClient *websocketClient = new CWebSocketClient(websocket, *(m_connections[i]));
-                delete m_connections[i];
-                m_connections.erase(m_connections.begin() + i);
-                m_connections.insert(m_connections.begin() + i, websocketClient);
-              }
-            }
-
-            if (response.empty())
-              m_connections[i]->PushBuffer(this, buffer, nread);
-
-            close = m_connections[i]->Closing();
-          }
-          else
-            close = true;
+  const unsigned int connectionLimit =
+      CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_jsonTcpConnectionLimit;
+  if (m_connections.size() >= connectionLimit)
+  {
+    CLog::Log(LOGWARNING, "JSONRPC Server: Rejecting new connection, limit of {} reached",
+              connectionLimit);
+    newconnection->Disconnect();
+    delete newconnection;
+    return true;
+  }
 
-          if (close)
-          {
-            CLog::Log(LOGINFO, "JSONRPC Server: Disconnection detected");
-            m_connections[i]->Disconnect();
-            delete m_connections[i];
-            m_connections.erase(m_connections.begin() + i);
-          }
-        }
-      }
+  // the connections are only ever written to without blocking
+#ifdef TARGET_WINDOWS
+  u_long nonblocking = 1;
+  int result = ioctlsocket(newconnection->m_socket, FIONBIO, &nonblocking);
+#else
+  int result = fcntl(newconnection->m_socket, F_SETFL,
+                     fcntl(newconnection->m_socket, F_GETFL) | O_NONBLOCK);
+#endif
 
-      for (auto& it : m_servers)
-      {
-        if (FD_ISSET(it, &rfds))
-        {
-          CLog::Log(LOGDEBUG, "JSONRPC Server: New connection detected");
-          CTCPClient *newconnection = new CTCPClient();
-          newconnection->m_socket =
-              accept(it, (sockaddr*)&newconnection->m_cliaddr, &newconnection->m_addrlen);
+#if defined(TARGET_LINUX)
+  if (result == 0)
+  {
+    epoll_event event = {};
+    event.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+    event.data.fd = newconnection->m_socket;
+    result = epoll_ctl(m_epollFd, EPOLL_CTL_ADD, newconnection->m_socket, &event);
+  }
+#endif
 
-          if (newconnection->m_socket == INVALID_SOCKET)
-          {
-            CLog::Log(LOGERROR, "JSONRPC Server: Accept of new connection failed: {}", errno);
-            if (EBADF == errno)
-            {
-              CThread::Sleep(1000ms);
-              Initialize();
-              break;
-            }
-          }
-          else
-          {
-            CLog::Log(LOGINFO, "JSONRPC Server: New connection added");
-            m_connections.push_back(newconnection);
-          }
-        }
+  if (result != 0)
+  {
+    CLog::Log(LOGERROR, "JSONRPC Server: Failed to set up new connection: {}", errno);
+    newconnection->Disconnect();
+    delete newconnection;
+    return true;
+  }
+
+  CLog::Log(LOGINFO, "JSONRPC Server: New connection added");
+  m_connections.push_back(newconnection);
+  return true;
+}
+
+bool CTCPServer::ReadConnection(size_t index)
+{
+  // read everything, the socket only signals again once more data arrived
+  while (true)
+  {
+    char buffer[RECEIVEBUFFER] = {};
+    int nread = recv(m_connections[index]->m_socket, (char*)&buffer, RECEIVEBUFFER, 0);
+    if (nread < 0 && errno == EINTR)
+      continue;
+    if (nread < 0 && WouldBlock())
+      return true;
+    if (nread <= 0)
+      return false;
+
+    std::string response;
+    if (m_connections[index]->IsNew())
+    {
+      CWebSocket *websocket = CWebSocketManager::Handle(buffer, nread, response);
+
+      if (!response.empty())
+        m_connections[index]->Send(response.c_str(), response.size());
+
+      if (websocket != NULL)
+      {
+        // Replace the CTCPClient with a CWebSocketClient
+        CWebSocketClient* websocketClient =
+            new CWebSocketClient(websocket, *(m_connections[index]));
+        delete m_connections[index];
+        m_connections[index] = websocketClient;
       }
     }
+
+    if (response.empty())
+      m_connections[index]->PushBuffer(this, buffer, nread);
+
+    if (m_connections[index]->Closing())
+      return false;
   }
+}
 
-  Deinitialize();
+void CTCPServer::CloseConnection(size_t index)
+{
+  m_connections[index]->LogAnnouncementStats();
+  m_connections[index]->Disconnect();
+  delete m_connections[index];
+  m_connections.erase(m_connections.begin() + index);
 }
 
 bool CTCPServer::PrepareDownload(const char *path, CVariant &details, std::string &protocol)
@@ -257,7 +403,10 @@ void CTCPServer::Announce(ANNOUNCEMENT::AnnouncementFlag flag,
   if (m_connections.empty())
     return;
 
-  std::string str = IJSONRPCAnnouncer::AnnouncementToJSONRPC(flag, sender, message, data, CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_jsonOutputCompact);
+  // Serialize once and queue the same notification for every client. Each client only gets as
+  // much of it as its socket takes without blocking, so a slow client cannot hold up the others.
+  auto notification = std::make_shared<const std::string>(IJSONRPCAnnouncer::AnnouncementToJSONRPC(flag, sender, message, data, CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_jsonOutputCompact));
+  const std::string key = CAnnouncementQueue::GetCoalescingKey(flag, sender, message, data);
 
   for (unsigned int i = 0; i < m_connections.size(); i++)
   {
@@ -267,7 +416,7 @@ void CTCPServer::Announce(ANNOUNCEMENT::AnnouncementFlag flag,
         continue;
     }
 
-    m_connections[i]->Send(str.c_str(), str.size());
+    m_connections[i]->QueueAnnouncement(key, notification);
   }
 }
 
@@ -280,6 +429,28 @@ bool CTCPServer::Initialize()
   started |= InitializeBlue();
   started |= InitializeTCP();
 
+#if defined(TARGET_LINUX)
+  if (started)
+  {
+    m_epollFd = epoll_create1(EPOLL_CLOEXEC);
+    if (m_epollFd < 0)
+    {
+      CLog::Log(LOGERROR, "JSONRPC Server: Failed to create epoll instance: {}", errno);
+      Deinitialize();
+      return false;
+    }
+
+    for (SOCKET server : m_servers)
+    {
+      epoll_event event = {};
+      event.events = EPOLLIN;
+      event.data.fd = server;
+      if (epoll_ctl(m_epollFd, EPOLL_CTL_ADD, server, &event) < 0)
+        CLog::Log(LOGERROR, "JSONRPC Server: Failed to watch server socket: {}", errno);
+    }
+  }
+#endif
+
   if (started)
   {
     CServiceBroker::GetAnnouncementManager()->AddAnnouncer(this);
@@ -511,6 +682,12 @@ void CTCPServer::Deinitialize()
 
   m_servers.clear();
 
+#if defined(TARGET_LINUX)
+  if (m_epollFd >= 0)
+    close(m_epollFd);
+  m_epollFd = -1;
+#endif
+
 #ifdef HAVE_LIBBLUETOOTH
   if (m_sdpd)
     sdp_close((sdp_session_t*)m_sdpd);
@@ -521,6 +698,15 @@ void CTCPServer::Deinitialize()
 }
 
 CTCPServer::CTCPClient::CTCPClient()
+  : m_announcements(
+        CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_jsonOutputCompact,
+        CServiceBroker::GetSettingsComponent()
+            ->GetAdvancedSettings()
+            ->m_jsonTcpNotificationQueueLimit),
+    m_sendBufferLimit(static_cast<size_t>(CServiceBroker::GetSettingsComponent()
+                                              ->GetAdvancedSettings()
+                                              ->m_jsonTcpSendBufferLimit) *
+                      1024)
 {
   m_new = true;
   m_announcementflags = ANNOUNCEMENT::ANNOUNCE_ALL;
@@ -533,6 +719,7 @@ CTCPServer::CTCPClient::CTCPClient()
 }
 
 CTCPServer::CTCPClient::CTCPClient(const CTCPClient& client)
+  : m_announcements(client.m_announcements), m_sendBufferLimit(client.m_sendBufferLimit)
 {
   Copy(client);
 }
@@ -561,12 +748,141 @@ bool CTCPServer::CTCPClient::SetAnnouncementFlags(int flags)
 
 void CTCPServer::CTCPClient::Send(const char *data, unsigned int size)
 {
-  unsigned int sent = 0;
-  do
+  std::unique_lock lock(m_critSection);
+
+  if (m_failed)
+    return;
+
+  // The responses are written without blocking, so a client which doesn't read them can't hold
+  // up the server. Give up on it once it left too much unread. A single large response is still
+  // buffered completely.
+  if (m_sendBuffer.size() - m_sendBufferSent > m_sendBufferLimit)
   {
-    std::unique_lock lock(m_critSection);
-    sent += send(m_socket, data + sent, size - sent, 0);
-  } while (sent < size);
+    CLog::Log(LOGWARNING,
+              "JSONRPC Server: client didn't read {} bytes of responses, giving up on it",
+              m_sendBuffer.size() - m_sendBufferSent);
+    m_failed = true;
+    return;
+  }
+
+  if (m_sendBufferSent > 0 && m_sendBufferSent >= m_sendBuffer.size() / 2)
+  {
+    m_sendBuffer.erase(0, m_sendBufferSent);
+    m_sendBufferSent = 0;
+  }
+
+  m_sendBuffer.append(data, size);
+  Flush();
+}
+
+void CTCPServer::CTCPClient::QueueAnnouncement(const std::string& key,
+                                               std::shared_ptr<const std::string> notification)
+{
+  std::unique_lock lock(m_critSection);
+
+  if (m_failed)
+    return;
+
+  if (!m_announcements.Push(key, std::move(notification)))
+  {
+    const CAnnouncementQueue::Stats& stats = m_announcements.GetStats();
+    CLog::Log(LOGWARNING,
+              "JSONRPC Server: client doesn't keep up with notifications, dropped {} of them "
+              "({} in total), asking it to resync",
+              stats.dropped - m_droppedAnnouncementsLogged, stats.dropped);
+    m_droppedAnnouncementsLogged = stats.dropped;
+  }
+
+  Flush();
+}
+
+void CTCPServer::CTCPClient::Flush()
+{
+  std::unique_lock lock(m_critSection);
+
+  while (!m_failed)
+  {
+    // finish a partially sent notification first, then the responses and then the next
+    // notifications, which may still be coalesced while they wait
+    if (m_pendingAnnouncement)
+    {
+      if (!SendNonBlocking(*m_pendingAnnouncement, m_pendingAnnouncementSent))
+        return;
+
+      m_pendingAnnouncement.reset();
+    }
+    else if (m_sendBufferSent < m_sendBuffer.size())
+    {
+      if (!SendNonBlocking(m_sendBuffer, m_sendBufferSent))
+        return;
+
+      m_sendBuffer.clear();
+      m_sendBufferSent = 0;
+    }
+    else
+    {
+      std::shared_ptr<const std::string> notification = m_announcements.Pop();
+      if (!notification)
+        return;
+
+      m_pendingAnnouncement = Encode(std::move(notification));
+      m_pendingAnnouncementSent = 0;
+    }
+  }
+}
+
+bool CTCPServer::CTCPClient::SendNonBlocking(const std::string& data, size_t& sent)
+{
+  while (sent < data.size())
+  {
+    const auto result = send(m_socket, data.c_str() + sent, data.size() - sent, 0);
+    if (result < 0 && errno == EINTR)
+      continue;
+    if (result < 0 && WouldBlock())
+      return false;
+
+    if (result <= 0)
+    {
+      // the connection is gone, Process() closes it
+      m_failed = true;
+      return false;
+    }
+
+    sent += result;
+  }
+
+  return true;
+}
+
+bool CTCPServer::CTCPClient::HasPendingOutput()
+{
+  std::unique_lock lock(m_critSection);
+  return m_pendingAnnouncement || m_sendBufferSent < m_sendBuffer.size() ||
+         !m_announcements.Empty();
+}
+
+bool CTCPServer::CTCPClient::Failed()
+{
+  std::unique_lock lock(m_critSection);
+  return m_failed;
+}
+
+void CTCPServer::CTCPClient::LogAnnouncementStats()
+{
+  std::unique_lock lock(m_critSection);
+
+  const CAnnouncementQueue::Stats& stats = m_announcements.GetStats();
+  if (stats.maxDepth > 1 || stats.coalesced > 0 || stats.dropped > 0)
+    CLog::Log(LOGDEBUG,
+              "JSONRPC Server: notifications to client: max queue depth {}, coalesced {}, "
+              "dropped {}, resyncs {}",
+              stats.maxDepth, stats.coalesced, stats.dropped, stats.resyncs);
+}
+
+std::shared_ptr<const std::string> CTCPServer::CTCPClient::Encode(
+    std::shared_ptr<const std::string> message)
+{
+  return message;
 }
 
 void CTCPServer::CTCPClient::PushBuffer(CTCPServer *host, const char *buffer, int length)
@@ -646,6 +962,8 @@ void CTCPServer::CTCPClient::Disconnect()
   if (m_socket > 0)
   {
     std::unique_lock lock(m_critSection);
+    // send what the socket takes right away, e.g. the close frame of a websocket
+    Flush();
     shutdown(m_socket, SHUT_RDWR);
     closesocket(m_socket);
     m_socket = INVALID_SOCKET;
@@ -664,6 +982,14 @@ void CTCPServer::CTCPClient::Copy(const CTCPClient& client)
   m_beginChar         = client.m_beginChar;
   m_endChar           = client.m_endChar;
   m_buffer            = client.m_buffer;
+  m_announcements     = client.m_announcements;
+  m_pendingAnnouncement = client.m_pendingAnnouncement;
+  m_pendingAnnouncementSent = client.m_pendingAnnouncementSent;
+  m_droppedAnnouncementsLogged = client.m_droppedAnnouncementsLogged;
+  m_sendBuffer        = client.m_sendBuffer;
+  m_sendBufferSent    = client.m_sendBufferSent;
+  m_sendBufferLimit   = client.m_sendBufferLimit;
+  m_failed            = client.m_failed;
 }
 
 CTCPServer::CWebSocketClient::CWebSocketClient(CWebSocket *websocket)
@@ -713,6 +1039,22 @@ void CTCPServer::CWebSocketClient::Send(const char *data, unsigned int size)
     CTCPClient::Send(frames.at(index)->GetFrameData(), (unsigned int)frames.at(index)->GetFrameLength());
 }
 
+std::shared_ptr<const std::string> CTCPServer::CWebSocketClient::Encode(
+    std::shared_ptr<const std::string> message)
+{
+  const CWebSocketMessage* msg =
+      m_websocket->Send(WebSocketTextFrame, message->c_str(), message->size());
+  if (msg == NULL || !msg->IsComplete())
+    return nullptr;
+
+  auto data = std::make_shared<std::string>();
+  for (const CWebSocketFrame* frame : msg->GetFrames())
+    data->append(frame->GetFrameData(), frame->GetFrameLength());
+
+  delete msg;
+  return data;
+}
+
 void CTCPServer::CWebSocketClient::PushBuffer(CTCPServer *host, const char *buffer, int length)
 {
   bool send;
@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include "AnnouncementQueue.h"
 #include "interfaces/json-rpc/IClient.h"
 #include "interfaces/json-rpc/IJSONRPCAnnouncer.h"
 #include "interfaces/json-rpc/ITransportLayer.h"
@@ -15,6 +16,8 @@
 #include "threads/Thread.h"
 #include "websocket/WebSocket.h"
 
+#include <memory>
+#include <string>
 #include <vector>
 
 #include <sys/socket.h>
@@ -50,6 +53,21 @@ namespace JSONRPC
     bool InitializeTCP();
     void Deinitialize();
 
+    struct SocketEvent
+    {
+      SOCKET socket;
+      bool readable;
+      bool writable;
+    };
+
+    //! Waits up to a second for sockets to become readable or writable.
+    bool WaitForEvents(std::vector<SocketEvent>& events);
+    //! Returns false if the server socket broke.
+    bool AcceptConnection(SOCKET server);
+    //! Reads all data the client sent, returns false if the connection has to be closed.
+    bool ReadConnection(size_t index);
+    void CloseConnection(size_t index);
+
     class CTCPClient : public IClient
     {
     public:
@@ -71,6 +89,19 @@ namespace JSONRPC
       virtual bool IsNew() const { return m_new; }
       virtual bool Closing() const { return false; }
 
+      /*!
+       \brief Queues a notification and sends as much of the pending data as the socket takes
+       without blocking.
+       */
+      void QueueAnnouncement(const std::string& key,
+                             std::shared_ptr<const std::string> notification);
+      //! Sends as much of the pending data as the socket takes without blocking.
+      void Flush();
+      bool HasPendingOutput();
+      //! Returns true if the connection broke or the client didn't read its responses in time.
+      bool Failed();
+      void LogAnnouncementStats();
+
       SOCKET m_socket{INVALID_SOCKET};
       sockaddr_storage m_cliaddr;
       socklen_t m_addrlen;
@@ -78,7 +109,25 @@ namespace JSONRPC
 
     protected:
       void Copy(const CTCPClient& client);
+      //! Returns the data to write to the socket to send the given message.
+      virtual std::shared_ptr<const std::string> Encode(
+          std::shared_ptr<const std::string> message);
+
     private:
+      //! Sends the rest of the data, returns false if the socket didn't take all of it.
+      bool SendNonBlocking(const std::string& data, size_t& sent);
+
+      CAnnouncementQueue m_announcements;
+      //! notification of which only a part could be sent
+      std::shared_ptr<const std::string> m_pendingAnnouncement;
+      size_t m_pendingAnnouncementSent = 0;
+      uint64_t m_droppedAnnouncementsLogged = 0;
+      //! responses waiting to be sent
+      std::string m_sendBuffer;
+      size_t m_sendBufferSent = 0;
+      size_t m_sendBufferLimit;
+      bool m_failed = false;
+
       bool m_new;
       int m_announcementflags;
       int m_beginBrackets, m_endBrackets;
@@ -102,6 +151,10 @@ namespace JSONRPC
       bool IsNew() const override { return m_websocket == NULL; }
       bool Closing() const override { return m_websocket != NULL && m_websocket->GetState() == WebSocketStateClosed; }
 
+    protected:
+      std::shared_ptr<const std::string> Encode(
+          std::shared_ptr<const std::string> message) override;
+
     private:
       CWebSocket *m_websocket;
       std::string m_buffer;
@@ -110,6 +163,9 @@ namespace JSONRPC
     std::vector<CTCPClient*> m_connections;
     std::vector<SOCKET> m_servers;
     CCriticalSection m_connectionsCritSection;
+#if defined(TARGET_LINUX)
+    int m_epollFd{-1};
+#endif
     int m_port;
     bool m_nonlocal;
     void* m_sdpd;
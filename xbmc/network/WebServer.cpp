@@ -10,8 +10,11 @@
 
 #include "CompileInfo.h"
 #include "ServiceBroker.h"
+#include "TextureCache.h"
+#include "URL.h"
 #include "XBDateTime.h"
 #include "filesystem/File.h"
+#include "filesystem/SpecialProtocol.h"
 #include "network/httprequesthandler/HTTPRequestHandlerUtils.h"
 #include "network/httprequesthandler/IHTTPRequestHandler.h"
 #include "settings/Settings.h"
@@ -24,13 +27,18 @@
 #include "utils/log.h"
 
 #include <algorithm>
+#include <chrono>
 #include <memory>
 #include <mutex>
 #include <stdexcept>
 #include <utility>
 
 #if defined(TARGET_POSIX)
+#include <fcntl.h>
 #include <pthread.h>
+#include <unistd.h>
+
+#include <sys/stat.h>
 #endif
 
 #include <inttypes.h>
@@ -209,6 +217,24 @@ MHD_RESULT CWebServer::HandlePartialRequest(struct MHD_Connection* connection,
         {
           bool cacheable = IsRequestCacheable(request);
 
+          // handle If-None-Match which takes precedence over If-Modified-Since
+          std::string entityTag;
+          const std::string ifNoneMatch = HTTPRequestHandlerUtils::GetRequestHeaderValue(
+              connection, MHD_HEADER_KIND, MHD_HTTP_HEADER_IF_NONE_MATCH);
+          const bool checkEntityTag = !ifNoneMatch.empty() && handler->GetEntityTag(entityTag);
+          if (checkEntityTag && cacheable &&
+              HTTPRequestHandlerUtils::MatchesEntityTag(ifNoneMatch, entityTag))
+          {
+            struct MHD_Response* response = create_response(0, nullptr, MHD_NO, MHD_NO);
+            if (response == nullptr)
+            {
+              m_logger->error("failed to create a HTTP 304 response");
+              return MHD_NO;
+            }
+
+            return FinalizeRequest(handler, MHD_HTTP_NOT_MODIFIED, response);
+          }
+
           CDateTime lastModified;
           if (handler->GetLastModifiedDate(lastModified) && lastModified.IsValid())
           {
@@ -221,7 +247,8 @@ MHD_RESULT CWebServer::HandlePartialRequest(struct MHD_Connection* connection,
             CDateTime ifModifiedSinceDate;
             CDateTime ifUnmodifiedSinceDate;
             // handle If-Modified-Since (but only if the response is cacheable)
-            if (cacheable && ifModifiedSinceDate.SetFromRFC1123DateTime(ifModifiedSince) &&
+            if (cacheable && !checkEntityTag &&
+                ifModifiedSinceDate.SetFromRFC1123DateTime(ifModifiedSince) &&
                 lastModified.GetAsUTCDateTime() <= ifModifiedSinceDate)
             {
               struct MHD_Response* response = create_response(0, nullptr, MHD_NO, MHD_NO);
@@ -325,12 +352,41 @@ MHD_RESULT CWebServer::HandleRequest(const std::shared_ptr<IHTTPRequestHandler>&
   if (handler == nullptr)
     return MHD_NO;
 
+  const std::string name = handler->GetName();
+  {
+    std::unique_lock lock(m_metricsSection);
+    HandlerMetrics& metrics = m_handlerMetrics[name];
+    metrics.maxActive = std::max(metrics.maxActive, ++metrics.active);
+  }
+
+  const auto start = std::chrono::steady_clock::now();
+  int responseStatus = MHD_HTTP_OK;
+  const MHD_RESULT ret = CreateResponse(handler, responseStatus);
+  const auto duration = std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - start);
+
+  std::unique_lock lock(m_metricsSection);
+  HandlerMetrics& metrics = m_handlerMetrics[name];
+  --metrics.active;
+  ++metrics.requests;
+  if (ret == MHD_NO || responseStatus >= MHD_HTTP_BAD_REQUEST)
+    ++metrics.failed;
+  metrics.totalTime += duration;
+  metrics.maxTime = std::max(metrics.maxTime, duration);
+
+  return ret;
+}
+
+MHD_RESULT CWebServer::CreateResponse(const std::shared_ptr<IHTTPRequestHandler>& handler,
+                                      int& responseStatus)
+{
   HTTPRequest request = handler->GetRequest();
   MHD_RESULT ret = handler->HandleRequest();
   if (ret == MHD_NO)
   {
     m_logger->error("failed to handle HTTP request for {}", request.pathUrl);
-    return SendErrorResponse(request, MHD_HTTP_INTERNAL_SERVER_ERROR, request.method);
+    responseStatus = MHD_HTTP_INTERNAL_SERVER_ERROR;
+    return SendErrorResponse(request, responseStatus, request.method);
   }
 
   const HTTPResponseDetails& responseDetails = handler->GetResponseDetails();
@@ -363,16 +419,19 @@ MHD_RESULT CWebServer::HandleRequest(const std::shared_ptr<IHTTPRequestHandler>&
 
     default:
       m_logger->error("internal error while HTTP request handler processed {}", request.pathUrl);
-      return SendErrorResponse(request, MHD_HTTP_INTERNAL_SERVER_ERROR, request.method);
+      responseStatus = MHD_HTTP_INTERNAL_SERVER_ERROR;
+      return SendErrorResponse(request, responseStatus, request.method);
   }
 
   if (ret == MHD_NO)
   {
     m_logger->error("failed to create HTTP response for {}", request.pathUrl);
-    return SendErrorResponse(request, MHD_HTTP_INTERNAL_SERVER_ERROR, request.method);
+    responseStatus = MHD_HTTP_INTERNAL_SERVER_ERROR;
+    return SendErrorResponse(request, responseStatus, request.method);
   }
 
-  return FinalizeRequest(handler, responseDetails.status, response);
+  responseStatus = responseDetails.status;
+  return FinalizeRequest(handler, responseStatus, response);
 }
 
 MHD_RESULT CWebServer::FinalizeRequest(const std::shared_ptr<IHTTPRequestHandler>& handler,
@@ -394,6 +453,12 @@ MHD_RESULT CWebServer::FinalizeRequest(const std::shared_ptr<IHTTPRequestHandler
   if (handler->GetLastModifiedDate(lastModified) && lastModified.IsValid())
     handler->AddResponseHeader(MHD_HTTP_HEADER_LAST_MODIFIED, lastModified.GetAsRFC1123DateTime());
 
+  // if the request handler has set an entity tag and it hasn't been set as a header, add it
+  std::string entityTag;
+  if (handler->CanBeCached() && !handler->HasResponseHeader(MHD_HTTP_HEADER_ETAG) &&
+      handler->GetEntityTag(entityTag))
+    handler->AddResponseHeader(MHD_HTTP_HEADER_ETAG, entityTag);
+
   // check if the request handler has set Cache-Control and add it if not
   if (!handler->HasResponseHeader(MHD_HTTP_HEADER_CACHE_CONTROL))
   {
@@ -788,7 +853,6 @@ MHD_RESULT CWebServer::CreateFileDownloadResponse(
     return MHD_NO;
 
   const HTTPRequest& request = handler->GetRequest();
-  const HTTPResponseDetails& responseDetails = handler->GetResponseDetails();
   HttpResponseRanges responseRanges = handler->GetResponseData();
 
   std::shared_ptr<XFILE::CFile> file = std::make_shared<XFILE::CFile>();
@@ -798,6 +862,14 @@ MHD_RESULT CWebServer::CreateFileDownloadResponse(
   if (!CFileUtils::CheckFileAccessAllowed(filePath))
     return SendErrorResponse(request, MHD_HTTP_NOT_FOUND, request.method);
 
+#if defined(TARGET_POSIX)
+  // local files are sent straight from the file descriptor (sendfile) instead of being copied
+  // through CFile, everything else and multipart ranges take the buffered path below
+  const std::string localPath = GetLocalFilePath(filePath);
+  if (!localPath.empty() && CreateLocalFileDownloadResponse(handler, localPath, response))
+    return MHD_YES;
+#endif
+
   if (!file->Open(filePath, XFILE::READ_NO_CACHE))
   {
     m_logger->error("Failed to open {}", filePath);
@@ -808,13 +880,7 @@ MHD_RESULT CWebServer::CreateFileDownloadResponse(
   uint64_t fileLength = static_cast<uint64_t>(file->GetLength());
 
   // get the MIME type for the Content-Type header
-  std::string mimeType = responseDetails.contentType;
-  if (mimeType.empty())
-  {
-    std::string ext = URIUtils::GetExtension(filePath);
-    StringUtils::ToLower(ext);
-    mimeType = CreateMimeTypeFromExtension(ext.c_str());
-  }
+  std::string mimeType = GetResponseMimeType(handler, filePath);
 
   uint64_t totalLength = 0;
   std::unique_ptr<HttpFileDownloadContext> context = std::make_unique<HttpFileDownloadContext>();
@@ -913,6 +979,124 @@ MHD_RESULT CWebServer::CreateFileDownloadResponse(
   return MHD_YES;
 }
 
+#if defined(TARGET_POSIX)
+bool CWebServer::CreateLocalFileDownloadResponse(
+    const std::shared_ptr<IHTTPRequestHandler>& handler,
+    const std::string& localPath,
+    struct MHD_Response*& response) const
+{
+  const HTTPRequest& request = handler->GetRequest();
+
+  const int fd = open(localPath.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0)
+    return false;
+
+  struct stat statBuffer;
+  if (fstat(fd, &statBuffer) != 0 || !S_ISREG(statBuffer.st_mode))
+  {
+    close(fd);
+    return false;
+  }
+  const uint64_t fileLength = static_cast<uint64_t>(statBuffer.st_size);
+
+  CHttpRanges ranges;
+  if (handler->IsRequestRanged())
+  {
+    if (!request.ranges.IsEmpty())
+      ranges = request.ranges;
+    else
+      HTTPRequestHandlerUtils::GetRequestedRanges(request.connection, fileLength, ranges);
+  }
+
+  // multiple ranges need multipart boundaries between the parts
+  if (ranges.Size() > 1)
+  {
+    close(fd);
+    return false;
+  }
+
+  uint64_t firstPosition = 0;
+  uint64_t lastPosition = fileLength > 0 ? fileLength - 1 : 0;
+  uint64_t length = fileLength;
+  if (!ranges.IsEmpty())
+  {
+    ranges.GetFirstPosition(firstPosition);
+    ranges.GetLastPosition(lastPosition);
+    length = ranges.GetLength();
+  }
+
+  // mhd takes ownership of the file descriptor and closes it with the response
+#if (MHD_VERSION >= 0x00094900)
+  response = MHD_create_response_from_fd_at_offset64(length, fd, firstPosition);
+#else
+  response = MHD_create_response_from_fd_at_offset(static_cast<size_t>(length), fd,
+                                                   static_cast<off_t>(firstPosition));
+#endif
+  if (response == nullptr)
+  {
+    m_logger->error("failed to create a HTTP response for {} to be sent from {}", request.pathUrl,
+                    localPath);
+    close(fd);
+    return false;
+  }
+
+  if (!ranges.IsEmpty())
+  {
+    handler->SetResponseStatus(MHD_HTTP_PARTIAL_CONTENT);
+    handler->AddResponseHeader(
+        MHD_HTTP_HEADER_CONTENT_RANGE,
+        HttpRangeUtils::GenerateContentRangeHeaderValue(firstPosition, lastPosition, fileLength));
+  }
+
+  const std::string mimeType = GetResponseMimeType(handler, handler->GetResponseFile());
+  if (!mimeType.empty())
+    handler->AddResponseHeader(MHD_HTTP_HEADER_CONTENT_TYPE, mimeType);
+
+  return true;
+}
+
+std::string CWebServer::GetLocalFilePath(const std::string& filePath)
+{
+  std::string path = filePath;
+  if (URIUtils::IsProtocol(path, "image"))
+  {
+    // the cached texture is what CImageFile reads, images not cached yet go through CFile
+    const auto textureCache = CServiceBroker::GetTextureCache();
+    if (textureCache == nullptr)
+      return "";
+
+    bool needsRecaching = false;
+    path = textureCache->CheckCachedImage(CURL(path).Get(), needsRecaching);
+    if (path.empty())
+      return "";
+  }
+
+  if (URIUtils::IsSpecial(path))
+    path = CSpecialProtocol::TranslatePath(path);
+
+  // anything with a protocol needs the VFS
+  if (URIUtils::IsURL(path))
+    return "";
+
+  return path;
+}
+#endif
+
+std::string CWebServer::GetResponseMimeType(const std::shared_ptr<IHTTPRequestHandler>& handler,
+                                            const std::string& filePath) const
+{
+  // get the MIME type for the Content-Type header
+  std::string mimeType = handler->GetResponseDetails().contentType;
+  if (mimeType.empty())
+  {
+    std::string ext = URIUtils::GetExtension(filePath);
+    StringUtils::ToLower(ext);
+    mimeType = CreateMimeTypeFromExtension(ext.c_str());
+  }
+
+  return mimeType;
+}
+
 MHD_RESULT CWebServer::CreateErrorResponse(struct MHD_Connection* connection,
                                            int responseType,
                                            HTTPMethod method,
@@ -1191,55 +1375,56 @@ bool CWebServer::LoadCert(std::string& skey, std::string& scert)
 
 struct MHD_Daemon* CWebServer::StartMHD(unsigned int flags, int port)
 {
-  unsigned int timeout = 60 * 60 * 24;
   const char* ciphers = "PFS:-VERS-TLS1.0:-VERS-TLS1.1";
 
   MHD_set_panic_func(&panicHandlerForMHD, nullptr);
 
+  if (m_threadPoolSize > 0)
+    // a pool of threads polling the connections, every thread serves many connections
+    flags |=
+#if (MHD_VERSION >= 0x00095207)
+        MHD_USE_INTERNAL_POLLING_THREAD | MHD_USE_AUTO /* epoll where available */
+#else
+        MHD_USE_SELECT_INTERNALLY
+#endif
+        ;
+  else
+    flags |=
+        // one thread per connection
+        // WARNING: set MHD_OPTION_CONNECTION_TIMEOUT to something higher than 1
+        // otherwise on libmicrohttpd 0.4.4-1 it spins a busy loop
+        MHD_USE_THREAD_PER_CONNECTION
+#if (MHD_VERSION >= 0x00095207)
+        | MHD_USE_INTERNAL_POLLING_THREAD /* MHD_USE_THREAD_PER_CONNECTION must be used only with
+                                             MHD_USE_INTERNAL_POLLING_THREAD since 0.9.54 */
+#endif
+        ;
+
   if (CServiceBroker::GetSettingsComponent()->GetSettings()->GetBool(
           CSettings::SETTING_SERVICES_WEBSERVERSSL) &&
       MHD_is_feature_supported(MHD_FEATURE_SSL) == MHD_YES && LoadCert(m_key, m_cert))
     // SSL enabled
     return MHD_start_daemon(
-        flags |
-            // one thread per connection
-            // WARNING: set MHD_OPTION_CONNECTION_TIMEOUT to something higher than 1
-            // otherwise on libmicrohttpd 0.4.4-1 it spins a busy loop
-            MHD_USE_THREAD_PER_CONNECTION
-#if (MHD_VERSION >= 0x00095207)
-            |
-            MHD_USE_INTERNAL_POLLING_THREAD /* MHD_USE_THREAD_PER_CONNECTION must be used only with
-                                               MHD_USE_INTERNAL_POLLING_THREAD since 0.9.54 */
-#endif
-            | MHD_USE_DEBUG /* Print MHD error messages to log */
+        flags | MHD_USE_DEBUG /* Print MHD error messages to log */
             | MHD_USE_SSL,
         port, 0, 0, &CWebServer::AnswerToConnection, this,
 
-        MHD_OPTION_EXTERNAL_LOGGER, &logFromMHD, 0, MHD_OPTION_CONNECTION_LIMIT, 512,
-        MHD_OPTION_CONNECTION_TIMEOUT, timeout, MHD_OPTION_URI_LOG_CALLBACK,
-        &CWebServer::UriRequestLogger, this, MHD_OPTION_THREAD_STACK_SIZE, m_thread_stacksize,
-        MHD_OPTION_HTTPS_MEM_KEY, m_key.c_str(), MHD_OPTION_HTTPS_MEM_CERT, m_cert.c_str(),
-        MHD_OPTION_HTTPS_PRIORITIES, ciphers, MHD_OPTION_END);
+        MHD_OPTION_EXTERNAL_LOGGER, &logFromMHD, 0, MHD_OPTION_CONNECTION_LIMIT, m_connectionLimit,
+        MHD_OPTION_CONNECTION_TIMEOUT, m_connectionTimeout, MHD_OPTION_THREAD_POOL_SIZE,
+        m_threadPoolSize, MHD_OPTION_URI_LOG_CALLBACK, &CWebServer::UriRequestLogger, this,
+        MHD_OPTION_THREAD_STACK_SIZE, m_thread_stacksize, MHD_OPTION_HTTPS_MEM_KEY, m_key.c_str(),
+        MHD_OPTION_HTTPS_MEM_CERT, m_cert.c_str(), MHD_OPTION_HTTPS_PRIORITIES, ciphers,
+        MHD_OPTION_END);
 
   // No SSL
   return MHD_start_daemon(
-      flags |
-          // one thread per connection
-          // WARNING: set MHD_OPTION_CONNECTION_TIMEOUT to something higher than 1
-          // otherwise on libmicrohttpd 0.4.4-1 it spins a busy loop
-          MHD_USE_THREAD_PER_CONNECTION
-#if (MHD_VERSION >= 0x00095207)
-          | MHD_USE_INTERNAL_POLLING_THREAD /* MHD_USE_THREAD_PER_CONNECTION must be used only with
-                                               MHD_USE_INTERNAL_POLLING_THREAD since 0.9.54 */
-#endif
-          | MHD_USE_DEBUG /* Print MHD error messages to log */
-      ,
+      flags | MHD_USE_DEBUG /* Print MHD error messages to log */,
       port, 0, 0, &CWebServer::AnswerToConnection, this,
 
-      MHD_OPTION_EXTERNAL_LOGGER, &logFromMHD, 0, MHD_OPTION_CONNECTION_LIMIT, 512,
-      MHD_OPTION_CONNECTION_TIMEOUT, timeout, MHD_OPTION_URI_LOG_CALLBACK,
-      &CWebServer::UriRequestLogger, this, MHD_OPTION_THREAD_STACK_SIZE, m_thread_stacksize,
-      MHD_OPTION_END);
+      MHD_OPTION_EXTERNAL_LOGGER, &logFromMHD, 0, MHD_OPTION_CONNECTION_LIMIT, m_connectionLimit,
+      MHD_OPTION_CONNECTION_TIMEOUT, m_connectionTimeout, MHD_OPTION_THREAD_POOL_SIZE,
+      m_threadPoolSize, MHD_OPTION_URI_LOG_CALLBACK, &CWebServer::UriRequestLogger, this,
+      MHD_OPTION_THREAD_STACK_SIZE, m_thread_stacksize, MHD_OPTION_END);
 }
 
 bool CWebServer::Start(uint16_t port, const std::string& username, const std::string& password)
@@ -1262,7 +1447,11 @@ bool CWebServer::Start(uint16_t port, const std::string& username, const std::st
     if (m_running)
     {
       m_port = port;
-      m_logger->info("Started");
+      if (m_threadPoolSize > 0)
+        m_logger->info("Started with {} threads for up to {} connections", m_threadPoolSize,
+                       m_connectionLimit);
+      else
+        m_logger->info("Started");
     }
     else
       m_logger->error("Failed to start");
@@ -1283,6 +1472,7 @@ bool CWebServer::Stop()
     MHD_stop_daemon(m_daemon_ip4);
 
   m_running = false;
+  LogHandlerMetrics();
   m_logger->info("Stopped");
   m_port = 0;
 
@@ -1308,6 +1498,15 @@ void CWebServer::SetCredentials(const std::string& username, const std::string&
   m_authenticationRequired = !m_authenticationPassword.empty();
 }
 
+void CWebServer::SetConnectionHandling(unsigned int threadPoolSize,
+                                       unsigned int connectionLimit,
+                                       unsigned int connectionTimeout)
+{
+  m_threadPoolSize = threadPoolSize;
+  m_connectionLimit = connectionLimit;
+  m_connectionTimeout = connectionTimeout;
+}
+
 void CWebServer::RegisterRequestHandler(IHTTPRequestHandler* handler)
 {
   if (handler == nullptr)
@@ -1333,6 +1532,24 @@ void CWebServer::UnregisterRequestHandler(IHTTPRequestHandler* handler)
                           m_requestHandlers.end());
 }
 
+std::map<std::string, CWebServer::HandlerMetrics> CWebServer::GetHandlerMetrics() const
+{
+  std::unique_lock lock(m_metricsSection);
+  return m_handlerMetrics;
+}
+
+void CWebServer::LogHandlerMetrics() const
+{
+  std::unique_lock lock(m_metricsSection);
+  for (const auto& [name, metrics] : m_handlerMetrics)
+  {
+    m_logger->debug("handler {}: {} requests, {} failed, up to {} concurrent, mean {} us, max {} us",
+                    name, metrics.requests, metrics.failed, metrics.maxActive,
+                    metrics.requests > 0 ? metrics.totalTime.count() / metrics.requests : 0,
+                    metrics.maxTime.count());
+  }
+}
+
 void CWebServer::LogRequest(const HTTPRequest& request) const
 {
   if (!CServiceBroker::GetLogging().CanLogComponent(LOGWEBSERVER))
@@ -12,7 +12,10 @@
 #include "threads/CriticalSection.h"
 #include "utils/logtypes.h"
 
+#include <chrono>
+#include <map>
 #include <memory>
+#include <string>
 #include <vector>
 
 namespace XFILE
@@ -34,9 +37,36 @@ public:
   static bool WebServerSupportsSSL();
   void SetCredentials(const std::string &username, const std::string &password);
 
+  /*!
+   \brief Sets how connections are served, takes effect on the next Start().
+   \param threadPoolSize number of threads polling the connections (with epoll where available),
+   0 to serve every connection with its own thread.
+   \param connectionLimit maximum number of concurrent connections, further ones are refused.
+   \param connectionTimeout seconds an idle connection is kept open for reuse.
+   */
+  void SetConnectionHandling(unsigned int threadPoolSize,
+                             unsigned int connectionLimit,
+                             unsigned int connectionTimeout);
+
   void RegisterRequestHandler(IHTTPRequestHandler *handler);
   void UnregisterRequestHandler(IHTTPRequestHandler *handler);
 
+  struct HandlerMetrics
+  {
+    uint64_t requests = 0;
+    uint64_t failed = 0; //!< requests answered with an error status
+    unsigned int active = 0;
+    unsigned int maxActive = 0;
+    //! time spent in the handler and creating the response, without sending it
+    std::chrono::microseconds totalTime{0};
+    std::chrono::microseconds maxTime{0};
+  };
+
+  /*!
+   \brief Returns the metrics of all request handlers which handled requests, by handler name.
+   */
+  std::map<std::string, HandlerMetrics> GetHandlerMetrics() const;
+
 protected:
   typedef struct ConnectionHandler
   {
@@ -58,8 +88,11 @@ protected:
 
 private:
   struct MHD_Daemon* StartMHD(unsigned int flags, int port);
+  void LogHandlerMetrics() const;
 
   std::shared_ptr<IHTTPRequestHandler> FindRequestHandler(const HTTPRequest& request) const;
+  MHD_RESULT CreateResponse(const std::shared_ptr<IHTTPRequestHandler>& handler,
+                            int& responseStatus);
 
   MHD_RESULT AskForAuthentication(const HTTPRequest& request) const;
   bool IsAuthenticated(const HTTPRequest& request) const;
@@ -76,6 +109,14 @@ private:
 
   MHD_RESULT CreateRedirect(struct MHD_Connection *connection, const std::string &strURL, struct MHD_Response *&response) const;
   MHD_RESULT CreateFileDownloadResponse(const std::shared_ptr<IHTTPRequestHandler>& handler, struct MHD_Response *&response) const;
+#if defined(TARGET_POSIX)
+  bool CreateLocalFileDownloadResponse(const std::shared_ptr<IHTTPRequestHandler>& handler,
+                                       const std::string& localPath,
+                                       struct MHD_Response*& response) const;
+  static std::string GetLocalFilePath(const std::string& filePath);
+#endif
+  std::string GetResponseMimeType(const std::shared_ptr<IHTTPRequestHandler>& handler,
+                                  const std::string& filePath) const;
   MHD_RESULT CreateErrorResponse(struct MHD_Connection *connection, int responseType, HTTPMethod method, struct MHD_Response *&response) const;
   MHD_RESULT CreateMemoryDownloadResponse(struct MHD_Connection *connection, const void *data, size_t size, bool free, bool copy, struct MHD_Response *&response) const;
 
@@ -113,6 +154,9 @@ private:
   struct MHD_Daemon *m_daemon_ip4 = nullptr;
   bool m_running = false;
   size_t m_thread_stacksize = 0;
+  unsigned int m_threadPoolSize = 0;
+  unsigned int m_connectionLimit = 512;
+  unsigned int m_connectionTimeout = 60 * 60 * 24;
   bool m_authenticationRequired = false;
   std::string m_authenticationUsername;
   std::string m_authenticationPassword;
@@ -120,6 +164,8 @@ private:
   std::string m_cert;
   mutable CCriticalSection m_critSection;
   std::vector<IHTTPRequestHandler *> m_requestHandlers;
+  mutable CCriticalSection m_metricsSection;
+  std::map<std::string, HandlerMetrics> m_handlerMetrics;
 
   Logger m_logger;
 };
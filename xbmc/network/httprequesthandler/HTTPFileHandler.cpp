@@ -39,6 +39,15 @@ bool CHTTPFileHandler::GetLastModifiedDate(CDateTime &lastModified) const
   return true;
 }
 
+bool CHTTPFileHandler::GetEntityTag(std::string& entityTag) const
+{
+  if (m_entityTag.empty())
+    return false;
+
+  entityTag = m_entityTag;
+  return true;
+}
+
 void CHTTPFileHandler::SetFile(const std::string& file, int responseStatus)
 {
   m_url = file;
@@ -100,4 +109,7 @@ void CHTTPFileHandler::SetLastModifiedDate(const struct __stat64 *statBuffer)
 #endif
   if (time != NULL)
     m_lastModified = *time;
+
+  m_entityTag = StringUtils::Format("\"{:x}-{:x}\"", static_cast<uint64_t>(statBuffer->st_mtime),
+                                    static_cast<uint64_t>(statBuffer->st_size));
 }
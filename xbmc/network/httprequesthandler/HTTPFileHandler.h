@@ -23,6 +23,7 @@ public:
   bool CanHandleRanges() const override { return m_canHandleRanges; }
   bool CanBeCached() const override { return m_canBeCached; }
   bool GetLastModifiedDate(CDateTime &lastModified) const override;
+  bool GetEntityTag(std::string& entityTag) const override;
 
   std::string GetRedirectUrl() const override { return m_url; }
   std::string GetResponseFile() const override { return m_url; }
@@ -44,5 +45,6 @@ private:
   bool m_canBeCached = true;
 
   CDateTime m_lastModified;
+  std::string m_entityTag;
 
 };
@@ -19,6 +19,7 @@ public:
   ~CHTTPImageHandler() override = default;
 
   IHTTPRequestHandler* Create(const HTTPRequest &request) const override { return new CHTTPImageHandler(request); }
+  std::string GetName() const override { return "image"; }
   bool CanHandleRequest(const HTTPRequest &request) const override;
 
   int GetPriority() const override { return 5; }
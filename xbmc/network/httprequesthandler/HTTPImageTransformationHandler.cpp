@@ -8,24 +8,90 @@
 
 #include "HTTPImageTransformationHandler.h"
 
+#include "ServiceBroker.h"
+#include "TextureCache.h"
 #include "TextureCacheJob.h"
 #include "URL.h"
+#include "filesystem/File.h"
 #include "filesystem/ImageFile.h"
+#include "imagefiles/ImageFileURL.h"
 #include "network/WebServer.h"
 #include "network/httprequesthandler/HTTPRequestHandlerUtils.h"
+#include "threads/CriticalSection.h"
+#include "threads/Event.h"
+#include "utils/Crc32.h"
 #include "utils/Mime.h"
 #include "utils/StringUtils.h"
 #include "utils/URIUtils.h"
+#include "utils/log.h"
 
 #include <charconv>
+#include <chrono>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <utility>
 
 #define TRANSFORMATION_OPTION_WIDTH             "width"
 #define TRANSFORMATION_OPTION_HEIGHT            "height"
 #define TRANSFORMATION_OPTION_SCALING_ALGORITHM "scaling_algorithm"
 
+#define TRANSFORMATION_CACHE_OPTION_SIZE    "transform"
+#define TRANSFORMATION_CACHE_OPTION_SCALING "transform_scaling"
+#define TRANSFORMATION_CACHE_OPTION_SOURCE  "transform_source"
+
+using namespace std::chrono_literals;
+
 static const std::string ImageBasePath = "/image/";
 
+namespace
+{
+// transformations currently being created, so that concurrent requests for the same
+// transformation wait for the first one instead of decoding and resizing the same image again
+CCriticalSection transformationsSection;
+std::map<std::string, std::shared_ptr<CEvent>> transformationsInProgress;
+
+// how long a request waits for the same transformation to be created by another request
+constexpr auto TRANSFORMATION_WAIT_TIMEOUT = 30s;
+
+//! Marks a transformation as done once it goes out of scope, even if creating it failed or threw.
+class CTransformationInProgress
+{
+public:
+  CTransformationInProgress(std::string cacheKey, std::shared_ptr<CEvent> event)
+    : m_cacheKey(std::move(cacheKey)), m_event(std::move(event))
+  {
+  }
+  ~CTransformationInProgress()
+  {
+    std::unique_lock lock(transformationsSection);
+    transformationsInProgress.erase(m_cacheKey);
+    m_event->Set();
+  }
+  CTransformationInProgress(const CTransformationInProgress&) = delete;
+  CTransformationInProgress& operator=(const CTransformationInProgress&) = delete;
+
+private:
+  const std::string m_cacheKey;
+  const std::shared_ptr<CEvent> m_event;
+};
+
+unsigned int GetDimension(const std::map<std::string, std::string>& options,
+                          const std::string& name)
+{
+  unsigned int value = 0;
+  const auto option = options.find(name);
+  if (option != options.end())
+  {
+    const std::string& str = option->second;
+    std::from_chars(str.data(), str.data() + str.size(), value);
+  }
+
+  return value;
+}
+} // unnamed namespace
+
 CHTTPImageTransformationHandler::CHTTPImageTransformationHandler()
   : m_url(),
     m_lastModified(),
@@ -61,17 +127,52 @@ CHTTPImageTransformationHandler::CHTTPImageTransformationHandler(const HTTPReque
   m_response.status = MHD_HTTP_OK;
 
   // determine the content type
-  std::string ext = URIUtils::GetExtension(pathToUrl.GetHostName());
-  StringUtils::ToLower(ext);
-  m_response.contentType = CMime::GetMimeType(ext);
+  m_extension = URIUtils::GetExtension(pathToUrl.GetHostName());
+  StringUtils::ToLower(m_extension);
+  m_response.contentType = CMime::GetMimeType(m_extension);
+
+  // get the transformation options
+  std::map<std::string, std::string> options;
+  HTTPRequestHandlerUtils::GetRequestHeaderValues(m_request.connection, MHD_GET_ARGUMENT_KIND, options);
+
+  m_width = GetDimension(options, TRANSFORMATION_OPTION_WIDTH);
+  m_height = GetDimension(options, TRANSFORMATION_OPTION_HEIGHT);
+
+  const auto option = options.find(TRANSFORMATION_OPTION_SCALING_ALGORITHM);
+  if (option != options.end())
+    m_scalingAlgorithm = CPictureScalingAlgorithm::FromString(option->second);
 
   //! @todo determine the maximum age
 
   // determine the last modified date
+  // the original image doesn't have to be in the texture cache
   struct __stat64 statBuffer;
-  if (imageFile.Stat(pathToUrl, &statBuffer) != 0)
+  if (imageFile.Stat(pathToUrl, &statBuffer) != 0 &&
+      XFILE::CFile::Stat(pathToUrl.GetHostName(), &statBuffer) != 0)
     return;
 
+  // the transformed image is only cached for the version of the image it has been created from
+  int64_t modified = statBuffer.st_mtime;
+  if (modified == 0)
+    modified = statBuffer.st_ctime;
+  if (modified != 0 || statBuffer.st_size != 0)
+  {
+    const std::string sourceHash =
+        StringUtils::Format("d{}s{}", modified, static_cast<int64_t>(statBuffer.st_size));
+
+    IMAGE_FILES::CImageFileURL imageURL(m_url);
+    imageURL.AddOption(TRANSFORMATION_CACHE_OPTION_SIZE,
+                       StringUtils::Format("{}x{}", m_width, m_height));
+    if (m_scalingAlgorithm != CPictureScalingAlgorithm::NoAlgorithm)
+      imageURL.AddOption(TRANSFORMATION_CACHE_OPTION_SCALING,
+                         CPictureScalingAlgorithm::ToString(m_scalingAlgorithm));
+    imageURL.AddOption(TRANSFORMATION_CACHE_OPTION_SOURCE, sourceHash);
+
+    m_cacheKey = imageURL.ToCacheKey();
+    m_entityTag =
+        StringUtils::Format("\"{:08x}-{}\"", Crc32::ComputeFromLowerCase(m_cacheKey), sourceHash);
+  }
+
   struct tm *time;
 #ifdef HAVE_LOCALTIME_R
   struct tm result = {};
@@ -88,7 +189,7 @@ CHTTPImageTransformationHandler::CHTTPImageTransformationHandler(const HTTPReque
 CHTTPImageTransformationHandler::~CHTTPImageTransformationHandler()
 {
   m_responseData.clear();
-  delete m_buffer;
+  delete[] m_buffer;
   m_buffer = NULL;
 }
 
@@ -111,35 +212,50 @@ MHD_RESULT CHTTPImageTransformationHandler::HandleRequest()
   if (m_response.type == HTTPError)
     return MHD_YES;
 
-  // get the transformation options
-  std::map<std::string, std::string> options;
-  HTTPRequestHandlerUtils::GetRequestHeaderValues(m_request.connection, MHD_GET_ARGUMENT_KIND, options);
+  // check if the same transformation has already been cached
+  if (GetCachedImage())
+    return MHD_YES;
 
-  unsigned int width = 0;
-  std::map<std::string, std::string>::const_iterator option = options.find(TRANSFORMATION_OPTION_WIDTH);
-  if (option != options.end())
+  std::shared_ptr<CEvent> inProgress;
+  bool transforming = false;
+  if (!m_cacheKey.empty())
   {
-    const std::string& str = option->second;
-    std::from_chars(str.data(), str.data() + str.size(), width);
+    std::unique_lock lock(transformationsSection);
+    auto& event = transformationsInProgress[m_cacheKey];
+    if (event == nullptr)
+    {
+      event = std::make_shared<CEvent>(true);
+      transforming = true;
+    }
+    inProgress = event;
   }
 
-  unsigned int height = 0;
-  option = options.find(TRANSFORMATION_OPTION_HEIGHT);
-  if (option != options.end())
+  std::optional<CTransformationInProgress> transformation;
+  if (transforming)
+    transformation.emplace(m_cacheKey, inProgress);
+
+  // another request is creating the same transformation so wait for it to be cached, if it takes
+  // too long or fails the image is transformed for this request as well
+  if (inProgress != nullptr && !transforming)
   {
-    const std::string& str = option->second;
-    std::from_chars(str.data(), str.data() + str.size(), height);
+    if (!inProgress->Wait(TRANSFORMATION_WAIT_TIMEOUT))
+      CLog::Log(LOGDEBUG,
+                "CHTTPImageTransformationHandler: gave up waiting for the transformation of {}",
+                m_url);
+    else if (GetCachedImage())
+      return MHD_YES;
   }
 
-  auto scalingAlgorithm{CPictureScalingAlgorithm::NoAlgorithm};
-  option = options.find(TRANSFORMATION_OPTION_SCALING_ALGORITHM);
-  if (option != options.end())
-    scalingAlgorithm = CPictureScalingAlgorithm::FromString(option->second);
-
   // resize the image into the local buffer
   size_t bufferSize;
-  if (!CTextureCacheJob::ResizeTexture(m_url, height, width, scalingAlgorithm, m_buffer,
-                                       bufferSize))
+  const bool resized = CTextureCacheJob::ResizeTexture(m_url, m_height, m_width,
+                                                       m_scalingAlgorithm, m_buffer, bufferSize);
+
+  if (resized && transforming)
+    CacheImage(bufferSize);
+  transformation.reset();
+
+  if (!resized)
   {
     m_response.status = MHD_HTTP_INTERNAL_SERVER_ERROR;
     m_response.type = HTTPError;
@@ -172,3 +288,74 @@ bool CHTTPImageTransformationHandler::GetLastModifiedDate(CDateTime &lastModifie
   lastModified = m_lastModified;
   return true;
 }
+
+bool CHTTPImageTransformationHandler::GetEntityTag(std::string& entityTag) const
+{
+  if (m_entityTag.empty())
+    return false;
+
+  entityTag = m_entityTag;
+  return true;
+}
+
+bool CHTTPImageTransformationHandler::GetCachedImage()
+{
+  if (m_cacheKey.empty())
+    return false;
+
+  const std::shared_ptr<CTextureCache> textureCache = CServiceBroker::GetTextureCache();
+  if (textureCache == nullptr)
+    return false;
+
+  bool needsRecaching = false;
+  const std::string cachedFile = textureCache->CheckCachedImage(m_cacheKey, needsRecaching);
+  if (cachedFile.empty() || !XFILE::CFile::Exists(cachedFile))
+    return false;
+
+  // let the webserver send the cached file including any requested ranges
+  m_cachedFile = cachedFile;
+  m_response.type = HTTPFileDownload;
+  m_response.status = MHD_HTTP_OK;
+
+  return true;
+}
+
+void CHTTPImageTransformationHandler::CacheImage(size_t size) const
+{
+  if (m_cacheKey.empty() || m_buffer == nullptr || size == 0)
+    return;
+
+  const std::shared_ptr<CTextureCache> textureCache = CServiceBroker::GetTextureCache();
+  if (textureCache == nullptr)
+    return;
+
+  // the image has been encoded in the format of the original image
+  CTextureDetails details;
+  details.file = CTextureCache::GetCacheFile(m_cacheKey);
+  details.file += m_extension;
+  details.width = m_width;
+  details.height = m_height;
+  // the version of the original image is part of the URL so there is nothing to revalidate
+  details.updateable = false;
+
+  const std::string cachedPath = CTextureCache::GetCachedPath(details.file);
+
+  XFILE::CFile file;
+  if (!file.OpenForWrite(cachedPath, true))
+  {
+    CLog::Log(LOGWARNING, "CHTTPImageTransformationHandler: failed to cache {} in {}", m_cacheKey,
+              cachedPath);
+    return;
+  }
+
+  const bool written = file.Write(m_buffer, size) == static_cast<ssize_t>(size);
+  file.Close();
+  if (!written)
+  {
+    CLog::Log(LOGWARNING, "CHTTPImageTransformationHandler: failed to write {}", cachedPath);
+    XFILE::CFile::Delete(cachedPath);
+    return;
+  }
+
+  textureCache->AddCachedTexture(m_cacheKey, details);
+}
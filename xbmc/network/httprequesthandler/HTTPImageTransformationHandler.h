@@ -10,6 +10,7 @@
 
 #include "XBDateTime.h"
 #include "network/httprequesthandler/IHTTPRequestHandler.h"
+#include "pictures/PictureScalingAlgorithm.h"
 
 #include <stdint.h>
 #include <string>
@@ -21,6 +22,7 @@ public:
   ~CHTTPImageTransformationHandler() override;
 
   IHTTPRequestHandler* Create(const HTTPRequest &request) const override { return new CHTTPImageTransformationHandler(request); }
+  std::string GetName() const override { return "imagetransformation"; }
   bool CanHandleRequest(const HTTPRequest &request)const  override;
 
   MHD_RESULT HandleRequest() override;
@@ -28,7 +30,9 @@ public:
   bool CanHandleRanges() const override { return true; }
   bool CanBeCached() const override { return true; }
   bool GetLastModifiedDate(CDateTime &lastModified) const override;
+  bool GetEntityTag(std::string& entityTag) const override;
 
+  std::string GetResponseFile() const override { return m_cachedFile; }
   HttpResponseRanges GetResponseData() const override { return m_responseData; }
 
   // priority must be higher than the one of CHTTPImageHandler
@@ -38,9 +42,29 @@ protected:
   explicit CHTTPImageTransformationHandler(const HTTPRequest &request);
 
 private:
+  /*!
+   * \brief Serves the transformed image from the texture cache if it has already been created.
+   */
+  bool GetCachedImage();
+  /*!
+   * \brief Stores the transformed image in the texture cache so that later requests for the same
+   * transformation of the same version of the image don't have to decode and resize it again.
+   */
+  void CacheImage(size_t size) const;
+
   std::string m_url;
   CDateTime m_lastModified;
 
+  unsigned int m_width = 0;
+  unsigned int m_height = 0;
+  CPictureScalingAlgorithm::Algorithm m_scalingAlgorithm = CPictureScalingAlgorithm::NoAlgorithm;
+  std::string m_extension;
+
+  //! texture cache URL of the transformed image, empty if it can't be cached
+  std::string m_cacheKey;
+  std::string m_entityTag;
+  std::string m_cachedFile;
+
   uint8_t* m_buffer;
   HttpResponseRanges m_responseData;
 };
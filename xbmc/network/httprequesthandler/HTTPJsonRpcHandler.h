@@ -22,6 +22,7 @@ public:
 
   // implementations of IHTTPRequestHandler
   IHTTPRequestHandler* Create(const HTTPRequest &request) const override { return new CHTTPJsonRpcHandler(request); }
+  std::string GetName() const override { return "jsonrpc"; }
   bool CanHandleRequest(const HTTPRequest &request) const override;
 
   MHD_RESULT HandleRequest() override;
@@ -20,6 +20,7 @@ public:
   ~CHTTPPythonHandler() override = default;
 
   IHTTPRequestHandler* Create(const HTTPRequest &request) const override { return new CHTTPPythonHandler(request); }
+  std::string GetName() const override { return "python"; }
   bool CanHandleRequest(const HTTPRequest &request) const override;
   bool CanHandleRanges() const override { return false; }
   bool CanBeCached() const override { return false; }
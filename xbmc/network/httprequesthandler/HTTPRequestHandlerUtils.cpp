@@ -62,6 +62,31 @@ bool HTTPRequestHandlerUtils::GetRequestedRanges(struct MHD_Connection *connecti
   return ranges.Parse(GetRequestHeaderValue(connection, MHD_HEADER_KIND, MHD_HTTP_HEADER_RANGE), totalLength);
 }
 
+bool HTTPRequestHandlerUtils::MatchesEntityTag(const std::string& ifNoneMatch,
+                                               const std::string& entityTag)
+{
+  const auto stripWeak = [](std::string tag)
+  {
+    StringUtils::Trim(tag);
+    if (StringUtils::StartsWith(tag, "W/"))
+      tag.erase(0, 2);
+    return tag;
+  };
+
+  const std::string tag = stripWeak(entityTag);
+  if (tag.empty())
+    return false;
+
+  for (const std::string& value : StringUtils::Split(ifNoneMatch, ","))
+  {
+    const std::string candidate = stripWeak(value);
+    if (candidate == "*" || candidate == tag)
+      return true;
+  }
+
+  return false;
+}
+
 MHD_RESULT HTTPRequestHandlerUtils::FillArgumentMap(void *cls, enum MHD_ValueKind kind, const char *key, const char *value)
 {
   if (cls == nullptr || key == nullptr)
@@ -22,6 +22,13 @@ public:
 
   static bool GetRequestedRanges(struct MHD_Connection *connection, uint64_t totalLength, CHttpRanges &ranges);
 
+  /*!
+   * \brief Checks whether the value of an If-None-Match header matches the given entity tag.
+   *
+   * \details Uses the weak comparison, so "W/" prefixes are ignored.
+   */
+  static bool MatchesEntityTag(const std::string& ifNoneMatch, const std::string& entityTag);
+
 private:
   HTTPRequestHandlerUtils() = delete;
 
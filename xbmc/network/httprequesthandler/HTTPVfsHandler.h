@@ -19,6 +19,7 @@ public:
   ~CHTTPVfsHandler() override = default;
 
   IHTTPRequestHandler* Create(const HTTPRequest &request) const override { return new CHTTPVfsHandler(request); }
+  std::string GetName() const override { return "vfs"; }
   bool CanHandleRequest(const HTTPRequest &request) const override;
 
   int GetPriority() const override { return 5; }
@@ -19,6 +19,7 @@ public:
   ~CHTTPWebinterfaceAddonsHandler() override = default;
 
   IHTTPRequestHandler* Create(const HTTPRequest &request) const override { return new CHTTPWebinterfaceAddonsHandler(request); }
+  std::string GetName() const override { return "webinterfaceaddons"; }
   bool CanHandleRequest(const HTTPRequest &request) const override;
 
   MHD_RESULT HandleRequest() override;
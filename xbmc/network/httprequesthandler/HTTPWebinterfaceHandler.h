@@ -20,6 +20,7 @@ public:
   ~CHTTPWebinterfaceHandler() override = default;
 
   IHTTPRequestHandler* Create(const HTTPRequest &request) const override { return new CHTTPWebinterfaceHandler(request); }
+  std::string GetName() const override { return "webinterface"; }
   bool CanHandleRequest(const HTTPRequest &request) const override;
 
   static int ResolveUrl(const std::string &url, std::string &path);
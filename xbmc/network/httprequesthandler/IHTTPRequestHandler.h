@@ -99,6 +99,11 @@ public:
    */
   virtual IHTTPRequestHandler* Create(const HTTPRequest &request) const = 0;
 
+  /*!
+   * \brief Returns the name of the HTTP request handler used to collect its metrics.
+   */
+  virtual std::string GetName() const = 0;
+
   /*!
    * \brief Returns the priority of the HTTP request handler.
    *
@@ -146,6 +151,13 @@ public:
   */
   virtual bool GetLastModifiedDate(CDateTime &lastModified) const { return false; }
 
+  /*!
+  * \brief Returns the entity tag (including the quotes) identifying the response data.
+  *
+  * \details This is only used if the response can be cached.
+  */
+  virtual bool GetEntityTag(std::string& entityTag) const { return false; }
+
   /*!
    * \brief Returns the ranges with raw data belonging to the response.
    *
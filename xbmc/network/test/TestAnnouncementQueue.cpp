@@ -0,0 +1,147 @@
+/*
+ *  Copyright (C) 2026 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "network/AnnouncementQueue.h"
+#include "utils/JSONVariantParser.h"
+#include "utils/Variant.h"
+
+#include <memory>
+#include <string>
+
+#include <gtest/gtest.h>
+
+using namespace JSONRPC;
+
+namespace
+{
+CVariant CreateUpdate(const std::string& type, int id)
+{
+  CVariant data;
+  data["item"]["type"] = type;
+  data["item"]["id"] = id;
+  return data;
+}
+
+std::string GetUpdateKey(const std::string& type, int id)
+{
+  return CAnnouncementQueue::GetCoalescingKey(ANNOUNCEMENT::VideoLibrary, "xbmc", "OnUpdate",
+                                              CreateUpdate(type, id));
+}
+
+std::shared_ptr<const std::string> MakeNotification(const std::string& notification)
+{
+  return std::make_shared<const std::string>(notification);
+}
+} // unnamed namespace
+
+TEST(TestAnnouncementQueue, GetCoalescingKey)
+{
+  EXPECT_FALSE(GetUpdateKey("movie", 1).empty());
+  EXPECT_EQ(GetUpdateKey("movie", 1), GetUpdateKey("movie", 1));
+  EXPECT_NE(GetUpdateKey("movie", 1), GetUpdateKey("movie", 2));
+  EXPECT_NE(GetUpdateKey("movie", 1), GetUpdateKey("episode", 1));
+
+  CVariant added = CreateUpdate("movie", 1);
+  added["added"] = true;
+  EXPECT_TRUE(CAnnouncementQueue::GetCoalescingKey(ANNOUNCEMENT::VideoLibrary, "xbmc",
+                                                   "OnUpdate", added)
+                  .empty());
+  EXPECT_TRUE(CAnnouncementQueue::GetCoalescingKey(ANNOUNCEMENT::VideoLibrary, "xbmc",
+                                                   "OnRemove", CreateUpdate("movie", 1))
+                  .empty());
+  EXPECT_TRUE(CAnnouncementQueue::GetCoalescingKey(ANNOUNCEMENT::Player, "xbmc", "OnPlay",
+                                                   CreateUpdate("movie", 1))
+                  .empty());
+}
+
+TEST(TestAnnouncementQueue, CoalescesUpdatesOfSameItem)
+{
+  CAnnouncementQueue queue(true);
+
+  EXPECT_TRUE(queue.Push(GetUpdateKey("movie", 1), MakeNotification("movie 1")));
+  EXPECT_TRUE(queue.Push(GetUpdateKey("movie", 2), MakeNotification("movie 2")));
+  EXPECT_TRUE(queue.Push(GetUpdateKey("movie", 1), MakeNotification("movie 1 again")));
+
+  EXPECT_EQ(2u, queue.Size());
+  EXPECT_EQ(1u, queue.GetStats().coalesced);
+  EXPECT_EQ(2u, queue.GetStats().maxDepth);
+  EXPECT_EQ("movie 1 again", *queue.Pop());
+  EXPECT_EQ("movie 2", *queue.Pop());
+  EXPECT_EQ(nullptr, queue.Pop());
+  EXPECT_EQ(0u, queue.Bytes());
+
+  // an update which was already taken from the queue isn't replaced
+  EXPECT_TRUE(queue.Push(GetUpdateKey("movie", 1), MakeNotification("movie 1")));
+  EXPECT_EQ(1u, queue.Size());
+  EXPECT_EQ("movie 1", *queue.Pop());
+}
+
+TEST(TestAnnouncementQueue, KeepsOrderAroundOtherNotifications)
+{
+  CAnnouncementQueue queue(true);
+
+  EXPECT_TRUE(queue.Push(GetUpdateKey("movie", 1), MakeNotification("update 1")));
+  EXPECT_TRUE(queue.Push("", MakeNotification("remove")));
+  EXPECT_TRUE(queue.Push(GetUpdateKey("movie", 1), MakeNotification("update 2")));
+  EXPECT_TRUE(queue.Push(GetUpdateKey("movie", 1), MakeNotification("update 3")));
+
+  // the copy must coalesce the same way
+  CAnnouncementQueue copy(queue);
+  EXPECT_TRUE(copy.Push(GetUpdateKey("movie", 1), MakeNotification("update 4")));
+
+  EXPECT_EQ(3u, queue.Size());
+  EXPECT_EQ("update 1", *queue.Pop());
+  EXPECT_EQ("remove", *queue.Pop());
+  EXPECT_EQ("update 3", *queue.Pop());
+
+  EXPECT_EQ(3u, copy.Size());
+  EXPECT_EQ("update 1", *copy.Pop());
+  EXPECT_EQ("remove", *copy.Pop());
+  EXPECT_EQ("update 4", *copy.Pop());
+}
+
+TEST(TestAnnouncementQueue, ResyncsWhenFull)
+{
+  CAnnouncementQueue queue(true, 4);
+
+  for (int i = 0; i < 4; i++)
+    EXPECT_TRUE(queue.Push("", MakeNotification("notification")));
+  EXPECT_FALSE(queue.Push("", MakeNotification("notification")));
+  EXPECT_EQ(1u, queue.Size());
+
+  // another overflow before the client took the resync notification adds up
+  for (int i = 0; i < 3; i++)
+    EXPECT_TRUE(queue.Push("", MakeNotification("notification")));
+  EXPECT_FALSE(queue.Push("", MakeNotification("notification")));
+
+  EXPECT_EQ(9u, queue.GetStats().dropped);
+  EXPECT_EQ(2u, queue.GetStats().resyncs);
+
+  CVariant resync;
+  ASSERT_TRUE(CJSONVariantParser::Parse(*queue.Pop(), resync));
+  EXPECT_EQ("System.OnResync", resync["method"].asString());
+  EXPECT_EQ(9u, resync["params"]["data"]["dropped"].asUnsignedInteger());
+  EXPECT_TRUE(queue.Empty());
+
+  // the next resync only reports what was dropped after the last one
+  for (int i = 0; i < 5; i++)
+    queue.Push("", MakeNotification("notification"));
+  ASSERT_TRUE(CJSONVariantParser::Parse(*queue.Pop(), resync));
+  EXPECT_EQ(5u, resync["params"]["data"]["dropped"].asUnsignedInteger());
+}
+
+TEST(TestAnnouncementQueue, ResyncsWhenTooLarge)
+{
+  CAnnouncementQueue queue(true, CAnnouncementQueue::DEFAULT_MAX_LENGTH, 1000);
+
+  EXPECT_TRUE(queue.Push("", MakeNotification(std::string(600, 'a'))));
+  EXPECT_FALSE(queue.Push("", MakeNotification(std::string(600, 'b'))));
+  EXPECT_EQ(2u, queue.GetStats().dropped);
+  EXPECT_EQ(1u, queue.Size());
+  EXPECT_LT(queue.Bytes(), 1000u);
+}
@@ -0,0 +1,272 @@
+/*
+ *  Copyright (C) 2026 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "ServiceBroker.h"
+#include "interfaces/AnnouncementManager.h"
+#include "interfaces/json-rpc/JSONRPC.h"
+#include "network/TCPServer.h"
+#include "settings/AdvancedSettings.h"
+#include "settings/SettingsComponent.h"
+#include "utils/JSONVariantParser.h"
+#include "utils/JSONVariantWriter.h"
+#include "utils/Variant.h"
+
+#include <chrono>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+
+using namespace std::chrono_literals;
+
+namespace
+{
+constexpr auto TIMEOUT = 10s;
+
+class CTestClient
+{
+public:
+  ~CTestClient()
+  {
+    if (m_socket >= 0)
+      close(m_socket);
+  }
+
+  //! Connects to the server, a receive buffer size of 0 keeps the default.
+  bool Connect(uint16_t port, int receiveBufferSize = 0)
+  {
+    m_socket = socket(AF_INET, SOCK_STREAM, 0);
+    if (m_socket < 0)
+      return false;
+
+    // has to be set before connecting to limit the advertised window
+    if (receiveBufferSize > 0 &&
+        setsockopt(m_socket, SOL_SOCKET, SO_RCVBUF, &receiveBufferSize,
+                   sizeof(receiveBufferSize)) != 0)
+      return false;
+
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    return connect(m_socket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0;
+  }
+
+  bool Send(const std::string& data)
+  {
+    size_t sent = 0;
+    while (sent < data.size())
+    {
+      const ssize_t result = send(m_socket, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+      if (result <= 0)
+        return false;
+      sent += result;
+    }
+    return true;
+  }
+
+  bool SendRequest(int id, const std::string& method)
+  {
+    return Send("{\"jsonrpc\": \"2.0\", \"method\": \"" + method +
+                "\", \"id\": " + std::to_string(id) + "}");
+  }
+
+  enum class ReadResult
+  {
+    DATA,
+    CLOSED,
+    TIMEOUT
+  };
+
+  //! Appends the next data the server sent to the given buffer.
+  ReadResult Read(std::string& data)
+  {
+    pollfd fd = {m_socket, POLLIN, 0};
+    const int timeout = std::chrono::duration_cast<std::chrono::milliseconds>(TIMEOUT).count();
+    if (poll(&fd, 1, timeout) <= 0)
+      return ReadResult::TIMEOUT;
+
+    char buffer[4096];
+    const ssize_t result = recv(m_socket, buffer, sizeof(buffer), 0);
+    if (result <= 0)
+      return ReadResult::CLOSED;
+
+    data.append(buffer, result);
+    return ReadResult::DATA;
+  }
+
+  //! Reads until the data the server sent is a complete JSON value.
+  bool ReadResponse(CVariant& response)
+  {
+    std::string data;
+    while (Read(data) == ReadResult::DATA)
+    {
+      if (CJSONVariantParser::Parse(data, response))
+        return true;
+    }
+    return false;
+  }
+
+  //! Reads and drops everything the server sends until it closes the connection.
+  bool WaitForClose(size_t& received)
+  {
+    std::string data;
+    while (true)
+    {
+      switch (Read(data))
+      {
+        case ReadResult::DATA:
+          received += data.size();
+          data.clear();
+          break;
+        case ReadResult::CLOSED:
+          return true;
+        case ReadResult::TIMEOUT:
+          return false;
+      }
+    }
+  }
+
+private:
+  int m_socket = -1;
+};
+} // unnamed namespace
+
+class TestTCPServer : public testing::Test
+{
+protected:
+  TestTCPServer()
+  {
+    static uint16_t port;
+    if (port == 0)
+    {
+      std::random_device rd;
+      std::mt19937 mt(rd());
+      std::uniform_int_distribution<uint16_t> dist(49152, 65535);
+      port = dist(mt);
+    }
+    m_port = port;
+  }
+
+  void SetUp() override
+  {
+    m_advancedSettings = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings();
+    m_connectionLimit = m_advancedSettings->m_jsonTcpConnectionLimit;
+    m_sendBufferLimit = m_advancedSettings->m_jsonTcpSendBufferLimit;
+
+    CServiceBroker::RegisterAnnouncementManager(
+        std::make_shared<ANNOUNCEMENT::CAnnouncementManager>());
+    JSONRPC::CJSONRPC::Initialize();
+  }
+
+  void TearDown() override
+  {
+    JSONRPC::CTCPServer::StopServer(true);
+
+    JSONRPC::CJSONRPC::Cleanup();
+    CServiceBroker::UnregisterAnnouncementManager();
+
+    m_advancedSettings->m_jsonTcpConnectionLimit = m_connectionLimit;
+    m_advancedSettings->m_jsonTcpSendBufferLimit = m_sendBufferLimit;
+  }
+
+  bool Ping(CTestClient& client, int id)
+  {
+    CVariant response;
+    return client.SendRequest(id, "JSONRPC.Ping") && client.ReadResponse(response) &&
+           response["id"].asInteger() == id && response["result"].asString() == "pong";
+  }
+
+  uint16_t m_port;
+  std::shared_ptr<CAdvancedSettings> m_advancedSettings;
+
+private:
+  unsigned int m_connectionLimit = 0;
+  unsigned int m_sendBufferLimit = 0;
+};
+
+TEST_F(TestTCPServer, CanSendResponseLargerThanSocketBuffer)
+{
+  ASSERT_TRUE(JSONRPC::CTCPServer::StartServer(m_port, false));
+
+  CTestClient client;
+  ASSERT_TRUE(client.Connect(m_port, 4096));
+  ASSERT_TRUE(client.SendRequest(1, "JSONRPC.Introspect"));
+
+  // don't read for a while, the server has to keep what the socket doesn't take
+  std::this_thread::sleep_for(500ms);
+
+  CVariant response;
+  ASSERT_TRUE(client.ReadResponse(response));
+  EXPECT_EQ(1, response["id"].asInteger());
+  EXPECT_TRUE(response["result"]["methods"].isMember("JSONRPC.Introspect"));
+
+  // the connection is still usable
+  EXPECT_TRUE(Ping(client, 2));
+}
+
+TEST_F(TestTCPServer, ClosesClientNotReadingResponses)
+{
+  constexpr int REQUESTS = 20;
+
+  m_advancedSettings->m_jsonTcpSendBufferLimit = 64;
+  ASSERT_TRUE(JSONRPC::CTCPServer::StartServer(m_port, false));
+
+  // every response is several times larger than the send buffer limit
+  CTestClient slowClient;
+  ASSERT_TRUE(slowClient.Connect(m_port, 4096));
+  for (int id = 0; id < REQUESTS; ++id)
+    ASSERT_TRUE(slowClient.SendRequest(id, "JSONRPC.Introspect"));
+
+  // other clients are still served while the slow client doesn't read
+  CTestClient client;
+  ASSERT_TRUE(client.Connect(m_port));
+  EXPECT_TRUE(Ping(client, 1));
+
+  // the slow client gets what was already sent to it before the connection is closed
+  size_t received = 0;
+  EXPECT_TRUE(slowClient.WaitForClose(received));
+
+  CTestClient introspectClient;
+  ASSERT_TRUE(introspectClient.Connect(m_port));
+  ASSERT_TRUE(introspectClient.SendRequest(1, "JSONRPC.Introspect"));
+  CVariant response;
+  ASSERT_TRUE(introspectClient.ReadResponse(response));
+  std::string json;
+  ASSERT_TRUE(CJSONVariantWriter::Write(response, json, true));
+  EXPECT_LT(received, REQUESTS * json.size());
+
+  EXPECT_TRUE(Ping(client, 2));
+}
+
+TEST_F(TestTCPServer, RejectsConnectionsBeyondLimit)
+{
+  m_advancedSettings->m_jsonTcpConnectionLimit = 1;
+  ASSERT_TRUE(JSONRPC::CTCPServer::StartServer(m_port, false));
+
+  CTestClient client;
+  ASSERT_TRUE(client.Connect(m_port));
+  ASSERT_TRUE(Ping(client, 1));
+
+  // the connection is accepted by the system but closed by the server right away
+  CTestClient rejectedClient;
+  ASSERT_TRUE(rejectedClient.Connect(m_port));
+  size_t received = 0;
+  EXPECT_TRUE(rejectedClient.WaitForClose(received));
+  EXPECT_EQ(0U, received);
+
+  EXPECT_TRUE(Ping(client, 2));
+}
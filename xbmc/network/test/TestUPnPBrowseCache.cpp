@@ -0,0 +1,105 @@
+/*
+ *  Copyright (C) 2026 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "FileItem.h"
+#include "FileItemList.h"
+#include "network/upnp/UPnPBrowseCache.h"
+
+#include <chrono>
+#include <limits>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+using namespace std::chrono_literals;
+using namespace UPNP;
+
+namespace
+{
+std::shared_ptr<CFileItemList> CreateListing(const std::string& path, int count)
+{
+  auto items = std::make_shared<CFileItemList>(path);
+  for (int i = 0; i < count; ++i)
+    items->Add(std::make_shared<CFileItem>(path + std::to_string(i) + "/", true));
+  return items;
+}
+} // unnamed namespace
+
+TEST(TestUPnPBrowseCache, GetAddedListing)
+{
+  CUPnPBrowseCache cache(2, 1min);
+  EXPECT_EQ(nullptr, cache.Get("videodb://movies/titles/"));
+
+  const auto movies = CreateListing("videodb://movies/titles/", 3);
+  cache.Add(movies);
+  EXPECT_EQ(movies, cache.Get("videodb://movies/titles/"));
+  EXPECT_EQ(nullptr, cache.Get("videodb://tvshows/titles/"));
+
+  // a newer listing of the same container replaces the old one
+  const auto newMovies = CreateListing("videodb://movies/titles/", 4);
+  cache.Add(newMovies);
+  EXPECT_EQ(newMovies, cache.Get("videodb://movies/titles/"));
+
+  cache.Clear();
+  EXPECT_EQ(nullptr, cache.Get("videodb://movies/titles/"));
+}
+
+TEST(TestUPnPBrowseCache, DropsLeastRecentlyUsedListing)
+{
+  CUPnPBrowseCache cache(2, 1min);
+  const auto movies = CreateListing("videodb://movies/titles/", 3);
+  const auto tvShows = CreateListing("videodb://tvshows/titles/", 3);
+  const auto songs = CreateListing("musicdb://songs/", 3);
+
+  cache.Add(movies);
+  cache.Add(tvShows);
+  ASSERT_EQ(movies, cache.Get("videodb://movies/titles/"));
+
+  cache.Add(songs);
+  EXPECT_EQ(movies, cache.Get("videodb://movies/titles/"));
+  EXPECT_EQ(songs, cache.Get("musicdb://songs/"));
+  EXPECT_EQ(nullptr, cache.Get("videodb://tvshows/titles/"));
+}
+
+TEST(TestUPnPBrowseCache, DropsExpiredListing)
+{
+  CUPnPBrowseCache cache(2, 10ms);
+  cache.Add(CreateListing("videodb://movies/titles/", 3));
+
+  std::this_thread::sleep_for(50ms);
+  EXPECT_EQ(nullptr, cache.Get("videodb://movies/titles/"));
+}
+
+TEST(TestUPnPBrowseCache, GetPage)
+{
+  const auto items = CreateListing("videodb://movies/titles/", 10);
+
+  CFileItemList page;
+  CUPnPBrowseCache::GetPage(*items, 4, 3, page);
+  ASSERT_EQ(3, page.Size());
+  EXPECT_EQ(items->Get(4)->GetPath(), page.Get(0)->GetPath());
+  EXPECT_EQ(items->Get(6)->GetPath(), page.Get(2)->GetPath());
+  // the listing may be shared, the page holds copies of its items
+  EXPECT_NE(items->Get(4), page.Get(0));
+
+  // the last page is cut short
+  page.Clear();
+  CUPnPBrowseCache::GetPage(*items, 8, 5, page);
+  ASSERT_EQ(2, page.Size());
+  EXPECT_EQ(items->Get(9)->GetPath(), page.Get(1)->GetPath());
+
+  page.Clear();
+  CUPnPBrowseCache::GetPage(*items, 1, std::numeric_limits<unsigned int>::max(), page);
+  EXPECT_EQ(9, page.Size());
+
+  page.Clear();
+  CUPnPBrowseCache::GetPage(*items, 10, 5, page);
+  EXPECT_EQ(0, page.Size());
+}
@@ -10,13 +10,19 @@
 #  include <windows.h>
 #endif
 
+#include "FileItemList.h"
 #include "ServiceBroker.h"
+#include "TextureCache.h"
 #include "URL.h"
+#include "Util.h"
 #include "filesystem/CurlFile.h"
 #include "filesystem/File.h"
+#include "imagefiles/ImageFileURL.h"
 #include "interfaces/json-rpc/JSONRPC.h"
+#include "jobs/JobManager.h"
 #include "network/DNSNameCache.h"
 #include "network/WebServer.h"
+#include "network/httprequesthandler/HTTPImageTransformationHandler.h"
 #include "network/httprequesthandler/HTTPJsonRpcHandler.h"
 #include "network/httprequesthandler/HTTPVfsHandler.h"
 #include "settings/MediaSourceSettings.h"
@@ -26,9 +32,15 @@
 #include "utils/URIUtils.h"
 #include "utils/Variant.h"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <errno.h>
+#include <memory>
 #include <random>
 #include <stdlib.h>
+#include <thread>
+#include <vector>
 
 #include <gtest/gtest.h>
 
@@ -542,6 +554,62 @@ TEST_F(TestWebServer, CanModifyOverJsonRpcWithHttpPost)
   JSONRPC::CJSONRPC::Cleanup();
 }
 
+TEST_F(TestWebServer, CanExecuteBatchOverJsonRpcInOrder)
+{
+  // read only calls of a batch are executed on the job manager
+  CServiceBroker::RegisterJobManager(std::make_shared<CJobManager>());
+  // initialized JSON-RPC
+  JSONRPC::CJSONRPC::Initialize();
+
+  // consecutive Files.GetSources calls run in parallel, JSONRPC.Version separates them and the
+  // notification doesn't get a response
+  const auto getSources = [](int id)
+  {
+    return "{ \"jsonrpc\": \"2.0\", \"method\": \"Files.GetSources\", "
+           "\"params\": { \"media\": \"video\" }, \"id\": " +
+           std::to_string(id) + " }";
+  };
+  std::string batch = "[ ";
+  for (int id = 1; id <= 4; ++id)
+    batch += getSources(id) + ", ";
+  batch += "{ \"jsonrpc\": \"2.0\", \"method\": \"JSONRPC.Version\", \"id\": 5 }, ";
+  batch += "{ \"jsonrpc\": \"2.0\", \"method\": \"Files.GetSources\", "
+           "\"params\": { \"media\": \"video\" } }, ";
+  for (int id = 6; id <= 8; ++id)
+    batch += getSources(id) + (id < 8 ? ", " : " ]");
+
+  std::string result;
+  CCurlFile curl;
+  curl.SetMimeType("application/json");
+  ASSERT_TRUE(curl.Post(GetUrl(TEST_URL_JSONRPC), batch, result));
+
+  // parse the JSON-RPC response
+  CVariant resultObj;
+  ASSERT_TRUE(CJSONVariantParser::Parse(result, resultObj));
+  // the responses must be in the order of the requests
+  ASSERT_TRUE(resultObj.isArray());
+  ASSERT_EQ(8U, resultObj.size());
+  for (unsigned int index = 0; index < resultObj.size(); ++index)
+  {
+    const CVariant& response = resultObj[index];
+    EXPECT_EQ(static_cast<int64_t>(index + 1), response["id"].asInteger());
+    ASSERT_TRUE(response.isMember("result"));
+    if (index + 1 == 5)
+      EXPECT_TRUE(response["result"].isMember("version"));
+    else
+    {
+      ASSERT_TRUE(response["result"]["sources"].isArray());
+      EXPECT_EQ(1U, response["result"]["sources"].size());
+    }
+  }
+
+  // uninitialize JSON-RPC
+  JSONRPC::CJSONRPC::Cleanup();
+  // wait for the workers to finish before the job manager goes away
+  CServiceBroker::GetJobManager()->CancelJobs();
+  CServiceBroker::UnregisterJobManager();
+}
+
 TEST_F(TestWebServer, CanNotHeadNonExistingFile)
 {
   CCurlFile curl;
@@ -672,6 +740,46 @@ TEST_F(TestWebServer, CanGetCachedFileWithNewerIfModifiedSinceForcingNoCache)
   CheckRangesTestFileResponse(curl);
 }
 
+TEST_F(TestWebServer, CanGetCachedFileWithMatchingIfNoneMatch)
+{
+  // get the entity tag of the file
+  std::string result;
+  CCurlFile curl;
+  curl.SetRequestHeader(MHD_HTTP_HEADER_RANGE, "");
+  ASSERT_TRUE(curl.Get(GetUrlOfTestFile(TEST_FILES_RANGES), result));
+  const std::string entityTag = curl.GetHttpHeader().GetValue(MHD_HTTP_HEADER_ETAG);
+  ASSERT_FALSE(entityTag.empty());
+
+  // get the file with a matching If-None-Match value
+  CCurlFile curlIfNoneMatch;
+  curlIfNoneMatch.SetRequestHeader(MHD_HTTP_HEADER_RANGE, "");
+  curlIfNoneMatch.SetRequestHeader(MHD_HTTP_HEADER_IF_NONE_MATCH, "\"other\", W/" + entityTag);
+  ASSERT_TRUE(curlIfNoneMatch.Get(GetUrlOfTestFile(TEST_FILES_RANGES), result));
+  ASSERT_TRUE(result.empty());
+  CheckRangesTestFileResponse(curlIfNoneMatch, MHD_HTTP_NOT_MODIFIED, true);
+  EXPECT_EQ(entityTag, curlIfNoneMatch.GetHttpHeader().GetValue(MHD_HTTP_HEADER_ETAG));
+}
+
+TEST_F(TestWebServer, CanGetCachedFileWithNonMatchingIfNoneMatch)
+{
+  // get the last modified date of the file
+  CDateTime lastModified;
+  ASSERT_TRUE(GetLastModifiedOfTestFile(TEST_FILES_RANGES, lastModified));
+  CDateTime lastModifiedNewer = lastModified + CDateTimeSpan(1, 0, 0, 0);
+
+  // get the file with a different If-None-Match value which takes precedence over the newer
+  // If-Modified-Since value
+  std::string result;
+  CCurlFile curl;
+  curl.SetRequestHeader(MHD_HTTP_HEADER_RANGE, "");
+  curl.SetRequestHeader(MHD_HTTP_HEADER_IF_NONE_MATCH, "\"other\"");
+  curl.SetRequestHeader(MHD_HTTP_HEADER_IF_MODIFIED_SINCE,
+                        lastModifiedNewer.GetAsRFC1123DateTime());
+  ASSERT_TRUE(curl.Get(GetUrlOfTestFile(TEST_FILES_RANGES), result));
+  EXPECT_STREQ(TEST_FILES_DATA_RANGES, result.c_str());
+  CheckRangesTestFileResponse(curl);
+}
+
 TEST_F(TestWebServer, CanGetCachedFileWithOlderIfUnmodifiedSince)
 {
   // get the last modified date of the file
@@ -928,3 +1036,118 @@ TEST_F(TestWebServer, CanGetCachedRangedFileWithNewerIfRange)
   ASSERT_TRUE(curl.Get(GetUrlOfTestFile(TEST_FILES_RANGES), result));
   CheckRangesTestFileResponse(curl, result, ranges);
 }
+
+TEST_F(TestWebServer, CanServeConcurrentRequestsWithThreadPool)
+{
+  constexpr int CLIENTS = 16;
+  constexpr int REQUESTS = 20;
+
+  // restart the webserver with a small thread pool serving more clients than it has threads
+  webserver.Stop();
+  webserver.SetConnectionHandling(4, 64, 30);
+  ASSERT_TRUE(webserver.Start(webserverPort, "", ""));
+
+  JSONRPC::CJSONRPC::Initialize();
+
+  std::vector<uint8_t> image;
+  CFile file;
+  ASSERT_GT(file.LoadFile(URIUtils::AddFileToFolder(sourcePath, "test.png"), image), 0);
+  const std::string imageData(image.begin(), image.end());
+  const std::string imageUrl = GetUrlOfTestFile("test.png");
+  const std::string jsonRpcUrl = GetUrl(TEST_URL_JSONRPC);
+
+  std::atomic<int> succeeded{0};
+  std::vector<std::thread> clients;
+  const auto start = std::chrono::steady_clock::now();
+  for (int client = 0; client < CLIENTS; ++client)
+  {
+    clients.emplace_back(
+        [&]
+        {
+          // every client reuses its (keep-alive) connection
+          CCurlFile curl;
+          for (int request = 0; request < REQUESTS; ++request)
+          {
+            std::string result;
+            if (request % 2 == 0)
+            {
+              curl.SetMimeType("application/json");
+              if (curl.Post(jsonRpcUrl,
+                            "{ \"jsonrpc\": \"2.0\", \"method\": \"JSONRPC.Version\", \"id\": 1 }",
+                            result) &&
+                  result.find("\"version\"") != std::string::npos)
+                ++succeeded;
+            }
+            else if (curl.Get(imageUrl, result) && result == imageData)
+              ++succeeded;
+          }
+        });
+  }
+  for (auto& client : clients)
+    client.join();
+  const auto duration = std::chrono::steady_clock::now() - start;
+
+  EXPECT_EQ(CLIENTS * REQUESTS, succeeded);
+
+  const auto metrics = webserver.GetHandlerMetrics();
+  ASSERT_EQ(1U, metrics.count("jsonrpc"));
+  ASSERT_EQ(1U, metrics.count("vfs"));
+  for (const auto& [name, handlerMetrics] : metrics)
+  {
+    EXPECT_EQ(static_cast<uint64_t>(CLIENTS * REQUESTS / 2), handlerMetrics.requests) << name;
+    EXPECT_EQ(0U, handlerMetrics.failed) << name;
+    EXPECT_EQ(0U, handlerMetrics.active) << name;
+    // requests are only handled on the threads of the pools, one pool per address family
+    EXPECT_LE(handlerMetrics.maxActive, 2 * 4U) << name;
+  }
+
+  const auto milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(duration).count();
+  RecordProperty("requests_per_second",
+                 std::to_string(CLIENTS * REQUESTS * 1000 / std::max<int64_t>(milliseconds, 1)));
+
+  JSONRPC::CJSONRPC::Cleanup();
+}
+
+TEST_F(TestWebServer, CanGetTransformedImageFromCache)
+{
+  auto textureCache = std::make_shared<CTextureCache>();
+  CServiceBroker::RegisterTextureCache(textureCache);
+  textureCache->Initialize();
+
+  CHTTPImageTransformationHandler imageHandler;
+  webserver.RegisterRequestHandler(&imageHandler);
+
+  const std::string image =
+      IMAGE_FILES::URLFromFile(URIUtils::AddFileToFolder(sourcePath, "test.png"));
+  const std::string imageUrl = baseUrl + "/image/" + CURL::Encode(image) + "?width=8";
+
+  // the first request transforms the image and stores it in the texture cache
+  std::string result;
+  CCurlFile curl;
+  ASSERT_TRUE(curl.Get(imageUrl, result));
+  EXPECT_FALSE(result.empty());
+  EXPECT_STREQ("image/png", curl.GetHttpHeader().GetMimeType().c_str());
+
+  CFileItemList cachedImages;
+  CUtil::GetRecursiveListing("special://thumbnails/", cachedImages, ".png");
+  ASSERT_EQ(1, cachedImages.Size());
+  const std::string cachedImage = cachedImages[0]->GetPath();
+  EXPECT_EQ(std::string::npos, cachedImage.find("..")) << cachedImage;
+
+  // replace the cached image to be able to tell where the second response comes from
+  const std::string cachedData = "cached";
+  CFile file;
+  ASSERT_TRUE(file.OpenForWrite(cachedImage, true));
+  ASSERT_EQ(static_cast<ssize_t>(cachedData.size()),
+            file.Write(cachedData.c_str(), cachedData.size()));
+  file.Close();
+
+  CCurlFile curlCached;
+  ASSERT_TRUE(curlCached.Get(imageUrl, result));
+  EXPECT_EQ(cachedData, result);
+
+  webserver.UnregisterRequestHandler(&imageHandler);
+  CFile::Delete(cachedImage);
+  textureCache->Deinitialize();
+  CServiceBroker::UnregisterTextureCache();
+}
@@ -0,0 +1,73 @@
+/*
+ *  Copyright (C) 2026 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "UPnPBrowseCache.h"
+
+#include "FileItem.h"
+#include "FileItemList.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <mutex>
+
+using namespace UPNP;
+
+CUPnPBrowseCache::CUPnPBrowseCache(size_t size, std::chrono::steady_clock::duration lifetime)
+  : m_size(size), m_lifetime(lifetime)
+{
+}
+
+std::shared_ptr<CFileItemList> CUPnPBrowseCache::Get(const std::string& path)
+{
+  std::unique_lock lock(m_section);
+
+  const auto now = std::chrono::steady_clock::now();
+  m_snapshots.remove_if([this, &now](const Snapshot& snapshot)
+                        { return now - snapshot.created > m_lifetime; });
+
+  const auto it = std::ranges::find_if(m_snapshots, [&path](const Snapshot& snapshot)
+                                       { return snapshot.items->GetPath() == path; });
+  if (it == m_snapshots.end())
+    return nullptr;
+
+  m_snapshots.splice(m_snapshots.begin(), m_snapshots, it);
+  return it->items;
+}
+
+void CUPnPBrowseCache::Add(const std::shared_ptr<CFileItemList>& items)
+{
+  std::unique_lock lock(m_section);
+
+  m_snapshots.remove_if([&items](const Snapshot& snapshot)
+                        { return snapshot.items->GetPath() == items->GetPath(); });
+  m_snapshots.push_front({items, std::chrono::steady_clock::now()});
+  if (m_snapshots.size() > m_size)
+    m_snapshots.pop_back();
+}
+
+void CUPnPBrowseCache::Clear()
+{
+  std::unique_lock lock(m_section);
+  m_snapshots.clear();
+}
+
+void CUPnPBrowseCache::GetPage(const CFileItemList& items,
+                               unsigned int start,
+                               unsigned int count,
+                               CFileItemList& page)
+{
+  const auto size = static_cast<unsigned int>(items.Size());
+  if (start >= size)
+    return;
+
+  // the listing is shared with other requests so the items of the page are copied
+  const auto stop = static_cast<unsigned int>(
+      std::min<uint64_t>(static_cast<uint64_t>(start) + count, static_cast<uint64_t>(size)));
+  for (unsigned int i = start; i < stop; ++i)
+    page.Add(std::make_shared<CFileItem>(*items.Get(static_cast<int>(i))));
+}
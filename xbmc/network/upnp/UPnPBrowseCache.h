@@ -0,0 +1,76 @@
+/*
+ *  Copyright (C) 2026 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "threads/CriticalSection.h"
+
+#include <chrono>
+#include <list>
+#include <memory>
+#include <string>
+
+class CFileItemList;
+
+namespace UPNP
+{
+
+/*!
+ \brief Listings of containers which are larger than a single browse response.
+
+ Renderers page through large containers with one browse request per page. The listings are kept
+ so the following pages don't cause the whole listing to be retrieved and sorted again, most
+ recently used first.
+ */
+class CUPnPBrowseCache
+{
+public:
+  CUPnPBrowseCache(size_t size, std::chrono::steady_clock::duration lifetime);
+
+  /*!
+   \brief Get the listing of a container.
+   \param path the path of the container.
+   \return the listing, nullptr if it isn't cached or is older than the lifetime of the cache.
+   */
+  std::shared_ptr<CFileItemList> Get(const std::string& path);
+
+  /*!
+   \brief Add the listing of a container, replacing an older one of the same path.
+   The least recently used listing is dropped if the cache is full.
+   */
+  void Add(const std::shared_ptr<CFileItemList>& items);
+
+  void Clear();
+
+  /*!
+   \brief Copy a page out of a listing.
+   \param items the listing.
+   \param start the index of the first item of the page.
+   \param count the maximum number of items of the page.
+   \param page the list the copies of the items of the page are added to.
+   */
+  static void GetPage(const CFileItemList& items,
+                      unsigned int start,
+                      unsigned int count,
+                      CFileItemList& page);
+
+private:
+  struct Snapshot
+  {
+    std::shared_ptr<CFileItemList> items;
+    std::chrono::steady_clock::time_point created;
+  };
+
+  const size_t m_size;
+  const std::chrono::steady_clock::duration m_lifetime;
+
+  CCriticalSection m_section;
+  std::list<Snapshot> m_snapshots;
+};
+
+} // namespace UPNP
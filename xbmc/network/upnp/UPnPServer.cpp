@@ -41,6 +41,7 @@
 #include "utils/Digest.h"
 #include "utils/FileExtensionProvider.h"
 #include "utils/FileUtils.h"
+#include "utils/LegacyPathTranslation.h"
 #include "utils/SortUtils.h"
 #include "utils/StringUtils.h"
 #include "utils/URIUtils.h"
@@ -52,6 +53,7 @@
 #include "video/VideoThumbLoader.h"
 #include "view/GUIViewState.h"
 
+#include <algorithm>
 #include <memory>
 
 #include <Platinum/Source/Platinum/Platinum.h>
@@ -81,12 +83,18 @@ const char* video_containers[] = {
     "library://video/movies/titles.xml/", "library://video/tvshows/titles.xml/",
     "videodb://recentlyaddedmovies/", "videodb://recentlyaddedepisodes/"};
 
+// number of container listings kept for paging and for how long they're kept at most, as
+// changes to anything but the libraries aren't announced
+constexpr size_t BROWSE_CACHE_SIZE = 8;
+constexpr auto BROWSE_CACHE_LIFETIME = std::chrono::minutes(2);
+
 /*----------------------------------------------------------------------
 |   CUPnPServer::CUPnPServer
 +---------------------------------------------------------------------*/
 CUPnPServer::CUPnPServer(const char* friendly_name, const char* uuid /*= NULL*/, int port /*= 0*/)
   : PLT_MediaConnect(friendly_name, false, uuid, port),
     PLT_FileMediaConnectDelegate("/", "/"),
+    m_BrowseCache(BROWSE_CACHE_SIZE, BROWSE_CACHE_LIFETIME),
     m_scanning(CMusicLibraryQueue::GetInstance().IsScanningLibrary() ||
                CVideoLibraryQueue::GetInstance().IsScanningLibrary()),
     m_logger(CServiceBroker::GetLogging().GetLogger(
@@ -517,6 +525,11 @@ void CUPnPServer::Announce(AnnouncementFlag flag,
   if (sender != CAnnouncementManager::ANNOUNCEMENT_SENDER)
     return;
 
+  // any change to the libraries may change the order or content of the cached listings
+  if (message == "OnUpdate" || message == "OnRemove" || message == "OnScanFinished" ||
+      message == "OnCleanFinished")
+    m_BrowseCache.Clear();
+
   if (message != "OnUpdate" && message != "OnRemove" && message != "OnScanStarted" &&
       message != "OnScanFinished")
     return;
@@ -779,7 +792,6 @@ NPT_Result CUPnPServer::OnBrowseDirectChildren(PLT_ActionReference& action,
                                                const char* sort_criteria,
                                                const PLT_HttpRequestContext& context)
 {
-  CFileItemList items;
   const NPT_String decodedObjectId = DecodeObjectId(object_id);
   m_logger->info("Received Browse DirectChildren request for encoded object '{}' (plain value: "
                  "'{}'), with sort criteria {}",
@@ -793,88 +805,118 @@ NPT_Result CUPnPServer::OnBrowseDirectChildren(PLT_ActionReference& action,
     return NPT_FAILURE;
   }
 
-  items.SetPath(static_cast<const char*>(parent_id));
+  // Don't pass parent_id if action is Search not BrowseDirectChildren, as
+  // we want the engine to determine the best parent id, not necessarily the one
+  // passed
+  NPT_String action_name = action->GetActionDesc().GetName();
+  const char* response_parent_id =
+      (action_name.Compare("Search", true) == 0) ? NULL : parent_id.GetChars();
 
-  // guard against loading while saving to the same cache file
-  // as CArchive currently performs no locking itself
-  bool load;
-  {
-    NPT_AutoLock lock(m_CacheMutex);
-    load = items.Load();
-  }
+  const NPT_UInt32 page_size = GetPageSize(requested_count);
 
-  if (!load)
+  std::shared_ptr<CFileItemList> items = m_BrowseCache.Get(static_cast<const char*>(parent_id));
+  if (!items)
   {
-    // cache anything that takes more than a second to retrieve
-    auto start = std::chrono::steady_clock::now();
+    // song and video title listings are paged by the databases if they can sort them the same
+    // way, so only the requested page is retrieved
+    CFileItemList page;
+    int total = 0;
+    if (GetSongsPage(static_cast<const char*>(parent_id), starting_index, page_size, page, total) ||
+        GetVideoTitlesPage(static_cast<const char*>(parent_id), starting_index, page_size, page,
+                           total))
+      return BuildResponse(action, page, filter, starting_index, requested_count, sort_criteria,
+                           context, response_parent_id, total);
+
+    items = std::make_shared<CFileItemList>();
+    items->SetPath(static_cast<const char*>(parent_id));
+
+    // guard against loading while saving to the same cache file
+    // as CArchive currently performs no locking itself
+    bool load;
+    {
+      NPT_AutoLock lock(m_CacheMutex);
+      load = items->Load();
+    }
 
-    if (parent_id.StartsWith("virtualpath://upnproot"))
+    if (!load)
     {
-      CFileItemPtr item;
+      // cache anything that takes more than a second to retrieve
+      auto start = std::chrono::steady_clock::now();
 
-      // music library
-      item = std::make_shared<CFileItem>("musicdb://", true);
-      item->SetLabel("Music Library");
-      item->SetLabelPreformatted(true);
-      items.Add(item);
+      if (parent_id.StartsWith("virtualpath://upnproot"))
+      {
+        CFileItemPtr item;
 
-      // video library
-      item = std::make_shared<CFileItem>("library://video/", true);
-      item->SetLabel("Video Library");
-      item->SetLabelPreformatted(true);
-      items.Add(item);
+        // music library
+        item = std::make_shared<CFileItem>("musicdb://", true);
+        item->SetLabel("Music Library");
+        item->SetLabelPreformatted(true);
+        items->Add(item);
 
-      items.Sort(SortBy::LABEL, SortOrder::ASCENDING);
-    }
-    else
-    {
-      // this is the only way to hide unplayable items in the 'files'
-      // view as we cannot tell what context (eg music vs video) the
-      // request came from
-      std::string supported =
-          CServiceBroker::GetFileExtensionProvider().GetPictureExtensions() + "|" +
-          CServiceBroker::GetFileExtensionProvider().GetVideoExtensions() + "|" +
-          CServiceBroker::GetFileExtensionProvider().GetMusicExtensions() + "|" +
-          CServiceBroker::GetFileExtensionProvider().GetPictureExtensions();
-      CDirectory::GetDirectory((const char*)parent_id, items, supported, DIR_FLAG_DEFAULTS);
-      DefaultSortItems(items);
-    }
+        // video library
+        item = std::make_shared<CFileItem>("library://video/", true);
+        item->SetLabel("Video Library");
+        item->SetLabelPreformatted(true);
+        items->Add(item);
 
-    auto end = std::chrono::steady_clock::now();
-    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+        items->Sort(SortBy::LABEL, SortOrder::ASCENDING);
+      }
+      else
+      {
+        // this is the only way to hide unplayable items in the 'files'
+        // view as we cannot tell what context (eg music vs video) the
+        // request came from
+        std::string supported =
+            CServiceBroker::GetFileExtensionProvider().GetPictureExtensions() + "|" +
+            CServiceBroker::GetFileExtensionProvider().GetVideoExtensions() + "|" +
+            CServiceBroker::GetFileExtensionProvider().GetMusicExtensions() + "|" +
+            CServiceBroker::GetFileExtensionProvider().GetPictureExtensions();
+        CDirectory::GetDirectory((const char*)parent_id, *items, supported, DIR_FLAG_DEFAULTS);
+        DefaultSortItems(*items);
+      }
 
-    if (items.CacheToDiscAlways() || (items.CacheToDiscIfSlow() && duration.count() > 1000))
-    {
-      NPT_AutoLock lock(m_CacheMutex);
-      items.Save();
-    }
-  }
+      auto end = std::chrono::steady_clock::now();
+      auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
 
-  // as there's no library://music support, manually add playlists and music
-  // video nodes
-  if (items.GetPath() == "musicdb://")
-  {
-    CFileItemPtr playlists(new CFileItem("special://musicplaylists/", true));
-    playlists->SetLabel(CServiceBroker::GetResourcesComponent().GetLocalizeStrings().Get(136));
-    items.Add(playlists);
+      if (items->CacheToDiscAlways() || (items->CacheToDiscIfSlow() && duration.count() > 1000))
+      {
+        NPT_AutoLock lock(m_CacheMutex);
+        items->Save();
+      }
+    }
 
-    CVideoDatabase database;
-    database.Open();
-    if (database.HasContent(VideoDbContentType::MUSICVIDEOS))
+    // as there's no library://music support, manually add playlists and music
+    // video nodes
+    if (items->GetPath() == "musicdb://")
     {
-      CFileItemPtr mvideos(new CFileItem("library://video/musicvideos/", true));
-      mvideos->SetLabel(CServiceBroker::GetResourcesComponent().GetLocalizeStrings().Get(20389));
-      items.Add(mvideos);
+      CFileItemPtr playlists(new CFileItem("special://musicplaylists/", true));
+      playlists->SetLabel(CServiceBroker::GetResourcesComponent().GetLocalizeStrings().Get(136));
+      items->Add(playlists);
+
+      CVideoDatabase database;
+      database.Open();
+      if (database.HasContent(VideoDbContentType::MUSICVIDEOS))
+      {
+        CFileItemPtr mvideos(new CFileItem("library://video/musicvideos/", true));
+        mvideos->SetLabel(CServiceBroker::GetResourcesComponent().GetLocalizeStrings().Get(20389));
+        items->Add(mvideos);
+      }
     }
+
+    // only keep listings which the renderer has to page through
+    if (items->Size() <= static_cast<int>(page_size))
+      return BuildResponse(action, *items, filter, starting_index, requested_count, sort_criteria,
+                           context, response_parent_id);
+
+    RemoveHiddenItems(*items);
+    m_BrowseCache.Add(items);
   }
 
-  // Don't pass parent_id if action is Search not BrowseDirectChildren, as
-  // we want the engine to determine the best parent id, not necessarily the one
-  // passed
-  NPT_String action_name = action->GetActionDesc().GetName();
-  return BuildResponse(action, items, filter, starting_index, requested_count, sort_criteria,
-                       context,
-                       (action_name.Compare("Search", true) == 0) ? NULL : parent_id.GetChars());
+  CFileItemList page(items->GetPath());
+  CUPnPBrowseCache::GetPage(*items, starting_index, page_size, page);
+
+  return BuildResponse(action, page, filter, starting_index, requested_count, sort_criteria,
+                       context, response_parent_id, items->Size());
 }
 
 /*----------------------------------------------------------------------
@@ -887,7 +929,8 @@ NPT_Result CUPnPServer::BuildResponse(PLT_ActionReference& action,
                                       NPT_UInt32 requested_count,
                                       const char* sort_criteria,
                                       const PLT_HttpRequestContext& context,
-                                      const char* parent_id /* = NULL */)
+                                      const char* parent_id /* = NULL */,
+                                      int total_items /* = -1 */)
 {
   NPT_COMPILER_UNUSED(sort_criteria);
 
@@ -915,30 +958,21 @@ NPT_Result CUPnPServer::BuildResponse(PLT_ActionReference& action,
     thumb_loader->OnLoaderStart();
   }
 
-  // this isn't pretty but needed to properly hide the addons node from clients
-  if (StringUtils::StartsWith(items.GetPath(), "library"))
-  {
-    for (int i = 0; i < items.Size(); i++)
-    {
-      if (StringUtils::StartsWith(items[i]->GetPath(), "addons") ||
-          StringUtils::EndsWith(items[i]->GetPath(), "/addons.xml/"))
-        items.Remove(i);
-    }
-  }
+  RemoveHiddenItems(items);
 
-  // won't return more than UPNP_MAX_RETURNED_ITEMS items at a time to keep things smooth
-  // 0 requested means as many as possible
-  NPT_UInt32 max_count = (requested_count == 0) ? m_MaxReturnedItems
-                                                : std::min((unsigned long)requested_count,
-                                                           (unsigned long)m_MaxReturnedItems);
-  NPT_UInt32 stop_index = std::min((unsigned long)(starting_index + max_count),
+  // items only holds the requested page if the total number of items is passed
+  const bool paged = total_items >= 0;
+  const NPT_UInt32 first_index = paged ? 0 : starting_index;
+
+  NPT_UInt32 max_count = GetPageSize(requested_count);
+  NPT_UInt32 stop_index = std::min((unsigned long)(first_index + max_count),
                                    (unsigned long)items.Size()); // don't return more than we can
 
   NPT_Cardinal count = 0;
-  NPT_Cardinal total = items.Size();
+  NPT_Cardinal total = paged ? total_items : items.Size();
   NPT_String didl = didl_header;
   PLT_MediaObjectReference object;
-  for (unsigned long i = starting_index; i < stop_index; ++i)
+  for (unsigned long i = first_index; i < stop_index; ++i)
   {
     object = Build(items[i], true, context, thumb_loader, parent_id);
     if (object.IsNull())
@@ -1538,14 +1572,189 @@ NPT_Result CUPnPServer::ServeFile(const NPT_HttpRequest& request,
 
 void CUPnPServer::DefaultSortItems(CFileItemList& items)
 {
-  CGUIViewState* viewState =
-      CGUIViewState::GetViewState(IsVideoDb(items) ? WINDOW_VIDEO_NAV : -1, items);
-  if (viewState)
-  {
-    SortDescription sorting = viewState->GetSortMethod();
+  SortDescription sorting;
+  if (GetDefaultSorting(items, sorting))
     items.Sort(sorting.sortBy, sorting.sortOrder, sorting.sortAttributes);
-    delete viewState;
+}
+
+bool CUPnPServer::GetDefaultSorting(const CFileItemList& items, SortDescription& sorting)
+{
+  std::unique_ptr<CGUIViewState> viewState(
+      CGUIViewState::GetViewState(IsVideoDb(items) ? WINDOW_VIDEO_NAV : -1, items));
+  if (!viewState)
+    return false;
+
+  sorting = viewState->GetSortMethod();
+  return true;
+}
+
+void CUPnPServer::RemoveHiddenItems(CFileItemList& items)
+{
+  // this isn't pretty but needed to properly hide the addons node from clients
+  if (StringUtils::StartsWith(items.GetPath(), "library"))
+  {
+    for (int i = 0; i < items.Size(); i++)
+    {
+      if (StringUtils::StartsWith(items[i]->GetPath(), "addons") ||
+          StringUtils::EndsWith(items[i]->GetPath(), "/addons.xml/"))
+        items.Remove(i);
+    }
+  }
+}
+
+NPT_UInt32 CUPnPServer::GetPageSize(NPT_UInt32 requested_count)
+{
+  // won't return more than UPNP_MAX_RETURNED_ITEMS items at a time to keep things smooth
+  // 0 requested means as many as possible
+  return (requested_count == 0) ? m_MaxReturnedItems
+                                : std::min(requested_count, m_MaxReturnedItems);
+}
+
+/*----------------------------------------------------------------------
+|   CUPnPServer::GetSongsPage
++---------------------------------------------------------------------*/
+bool CUPnPServer::GetSongsPage(const std::string& path,
+                               NPT_UInt32 starting_index,
+                               NPT_UInt32 count,
+                               CFileItemList& items,
+                               int& total)
+{
+  if (!URIUtils::IsMusicDb(path) ||
+      CMusicDatabaseDirectory::GetDirectoryChildType(path) != MUSICDATABASEDIRECTORY::NodeType::SONG)
+    return false;
+
+  const std::string songsPath = CLegacyPathTranslation::TranslateMusicDbPath(path);
+  items.SetPath(path);
+
+  // the database must sort the songs the same way as DefaultSortItems() would, it sorts by
+  // track number instead of by label though
+  SortDescription sorting;
+  if (!GetDefaultSorting(items, sorting) || sorting.sortBy == SortBy::LABEL)
+    return false;
+
+  FieldList fields;
+  SortUtils::GetFieldsForSQLSort(MediaTypeSong, sorting.sortBy, fields);
+  if (fields.empty())
+    return false;
+
+  MUSICDATABASEDIRECTORY::CQueryParams params;
+  MUSICDATABASEDIRECTORY::CDirectoryNode::GetDatabaseInfo(songsPath, params);
+
+  sorting.limitStart = static_cast<int>(starting_index);
+  sorting.limitEnd = static_cast<int>(starting_index + count);
+
+  CMusicDatabase database;
+  if (!database.Open() ||
+      !database.GetSongsNav(songsPath, items, sorting, params.GetGenreId(), params.GetArtistId(),
+                            params.GetAlbumId()))
+  {
+    items.Clear();
+    return false;
   }
+
+  // the total isn't known if the requested page is beyond the last song
+  if (!items.HasProperty("total"))
+  {
+    if (starting_index > 0)
+      return false;
+
+    total = 0;
+    return true;
+  }
+
+  total = items.GetProperty("total").asInteger32();
+  return true;
+}
+
+/*----------------------------------------------------------------------
+|   CUPnPServer::GetVideoTitlesPage
++---------------------------------------------------------------------*/
+bool CUPnPServer::GetVideoTitlesPage(const std::string& path,
+                                     NPT_UInt32 starting_index,
+                                     NPT_UInt32 count,
+                                     CFileItemList& items,
+                                     int& total)
+{
+  if (!URIUtils::IsVideoDb(path))
+    return false;
+
+  MediaType mediaType;
+  const VIDEODATABASEDIRECTORY::NodeType childType =
+      CVideoDatabaseDirectory::GetDirectoryChildType(path);
+  switch (childType)
+  {
+    case VIDEODATABASEDIRECTORY::NodeType::TITLE_MOVIES:
+      mediaType = MediaTypeMovie;
+      break;
+    case VIDEODATABASEDIRECTORY::NodeType::TITLE_TVSHOWS:
+      mediaType = MediaTypeTvShow;
+      break;
+    case VIDEODATABASEDIRECTORY::NodeType::TITLE_MUSICVIDEOS:
+      mediaType = MediaTypeMusicVideo;
+      break;
+    default:
+      return false;
+  }
+
+  const std::string titlesPath = CLegacyPathTranslation::TranslateVideoDbPath(path);
+  items.SetPath(path);
+
+  // the database only sorts in SQL what it can sort the same way as DefaultSortItems() would,
+  // which excludes the sorting by title or label most views default to
+  SortDescription sorting;
+  FieldList fields;
+  if (!GetDefaultSorting(items, sorting) ||
+      !SortUtils::GetFieldsForSQLSort(mediaType, sorting.sortBy, fields))
+    return false;
+
+  VIDEODATABASEDIRECTORY::CQueryParams params;
+  if (!CVideoDatabaseDirectory::GetQueryParams(titlesPath, params))
+    return false;
+
+  sorting.limitStart = static_cast<int>(starting_index);
+  sorting.limitEnd = static_cast<int>(starting_index + count);
+
+  CVideoDatabase database;
+  bool success = database.Open();
+  if (success)
+  {
+    switch (childType)
+    {
+      case VIDEODATABASEDIRECTORY::NodeType::TITLE_MOVIES:
+        success = database.GetMoviesNav(titlesPath, items, params.GetGenreId(), params.GetYear(),
+                                        params.GetActorId(), params.GetDirectorId(),
+                                        params.GetStudioId(), params.GetCountryId(),
+                                        params.GetSetId(), params.GetTagId(), sorting);
+        break;
+      case VIDEODATABASEDIRECTORY::NodeType::TITLE_TVSHOWS:
+        success = database.GetTvShowsNav(titlesPath, items, params.GetGenreId(), params.GetYear(),
+                                         params.GetActorId(), params.GetDirectorId(),
+                                         params.GetStudioId(), params.GetTagId(), sorting);
+        break;
+      default:
+        success = database.GetMusicVideosNav(
+            titlesPath, items, params.GetGenreId(), params.GetYear(), params.GetActorId(),
+            params.GetDirectorId(), params.GetStudioId(), params.GetAlbumId(), params.GetTagId(),
+            sorting);
+        break;
+    }
+  }
+
+  if (!success || !items.HasProperty("total"))
+  {
+    items.Clear();
+    return false;
+  }
+
+  // as CVideoDatabaseDirectory would
+  for (const auto& item : items)
+  {
+    if (item->HasVideoInfoTag())
+      item->SetDynPath(item->GetVideoInfoTag()->GetPath());
+  }
+
+  total = items.GetProperty("total").asInteger32();
+  return true;
 }
 
 NPT_Result CUPnPServer::AddSubtitleUriForSecResponse(const NPT_String& movie_md5,
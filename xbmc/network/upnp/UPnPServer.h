@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include "UPnPBrowseCache.h"
 #include "interfaces/IAnnouncer.h"
 #include "utils/logtypes.h"
 
@@ -24,6 +25,7 @@ class CThumbLoader;
 class CVariant;
 class PLT_MediaObject;
 class PLT_HttpRequestContext;
+struct SortDescription;
 
 namespace UPNP
 {
@@ -125,10 +127,26 @@ public:
                              NPT_UInt32                    requested_count,
                              const char*                   sort_criteria,
                              const PLT_HttpRequestContext& context,
-                             const char*                   parent_id /* = NULL */);
+                             const char*                   parent_id /* = NULL */,
+                             int                           total_items = -1);
+
+    bool GetSongsPage(const std::string& path,
+                      NPT_UInt32 starting_index,
+                      NPT_UInt32 count,
+                      CFileItemList& items,
+                      int& total);
+
+    bool GetVideoTitlesPage(const std::string& path,
+                            NPT_UInt32 starting_index,
+                            NPT_UInt32 count,
+                            CFileItemList& items,
+                            int& total);
 
     // class methods
     static void DefaultSortItems(CFileItemList& items);
+    static bool GetDefaultSorting(const CFileItemList& items, SortDescription& sorting);
+    static void RemoveHiddenItems(CFileItemList& items);
+    static NPT_UInt32 GetPageSize(NPT_UInt32 requested_count);
     static NPT_String GetParentFolder(const NPT_String& file_path)
     {
       int index = file_path.ReverseFind("\\");
@@ -145,6 +163,9 @@ public:
     NPT_Mutex m_FileMutex;
     NPT_Map<NPT_String, NPT_String> m_FileMap;
 
+    // listings of containers which are larger than a single browse response
+    CUPnPBrowseCache m_BrowseCache;
+
     std::map<std::string, std::pair<bool, unsigned long> > m_UpdateIDs;
     bool m_scanning;
 
@@ -0,0 +1,237 @@
+/*
+ *  Copyright (C) 2026 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "InotifyDirectoryWatcher.h"
+
+#include "utils/log.h"
+
+#include <cerrno>
+#include <cstring>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include <dirent.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+constexpr uint32_t WATCH_MASK = IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO |
+                                IN_CLOSE_WRITE | IN_ATTRIB | IN_DELETE_SELF | IN_MOVE_SELF |
+                                IN_ONLYDIR;
+} // unnamed namespace
+
+CInotifyDirectoryWatcher::CInotifyDirectoryWatcher(ChangedCallback changed, LostCallback lost)
+  : CThread("InotifyWatcher"),
+    m_changed(std::move(changed)),
+    m_lost(std::move(lost))
+{
+  m_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (m_fd < 0)
+  {
+    CLog::Log(LOGERROR, "CInotifyDirectoryWatcher: inotify_init1 failed: {}", strerror(errno));
+    return;
+  }
+
+  m_wakeupFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+  if (m_wakeupFd < 0)
+  {
+    CLog::Log(LOGERROR, "CInotifyDirectoryWatcher: eventfd failed: {}", strerror(errno));
+    close(m_fd);
+    m_fd = -1;
+    return;
+  }
+
+  Create();
+}
+
+CInotifyDirectoryWatcher::~CInotifyDirectoryWatcher()
+{
+  if (m_wakeupFd >= 0)
+  {
+    StopThread(false);
+    eventfd_write(m_wakeupFd, 1);
+    StopThread(true);
+    close(m_wakeupFd);
+  }
+
+  if (m_fd >= 0)
+    close(m_fd);
+}
+
+bool CInotifyDirectoryWatcher::Watch(const std::string& path)
+{
+  if (m_fd < 0 || path.empty() || path.back() != '/')
+    return false;
+
+  std::unique_lock lock(m_section);
+  if (m_watched.contains(path))
+    return true;
+
+  return AddWatches(path);
+}
+
+bool CInotifyDirectoryWatcher::IsWatched(const std::string& directory) const
+{
+  std::unique_lock lock(m_section);
+  return m_watched.contains(directory);
+}
+
+bool CInotifyDirectoryWatcher::AddWatches(const std::string& directory)
+{
+  // add the watch before listing, so entries created meanwhile are reported
+  const int wd = inotify_add_watch(m_fd, directory.c_str(), WATCH_MASK);
+  if (wd < 0)
+  {
+    if (errno == ENOSPC && !m_limitReached)
+    {
+      CLog::Log(LOGWARNING,
+                "CInotifyDirectoryWatcher: inotify watch limit reached, increase "
+                "fs.inotify.max_user_watches to watch all library folders");
+      m_limitReached = true;
+    }
+    else if (errno != ENOSPC)
+      CLog::Log(LOGDEBUG, "CInotifyDirectoryWatcher: unable to watch {}: {}", directory,
+                strerror(errno));
+    return false;
+  }
+
+  // the same directory may be reachable through several paths, events are only reported for one
+  const auto [it, inserted] = m_directories.try_emplace(wd, directory);
+  if (!inserted)
+  {
+    m_watched.erase(it->second);
+    it->second = directory;
+  }
+  m_watched.insert(directory);
+
+  DIR* dir = opendir(directory.c_str());
+  if (!dir)
+    return false;
+
+  bool result = true;
+  while (const dirent* entry = readdir(dir))
+  {
+    if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0)
+      continue;
+
+    const std::string path = directory + entry->d_name;
+    bool isDirectory = entry->d_type == DT_DIR;
+    if (entry->d_type == DT_UNKNOWN)
+    {
+      struct stat st;
+      isDirectory = lstat(path.c_str(), &st) == 0 && S_ISDIR(st.st_mode);
+    }
+
+    if (isDirectory && !AddWatches(path + "/"))
+      result = false;
+  }
+  closedir(dir);
+
+  return result;
+}
+
+void CInotifyDirectoryWatcher::RemoveWatches(const std::string& directory)
+{
+  for (auto it = m_directories.begin(); it != m_directories.end();)
+  {
+    if (it->second.starts_with(directory))
+    {
+      inotify_rm_watch(m_fd, it->first);
+      m_watched.erase(it->second);
+      it = m_directories.erase(it);
+    }
+    else
+      ++it;
+  }
+}
+
+void CInotifyDirectoryWatcher::HandleEvent(const inotify_event& event)
+{
+  if (event.mask & IN_Q_OVERFLOW)
+  {
+    CLog::Log(LOGWARNING, "CInotifyDirectoryWatcher: event queue overflow, changes were lost");
+    m_lost();
+    return;
+  }
+
+  std::vector<std::pair<std::string, bool>> changed;
+  {
+    std::unique_lock lock(m_section);
+    const auto it = m_directories.find(event.wd);
+    if (it == m_directories.end())
+      return;
+
+    const std::string directory = it->second;
+    if (event.mask & IN_IGNORED)
+    {
+      // the directory is gone or the watch has been removed
+      m_watched.erase(directory);
+      m_directories.erase(it);
+      return;
+    }
+
+    changed.emplace_back(directory, false);
+
+    if ((event.mask & IN_ISDIR) && event.len > 0)
+    {
+      const std::string subdirectory = directory + event.name + "/";
+      if (event.mask & (IN_CREATE | IN_MOVED_TO))
+        AddWatches(subdirectory);
+      else if (event.mask & IN_MOVED_FROM)
+      {
+        // the watches of a moved tree would report under the old path
+        RemoveWatches(subdirectory);
+        changed.emplace_back(subdirectory, true);
+      }
+    }
+  }
+
+  for (const auto& [directory, tree] : changed)
+    m_changed(directory, tree);
+}
+
+void CInotifyDirectoryWatcher::Process()
+{
+  // large enough for many events with names of maximum length
+  alignas(inotify_event) char buffer[64 * 1024];
+
+  pollfd fds[2] = {{m_fd, POLLIN, 0}, {m_wakeupFd, POLLIN, 0}};
+  while (!m_bStop)
+  {
+    if (poll(fds, 2, -1) < 0)
+    {
+      if (errno == EINTR)
+        continue;
+      CLog::Log(LOGERROR, "CInotifyDirectoryWatcher: poll failed: {}", strerror(errno));
+      m_lost();
+      break;
+    }
+
+    if (fds[1].revents & POLLIN)
+      break;
+
+    if (!(fds[0].revents & POLLIN))
+      continue;
+
+    const ssize_t length = read(m_fd, buffer, sizeof(buffer));
+    if (length <= 0)
+      continue;
+
+    for (const char* data = buffer; data < buffer + length;)
+    {
+      const auto* event = reinterpret_cast<const inotify_event*>(data);
+      HandleEvent(*event);
+      data += sizeof(inotify_event) + event->len;
+    }
+  }
+}
@@ -0,0 +1,54 @@
+/*
+ *  Copyright (C) 2026 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "filesystem/IDirectoryWatcher.h"
+#include "threads/CriticalSection.h"
+#include "threads/Thread.h"
+
+#include <set>
+#include <string>
+#include <unordered_map>
+
+struct inotify_event;
+
+/*!
+ \brief Directory watcher based on the Linux inotify API.
+
+ inotify watches are not recursive, so a watch is added for every directory of a watched tree and
+ for directories created or moved into it later on. Symbolic links to directories are not
+ followed; directories reached through them are not watched.
+ */
+class CInotifyDirectoryWatcher : public XFILE::IDirectoryWatcher, private CThread
+{
+public:
+  CInotifyDirectoryWatcher(ChangedCallback changed, LostCallback lost);
+  ~CInotifyDirectoryWatcher() override;
+
+  bool Watch(const std::string& path) override;
+  bool IsWatched(const std::string& directory) const override;
+
+private:
+  void Process() override;
+
+  bool AddWatches(const std::string& directory);
+  void RemoveWatches(const std::string& directory);
+  void HandleEvent(const inotify_event& event);
+
+  ChangedCallback m_changed;
+  LostCallback m_lost;
+
+  int m_fd{-1};
+  int m_wakeupFd{-1};
+
+  mutable CCriticalSection m_section;
+  std::unordered_map<int, std::string> m_directories; // watch descriptor -> path
+  std::set<std::string, std::less<>> m_watched;
+  bool m_limitReached{false};
+};
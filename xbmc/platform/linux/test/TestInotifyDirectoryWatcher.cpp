@@ -0,0 +1,121 @@
+/*
+ *  Copyright (C) 2026 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "platform/linux/InotifyDirectoryWatcher.h"
+#include "threads/CriticalSection.h"
+#include "threads/Event.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <set>
+#include <string>
+
+#include <gtest/gtest.h>
+
+using namespace std::chrono_literals;
+
+class TestInotifyDirectoryWatcher : public ::testing::Test
+{
+protected:
+  TestInotifyDirectoryWatcher()
+  {
+    const char* tmpdir = getenv("TMPDIR");
+    std::string pattern{tmpdir && tmpdir[0] != '\0' ? tmpdir : "/tmp"};
+    pattern += "/kodi-test-XXXXXX";
+    if (mkdtemp(pattern.data()))
+      m_root = pattern + "/";
+  }
+
+  ~TestInotifyDirectoryWatcher() override
+  {
+    if (!m_root.empty())
+      std::filesystem::remove_all(m_root);
+  }
+
+  void OnChanged(const std::string& directory, bool tree)
+  {
+    std::unique_lock lock(m_section);
+    m_changed.insert(directory);
+    if (tree)
+      m_changedTrees.insert(directory);
+    m_event.Set();
+  }
+
+  void ClearChanges()
+  {
+    std::unique_lock lock(m_section);
+    m_changed.clear();
+    m_changedTrees.clear();
+  }
+
+  bool WaitForChange(const std::string& directory)
+  {
+    const auto end = std::chrono::steady_clock::now() + 5s;
+    while (std::chrono::steady_clock::now() < end)
+    {
+      {
+        std::unique_lock lock(m_section);
+        if (m_changed.contains(directory))
+          return true;
+      }
+      m_event.Wait(100ms);
+    }
+    return false;
+  }
+
+  std::string m_root;
+  CCriticalSection m_section;
+  std::set<std::string> m_changed;
+  std::set<std::string> m_changedTrees;
+  CEvent m_event;
+  bool m_lost{false};
+};
+
+TEST_F(TestInotifyDirectoryWatcher, ReportsChanges)
+{
+  ASSERT_FALSE(m_root.empty());
+  std::filesystem::create_directories(m_root + "a/b");
+
+  CInotifyDirectoryWatcher watcher([this](const std::string& directory, bool tree)
+                                   { OnChanged(directory, tree); },
+                                   [this]() { m_lost = true; });
+  EXPECT_TRUE(watcher.Watch(m_root));
+  EXPECT_TRUE(watcher.IsWatched(m_root));
+  EXPECT_TRUE(watcher.IsWatched(m_root + "a/"));
+  EXPECT_TRUE(watcher.IsWatched(m_root + "a/b/"));
+  EXPECT_FALSE(watcher.IsWatched(m_root + "c/"));
+
+  std::ofstream(m_root + "a/b/file.mkv") << "data";
+  EXPECT_TRUE(WaitForChange(m_root + "a/b/"));
+
+  // new folders are watched as well
+  std::filesystem::create_directory(m_root + "c");
+  EXPECT_TRUE(WaitForChange(m_root));
+  EXPECT_TRUE(watcher.IsWatched(m_root + "c/"));
+  std::ofstream(m_root + "c/file.mkv") << "data";
+  EXPECT_TRUE(WaitForChange(m_root + "c/"));
+
+  // moved folders are reported under their new path only
+  ClearChanges();
+  std::filesystem::rename(m_root + "a/b", m_root + "c/b");
+  EXPECT_TRUE(WaitForChange(m_root + "a/b/"));
+  EXPECT_TRUE(WaitForChange(m_root + "c/"));
+  EXPECT_FALSE(watcher.IsWatched(m_root + "a/b/"));
+  EXPECT_TRUE(watcher.IsWatched(m_root + "c/b/"));
+  {
+    // the old path is reported as a tree, as it may come back with different contents
+    std::unique_lock lock(m_section);
+    EXPECT_TRUE(m_changedTrees.contains(m_root + "a/b/"));
+    EXPECT_FALSE(m_changedTrees.contains(m_root + "c/"));
+  }
+
+  EXPECT_FALSE(m_lost);
+}
@@ -22,11 +22,18 @@
 #include <mntent.h>
 #endif
 #include <algorithm>
+#include <span>
 
 #include <sys/stat.h>
 
 using namespace XFILE;
 
+namespace
+{
+// number of entries read before they're reported as partial listing
+constexpr size_t PARTIAL_ITEMS_BATCH = 500;
+} // unnamed namespace
+
 CPosixDirectory::CPosixDirectory(void) = default;
 
 CPosixDirectory::~CPosixDirectory(void) = default;
@@ -50,6 +57,7 @@ bool CPosixDirectory::GetDirectory(const CURL& url, CFileItemList& items)
   struct stat buffer;
 
   std::vector<std::shared_ptr<CFileItem>> fileItems;
+  size_t reported = 0;
   struct dirent* entry;
   while ((entry = readdir(dir)) != NULL)
   {
@@ -92,6 +100,16 @@ bool CPosixDirectory::GetDirectory(const CURL& url, CFileItemList& items)
 
       if (name.starts_with('.'))
         item->SetProperty("file:hidden", true);
+
+      if (fileItems.size() - reported >= PARTIAL_ITEMS_BATCH)
+      {
+        if (!ReportItems(std::span(fileItems).subspan(reported)))
+        {
+          closedir(dir);
+          return false;
+        }
+        reported = fileItems.size();
+      }
     }
   }
   items.AddItems(std::move(fileItems));
@@ -251,6 +251,10 @@ void CAdvancedSettings::Initialize()
   m_addSourceOnTop = false;
 
   m_handleMounting = CServiceBroker::GetAppParams()->IsStandAlone();
+  m_libraryChangeJournal = false;
+  m_persistentDirCacheSize = 0;
+  m_persistentDirCacheTTL = {
+      {"smb", 300}, {"nfs", 300}, {"upnp", 300}, {"dav", 300}, {"davs", 300}};
 
   m_fullScreenOnMovieStart = true;
   m_cachePath = "special://temp/";
@@ -385,6 +389,8 @@ void CAdvancedSettings::Initialize()
   m_bMusicLibraryAllItemsOnBottom = false;
   m_bMusicLibraryCleanOnUpdate = false;
   m_bMusicLibraryArtistSortOnUpdate = false;
+  m_musicLibraryScannerThreads = 8;
+  m_musicLibraryScannerThreadsPerShare = 4;
   m_iMusicLibraryRecentlyAddedItems = 25;
   m_strMusicLibraryAlbumFormat = "";
   m_prioritiseAPEv2tags = false;
@@ -399,6 +405,8 @@ void CAdvancedSettings::Initialize()
   m_iVideoLibraryRecentlyAddedItems = 25;
   m_bVideoLibraryCleanOnUpdate = false;
   m_bVideoLibraryUseFastHash = true;
+  m_videoLibraryScannerThreads = 8;
+  m_videoLibraryScannerThreadsPerShare = 4;
   m_bVideoScannerIgnoreErrors = false;
   m_iVideoLibraryDateAdded = 1; // prefer mtime over ctime and current time
   m_minimumEpisodePlaylistDuration = 5 * 60; // 5 minutes
@@ -496,6 +504,13 @@ void CAdvancedSettings::Initialize()
 
   m_jsonOutputCompact = true;
   m_jsonTcpPort = 9090;
+  m_jsonTcpConnectionLimit = 512;
+  m_jsonTcpSendBufferLimit = 32 * 1024;
+  m_jsonTcpNotificationQueueLimit = 1024;
+
+  m_webserverThreadPoolSize = 0;
+  m_webserverConnectionLimit = 512;
+  m_webserverConnectionTimeout = 60 * 60 * 24;
 
   m_enableMultimediaKeys = false;
 
@@ -508,6 +523,8 @@ void CAdvancedSettings::Initialize()
 
   m_databaseMusic.Reset();
   m_databaseVideo.Reset();
+  m_databaseQueryStats = false;
+  m_databaseSlowQueryThreshold = 0;
 
   m_useLocaleCollation = true;
 
@@ -530,6 +547,12 @@ void CAdvancedSettings::Initialize()
   m_stereoscopicregex_tab = "[-. _]h?tab[-. _]";
 
   m_logLevelHint = m_logLevel = LOG_LEVEL_NORMAL;
+  m_logAsync = false;
+  m_logAsyncQueueSize = 8192;
+  m_logAsyncOverflowPolicy = LogOverflowPolicy::DROP;
+  m_logComponentRateLimit = 0;
+  m_logTextFile = true;
+  m_logBinaryFile = false;
 
   m_openGlDebugging = false;
 
@@ -877,6 +900,9 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     XMLUtils::GetBoolean(pElement, "allitemsonbottom", m_bMusicLibraryAllItemsOnBottom);
     XMLUtils::GetBoolean(pElement, "cleanonupdate", m_bMusicLibraryCleanOnUpdate);
     XMLUtils::GetBoolean(pElement, "artistsortonupdate", m_bMusicLibraryArtistSortOnUpdate);
+    XMLUtils::GetUInt(pElement, "scannerthreads", m_musicLibraryScannerThreads, 1, 64);
+    XMLUtils::GetUInt(pElement, "scannerthreadspershare", m_musicLibraryScannerThreadsPerShare, 1,
+                      64);
     XMLUtils::GetString(pElement, "albumformat", m_strMusicLibraryAlbumFormat);
     XMLUtils::GetString(pElement, "itemseparator", m_musicItemSeparator);
     XMLUtils::GetInt(pElement, "dateadded", m_iMusicLibraryDateAdded);
@@ -904,6 +930,9 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     XMLUtils::GetInt(pElement, "recentlyaddeditems", m_iVideoLibraryRecentlyAddedItems, 1, INT_MAX);
     XMLUtils::GetBoolean(pElement, "cleanonupdate", m_bVideoLibraryCleanOnUpdate);
     XMLUtils::GetBoolean(pElement, "usefasthash", m_bVideoLibraryUseFastHash);
+    XMLUtils::GetUInt(pElement, "scannerthreads", m_videoLibraryScannerThreads, 1, 64);
+    XMLUtils::GetUInt(pElement, "scannerthreadspershare", m_videoLibraryScannerThreadsPerShare, 1,
+                      64);
     XMLUtils::GetString(pElement, "itemseparator", m_videoItemSeparator);
     XMLUtils::GetBoolean(pElement, "importwatchedstate", m_bVideoLibraryImportWatchedState);
     XMLUtils::GetBoolean(pElement, "importresumepoint", m_bVideoLibraryImportResumePoint);
@@ -953,6 +982,21 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
   {
     XMLUtils::GetBoolean(pElement, "compactoutput", m_jsonOutputCompact);
     XMLUtils::GetUInt(pElement, "tcpport", m_jsonTcpPort);
+    XMLUtils::GetUInt(pElement, "tcpconnectionlimit", m_jsonTcpConnectionLimit, 1, 4096);
+    // responses a client didn't read yet, in KiB
+    XMLUtils::GetUInt(pElement, "tcpsendbufferlimit", m_jsonTcpSendBufferLimit, 64, 1024 * 1024);
+    XMLUtils::GetUInt(pElement, "tcpnotificationqueuelimit", m_jsonTcpNotificationQueueLimit, 16,
+                      64 * 1024);
+  }
+
+  pElement = pRootElement->FirstChildElement("webserver");
+  if (pElement)
+  {
+    // 0 serves every connection with its own thread
+    XMLUtils::GetUInt(pElement, "threadpoolsize", m_webserverThreadPoolSize, 0, 64);
+    XMLUtils::GetUInt(pElement, "connectionlimit", m_webserverConnectionLimit, 1, 4096);
+    XMLUtils::GetUInt(pElement, "connectiontimeout", m_webserverConnectionTimeout, 5,
+                      60 * 60 * 24);
   }
 
   pElement = pRootElement->FirstChildElement("samba");
@@ -989,6 +1033,30 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     CServiceBroker::GetLogging().SetLogLevel(m_logLevel);
   }
 
+  pElement = pRootElement->FirstChildElement("log");
+  if (pElement)
+  {
+    XMLUtils::GetBoolean(pElement, "async", m_logAsync);
+    XMLUtils::GetInt(pElement, "queuesize", m_logAsyncQueueSize, 256, 1048576);
+    std::string overflow;
+    if (XMLUtils::GetString(pElement, "overflow", overflow))
+      m_logAsyncOverflowPolicy = StringUtils::EqualsNoCase(overflow, "block")
+                                     ? LogOverflowPolicy::BLOCK
+                                     : LogOverflowPolicy::DROP;
+    XMLUtils::GetInt(pElement, "componentratelimit", m_logComponentRateLimit, 0, 1000000);
+    std::string format;
+    if (XMLUtils::GetString(pElement, "format", format))
+    {
+      // text, binary or both
+      m_logBinaryFile = !StringUtils::EqualsNoCase(format, "text");
+      m_logTextFile = !StringUtils::EqualsNoCase(format, "binary");
+    }
+  }
+  CServiceBroker::GetLogging().SetAsyncLogging(m_logAsync, m_logAsyncQueueSize,
+                                               m_logAsyncOverflowPolicy);
+  CServiceBroker::GetLogging().SetComponentRateLimit(m_logComponentRateLimit);
+  CServiceBroker::GetLogging().SetLogFileFormats(m_logTextFile, m_logBinaryFile);
+
   XMLUtils::GetString(pRootElement, "cddbaddress", m_cddbAddress);
   XMLUtils::GetBoolean(pRootElement, "addsourceontop", m_addSourceOnTop);
 
@@ -997,6 +1065,26 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
   XMLUtils::GetInt(pRootElement,     "airplayport", m_airPlayPort);
 
   XMLUtils::GetBoolean(pRootElement, "handlemounting", m_handleMounting);
+  XMLUtils::GetBoolean(pRootElement, "librarychangejournal", m_libraryChangeJournal);
+
+  pElement = pRootElement->FirstChildElement("directorycache");
+  if (pElement)
+  {
+    XMLUtils::GetUInt(pElement, "persistentsize", m_persistentDirCacheSize, 0, 4096);
+    for (const TiXmlElement* ttl = pElement->FirstChildElement("ttl"); ttl;
+         ttl = ttl->NextSiblingElement("ttl"))
+    {
+      const std::string protocol = XMLUtils::GetAttribute(ttl, "protocol");
+      if (protocol.empty() || !ttl->FirstChild())
+        continue;
+      // a negative time to live stops keeping the listings of the protocol
+      const int seconds = atoi(ttl->FirstChild()->Value());
+      if (seconds < 0)
+        m_persistentDirCacheTTL.erase(protocol);
+      else
+        m_persistentDirCacheTTL[protocol] = seconds;
+    }
+  }
   XMLUtils::GetBoolean(pRootElement, "automountopticalmedia", m_autoMountOpticalMedia);
 
 #if defined(TARGET_WINDOWS_DESKTOP)
@@ -1271,6 +1359,13 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
       dbElement != nullptr)
     ParseDatabaseSettings(dbElement, m_databaseEpg);
 
+  if (const TiXmlElement* statsElement = pRootElement->FirstChildElement("databasequerystats");
+      statsElement != nullptr)
+  {
+    XMLUtils::GetBoolean(statsElement, "enabled", m_databaseQueryStats);
+    XMLUtils::GetInt(statsElement, "slowquerythreshold", m_databaseSlowQueryThreshold, 0, INT_MAX);
+  }
+
   XMLUtils::GetBoolean(pRootElement, "enablemultimediakeys", m_enableMultimediaKeys);
 
   pElement = pRootElement->FirstChildElement("gui");
@@ -15,6 +15,7 @@
 #include "threads/CriticalSection.h"
 #include "utils/RegExp.h"
 #include "utils/SortUtils.h"
+#include "utils/logtypes.h"
 
 #include <cstdint>
 #include <functional>
@@ -209,6 +210,12 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     int m_songInfoDuration;
     int m_logLevel;
     int m_logLevelHint;
+    bool m_logAsync; //!< Write the log file from a background thread
+    int m_logAsyncQueueSize; //!< Maximum number of messages waiting to be written
+    LogOverflowPolicy m_logAsyncOverflowPolicy;
+    int m_logComponentRateLimit; //!< Messages per second and log component, 0 for no limit
+    bool m_logTextFile; //!< Write the text log file
+    bool m_logBinaryFile; //!< Write the binary log file, see CBinaryLogSink
     std::string m_cddbAddress;
     bool m_addSourceOnTop; //!< True to put 'add source' buttons on top
 
@@ -222,6 +229,18 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     * be set to tue
     */
     bool m_handleMounting;
+    /*! \brief Watch local library sources for changes, so library updates only scan changed
+    * folders (see CLibraryChangeJournal)
+    */
+    bool m_libraryChangeJournal;
+    /*! \brief Size limit in MB of the directory listings kept on disk across restarts, 0 to
+    * disable (see CDirectoryCache::GetPersistentDirectory)
+    */
+    unsigned int m_persistentDirCacheSize;
+    /*! \brief Protocols whose listings are kept on disk, with the time in seconds they are used
+    * without revalidation
+    */
+    std::map<std::string, int, std::less<>> m_persistentDirCacheTTL;
     /*! \brief Only used in linux for the udisks and udisks2 providers
     * defines if kodi should automount optical discs
     */
@@ -276,6 +295,8 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     bool m_bMusicLibraryAllItemsOnBottom;
     bool m_bMusicLibraryCleanOnUpdate;
     bool m_bMusicLibraryArtistSortOnUpdate;
+    unsigned int m_musicLibraryScannerThreads;
+    unsigned int m_musicLibraryScannerThreadsPerShare;
     bool m_bMusicLibraryUseISODates;
     bool m_bMusicLibraryArtistNavigatesToSongs;
     std::string m_strMusicLibraryAlbumFormat;
@@ -289,6 +310,8 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     int m_iVideoLibraryRecentlyAddedItems;
     bool m_bVideoLibraryCleanOnUpdate;
     bool m_bVideoLibraryUseFastHash;
+    unsigned int m_videoLibraryScannerThreads;
+    unsigned int m_videoLibraryScannerThreadsPerShare;
     bool m_bVideoLibraryImportWatchedState{true};
     bool m_bVideoLibraryImportResumePoint{true};
 
@@ -369,6 +392,9 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     DatabaseSettings m_databaseTV;    // advanced tv database setup
     DatabaseSettings m_databaseEpg;   /*!< advanced EPG database setup */
 
+    bool m_databaseQueryStats; /*!< @brief collect per query template execution statistics */
+    int m_databaseSlowQueryThreshold; /*!< @brief log queries slower than this many milliseconds, 0 to disable */
+
     bool m_useLocaleCollation;
 
     bool m_guiVisualizeDirtyRegions;
@@ -384,6 +410,13 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
 
     bool m_jsonOutputCompact;
     unsigned int m_jsonTcpPort;
+    unsigned int m_jsonTcpConnectionLimit;
+    unsigned int m_jsonTcpSendBufferLimit; // KiB
+    unsigned int m_jsonTcpNotificationQueueLimit;
+
+    unsigned int m_webserverThreadPoolSize;
+    unsigned int m_webserverConnectionLimit;
+    unsigned int m_webserverConnectionTimeout;
 
     bool m_enableMultimediaKeys;
     std::vector<std::string> m_settingsFiles;
@@ -13,6 +13,15 @@
 #include "settings/Settings.h"
 #include "settings/SettingsComponent.h"
 #include "settings/lib/SettingsManager.h"
+#include "video/VideoInfoTag.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
 
 #include <gtest/gtest.h>
 
@@ -1015,3 +1024,80 @@ TEST(TestFileItem, MimeType)
   EXPECT_EQ("http://testdomain.com/api/movies", item.GetURL().Get());
   EXPECT_EQ("http://testdomain.com/api/movies", item.GetDynURL().Get());
 }
+
+TEST(TestFileItem, MimeTypeShared)
+{
+  CFileItem item1("/movies/a.mkv", false);
+  CFileItem item2("/movies/b.mkv", false);
+  item1.SetMimeType("video/x-matroska");
+  item2.SetMimeType(std::string("video/x-") + "matroska");
+
+  EXPECT_EQ("video/x-matroska", item1.GetMimeType());
+  EXPECT_EQ(&item1.GetMimeType(), &item2.GetMimeType());
+
+  CFileItem copy(item1);
+  EXPECT_EQ(&item1.GetMimeType(), &copy.GetMimeType());
+}
+
+TEST(TestFileItem, LazyProperties)
+{
+  CFileItem item("/movies/a.mkv", false);
+  EXPECT_FALSE(item.HasProperties());
+  EXPECT_TRUE(item.GetProperties().empty());
+  EXPECT_TRUE(item.GetProperty("missing").isNull());
+
+  item.SetProperty("key", "value");
+  EXPECT_TRUE(item.HasProperties());
+  EXPECT_EQ("value", item.GetProperty("KEY").asString());
+
+  CFileItem copy(item);
+  EXPECT_EQ("value", copy.GetProperty("key").asString());
+
+  item.ClearProperties();
+  EXPECT_FALSE(item.HasProperties());
+  EXPECT_TRUE(copy.HasProperties());
+}
+
+// Reports the memory used per item of a typical movie listing. Not a benchmark, the assertions
+// only catch gross regressions.
+TEST(TestFileItem, BytesPerItem)
+{
+  constexpr size_t ITEMS = 10000;
+
+#if defined(__GLIBC__)
+  const size_t heapBefore = mallinfo2().uordblks;
+#endif
+
+  std::vector<std::unique_ptr<CFileItem>> items;
+  items.reserve(ITEMS);
+  for (size_t i = 0; i < ITEMS; ++i)
+  {
+    const std::string title = "Some Movie Title " + std::to_string(i);
+    const std::string folder = "/media/storage/movies/" + title + " (2024)/";
+    auto item = std::make_unique<CFileItem>(folder + title + ".mkv", false);
+    item->SetLabel(title);
+    item->SetSize(4'000'000'000);
+    item->SetMimeType("video/x-matroska");
+    item->SetArt("thumb", "image://" + folder + "poster.jpg/");
+    item->SetArt("fanart", "image://" + folder + "fanart.jpg/");
+    CVideoInfoTag* tag = item->GetVideoInfoTag();
+    tag->SetTitle(title);
+    tag->SetYear(2024);
+    tag->SetPlot("A plot outline of a typical length for a movie in the library.");
+    tag->m_iDbId = static_cast<int>(i);
+    tag->m_type = MediaTypeMovie;
+    // what a listing typically parses once the items are shown and sorted
+    item->GetURL();
+    items.emplace_back(std::move(item));
+  }
+
+  RecordProperty("sizeof_CFileItem", std::to_string(sizeof(CFileItem)));
+  RecordProperty("sizeof_CVideoInfoTag", std::to_string(sizeof(CVideoInfoTag)));
+
+#if defined(__GLIBC__)
+  const size_t bytesPerItem = (mallinfo2().uordblks - heapBefore) / ITEMS;
+  RecordProperty("bytes_per_item", std::to_string(bytesPerItem));
+#endif
+
+  EXPECT_LT(sizeof(CFileItem), 1024u);
+}
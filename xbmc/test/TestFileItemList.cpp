@@ -0,0 +1,138 @@
+/*
+ *  Copyright (C) 2026 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "FileItem.h"
+#include "FileItemList.h"
+
+#include <memory>
+#include <string>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+std::string GetPath(int i)
+{
+  return "/media/music/track " + std::to_string(i) + ".flac";
+}
+
+void FillList(CFileItemList& items, int count)
+{
+  for (int i = 0; i < count; ++i)
+    items.Add(std::make_shared<CFileItem>(GetPath(i), false));
+}
+} // namespace
+
+class TestFileItemList : public ::testing::TestWithParam<int>
+{
+};
+
+TEST_P(TestFileItemList, AddAndRemove)
+{
+  CFileItemList items;
+  FillList(items, GetParam());
+
+  EXPECT_TRUE(items.Contains(GetPath(0)));
+  EXPECT_TRUE(items.Contains(GetPath(GetParam() - 1)));
+  EXPECT_FALSE(items.Contains(GetPath(GetParam())));
+  EXPECT_EQ(GetPath(1), items.Get(GetPath(1))->GetPath());
+
+  // kept up to date once built
+  items.Add(std::make_shared<CFileItem>(GetPath(GetParam()), false));
+  EXPECT_TRUE(items.Contains(GetPath(GetParam())));
+
+  items.Remove(items.Get(GetPath(1)).get());
+  EXPECT_FALSE(items.Contains(GetPath(1)));
+  items.Remove(0);
+  EXPECT_FALSE(items.Contains(GetPath(0)));
+  EXPECT_TRUE(items.Contains(GetPath(2)));
+
+  items.ClearItems();
+  EXPECT_FALSE(items.Contains(GetPath(2)));
+}
+
+TEST_P(TestFileItemList, Duplicates)
+{
+  CFileItemList items;
+  FillList(items, GetParam());
+  const auto duplicate = std::make_shared<CFileItem>(GetPath(0), false);
+  items.Add(duplicate);
+
+  // the first item with the path is found
+  EXPECT_NE(duplicate, items.Get(GetPath(0)));
+  items.Remove(0);
+  EXPECT_EQ(duplicate, items.Get(GetPath(0)));
+  items.Remove(duplicate.get());
+  EXPECT_FALSE(items.Contains(GetPath(0)));
+}
+
+TEST_P(TestFileItemList, PathChanged)
+{
+  CFileItemList items;
+  FillList(items, GetParam());
+  ASSERT_TRUE(items.Contains(GetPath(0)));
+
+  items.Get(0)->SetPath("/media/music/renamed.flac");
+  EXPECT_TRUE(items.Contains("/media/music/renamed.flac"));
+  EXPECT_FALSE(items.Contains(GetPath(0)));
+
+  // also when the item is looked up in another list
+  CFileItemList other;
+  other.Append(items);
+  ASSERT_TRUE(other.Contains("/media/music/renamed.flac"));
+  items.Get(0)->SetPath(GetPath(0));
+  EXPECT_TRUE(other.Contains(GetPath(0)));
+  EXPECT_FALSE(other.Contains("/media/music/renamed.flac"));
+
+  // and after a list it was in is gone
+  const CFileItemPtr item = other.Get(0);
+  other.Clear();
+  {
+    CFileItemList gone;
+    gone.SetFastLookup(true);
+    gone.Add(item);
+    ASSERT_TRUE(gone.Contains(GetPath(0)));
+  }
+  item->SetPath("/media/music/renamed again.flac");
+  EXPECT_TRUE(items.Contains("/media/music/renamed again.flac"));
+  EXPECT_FALSE(items.Contains(GetPath(0)));
+}
+
+TEST_P(TestFileItemList, AppendSkipsDuplicates)
+{
+  CFileItemList items;
+  FillList(items, GetParam());
+
+  CFileItemList other;
+  other.Add(std::make_shared<CFileItem>(GetPath(1), false));
+  other.Add(std::make_shared<CFileItem>("/media/music/other.flac", false));
+  other.Add(std::make_shared<CFileItem>("/media/music/other.flac", false));
+
+  items.Append(other, true);
+  EXPECT_EQ(GetParam() + 1, items.Size());
+  EXPECT_NE(other.Get(0), items.Get(GetPath(1)));
+  EXPECT_EQ(other.Get(1), items.Get("/media/music/other.flac"));
+
+  items.Append(other);
+  EXPECT_EQ(GetParam() + 4, items.Size());
+}
+
+TEST_P(TestFileItemList, IgnoreURLOptions)
+{
+  CFileItemList items;
+  FillList(items, GetParam());
+  items.Add(std::make_shared<CFileItem>("http://host/stream.mp3|User-Agent=Kodi", false));
+
+  EXPECT_FALSE(items.Contains("http://host/stream.mp3"));
+  items.SetIgnoreURLOptions(true);
+  EXPECT_TRUE(items.Contains("http://host/stream.mp3"));
+  EXPECT_TRUE(items.Contains(GetPath(0)));
+}
+
+// small lists are searched linearly, larger ones through the index
+INSTANTIATE_TEST_SUITE_P(FileItemList, TestFileItemList, ::testing::Values(4, 100));
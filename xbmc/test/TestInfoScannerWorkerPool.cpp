@@ -0,0 +1,157 @@
+/*
+ *  Copyright (C) 2026 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "InfoScannerWorkerPool.h"
+#include "threads/Event.h"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+using namespace std::chrono_literals;
+
+TEST(TestInfoScannerWorkerPool, RunsTasks)
+{
+  auto prefetch = std::make_shared<CInfoScannerPrefetch>();
+  std::atomic<int> runs{0};
+  {
+    CInfoScannerWorkerPool pool("TestWorker", 2, 1);
+    pool.Submit("smb://server/music/",
+                [prefetch, &runs]()
+                {
+                  if (!prefetch->Start())
+                    return;
+                  runs++;
+                  prefetch->Finish();
+                });
+    EXPECT_TRUE(prefetch->Wait([]() { return false; }));
+  }
+  EXPECT_FALSE(prefetch->Start());
+  EXPECT_EQ(1, runs);
+}
+
+TEST(TestInfoScannerWorkerPool, CancelledTaskIsRunByCaller)
+{
+  CInfoScannerWorkerPool pool("TestWorker", 1, 1);
+
+  // keep the only worker busy so the prefetch stays queued
+  CEvent release;
+  CEvent busy;
+  pool.Submit("smb://server/music/",
+              [&release, &busy]()
+              {
+                busy.Set();
+                release.Wait();
+              });
+  ASSERT_TRUE(busy.Wait(5s));
+
+  auto prefetch = std::make_shared<CInfoScannerPrefetch>();
+  std::atomic<int> runs{0};
+  pool.Submit("smb://server/music/album/",
+              [prefetch, &runs]()
+              {
+                if (!prefetch->Start())
+                  return;
+                runs++;
+                prefetch->Finish();
+              });
+  pool.Cancel();
+
+  // the caller doesn't wait for the dropped task but runs it itself
+  EXPECT_TRUE(prefetch->Start());
+  release.Set();
+  EXPECT_EQ(0, runs);
+}
+
+TEST(TestInfoScannerWorkerPool, ReleasedTaskIsSkipped)
+{
+  CInfoScannerWorkerPool pool("TestWorker", 1, 1);
+
+  CEvent release;
+  pool.Submit("smb://server/music/", [&release]() { release.Wait(); });
+
+  auto prefetch = std::make_shared<CInfoScannerPrefetch>();
+  std::atomic<int> runs{0};
+  CEvent skipped;
+  pool.Submit("smb://server/music/album/",
+              [prefetch, &runs, &skipped]()
+              {
+                if (prefetch->Start())
+                  runs++;
+                skipped.Set();
+              });
+
+  // claimed without running it, as the folder isn't going to be scanned
+  EXPECT_TRUE(prefetch->Start());
+  release.Set();
+  EXPECT_TRUE(skipped.Wait(5s));
+  EXPECT_EQ(0, runs);
+}
+
+TEST(TestInfoScannerWorkerPool, WaitGivesUpWhenStopped)
+{
+  CInfoScannerPrefetch prefetch;
+  ASSERT_TRUE(prefetch.Start());
+
+  // claimed by a worker that doesn't finish
+  std::atomic<bool> stopped{false};
+  std::thread stopper(
+      [&stopped]()
+      {
+        std::this_thread::sleep_for(200ms);
+        stopped = true;
+      });
+  EXPECT_FALSE(prefetch.Wait([&stopped]() { return stopped.load(); }));
+  stopper.join();
+
+  prefetch.Finish();
+  EXPECT_TRUE(prefetch.Wait([]() { return true; }));
+}
+
+TEST(TestInfoScannerWorkerPool, QueuedTaskIsRunByCallerAfterDestruction)
+{
+  auto probe = std::make_shared<CInfoScannerPrefetch>();
+  std::atomic<int> runs{0};
+  CEvent release;
+  std::thread releaser;
+  {
+    CInfoScannerWorkerPool pool("TestWorker", 1, 1);
+
+    CEvent busy;
+    pool.Submit("/media/movies/",
+                [&release, &busy]()
+                {
+                  busy.Set();
+                  release.Wait();
+                });
+    pool.Submit("/media/movies/movie.mkv",
+                [probe, &runs]()
+                {
+                  if (!probe->Start())
+                    return;
+                  runs++;
+                  probe->Finish();
+                });
+    ASSERT_TRUE(busy.Wait(5s));
+
+    // the scanner drops its pool, e.g. after an exception, while the probe is still queued
+    releaser = std::thread(
+        [&release]()
+        {
+          std::this_thread::sleep_for(100ms);
+          release.Set();
+        });
+  }
+  releaser.join();
+
+  EXPECT_EQ(0, runs);
+  EXPECT_TRUE(probe->Start());
+}
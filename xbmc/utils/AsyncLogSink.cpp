@@ -0,0 +1,156 @@
+/*
+ *  Copyright (C) 2026 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "AsyncLogSink.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <utility>
+
+#include <spdlog/details/log_msg.h>
+#include <spdlog/fmt/fmt.h>
+
+CAsyncLogSink::CAsyncLogSink(std::shared_ptr<spdlog::sinks::sink> sink,
+                             size_t queueSize,
+                             LogOverflowPolicy policy)
+  : m_sink(std::move(sink)),
+    m_policy(policy),
+    m_mask(std::bit_ceil(std::max<size_t>(queueSize, 2)) - 1),
+    m_slots(std::make_unique<Slot[]>(m_mask + 1))
+{
+  for (size_t i = 0; i <= m_mask; ++i)
+    m_slots[i].sequence.store(i, std::memory_order_relaxed);
+
+  // not a CThread, that would log from the thread writing the log
+  m_thread = std::thread(&CAsyncLogSink::Process, this);
+}
+
+CAsyncLogSink::~CAsyncLogSink()
+{
+  m_stop = true;
+  m_queued.fetch_add(1, std::memory_order_release);
+  m_queued.notify_one();
+  m_thread.join();
+}
+
+void CAsyncLogSink::log(const spdlog::details::log_msg& msg)
+{
+  while (!TryPush(msg))
+  {
+    if (m_policy == LogOverflowPolicy::DROP)
+    {
+      m_dropped.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+    std::this_thread::yield();
+  }
+
+  m_queued.fetch_add(1, std::memory_order_release);
+  m_queued.notify_one();
+}
+
+void CAsyncLogSink::set_pattern(const std::string& pattern)
+{
+  std::unique_lock lock(m_sinkMutex);
+  m_sink->set_pattern(pattern);
+}
+
+void CAsyncLogSink::set_formatter(std::unique_ptr<spdlog::formatter> sinkFormatter)
+{
+  std::unique_lock lock(m_sinkMutex);
+  m_sink->set_formatter(std::move(sinkFormatter));
+}
+
+bool CAsyncLogSink::TryPush(const spdlog::details::log_msg& msg)
+{
+  // bounded queue where every slot carries the position it's ready for, producers claim a
+  // position by advancing m_enqueuePos and publish the slot by advancing its sequence
+  size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+  Slot* slot;
+  while (true)
+  {
+    slot = &m_slots[pos & m_mask];
+    const size_t sequence = slot->sequence.load(std::memory_order_acquire);
+    const auto diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos);
+    if (diff == 0)
+    {
+      if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+        break;
+    }
+    else if (diff < 0)
+      return false; // full
+    else
+      pos = m_enqueuePos.load(std::memory_order_relaxed);
+  }
+
+  slot->msg = spdlog::details::log_msg_buffer(msg);
+  slot->sequence.store(pos + 1, std::memory_order_release);
+  return true;
+}
+
+bool CAsyncLogSink::TryPop(spdlog::details::log_msg_buffer& msg)
+{
+  // single consumer, only the background thread dequeues
+  const size_t pos = m_dequeuePos.load(std::memory_order_relaxed);
+  Slot& slot = m_slots[pos & m_mask];
+  if (slot.sequence.load(std::memory_order_acquire) != pos + 1)
+    return false; // empty
+
+  msg = std::move(slot.msg);
+  m_dequeuePos.store(pos + 1, std::memory_order_relaxed);
+  slot.sequence.store(pos + m_mask + 1, std::memory_order_release);
+  return true;
+}
+
+void CAsyncLogSink::Process()
+{
+  uint64_t reported = 0;
+  spdlog::details::log_msg_buffer msg;
+  while (true)
+  {
+    const uint32_t queued = m_queued.load(std::memory_order_acquire);
+
+    bool written = false;
+    {
+      std::unique_lock lock(m_sinkMutex);
+      while (TryPop(msg))
+      {
+        m_sink->log(msg);
+        written = true;
+      }
+      ReportDropped(reported);
+      if (written)
+        m_sink->flush();
+    }
+
+    if (m_stop)
+    {
+      // messages queued after the last pop but before stopping
+      std::unique_lock lock(m_sinkMutex);
+      while (TryPop(msg))
+        m_sink->log(msg);
+      m_sink->flush();
+      return;
+    }
+
+    m_queued.wait(queued, std::memory_order_acquire);
+  }
+}
+
+void CAsyncLogSink::ReportDropped(uint64_t& reported)
+{
+  const uint64_t dropped = m_dropped.load(std::memory_order_relaxed);
+  if (dropped == reported)
+    return;
+
+  const std::string text =
+      fmt::format("{} log messages dropped, the log queue was full", dropped - reported);
+  m_sink->log(spdlog::details::log_msg("general", spdlog::level::warn, text));
+  reported = dropped;
+}
@@ -0,0 +1,81 @@
+/*
+ *  Copyright (C) 2026 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "utils/logtypes.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include <spdlog/details/log_msg_buffer.h>
+#include <spdlog/sinks/sink.h>
+
+/*!
+ \brief Sink handing log messages to a background thread, which writes them to another sink.
+
+ Logging threads only copy the message into a bounded lock-free queue, so they never wait for the
+ file I/O of the wrapped sink. The background thread writes the queued messages and flushes the
+ wrapped sink whenever the queue runs empty. What happens when the queue is full is decided by the
+ overflow policy, dropped messages are counted and reported in the log once there's room again.
+
+ Destroying the sink writes all queued messages.
+ */
+class CAsyncLogSink : public spdlog::sinks::sink
+{
+public:
+  /*!
+   \param sink the sink to write the messages to, only used from the background thread.
+   \param queueSize maximum number of queued messages, rounded up to a power of two.
+   \param policy what to do with messages logged while the queue is full.
+   */
+  CAsyncLogSink(std::shared_ptr<spdlog::sinks::sink> sink,
+                size_t queueSize,
+                LogOverflowPolicy policy);
+  ~CAsyncLogSink() override;
+
+  void log(const spdlog::details::log_msg& msg) override;
+  /*! \brief Does nothing, the background thread flushes whenever the queue runs empty. */
+  void flush() override {}
+  void set_pattern(const std::string& pattern) override;
+  void set_formatter(std::unique_ptr<spdlog::formatter> sinkFormatter) override;
+
+  /*! \brief Number of messages dropped because the queue was full. */
+  uint64_t GetDroppedCount() const { return m_dropped; }
+
+private:
+  struct Slot
+  {
+    std::atomic<size_t> sequence{0};
+    spdlog::details::log_msg_buffer msg;
+  };
+
+  bool TryPush(const spdlog::details::log_msg& msg);
+  bool TryPop(spdlog::details::log_msg_buffer& msg);
+  void Process();
+  void ReportDropped(uint64_t& reported);
+
+  const std::shared_ptr<spdlog::sinks::sink> m_sink;
+  std::mutex m_sinkMutex; ///< only contended when the pattern changes
+  const LogOverflowPolicy m_policy;
+  const size_t m_mask;
+  std::unique_ptr<Slot[]> m_slots;
+
+  // producers and the consumer on separate cache lines
+  alignas(64) std::atomic<size_t> m_enqueuePos{0};
+  alignas(64) std::atomic<size_t> m_dequeuePos{0};
+
+  std::atomic<uint32_t> m_queued{0}; ///< incremented for every message, waited on when empty
+  std::atomic<uint64_t> m_dropped{0};
+  std::atomic_bool m_stop{false};
+  std::thread m_thread;
+};
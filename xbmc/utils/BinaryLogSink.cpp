@@ -0,0 +1,285 @@
+/*
+ *  Copyright (C) 2026 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "BinaryLogSink.h"
+
+#include <bit>
+#include <cstring>
+#include <type_traits>
+
+#include <spdlog/details/log_msg.h>
+
+namespace
+{
+constexpr size_t BUFFER_SIZE = 64 * 1024;
+constexpr auto FLUSH_INTERVAL = std::chrono::seconds(1);
+
+thread_local const CBinaryLogSink::CStructuredMessage* currentMessage = nullptr;
+
+void PutByte(spdlog::memory_buf_t& buffer, uint8_t value)
+{
+  buffer.push_back(static_cast<char>(value));
+}
+
+void PutVarint(spdlog::memory_buf_t& buffer, uint64_t value)
+{
+  while (value >= 0x80)
+  {
+    PutByte(buffer, static_cast<uint8_t>(value) | 0x80);
+    value >>= 7;
+  }
+  PutByte(buffer, static_cast<uint8_t>(value));
+}
+
+void PutSigned(spdlog::memory_buf_t& buffer, int64_t value)
+{
+  PutVarint(buffer, (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+}
+
+void PutString(spdlog::memory_buf_t& buffer, std::string_view value)
+{
+  PutVarint(buffer, value.size());
+  buffer.append(value.data(), value.data() + value.size());
+}
+
+void PutTag(spdlog::memory_buf_t& buffer, CBinaryLogSink::ArgType type)
+{
+  PutByte(buffer, static_cast<uint8_t>(type));
+}
+
+struct ArgEncoder
+{
+  spdlog::memory_buf_t& buffer;
+
+  // returns false for types that have to be stored formatted
+  template<typename T>
+  bool operator()(T value)
+  {
+    using ArgType = CBinaryLogSink::ArgType;
+    if constexpr (std::is_same_v<T, fmt::monostate>)
+      PutTag(buffer, ArgType::NONE);
+    else if constexpr (std::is_same_v<T, bool>)
+    {
+      PutTag(buffer, ArgType::BOOL);
+      PutByte(buffer, value ? 1 : 0);
+    }
+    else if constexpr (std::is_same_v<T, char>)
+    {
+      PutTag(buffer, ArgType::CHAR);
+      PutByte(buffer, static_cast<uint8_t>(value));
+    }
+    else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>)
+    {
+      PutTag(buffer, ArgType::INT);
+      PutSigned(buffer, static_cast<int64_t>(value));
+    }
+    else if constexpr (std::is_integral_v<T>)
+    {
+      PutTag(buffer, ArgType::UINT);
+      PutVarint(buffer, static_cast<uint64_t>(value));
+    }
+    else if constexpr (std::is_floating_point_v<T>)
+    {
+      PutTag(buffer, ArgType::DOUBLE);
+      const auto bits = std::bit_cast<uint64_t>(static_cast<double>(value));
+      for (int i = 0; i < 8; ++i)
+        PutByte(buffer, static_cast<uint8_t>(bits >> (i * 8)));
+    }
+    else if constexpr (std::is_same_v<T, const char*>)
+    {
+      PutTag(buffer, ArgType::STRING);
+      PutString(buffer, value ? std::string_view(value) : std::string_view());
+    }
+    else if constexpr (std::is_same_v<T, fmt::string_view>)
+    {
+      PutTag(buffer, ArgType::STRING);
+      PutString(buffer, std::string_view(value.data(), value.size()));
+    }
+    else if constexpr (std::is_same_v<T, const void*>)
+    {
+      PutTag(buffer, ArgType::POINTER);
+      PutVarint(buffer, reinterpret_cast<uintptr_t>(value));
+    }
+    else
+      return false;
+    return true;
+  }
+};
+} // unnamed namespace
+
+CBinaryLogSink::CStructuredMessage::CStructuredMessage(fmt::string_view format,
+                                                       fmt::format_args args)
+  : m_format(format), m_args(args), m_previous(currentMessage)
+{
+  currentMessage = this;
+}
+
+CBinaryLogSink::CStructuredMessage::~CStructuredMessage()
+{
+  currentMessage = m_previous;
+}
+
+CBinaryLogSink::CBinaryLogSink(const spdlog::filename_t& filename)
+  : m_lastWrite(std::chrono::steady_clock::now())
+{
+  m_file.open(filename, true);
+  m_buffer.append(MAGIC.data(), MAGIC.data() + MAGIC.size());
+  PutByte(m_buffer, VERSION);
+
+  // not a CThread, that would log from the thread writing the log
+  m_thread = std::thread(&CBinaryLogSink::Process, this);
+}
+
+CBinaryLogSink::~CBinaryLogSink()
+{
+  {
+    std::unique_lock lock(mutex_);
+    m_stop = true;
+  }
+  m_stopCondition.notify_all();
+  m_thread.join();
+
+  std::unique_lock lock(mutex_);
+  WriteBuffer();
+  m_file.flush();
+}
+
+void CBinaryLogSink::sink_it_(const spdlog::details::log_msg& msg)
+{
+  const CStructuredMessage* structured = currentMessage;
+
+  // string records have to precede the message using them
+  const uint64_t loggerId = GetLoggerId(std::string_view(msg.logger_name.data(),
+                                                         msg.logger_name.size()));
+  const uint64_t formatId = GetFormatId(structured ? structured->m_format : "{}");
+
+  const int64_t time = std::chrono::duration_cast<std::chrono::microseconds>(
+                           msg.time.time_since_epoch())
+                           .count();
+  PutByte(m_buffer, static_cast<uint8_t>(RecordType::MESSAGE));
+  PutSigned(m_buffer, time - m_lastTime);
+  m_lastTime = time;
+  PutVarint(m_buffer, msg.thread_id);
+  PutByte(m_buffer, static_cast<uint8_t>(msg.level));
+  PutVarint(m_buffer, loggerId);
+  PutVarint(m_buffer, formatId);
+
+  if (structured)
+    EncodeArgs(structured->m_args);
+  else
+  {
+    PutVarint(m_buffer, 1);
+    PutTag(m_buffer, ArgType::STRING);
+    PutString(m_buffer, std::string_view(msg.payload.data(), msg.payload.size()));
+  }
+
+  if (m_buffer.size() >= BUFFER_SIZE || msg.level >= spdlog::level::err)
+  {
+    WriteBuffer();
+    m_file.flush();
+  }
+}
+
+void CBinaryLogSink::flush_()
+{
+  // flushed on every message, only write out once in a while
+  if (std::chrono::steady_clock::now() - m_lastWrite < FLUSH_INTERVAL)
+    return;
+
+  WriteBuffer();
+  m_file.flush();
+}
+
+void CBinaryLogSink::Process()
+{
+  std::unique_lock lock(mutex_);
+  while (!m_stop)
+  {
+    m_stopCondition.wait_for(lock, FLUSH_INTERVAL);
+    if (m_stop || m_buffer.size() == 0 ||
+        std::chrono::steady_clock::now() - m_lastWrite < FLUSH_INTERVAL)
+      continue;
+
+    try
+    {
+      WriteBuffer();
+      m_file.flush();
+    }
+    catch (const spdlog::spdlog_ex&)
+    {
+      // nowhere to report it, the next message written by a logging thread fails as well
+    }
+  }
+}
+
+uint64_t CBinaryLogSink::GetFormatId(fmt::string_view format)
+{
+  const std::string_view value(format.data(), format.size());
+  auto it = m_formats.find(format.data());
+  // the address may be reused by a different runtime format string
+  if (it != m_formats.end() && it->second.value == value)
+    return it->second.id;
+
+  const uint64_t id = AddString(value);
+  m_formats.insert_or_assign(format.data(), FormatEntry{std::string(value), id});
+  return id;
+}
+
+uint64_t CBinaryLogSink::GetLoggerId(std::string_view name)
+{
+  if (const auto it = m_loggers.find(name); it != m_loggers.end())
+    return it->second;
+
+  const uint64_t id = AddString(name);
+  m_loggers.emplace(name, id);
+  return id;
+}
+
+uint64_t CBinaryLogSink::AddString(std::string_view value)
+{
+  const uint64_t id = m_nextStringId++;
+  PutByte(m_buffer, static_cast<uint8_t>(RecordType::STRING));
+  PutVarint(m_buffer, id);
+  PutString(m_buffer, value);
+  return id;
+}
+
+void CBinaryLogSink::EncodeArgs(fmt::format_args args)
+{
+  int count = 0;
+  while (args.get(count))
+    ++count;
+
+  PutVarint(m_buffer, count);
+  ArgEncoder encoder{m_buffer};
+  for (int i = 0; i < count; ++i)
+  {
+    const auto arg = args.get(i);
+#if FMT_VERSION >= 110000
+    const bool encoded = arg.visit(encoder);
+#else
+    const bool encoded = fmt::visit_format_arg(encoder, arg);
+#endif
+    if (!encoded)
+    {
+      // custom formatters and 128 bit integers
+      PutTag(m_buffer, ArgType::STRING);
+      PutString(m_buffer, fmt::vformat("{}", fmt::format_args(&arg, 1)));
+    }
+  }
+}
+
+void CBinaryLogSink::WriteBuffer()
+{
+  if (m_buffer.size() > 0)
+  {
+    m_file.write(m_buffer);
+    m_buffer.clear();
+  }
+  m_lastWrite = std::chrono::steady_clock::now();
+}
@@ -0,0 +1,138 @@
+/*
+ *  Copyright (C) 2026 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+
+#include <spdlog/details/file_helper.h>
+#include <spdlog/sinks/base_sink.h>
+
+/*!
+ \brief Sink writing the log in a compact binary format.
+
+ Instead of the formatted text, every message is stored as its format string id and its
+ arguments, the format strings and logger names are stored once per file. Messages logged
+ through CLog provide their format and arguments with CStructuredMessage, messages logged
+ directly through a spdlog logger are stored as preformatted text.
+
+ The records are buffered and written when the buffer is full, when an error is logged and on
+ flush, but at most once per second for flushes. A background thread writes records which were
+ buffered for more than a second, so the end of the log reaches the file when logging goes idle.
+ Decode the file with tools/binlog/binlog.py.
+
+ File format, all integers are LEB128 varints, signed ones zigzag encoded:
+ \code
+ file    := "KODIBLOG" version:u8 record*
+ record  := STRING id name_length name
+          | MESSAGE time_delta_us:signed thread level:u8 logger_id format_id arg_count arg*
+ arg     := NONE | INT value:signed | UINT value | BOOL value:u8 | CHAR value:u8
+          | DOUBLE value:f64le | STRING length bytes | POINTER value
+ \endcode
+ Record types and argument tags are the values of RecordType and ArgType. time_delta_us is
+ relative to the previous message, the first one to the epoch.
+ */
+class CBinaryLogSink : public spdlog::sinks::base_sink<std::mutex>
+{
+public:
+  static constexpr std::string_view MAGIC = "KODIBLOG";
+  static constexpr uint8_t VERSION = 1;
+
+  enum class RecordType : uint8_t
+  {
+    STRING = 1,
+    MESSAGE = 2,
+  };
+
+  enum class ArgType : uint8_t
+  {
+    NONE = 0,
+    INT = 1,
+    UINT = 2,
+    BOOL = 3,
+    CHAR = 4,
+    DOUBLE = 5,
+    STRING = 6,
+    POINTER = 7,
+  };
+
+  /*!
+   \brief Format string and arguments of the message being logged on the current thread.
+   Lives on the stack of the logging call, while the message passes the sinks.
+   */
+  class CStructuredMessage
+  {
+  public:
+    CStructuredMessage(fmt::string_view format, fmt::format_args args);
+    ~CStructuredMessage();
+
+    CStructuredMessage(const CStructuredMessage&) = delete;
+    CStructuredMessage& operator=(const CStructuredMessage&) = delete;
+
+  private:
+    friend class CBinaryLogSink;
+
+    const fmt::string_view m_format;
+    const fmt::format_args m_args;
+    const CStructuredMessage* m_previous;
+  };
+
+  /*!
+   \param filename the file to write, truncated if it exists.
+   \throws spdlog::spdlog_ex if the file can't be opened.
+   */
+  explicit CBinaryLogSink(const spdlog::filename_t& filename);
+  ~CBinaryLogSink() override;
+
+protected:
+  void sink_it_(const spdlog::details::log_msg& msg) override;
+  void flush_() override;
+
+private:
+  uint64_t GetFormatId(fmt::string_view format);
+  uint64_t GetLoggerId(std::string_view name);
+  uint64_t AddString(std::string_view value);
+  void EncodeArgs(fmt::format_args args);
+  void WriteBuffer();
+  //! Writes buffered records which weren't written by a flush in time.
+  void Process();
+
+  spdlog::details::file_helper m_file;
+  spdlog::memory_buf_t m_buffer;
+  std::chrono::steady_clock::time_point m_lastWrite;
+  int64_t m_lastTime{0};
+
+  struct FormatEntry
+  {
+    std::string value;
+    uint64_t id;
+  };
+  // keyed by the address of the format string, which is a literal for almost all messages
+  std::unordered_map<const char*, FormatEntry> m_formats;
+
+  struct StringHash
+  {
+    using is_transparent = void;
+    size_t operator()(std::string_view value) const { return std::hash<std::string_view>{}(value); }
+  };
+  std::unordered_map<std::string, uint64_t, StringHash, std::equal_to<>> m_loggers;
+  uint64_t m_nextStringId{0};
+
+  // waits with mutex_ of the base sink
+  std::condition_variable m_stopCondition;
+  bool m_stop{false};
+  std::thread m_thread;
+};
@@ -0,0 +1,57 @@
+/*
+ *  Copyright (C) 2026 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "InternedString.h"
+
+#include "threads/CriticalSection.h"
+
+#include <functional>
+#include <mutex>
+#include <unordered_set>
+
+namespace
+{
+struct StringHash
+{
+  using is_transparent = void;
+  size_t operator()(std::string_view value) const { return std::hash<std::string_view>{}(value); }
+};
+
+struct StringPool
+{
+  CCriticalSection section;
+  // node based, the addresses of the values never change
+  std::unordered_set<std::string, StringHash, std::equal_to<>> values;
+};
+
+StringPool& GetPool()
+{
+  // intentionally leaked, holders may be destroyed after static destruction started
+  static StringPool* pool = new StringPool;
+  return *pool;
+}
+} // unnamed namespace
+
+const std::string* CInternedString::Intern(std::string_view value)
+{
+  if (value.empty())
+    return nullptr;
+
+  StringPool& pool = GetPool();
+  std::unique_lock lock(pool.section);
+  auto it = pool.values.find(value);
+  if (it == pool.values.end())
+    it = pool.values.emplace(value).first;
+  return &*it;
+}
+
+const std::string& CInternedString::Empty()
+{
+  static const std::string empty;
+  return empty;
+}
@@ -0,0 +1,47 @@
+/*
+ *  Copyright (C) 2026 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include <string>
+#include <string_view>
+
+/*!
+ \brief Immutable string shared by all holders of the same value.
+
+ Meant for members with a small set of values repeated over many objects, e.g. the mime type of
+ file items. Every distinct value is stored once for the lifetime of the application and holders
+ only keep a pointer to it, so don't use it for values that are unique per object such as paths.
+ */
+class CInternedString
+{
+public:
+  CInternedString() = default;
+  explicit CInternedString(std::string_view value) : m_value(Intern(value)) {}
+
+  CInternedString& operator=(std::string_view value)
+  {
+    m_value = Intern(value);
+    return *this;
+  }
+
+  const std::string& Get() const { return m_value ? *m_value : Empty(); }
+  operator const std::string&() const { return Get(); }
+
+  bool empty() const { return m_value == nullptr; }
+  void clear() { m_value = nullptr; }
+
+  bool operator==(const CInternedString& other) const { return m_value == other.m_value; }
+  bool operator==(std::string_view other) const { return Get() == other; }
+
+private:
+  static const std::string* Intern(std::string_view value);
+  static const std::string& Empty();
+
+  const std::string* m_value{nullptr}; // nullptr for the empty string
+};
@@ -8,199 +8,504 @@
 
 #include "JSONVariantParser.h"
 
-#include <nlohmann/json.hpp>
+#include <charconv>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace
+{
+/*!
+ \brief Parses JSON straight into a CVariant.
 
-class CJSONVariantParserHandler : public nlohmann::json::json_sax_t
+ It accepts the same input as nlohmann::json, which was used before, and creates the same values.
+ Strings are copied in runs of plain characters, eight bytes at a time where possible, instead of
+ one character at a time.
+ */
+class CJSONParser
 {
 public:
-  explicit CJSONVariantParserHandler(CVariant& parsedObject);
-
-  bool null() override;
-  bool binary(binary_t& b) override;
-  bool boolean(bool b) override;
-  bool number_integer(number_integer_t i) override;
-  bool number_unsigned(number_unsigned_t u) override;
-  bool number_float(number_float_t d, const string_t& s) override;
-  bool string(std::string& str) override;
-  bool start_object(std::size_t elements) override;
-  bool key(string_t& str) override;
-  bool end_object() override;
-  bool start_array(std::size_t elements) override;
-  bool end_array() override;
-  bool parse_error(std::size_t position,
-                   const std::string& last_token,
-                   const nlohmann::json::exception& ex) override;
+  CJSONParser(const char* json, size_t length) : m_pos(json), m_end(json + length) {}
+
+  bool Parse(CVariant& root);
 
 private:
-  template <typename... TArgs>
-  bool Primitive(TArgs... args)
+  // deeper documents are rejected, destroying them would overflow the stack
+  static constexpr size_t MAX_DEPTH = 1000;
+
+  struct Container
   {
-    PushObject(CVariant(std::forward<TArgs>(args)...));
-    PopObject();
+    CVariant* value;
+    bool isObject;
+  };
 
-    return true;
+  bool ParseValue(CVariant& value, std::vector<Container>& containers);
+  bool ParseString(std::string& str);
+  bool ParseEscape(std::string& str);
+  bool ParseHex(uint32_t& codepoint);
+  bool ParseNumber(CVariant& value);
+  bool ParseLiteral(std::string_view literal);
+  //! Copies the characters which need no special handling and returns the first other one.
+  char CopyPlainCharacters(std::string& str);
+  //! Returns the length of the valid UTF-8 sequence at the current position, 0 if it is invalid.
+  size_t GetUTF8SequenceLength() const;
+
+  void SkipWhitespace()
+  {
+    while (m_pos < m_end && (*m_pos == ' ' || *m_pos == '\n' || *m_pos == '\r' || *m_pos == '\t'))
+      ++m_pos;
   }
 
-  void PushObject(CVariant variant);
-  void PopObject();
-
-  CVariant& m_parsedObject;
-  std::vector<CVariant *> m_parse;
-  std::string m_key;
-  CVariant m_root;
-
-  enum class PARSE_STATUS
+  bool Consume(char c)
   {
-    Variable,
-    Array,
-    Object
-  };
-  PARSE_STATUS m_status = PARSE_STATUS::Variable;
-};
+    SkipWhitespace();
+    if (m_pos == m_end || *m_pos != c)
+      return false;
+    ++m_pos;
+    return true;
+  }
 
-CJSONVariantParserHandler::CJSONVariantParserHandler(CVariant& parsedObject)
-  : m_parsedObject(parsedObject), m_parse(), m_key()
-{ }
+  const char* m_pos;
+  const char* const m_end;
+};
 
-bool CJSONVariantParserHandler::null()
+bool CJSONParser::Parse(CVariant& root)
 {
-  PushObject(CVariant::ConstNullVariant);
-  PopObject();
+  // like nlohmann::json, a UTF-8 byte order mark is skipped
+  if (m_end - m_pos >= 3 && std::memcmp(m_pos, "\xEF\xBB\xBF", 3) == 0)
+    m_pos += 3;
+
+  // the objects and arrays the current value is part of
+  std::vector<Container> containers;
+  CVariant* value = &root;
+  while (true)
+  {
+    if (!ParseValue(*value, containers))
+      return false;
+
+    // close the containers which end after the value and find the place of the next value
+    value = nullptr;
+    while (!containers.empty() && !value)
+    {
+      CVariant& container = *containers.back().value;
+      SkipWhitespace();
+      if (m_pos == m_end)
+        return false;
+
+      const char c = *m_pos++;
+      if (containers.back().isObject)
+      {
+        if (c == '}')
+        {
+          containers.pop_back();
+          continue;
+        }
+
+        std::string key;
+        if (c != ',' || !Consume('"') || !ParseString(key) || !Consume(':'))
+          return false;
+        value = &container[key];
+      }
+      else
+      {
+        if (c == ']')
+        {
+          containers.pop_back();
+          continue;
+        }
+
+        if (c != ',')
+          return false;
+        container.push_back(CVariant());
+        value = &container[container.size() - 1];
+      }
+    }
+
+    if (!value)
+      break;
+  }
 
-  return true;
+  SkipWhitespace();
+  return m_pos == m_end;
 }
 
-bool CJSONVariantParserHandler::boolean(bool b)
+bool CJSONParser::ParseValue(CVariant& value, std::vector<Container>& containers)
 {
-  return Primitive(b);
-}
+  SkipWhitespace();
+  if (m_pos == m_end)
+    return false;
 
-bool CJSONVariantParserHandler::number_integer(number_integer_t i)
-{
-  return Primitive(i);
+  switch (*m_pos)
+  {
+    case '{':
+    {
+      ++m_pos;
+      value = CVariant(CVariant::VariantTypeObject);
+      if (Consume('}'))
+        return true;
+      if (containers.size() == MAX_DEPTH)
+        return false;
+
+      // the first member, the following ones are handled after their value
+      std::string key;
+      if (!Consume('"') || !ParseString(key) || !Consume(':'))
+        return false;
+      containers.push_back({&value, true});
+      return ParseValue(value[key], containers);
+    }
+    case '[':
+    {
+      ++m_pos;
+      value = CVariant(CVariant::VariantTypeArray);
+      if (Consume(']'))
+        return true;
+      if (containers.size() == MAX_DEPTH)
+        return false;
+
+      containers.push_back({&value, false});
+      value.push_back(CVariant());
+      return ParseValue(value[0], containers);
+    }
+    case '"':
+    {
+      ++m_pos;
+      std::string str;
+      if (!ParseString(str))
+        return false;
+      value = std::move(str);
+      return true;
+    }
+    case 't':
+      value = true;
+      return ParseLiteral("true");
+    case 'f':
+      value = false;
+      return ParseLiteral("false");
+    case 'n':
+      value = CVariant::ConstNullVariant;
+      return ParseLiteral("null");
+    default:
+      return ParseNumber(value);
+  }
 }
 
-bool CJSONVariantParserHandler::number_unsigned(number_unsigned_t u)
+bool CJSONParser::ParseLiteral(std::string_view literal)
 {
-  return Primitive(u);
-}
+  if (static_cast<size_t>(m_end - m_pos) < literal.size() ||
+      std::memcmp(m_pos, literal.data(), literal.size()) != 0)
+    return false;
 
-bool CJSONVariantParserHandler::number_float(number_float_t d, const string_t& s)
-{
-  return Primitive(d);
+  m_pos += literal.size();
+  return true;
 }
 
-bool CJSONVariantParserHandler::string(std::string& str)
+char CJSONParser::CopyPlainCharacters(std::string& str)
 {
-  return Primitive(str);
-}
+  constexpr uint64_t ONES = 0x0101010101010101ULL;
+  constexpr uint64_t HIGH_BITS = 0x8080808080808080ULL;
 
-bool CJSONVariantParserHandler::binary(binary_t& b)
-{
-  return true;
-}
+  const char* start = m_pos;
+  // eight characters at a time as long as none of them is a quote, a backslash, a control
+  // character or part of a multibyte sequence
+  while (m_end - m_pos >= 8)
+  {
+    uint64_t chunk;
+    std::memcpy(&chunk, m_pos, sizeof(chunk));
+    const uint64_t quote = chunk ^ (ONES * '"');
+    const uint64_t backslash = chunk ^ (ONES * '\\');
+    const uint64_t special = ((quote - ONES) & ~quote) | ((backslash - ONES) & ~backslash) |
+                             (chunk - ONES * 0x20) | chunk;
+    if (special & HIGH_BITS)
+      break;
+    m_pos += 8;
+  }
 
-bool CJSONVariantParserHandler::start_object(std::size_t elements)
-{
-  PushObject(CVariant::VariantTypeObject);
+  while (m_pos < m_end)
+  {
+    const auto c = static_cast<unsigned char>(*m_pos);
+    if (c == '"' || c == '\\' || c < 0x20 || c >= 0x80)
+      break;
+    ++m_pos;
+  }
 
-  return true;
+  str.append(start, m_pos);
+  return m_pos < m_end ? *m_pos : '\0';
 }
 
-bool CJSONVariantParserHandler::key(std::string& str)
+bool CJSONParser::ParseString(std::string& str)
 {
-  m_key = str;
-
-  return true;
+  while (true)
+  {
+    const auto c = static_cast<unsigned char>(CopyPlainCharacters(str));
+    if (m_pos == m_end)
+      return false;
+
+    if (c == '"')
+    {
+      ++m_pos;
+      return true;
+    }
+
+    if (c == '\\')
+    {
+      ++m_pos;
+      if (!ParseEscape(str))
+        return false;
+    }
+    else if (c >= 0x80)
+    {
+      const size_t length = GetUTF8SequenceLength();
+      if (length == 0)
+        return false;
+      str.append(m_pos, length);
+      m_pos += length;
+    }
+    else
+    {
+      // unescaped control character
+      return false;
+    }
+  }
 }
 
-bool CJSONVariantParserHandler::end_object()
+bool CJSONParser::ParseEscape(std::string& str)
 {
-  PopObject();
+  if (m_pos == m_end)
+    return false;
 
-  return true;
-}
+  switch (*m_pos++)
+  {
+    case '"':
+      str.push_back('"');
+      return true;
+    case '\\':
+      str.push_back('\\');
+      return true;
+    case '/':
+      str.push_back('/');
+      return true;
+    case 'b':
+      str.push_back('\b');
+      return true;
+    case 'f':
+      str.push_back('\f');
+      return true;
+    case 'n':
+      str.push_back('\n');
+      return true;
+    case 'r':
+      str.push_back('\r');
+      return true;
+    case 't':
+      str.push_back('\t');
+      return true;
+    case 'u':
+      break;
+    default:
+      return false;
+  }
 
-bool CJSONVariantParserHandler::start_array(std::size_t elements)
-{
-  PushObject(CVariant::VariantTypeArray);
+  uint32_t codepoint;
+  if (!ParseHex(codepoint))
+    return false;
+
+  if (codepoint >= 0xDC00 && codepoint <= 0xDFFF)
+    return false;
+
+  if (codepoint >= 0xD800 && codepoint <= 0xDBFF)
+  {
+    // a high surrogate must be followed by a low one
+    uint32_t low;
+    if (m_end - m_pos < 2 || m_pos[0] != '\\' || m_pos[1] != 'u')
+      return false;
+    m_pos += 2;
+    if (!ParseHex(low) || low < 0xDC00 || low > 0xDFFF)
+      return false;
+    codepoint = 0x10000 + ((codepoint - 0xD800) << 10) + (low - 0xDC00);
+  }
 
+  if (codepoint < 0x80)
+  {
+    str.push_back(static_cast<char>(codepoint));
+  }
+  else if (codepoint < 0x800)
+  {
+    str.push_back(static_cast<char>(0xC0 | (codepoint >> 6)));
+    str.push_back(static_cast<char>(0x80 | (codepoint & 0x3F)));
+  }
+  else if (codepoint < 0x10000)
+  {
+    str.push_back(static_cast<char>(0xE0 | (codepoint >> 12)));
+    str.push_back(static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F)));
+    str.push_back(static_cast<char>(0x80 | (codepoint & 0x3F)));
+  }
+  else
+  {
+    str.push_back(static_cast<char>(0xF0 | (codepoint >> 18)));
+    str.push_back(static_cast<char>(0x80 | ((codepoint >> 12) & 0x3F)));
+    str.push_back(static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F)));
+    str.push_back(static_cast<char>(0x80 | (codepoint & 0x3F)));
+  }
   return true;
 }
 
-bool CJSONVariantParserHandler::end_array()
+bool CJSONParser::ParseHex(uint32_t& codepoint)
 {
-  PopObject();
+  if (m_end - m_pos < 4)
+    return false;
 
+  codepoint = 0;
+  for (int i = 0; i < 4; ++i)
+  {
+    const char c = *m_pos++;
+    codepoint <<= 4;
+    if (c >= '0' && c <= '9')
+      codepoint |= c - '0';
+    else if (c >= 'a' && c <= 'f')
+      codepoint |= c - 'a' + 10;
+    else if (c >= 'A' && c <= 'F')
+      codepoint |= c - 'A' + 10;
+    else
+      return false;
+  }
   return true;
 }
 
-bool CJSONVariantParserHandler::parse_error(std::size_t position,
-                                            const std::string& last_token,
-                                            const nlohmann::json::exception& ex)
+bool CJSONParser::ParseNumber(CVariant& value)
 {
-  return false;
-}
+  const auto isDigit = [this]() { return m_pos < m_end && *m_pos >= '0' && *m_pos <= '9'; };
 
-void CJSONVariantParserHandler::PushObject(CVariant variant)
-{
-  const auto variant_type = variant.type();
+  const char* start = m_pos;
+  const bool negative = *m_pos == '-';
+  if (negative)
+    ++m_pos;
 
-  if (m_status == PARSE_STATUS::Object)
+  // -?(0|[1-9][0-9]*)(\.[0-9]+)?([eE][+-]?[0-9]+)?
+  if (!isDigit())
+    return false;
+  if (*m_pos++ != '0')
   {
-    (*m_parse.back())[m_key] = std::move(variant);
-    m_parse.push_back(&((*m_parse.back())[m_key]));
+    while (isDigit())
+      ++m_pos;
   }
-  else if (m_status == PARSE_STATUS::Array)
+
+  bool isFloat = false;
+  if (m_pos < m_end && *m_pos == '.')
+  {
+    isFloat = true;
+    ++m_pos;
+    if (!isDigit())
+      return false;
+    while (isDigit())
+      ++m_pos;
+  }
+
+  if (m_pos < m_end && (*m_pos == 'e' || *m_pos == 'E'))
   {
-    CVariant *temp = m_parse[m_parse.size() - 1];
-    temp->push_back(std::move(variant));
-    m_parse.push_back(&(*temp)[temp->size() - 1]);
+    isFloat = true;
+    ++m_pos;
+    if (m_pos < m_end && (*m_pos == '+' || *m_pos == '-'))
+      ++m_pos;
+    if (!isDigit())
+      return false;
+    while (isDigit())
+      ++m_pos;
   }
-  else if (m_parse.empty())
+
+  if (!isFloat)
   {
-    m_root = std::move(variant);
-    m_parse.push_back(&m_root);
+    // integers which don't fit into 64 bits become doubles
+    if (negative)
+    {
+      int64_t integer;
+      if (std::from_chars(start, m_pos, integer).ec == std::errc())
+      {
+        value = integer;
+        return true;
+      }
+    }
+    else
+    {
+      uint64_t integer;
+      if (std::from_chars(start, m_pos, integer).ec == std::errc())
+      {
+        value = integer;
+        return true;
+      }
+    }
   }
 
-  if (variant_type == CVariant::VariantTypeObject)
-    m_status = PARSE_STATUS::Object;
-  else if (variant_type == CVariant::VariantTypeArray)
-    m_status = PARSE_STATUS::Array;
+  // strtod needs a null terminated string
+  const size_t length = m_pos - start;
+  char buffer[64];
+  double number;
+  if (length < sizeof(buffer))
+  {
+    std::memcpy(buffer, start, length);
+    buffer[length] = '\0';
+    number = std::strtod(buffer, nullptr);
+  }
   else
-    m_status = PARSE_STATUS::Variable;
+  {
+    number = std::strtod(std::string(start, length).c_str(), nullptr);
+  }
+
+  // numbers too large for a double are rejected
+  if (!std::isfinite(number))
+    return false;
+
+  value = number;
+  return true;
 }
 
-void CJSONVariantParserHandler::PopObject()
+size_t CJSONParser::GetUTF8SequenceLength() const
 {
-  assert(!m_parse.empty());
-  CVariant* variant = m_parse.back();
-  m_parse.pop_back();
+  const size_t available = m_end - m_pos;
+  const auto byte = [this, available](size_t index)
+  { return index < available ? static_cast<unsigned char>(m_pos[index]) : 0; };
+  const auto isContinuation = [](unsigned char c) { return (c & 0xC0) == 0x80; };
 
-  if (!m_parse.empty())
+  const unsigned char first = byte(0);
+  if (first >= 0xC2 && first <= 0xDF)
+    return isContinuation(byte(1)) ? 2 : 0;
+
+  if (first >= 0xE0 && first <= 0xEF)
   {
-    variant = m_parse[m_parse.size() - 1];
-    if (variant->isObject())
-      m_status = PARSE_STATUS::Object;
-    else if (variant->isArray())
-      m_status = PARSE_STATUS::Array;
-    else
-      m_status = PARSE_STATUS::Variable;
+    // no overlong encodings and no surrogates
+    const unsigned char second = byte(1);
+    if ((first == 0xE0 && second < 0xA0) || (first == 0xED && second > 0x9F))
+      return 0;
+    return isContinuation(second) && isContinuation(byte(2)) ? 3 : 0;
   }
-  else
+
+  if (first >= 0xF0 && first <= 0xF4)
   {
-    m_parsedObject = *variant;
-    m_status = PARSE_STATUS::Variable;
+    // no overlong encodings and nothing above U+10FFFF
+    const unsigned char second = byte(1);
+    if ((first == 0xF0 && second < 0x90) || (first == 0xF4 && second > 0x8F))
+      return 0;
+    return isContinuation(second) && isContinuation(byte(2)) && isContinuation(byte(3)) ? 4 : 0;
   }
+
+  return 0;
 }
+} // unnamed namespace
 
 bool CJSONVariantParser::Parse(const char* json, CVariant& data)
 {
   if (json == nullptr)
     return false;
 
-  CJSONVariantParserHandler handler(data);
-  return nlohmann::json::sax_parse(json, &handler);
+  CVariant root;
+  CJSONParser parser(json, std::strlen(json));
+  if (!parser.Parse(root))
+    return false;
+
+  data = std::move(root);
+  return true;
 }
 
 bool CJSONVariantParser::Parse(const std::string& json, CVariant& data)
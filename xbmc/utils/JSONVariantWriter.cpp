@@ -10,74 +10,329 @@
 
 #include "utils/Variant.h"
 
-#include <nlohmann/json.hpp>
+#include <charconv>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <string_view>
 
-void InternalWrite(nlohmann::json& writer, const CVariant& value)
+#include <fmt/format.h>
+
+namespace
 {
-  switch (value.type())
+/*!
+ \brief Writes a CVariant as JSON straight into the output string.
+
+ The output has the same layout as the one of nlohmann::json::dump(), which was used before,
+ without building a json document holding a copy of all values first. Doubles are written in
+ their shortest representation which reads back to the same value.
+ */
+class CJSONStreamWriter
+{
+public:
+  CJSONStreamWriter(std::string& output, bool compact) : m_output(output), m_compact(compact) {}
+
+  bool Write(const CVariant& value, unsigned int depth)
+  {
+    switch (value.type())
+    {
+      case CVariant::VariantTypeInteger:
+        WriteInteger(value.asInteger());
+        return true;
+      case CVariant::VariantTypeUnsignedInteger:
+        WriteInteger(value.asUnsignedInteger());
+        return true;
+      case CVariant::VariantTypeDouble:
+        WriteDouble(value.asDouble());
+        return true;
+      case CVariant::VariantTypeBoolean:
+        m_output.append(value.asBoolean() ? "true" : "false");
+        return true;
+      case CVariant::VariantTypeString:
+        return WriteString(std::string_view(value.c_str(), value.size()));
+      case CVariant::VariantTypeArray:
+        return WriteArray(value, depth);
+      case CVariant::VariantTypeObject:
+        return WriteObject(value, depth);
+
+      case CVariant::VariantTypeConstNull:
+      case CVariant::VariantTypeNull:
+      default:
+        m_output.append("null");
+        return true;
+    }
+  }
+
+private:
+  bool WriteArray(const CVariant& value, unsigned int depth)
   {
-  case CVariant::VariantTypeInteger:
-    writer = value.asInteger();
-    break;
-  case CVariant::VariantTypeUnsignedInteger:
-    writer = value.asUnsignedInteger();
-    break;
-  case CVariant::VariantTypeDouble:
-    writer = value.asDouble();
-    break;
-  case CVariant::VariantTypeBoolean:
-    writer = value.asBoolean();
-    break;
-  case CVariant::VariantTypeString:
-    writer = std::string(value.c_str(), value.size());
-    break;
-  case CVariant::VariantTypeArray:
-    writer = nlohmann::json::array();
+    if (value.empty())
+    {
+      m_output.append("[]");
+      return true;
+    }
 
+    m_output.push_back('[');
     for (CVariant::const_iterator_array itr = value.begin_array(); itr != value.end_array(); ++itr)
     {
-      nlohmann::json& o = writer.emplace_back();
-      InternalWrite(o, *itr);
+      if (itr != value.begin_array())
+        m_output.push_back(',');
+      NewLine(depth + 1);
+      if (!Write(*itr, depth + 1))
+        return false;
     }
+    NewLine(depth);
+    m_output.push_back(']');
+    return true;
+  }
 
-    break;
-  case CVariant::VariantTypeObject:
-    writer = nlohmann::json::object();
+  bool WriteObject(const CVariant& value, unsigned int depth)
+  {
+    if (value.empty())
+    {
+      m_output.append("{}");
+      return true;
+    }
 
+    m_output.push_back('{');
     for (CVariant::const_iterator_map itr = value.begin_map(); itr != value.end_map(); ++itr)
     {
-      nlohmann::json& o = writer[itr->first];
-      InternalWrite(o, itr->second);
+      if (itr != value.begin_map())
+        m_output.push_back(',');
+      NewLine(depth + 1);
+      if (!WriteString(itr->first))
+        return false;
+      m_output.append(m_compact ? ":" : ": ");
+      if (!Write(itr->second, depth + 1))
+        return false;
     }
+    NewLine(depth);
+    m_output.push_back('}');
+    return true;
+  }
 
-    break;
+  void NewLine(unsigned int depth)
+  {
+    if (m_compact)
+      return;
 
-  case CVariant::VariantTypeConstNull:
-  case CVariant::VariantTypeNull:
-  default:
-    writer = nullptr;
-    break;
+    m_output.push_back('\n');
+    m_output.append(depth, '\t');
   }
-}
 
-bool CJSONVariantWriter::Write(const CVariant &value, std::string& output, bool compact)
-{
-  try
+  template<typename T>
+  void WriteInteger(T value)
   {
-    nlohmann::json json;
-    InternalWrite(json, value);
+    char buffer[24];
+    const auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    m_output.append(buffer, result.ptr);
+  }
+
+  void WriteDouble(double value)
+  {
+    if (!std::isfinite(value))
+    {
+      m_output.append("null");
+      return;
+    }
 
-    if (compact)
+    if (value == 0.0)
     {
-      output = json.dump();
+      m_output.append(std::signbit(value) ? "-0.0" : "0.0");
+      return;
+    }
+
+    // shortest representation which reads back to the same value. Floating point std::to_chars
+    // isn't available on all platforms so take the digits from fmt, which picks its own layout
+    char buffer[32];
+    const auto result = fmt::format_to_n(buffer, sizeof(buffer), "{}", value);
+    std::string_view formatted(buffer, result.out - buffer);
+
+    if (formatted.front() == '-')
+    {
+      m_output.push_back('-');
+      formatted.remove_prefix(1);
+    }
+
+    const size_t exponentPos = formatted.find_first_of("eE");
+    int exponent = 0;
+    if (exponentPos != std::string_view::npos)
+    {
+      const char* exponentBegin = formatted.data() + exponentPos + 1;
+      if (*exponentBegin == '+')
+        ++exponentBegin;
+      std::from_chars(exponentBegin, formatted.data() + formatted.size(), exponent);
+    }
+    const std::string_view mantissa = formatted.substr(0, exponentPos);
+
+    // value = 0.<digits> * 10^point
+    std::string digits;
+    digits.reserve(mantissa.size());
+    int point = static_cast<int>(mantissa.find('.'));
+    if (point < 0)
+      point = static_cast<int>(mantissa.size());
+    for (const char c : mantissa)
+    {
+      if (c != '.')
+        digits.push_back(c);
+    }
+    point += exponent;
+
+    const size_t firstDigit = digits.find_first_not_of('0');
+    digits.erase(0, firstDigit);
+    point -= static_cast<int>(firstDigit);
+    digits.erase(digits.find_last_not_of('0') + 1);
+    exponent = point - 1;
+
+    // same layout as nlohmann::json: plain notation for 1e-5 < |value| < 1e15, otherwise
+    // scientific with a two digit exponent
+    const int digitCount = static_cast<int>(digits.size());
+    if (point >= digitCount && point <= 15)
+    {
+      // 1234500.0
+      m_output.append(digits);
+      m_output.append(point - digitCount, '0');
+      m_output.append(".0");
+    }
+    else if (point > 0 && point <= 15)
+    {
+      // 1234.5
+      m_output.append(digits, 0, point);
+      m_output.push_back('.');
+      m_output.append(digits, point);
+    }
+    else if (point > -4 && point <= 0)
+    {
+      // 0.0012345
+      m_output.append("0.");
+      m_output.append(-point, '0');
+      m_output.append(digits);
     }
     else
     {
-      output = json.dump(1, '\t');
+      // 1.2345e+20
+      m_output.push_back(digits.front());
+      if (digitCount > 1)
+      {
+        m_output.push_back('.');
+        m_output.append(digits, 1);
+      }
+      m_output.push_back('e');
+      m_output.push_back(exponent < 0 ? '-' : '+');
+      const int absExponent = std::abs(exponent);
+      if (absExponent < 10)
+        m_output.push_back('0');
+      WriteInteger(absExponent);
+    }
+  }
+
+  bool WriteString(std::string_view value)
+  {
+    static constexpr char HEX[] = "0123456789abcdef";
+
+    m_output.push_back('"');
+    size_t unescaped = 0;
+    for (size_t pos = 0; pos < value.size();)
+    {
+      const auto c = static_cast<unsigned char>(value[pos]);
+      if (c >= 0x80)
+      {
+        // only copy valid UTF-8, like nlohmann::json does
+        const size_t length = GetUTF8SequenceLength(value.substr(pos));
+        if (length == 0)
+          return false;
+        pos += length;
+        continue;
+      }
+
+      if (c >= 0x20 && c != '"' && c != '\\')
+      {
+        ++pos;
+        continue;
+      }
+
+      m_output.append(value.data() + unescaped, pos - unescaped);
+      m_output.push_back('\\');
+      switch (c)
+      {
+        case '"':
+        case '\\':
+          m_output.push_back(static_cast<char>(c));
+          break;
+        case '\b':
+          m_output.push_back('b');
+          break;
+        case '\f':
+          m_output.push_back('f');
+          break;
+        case '\n':
+          m_output.push_back('n');
+          break;
+        case '\r':
+          m_output.push_back('r');
+          break;
+        case '\t':
+          m_output.push_back('t');
+          break;
+        default:
+          m_output.append("u00");
+          m_output.push_back(HEX[c >> 4]);
+          m_output.push_back(HEX[c & 0xf]);
+          break;
+      }
+      unescaped = ++pos;
+    }
+    m_output.append(value.data() + unescaped, value.size() - unescaped);
+    m_output.push_back('"');
+    return true;
+  }
+
+  //! Returns the length of the UTF-8 sequence at the start of the value, 0 if it is invalid.
+  static size_t GetUTF8SequenceLength(std::string_view value)
+  {
+    const auto byte = [&value](size_t index)
+    { return index < value.size() ? static_cast<unsigned char>(value[index]) : 0; };
+    const auto isContinuation = [](unsigned char c) { return (c & 0xc0) == 0x80; };
+
+    const unsigned char first = byte(0);
+    if (first >= 0xc2 && first <= 0xdf)
+      return isContinuation(byte(1)) ? 2 : 0;
+
+    if (first >= 0xe0 && first <= 0xef)
+    {
+      // no overlong encodings and no surrogates
+      const unsigned char second = byte(1);
+      if ((first == 0xe0 && second < 0xa0) || (first == 0xed && second > 0x9f))
+        return 0;
+      return isContinuation(second) && isContinuation(byte(2)) ? 3 : 0;
     }
+
+    if (first >= 0xf0 && first <= 0xf4)
+    {
+      // no overlong encodings and nothing above U+10FFFF
+      const unsigned char second = byte(1);
+      if ((first == 0xf0 && second < 0x90) || (first == 0xf4 && second > 0x8f))
+        return 0;
+      return isContinuation(second) && isContinuation(byte(2)) && isContinuation(byte(3)) ? 4
+                                                                                          : 0;
+    }
+
+    return 0;
   }
-  catch (nlohmann::json::exception&)
+
+  std::string& m_output;
+  const bool m_compact;
+};
+} // unnamed namespace
+
+bool CJSONVariantWriter::Write(const CVariant &value, std::string& output, bool compact)
+{
+  output.clear();
+
+  CJSONStreamWriter writer(output, compact);
+  if (!writer.Write(value, 0))
   {
+    output.clear();
     return false;
   }
 
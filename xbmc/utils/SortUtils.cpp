@@ -651,6 +651,105 @@ bool SorterIndirectIgnoreFoldersDescending(const std::shared_ptr<SortItem>& left
   return SorterIgnoreFoldersDescending(*left, *right);
 }
 
+namespace
+{
+struct CollationKey
+{
+  int special;
+  bool folder;
+  std::string label;
+  size_t index;
+};
+
+int GetSpecialRank(const SortItem& item)
+{
+  const auto it = item.find(Field::SORT_SPECIAL);
+  if (it == item.end() || it->second.asInteger() > static_cast<int64_t>(SortSpecial::BOTTOM))
+    return 1;
+
+  switch (static_cast<SortSpecial>(it->second.asInteger()))
+  {
+    case SortSpecial::TOP:
+      return 0;
+    case SortSpecial::BOTTOM:
+      return 2;
+    default:
+      return 1;
+  }
+}
+
+/*!
+ * \brief Sort items by binary sort keys of their Field::SORT labels.
+ *
+ * Gives the same order as std::stable_sort() with the Sorter* functions above, but the labels are
+ * only converted into sort keys once instead of being copied and compared character by character
+ * in every comparison.
+ *
+ * \return false if the items weren't sorted, as the keys can't give the same order for the labels
+ * under locale collation.
+ */
+template<typename Items, typename GetItem>
+bool SortByCollationKeys(Items& items, SortOrder sortOrder, SortAttribute attributes, GetItem getItem)
+{
+  const bool descending = sortOrder == SortOrder::DESCENDING;
+  const bool handleFolder = !(attributes & SortAttributeIgnoreFolders);
+
+  std::vector<CollationKey> keys;
+  std::vector<std::wstring> labels;
+  keys.reserve(items.size());
+  labels.resize(items.size());
+  for (size_t i = 0; i < items.size(); ++i)
+  {
+    const SortItem& item = getItem(items[i]);
+    CollationKey& key = keys.emplace_back(GetSpecialRank(item), false, std::string(), i);
+
+    // items sorted on top or bottom keep their order
+    if (key.special != 1)
+      continue;
+
+    if (handleFolder)
+    {
+      const auto it = item.find(Field::FOLDER);
+      key.folder = it != item.end() && it->second.asBoolean();
+    }
+    labels[i] = item.at(Field::SORT).asWideString();
+  }
+
+  StringUtils::CollationWeights weights;
+  const StringUtils::CollationWeights* collation = nullptr;
+  if (g_langInfo.UseLocaleCollation())
+  {
+    const std::vector<std::wstring_view> views(labels.begin(), labels.end());
+    if (!StringUtils::GetLocaleCollationWeights(g_langInfo.GetSystemLocale(), views, weights))
+      return false;
+    collation = &weights;
+  }
+
+  for (auto& key : keys)
+  {
+    if (key.special == 1)
+      key.label = StringUtils::AlphaNumericSortKey(labels[key.index], collation);
+  }
+
+  std::stable_sort(keys.begin(), keys.end(),
+                   [descending](const CollationKey& left, const CollationKey& right)
+                   {
+                     if (left.special != right.special)
+                       return left.special < right.special;
+                     if (left.folder != right.folder)
+                       return left.folder;
+                     return descending ? right.label < left.label : left.label < right.label;
+                   });
+
+  Items sorted;
+  sorted.reserve(items.size());
+  for (const auto& key : keys)
+    sorted.emplace_back(std::move(items[key.index]));
+  items.swap(sorted);
+  return true;
+}
+} // unnamed namespace
+
 // clang-format off
 std::map<SortBy, SortUtils::SortPreparator> fillPreparators()
 {
@@ -792,13 +891,13 @@ std::map<SortBy, Fields> fillSortingFields()
 std::map<SortBy, SortUtils::SortPreparator> SortUtils::m_preparators = fillPreparators();
 std::map<SortBy, Fields> SortUtils::m_sortingFields = fillSortingFields();
 
-void SortUtils::GetFieldsForSQLSort(const MediaType& mediaType,
+bool SortUtils::GetFieldsForSQLSort(const MediaType& mediaType,
                                     SortBy sortMethod,
                                     FieldList& fields)
 {
   fields.clear();
   if (mediaType == MediaTypeNone)
-    return;
+    return false;
 
   if (mediaType == MediaTypeAlbum)
   {
@@ -967,10 +1066,36 @@ void SortUtils::GetFieldsForSQLSort(const MediaType& mediaType,
     else if (sortMethod == SortBy::DATE_ADDED)
       fields.emplace_back(Field::DATE_ADDED);
   }
+  else if (mediaType == MediaTypeMovie || mediaType == MediaTypeTvShow ||
+           mediaType == MediaTypeEpisode || mediaType == MediaTypeMusicVideo)
+  {
+    // Only sort methods on numeric and date columns, sorting by labels depends on sort titles,
+    // ignored articles and natural number ordering that can't be expressed in SQL
+    if (sortMethod == SortBy::DATE_ADDED)
+      fields.emplace_back(Field::DATE_ADDED);
+    else if (sortMethod == SortBy::LAST_PLAYED)
+      fields.emplace_back(Field::LAST_PLAYED);
+    else if (sortMethod == SortBy::USER_RATING)
+      fields.emplace_back(Field::USER_RATING);
+    else if (sortMethod == SortBy::RANDOM)
+      fields.emplace_back(Field::RANDOM);
+    else if (sortMethod == SortBy::PLAYCOUNT && mediaType != MediaTypeTvShow)
+      fields.emplace_back(Field::PLAYCOUNT);
+    else if (sortMethod == SortBy::RATING && mediaType != MediaTypeMusicVideo)
+      fields.emplace_back(Field::RATING);
+    else if (sortMethod == SortBy::VOTES && mediaType != MediaTypeMusicVideo)
+      fields.emplace_back(Field::VOTES);
+    else if (sortMethod == SortBy::NUMBER_OF_EPISODES && mediaType == MediaTypeTvShow)
+      fields.emplace_back(Field::NUMBER_OF_EPISODES);
+    else if (sortMethod == SortBy::NUMBER_OF_WATCHED_EPISODES && mediaType == MediaTypeTvShow)
+      fields.emplace_back(Field::NUMBER_OF_WATCHED_EPISODES);
+  }
+
+  const bool supported = sortMethod == SortBy::NONE || !fields.empty();
 
   // Add sort by id to define order when other fields same or sort none
   fields.emplace_back(Field::ID);
-  return;
+  return supported;
 }
 
 void SortUtils::Sort(SortBy sortBy, SortOrder sortOrder, SortAttribute attributes, DatabaseResults& items, int limitEnd /* = -1 */, int limitStart /* = 0 */)
@@ -999,7 +1124,9 @@ void SortUtils::Sort(SortBy sortBy, SortOrder sortOrder, SortAttribute attribute
       }
 
       // Do the sorting
-      std::stable_sort(items.begin(), items.end(), getSorter(sortOrder, attributes));
+      if (!SortByCollationKeys(items, sortOrder, attributes,
+                               [](const SortItem& item) -> const SortItem& { return item; }))
+        std::stable_sort(items.begin(), items.end(), getSorter(sortOrder, attributes));
     }
   }
 
@@ -1038,7 +1165,10 @@ void SortUtils::Sort(SortBy sortBy, SortOrder sortOrder, SortAttribute attribute
       }
 
       // Do the sorting
-      std::stable_sort(items.begin(), items.end(), getSorterIndirect(sortOrder, attributes));
+      if (!SortByCollationKeys(items, sortOrder, attributes,
+                               [](const std::shared_ptr<SortItem>& item) -> const SortItem&
+                               { return *item; }))
+        std::stable_sort(items.begin(), items.end(), getSorterIndirect(sortOrder, attributes));
     }
   }
 
@@ -224,7 +224,14 @@ public:
                               dbiplus::Dataset& dataset,
                               DatabaseResults& results);
 
-  static void GetFieldsForSQLSort(const MediaType& mediaType, SortBy sortMethod, FieldList& fields);
+  /*! \brief Get the fields a database query has to be ordered by for the given sort method.
+   The id of the media type is always added as the last field to get a stable order.
+   \param mediaType the media type of the items to sort.
+   \param sortMethod the sort method.
+   \param fields the list of fields to order by.
+   \return true if the sort method can be expressed in SQL, false if it has to be sorted in memory.
+   */
+  static bool GetFieldsForSQLSort(const MediaType& mediaType, SortBy sortMethod, FieldList& fields);
   static const Fields& GetFieldsForSorting(SortBy sortBy);
   static std::string RemoveArticles(const std::string &label);
 
@@ -1147,6 +1147,142 @@ int64_t StringUtils::AlphaNumericCompare(std::wstring_view left, std::wstring_vi
   return 0; // files are the same
 }
 
+namespace
+{
+bool IsAsciiSymbol(wchar_t c)
+{
+  return (c >= 32 && c < L'0') || (c > L'9' && c < L'A') || (c > L'Z' && c < L'a') ||
+         (c > L'z' && c < 128);
+}
+
+wchar_t FoldAsciiCase(wchar_t c)
+{
+  return c >= L'A' && c <= L'Z' ? c + (L'a' - L'A') : c;
+}
+
+void AppendWeight(std::string& key, uint32_t weight)
+{
+  key += '\x02';
+  key += static_cast<char>((weight >> 16) & 0xFF);
+  key += static_cast<char>((weight >> 8) & 0xFF);
+  key += static_cast<char>(weight & 0xFF);
+}
+} // unnamed namespace
+
+// Builds a key that compares bytewise the same as AlphaNumericCompare() compares the strings.
+// Every character is encoded as a unit of the form
+//   0x01 <symbol>                    for ascii punctuation and symbols, sorted first
+//   0x02 <weight>                    for all other characters, 3 bytes big endian. Without
+//                                    locale collation the weight is the character after accent
+//                                    and case folding, otherwise its rank in the locale.
+//   0x02 <weight of '0'> <length> <digits>
+//                                    for numbers of up to 15 digits, where length counts the
+//                                    digits without leading zeros so numbers sort by value
+// Numbers take the place of the character '0' so they sort between the characters before and
+// after the digits, just like AlphaNumericCompare() compares a digit with any other character.
+std::string StringUtils::AlphaNumericSortKey(std::wstring_view str,
+                                             const CollationWeights* weights /* = nullptr */)
+{
+  const auto weight = [weights](wchar_t c) -> uint32_t
+  {
+    if (!weights)
+      return static_cast<uint32_t>(c > 128 ? GetCollationWeight(c) : c);
+    const auto it = weights->find(c);
+    return it != weights->end() ? it->second : 0;
+  };
+  const uint32_t numberWeight = weight(L'0');
+
+  std::string key;
+  key.reserve(str.size() * 4);
+
+  auto it{str.cbegin()};
+  while (it != str.cend())
+  {
+    if (*it >= L'0' && *it <= L'9')
+    {
+      const auto start = it;
+      while (it != str.cend() && *it >= L'0' && *it <= L'9' && std::distance(start, it) < 15)
+        ++it;
+      auto digit = start;
+      while (digit != it && *digit == L'0')
+        ++digit;
+
+      AppendWeight(key, numberWeight);
+      key += static_cast<char>(std::distance(digit, it));
+      for (; digit != it; ++digit)
+        key += static_cast<char>(*digit);
+      continue;
+    }
+
+    const wchar_t c{*it++};
+    if (IsAsciiSymbol(c))
+    {
+      key += '\x01';
+      key += static_cast<char>(c);
+      continue;
+    }
+
+    // AlphaNumericCompare() folds the accents before the case
+    AppendWeight(key, weights ? weight(FoldAsciiCase(c)) : FoldAsciiCase(weight(c)));
+  }
+
+  return key;
+}
+
+bool StringUtils::GetLocaleCollationWeights(const std::locale& locale,
+                                            std::span<const std::wstring_view> strings,
+                                            CollationWeights& weights)
+{
+  // the characters AlphaNumericCompare() compares with the collate facet
+  std::vector<wchar_t> chars{L'0', L'1', L'2', L'3', L'4', L'5', L'6', L'7', L'8', L'9'};
+  for (const auto& str : strings)
+  {
+    for (const wchar_t c : str)
+    {
+      if ((c < L'0' || c > L'9') && !IsAsciiSymbol(c))
+        chars.emplace_back(FoldAsciiCase(c));
+    }
+  }
+  std::ranges::sort(chars);
+  chars.erase(std::ranges::unique(chars).begin(), chars.end());
+
+  const auto& coll = std::use_facet<std::collate<wchar_t>>(locale);
+  std::vector<std::pair<std::wstring, wchar_t>> transformed;
+  transformed.reserve(chars.size());
+  for (const wchar_t c : chars)
+    transformed.emplace_back(coll.transform(&c, &c + 1), c);
+  std::ranges::sort(transformed);
+
+  // the digits are compared by value and share the weight of numbers. Other characters must
+  // collate either before or after all of them.
+  ptrdiff_t first = -1;
+  ptrdiff_t last = -1;
+  for (ptrdiff_t i = 0; i < std::ssize(transformed); ++i)
+  {
+    if (transformed[i].second >= L'0' && transformed[i].second <= L'9')
+    {
+      if (first < 0)
+        first = i;
+      last = i;
+    }
+  }
+  if (last - first != 9 ||
+      (first > 0 && transformed[first - 1].first == transformed[first].first) ||
+      (last + 1 < std::ssize(transformed) && transformed[last + 1].first == transformed[last].first))
+    return false;
+
+  weights.clear();
+  weights.reserve(transformed.size());
+  uint32_t weight = 0;
+  for (ptrdiff_t i = 0; i < std::ssize(transformed); ++i)
+  {
+    if (i == 0 || (transformed[i].first != transformed[i - 1].first && (i <= first || i > last)))
+      ++weight;
+    weights.try_emplace(transformed[i].second, weight);
+  }
+  return true;
+}
+
 /*
   Convert the UTF8 character to which z points into a 31-bit Unicode point.
   Return how many bytes (0 to 3) of UTF8 data encode the character.
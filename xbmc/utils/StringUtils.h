@@ -27,6 +27,7 @@
 #include <stdarg.h>
 #include <stdint.h>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 // workaround for broken [[deprecated]] in coverity
@@ -282,6 +283,31 @@ public:
                                                  const void* pKey1,
                                                  int nKey2,
                                                  const void* pKey2) noexcept;
+  /*! \brief Weights of characters under locale collation, see GetLocaleCollationWeights() */
+  using CollationWeights = std::unordered_map<wchar_t, uint32_t>;
+  /*! \brief Build a binary sort key for a wide string
+   Comparing two sort keys bytewise (e.g. with memcmp or std::string's operator<) gives the same
+   order as comparing the strings with AlphaNumericCompare().
+   \param str the string to build the sort key for
+   \param weights the weights from GetLocaleCollationWeights() if locale collation is in use,
+   nullptr otherwise
+   \return the sort key
+   \sa AlphaNumericCompare, CLangInfo::UseLocaleCollation
+   */
+  [[nodiscard]] static std::string AlphaNumericSortKey(std::wstring_view str,
+                                                       const CollationWeights* weights = nullptr);
+  /*! \brief Rank the characters of the given strings by the collate facet of a locale
+   Characters that collate the same get the same weight.
+   \param locale the locale to collate the characters with
+   \param strings the strings to rank the characters of
+   \param weights [out] the weights for AlphaNumericSortKey()
+   \return false if a character collates among the digits, e.g. a superscript digit. Sort keys
+   can't give the same order as AlphaNumericCompare() then, as it compares such a character with
+   the first digit of a number, while numbers are compared with each other by value.
+   */
+  [[nodiscard]] static bool GetLocaleCollationWeights(const std::locale& locale,
+                                                      std::span<const std::wstring_view> strings,
+                                                      CollationWeights& weights);
   [[nodiscard]] static long TimeStringToSeconds(std::string_view timeString);
   static void RemoveCRLF(std::string& strLine) noexcept;
 
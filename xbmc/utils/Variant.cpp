@@ -10,9 +10,11 @@
 
 #include "Variant.h"
 
+#include <algorithm>
 #include <charconv>
 #include <cstdlib>
 #include <cstring>
+#include <new>
 #include <string>
 #include <utility>
 #include <variant>
@@ -138,6 +140,270 @@ double str2double(std::wstring_view str, double fallback /* = 0.0 */)
   return fallback;
 }
 
+namespace
+{
+/*!
+ \brief Keeps released member blocks of CVariantMap for reuse by the same thread.
+
+ Large trees (e.g. JSON-RPC library results) create and free many small objects, which then don't
+ need to go through the allocator for every object.
+ */
+class CVariantMapBlockPool
+{
+public:
+  ~CVariantMapBlockPool();
+
+  void* Allocate(size_t blockClass, size_t size);
+  void Release(size_t blockClass, void* block);
+
+private:
+  // blocks with up to 32 members are pooled
+  static constexpr size_t POOLED_CLASSES = 5;
+  static constexpr size_t MAX_BLOCKS_PER_CLASS = 256;
+
+  std::vector<void*> m_blocks[POOLED_CLASSES];
+};
+
+thread_local CVariantMapBlockPool blockPool;
+// objects destroyed after the pool of their thread (e.g. statics) don't use it anymore
+thread_local bool blockPoolDestroyed = false;
+
+CVariantMapBlockPool::~CVariantMapBlockPool()
+{
+  blockPoolDestroyed = true;
+  for (std::vector<void*>& blocks : m_blocks)
+  {
+    for (void* block : blocks)
+      ::operator delete(block);
+  }
+}
+
+void* CVariantMapBlockPool::Allocate(size_t blockClass, size_t size)
+{
+  if (blockClass < POOLED_CLASSES && !m_blocks[blockClass].empty())
+  {
+    void* block = m_blocks[blockClass].back();
+    m_blocks[blockClass].pop_back();
+    return block;
+  }
+
+  return ::operator new(size);
+}
+
+void CVariantMapBlockPool::Release(size_t blockClass, void* block)
+{
+  if (blockClass < POOLED_CLASSES && m_blocks[blockClass].size() < MAX_BLOCKS_PER_CLASS)
+  {
+    m_blocks[blockClass].push_back(block);
+    return;
+  }
+
+  ::operator delete(block);
+}
+
+void* AllocatePooledBlock(size_t blockClass, size_t size)
+{
+  if (blockPoolDestroyed)
+    return ::operator new(size);
+
+  return blockPool.Allocate(blockClass, size);
+}
+
+void ReleasePooledBlock(size_t blockClass, void* block)
+{
+  if (blockPoolDestroyed)
+  {
+    ::operator delete(block);
+    return;
+  }
+
+  try
+  {
+    blockPool.Release(blockClass, block);
+  }
+  catch (const std::bad_alloc&)
+  {
+    ::operator delete(block);
+  }
+}
+} // unnamed namespace
+
+struct alignas(CVariantMap::value_type) CVariantMap::Block
+{
+  Block* previous;
+  size_t blockClass;
+
+  // the members follow the header, which keeps them aligned
+  value_type* Members() { return reinterpret_cast<value_type*>(this + 1); }
+  static size_t Capacity(size_t blockClass) { return size_t{2} << blockClass; }
+};
+
+CVariantMap::CVariantMap(const CVariantMap& rhs)
+{
+  if (rhs.empty())
+    return;
+
+  AllocateBlock(rhs.size());
+  for (const value_type* rhsMember : rhs.m_order)
+  {
+    // the members of rhs are already sorted
+    value_type* member = AllocateMember();
+    try
+    {
+      new (member) value_type(*rhsMember);
+    }
+    catch (...)
+    {
+      ReleaseMember(member);
+      Destroy();
+      throw;
+    }
+    m_order.push_back(member);
+  }
+}
+
+CVariantMap::CVariantMap(CVariantMap&& rhs) noexcept
+  : m_order(std::move(rhs.m_order)),
+    m_lastBlock(std::exchange(rhs.m_lastBlock, nullptr)),
+    m_free(std::exchange(rhs.m_free, nullptr)),
+    m_capacity(std::exchange(rhs.m_capacity, 0)),
+    m_lastBlockUsed(std::exchange(rhs.m_lastBlockUsed, 0))
+{
+  rhs.m_order.clear();
+}
+
+CVariantMap::~CVariantMap()
+{
+  Destroy();
+}
+
+CVariantMap& CVariantMap::operator=(const CVariantMap& rhs)
+{
+  if (this != &rhs)
+    *this = CVariantMap(rhs);
+  return *this;
+}
+
+CVariantMap& CVariantMap::operator=(CVariantMap&& rhs) noexcept
+{
+  if (this == &rhs)
+    return *this;
+
+  Destroy();
+  m_order = std::move(rhs.m_order);
+  m_lastBlock = std::exchange(rhs.m_lastBlock, nullptr);
+  m_free = std::exchange(rhs.m_free, nullptr);
+  m_capacity = std::exchange(rhs.m_capacity, 0);
+  m_lastBlockUsed = std::exchange(rhs.m_lastBlockUsed, 0);
+  rhs.m_order.clear();
+  return *this;
+}
+
+bool CVariantMap::operator==(const CVariantMap& rhs) const
+{
+  return std::equal(begin(), end(), rhs.begin(), rhs.end());
+}
+
+void CVariantMap::clear()
+{
+  Destroy();
+}
+
+CVariantMap::iterator CVariantMap::find(std::string_view key)
+{
+  const auto position = LowerBound(key);
+  if (position == m_order.cend() || (*position)->first != key)
+    return end();
+
+  return iterator(&*position);
+}
+
+CVariantMap::const_iterator CVariantMap::find(std::string_view key) const
+{
+  const auto position = LowerBound(key);
+  if (position == m_order.cend() || (*position)->first != key)
+    return end();
+
+  return const_iterator(&*position);
+}
+
+CVariantMap::size_type CVariantMap::erase(std::string_view key)
+{
+  const auto position = LowerBound(key);
+  if (position == m_order.cend() || (*position)->first != key)
+    return 0;
+
+  value_type* member = *position;
+  m_order.erase(position);
+  member->~value_type();
+  ReleaseMember(member);
+  return 1;
+}
+
+std::vector<CVariantMap::value_type*>::const_iterator CVariantMap::LowerBound(
+    std::string_view key) const
+{
+  return std::lower_bound(m_order.cbegin(), m_order.cend(), key,
+                          [](const value_type* member, std::string_view key)
+                          { return std::string_view(member->first) < key; });
+}
+
+CVariantMap::value_type* CVariantMap::AllocateMember()
+{
+  if (m_free)
+  {
+    value_type* member = m_free;
+    m_free = *std::launder(reinterpret_cast<value_type**>(member));
+    return member;
+  }
+
+  if (!m_lastBlock || m_lastBlockUsed == Block::Capacity(m_lastBlock->blockClass))
+    AllocateBlock(1);
+
+  return m_lastBlock->Members() + m_lastBlockUsed++;
+}
+
+void CVariantMap::ReleaseMember(value_type* member)
+{
+  new (member) value_type*(m_free);
+  m_free = member;
+}
+
+void CVariantMap::AllocateBlock(size_t count)
+{
+  // every block is at least twice as large as the one before it
+  size_t blockClass = m_lastBlock ? m_lastBlock->blockClass + 1 : 0;
+  while (Block::Capacity(blockClass) < count)
+    ++blockClass;
+  const size_t capacity = Block::Capacity(blockClass);
+
+  // there's room in m_order for every member, so inserting a member doesn't throw
+  m_order.reserve(m_capacity + capacity);
+
+  void* memory = AllocatePooledBlock(blockClass, sizeof(Block) + sizeof(value_type) * capacity);
+  m_lastBlock = new (memory) Block{m_lastBlock, blockClass};
+  m_capacity += static_cast<uint32_t>(capacity);
+  m_lastBlockUsed = 0;
+}
+
+void CVariantMap::Destroy()
+{
+  for (value_type* member : m_order)
+    member->~value_type();
+  m_order.clear();
+
+  while (m_lastBlock)
+  {
+    Block* previous = m_lastBlock->previous;
+    ReleasePooledBlock(m_lastBlock->blockClass, m_lastBlock);
+    m_lastBlock = previous;
+  }
+
+  m_free = nullptr;
+  m_capacity = 0;
+  m_lastBlockUsed = 0;
+}
+
 CVariant::CVariant()
   : CVariant(VariantTypeNull)
 {
@@ -285,13 +551,17 @@ CVariant::CVariant(std::map<std::string, std::string>&& strMap)
 }
 
 CVariant::CVariant(const std::map<std::string, CVariant>& variantMap)
-  : m_data(std::in_place_type<VariantMap>, variantMap)
+  : m_data(std::in_place_type<VariantMap>, variantMap.begin(), variantMap.end())
 {
 }
 
 CVariant::CVariant(std::map<std::string, CVariant>&& variantMap)
-  : m_data(std::in_place_type<VariantMap>, std::move(variantMap))
 {
+  VariantMap tmpMap;
+  for (auto& elem : variantMap)
+    tmpMap.emplace(elem.first, std::move(elem.second));
+
+  m_data = std::move(tmpMap);
 }
 
 CVariant::CVariant(const CVariant& variant) : m_data(variant.m_data)
@@ -8,10 +8,15 @@
 
 #pragma once
 
+#include <cstddef>
+#include <iterator>
 #include <map>
+#include <new>
 #include <stdint.h>
 #include <string>
 #include <string_view>
+#include <tuple>
+#include <utility>
 #include <variant>
 #include <vector>
 #include <wchar.h>
@@ -28,6 +33,144 @@ double str2double(std::wstring_view, double fallback = 0.0);
 #pragma pack(8)
 #endif
 
+class CVariant;
+
+/*!
+ \brief Sorted map of the members of a CVariant object.
+
+ The members are stored in a few blocks of growing size (2, 4, 8, ... members) instead of one
+ allocation per member, and a vector of pointers to the members sorted by key is used for the
+ lookup. Members never move, so references to them stay valid until they are erased, like with
+ std::map. Released blocks are reused by the same thread.
+ */
+class CVariantMap
+{
+public:
+  using key_type = std::string;
+  using mapped_type = CVariant;
+  using value_type = std::pair<const std::string, CVariant>;
+  using size_type = std::size_t;
+
+  template<bool IsConst>
+  class Iterator
+  {
+  public:
+    using iterator_category = std::bidirectional_iterator_tag;
+    using value_type = CVariantMap::value_type;
+    using difference_type = std::ptrdiff_t;
+    using pointer = std::conditional_t<IsConst, const value_type*, value_type*>;
+    using reference = std::conditional_t<IsConst, const value_type&, value_type&>;
+
+    Iterator() = default;
+    explicit Iterator(value_type* const* position) : m_position(position) {}
+    template<bool WasConst, typename = std::enable_if_t<IsConst && !WasConst>>
+    Iterator(const Iterator<WasConst>& other) : m_position(other.m_position)
+    {
+    }
+
+    reference operator*() const { return **m_position; }
+    pointer operator->() const { return *m_position; }
+
+    Iterator& operator++()
+    {
+      ++m_position;
+      return *this;
+    }
+    Iterator operator++(int)
+    {
+      Iterator tmp = *this;
+      ++m_position;
+      return tmp;
+    }
+    Iterator& operator--()
+    {
+      --m_position;
+      return *this;
+    }
+    Iterator operator--(int)
+    {
+      Iterator tmp = *this;
+      --m_position;
+      return tmp;
+    }
+
+    bool operator==(const Iterator& rhs) const { return m_position == rhs.m_position; }
+    bool operator!=(const Iterator& rhs) const { return m_position != rhs.m_position; }
+
+  private:
+    template<bool>
+    friend class Iterator;
+
+    value_type* const* m_position = nullptr;
+  };
+
+  using iterator = Iterator<false>;
+  using const_iterator = Iterator<true>;
+
+  CVariantMap() = default;
+  template<typename InputIt>
+  CVariantMap(InputIt first, InputIt last)
+  {
+    for (; first != last; ++first)
+      emplace(first->first, first->second);
+  }
+  CVariantMap(const CVariantMap& rhs);
+  CVariantMap(CVariantMap&& rhs) noexcept;
+  ~CVariantMap();
+
+  CVariantMap& operator=(const CVariantMap& rhs);
+  CVariantMap& operator=(CVariantMap&& rhs) noexcept;
+  bool operator==(const CVariantMap& rhs) const;
+
+  iterator begin() { return iterator(m_order.data()); }
+  const_iterator begin() const { return const_iterator(m_order.data()); }
+  const_iterator cbegin() const { return begin(); }
+  iterator end() { return iterator(m_order.data() + m_order.size()); }
+  const_iterator end() const { return const_iterator(m_order.data() + m_order.size()); }
+  const_iterator cend() const { return end(); }
+
+  size_type size() const { return m_order.size(); }
+  bool empty() const { return m_order.empty(); }
+  void clear();
+
+  iterator find(std::string_view key);
+  const_iterator find(std::string_view key) const;
+  bool contains(std::string_view key) const { return find(key) != end(); }
+  size_type erase(std::string_view key);
+
+  /*!
+   \brief Inserts a member with the given value unless one with the key already exists.
+   \return The member with the key and whether it was inserted.
+   */
+  template<typename... Args>
+  std::pair<iterator, bool> emplace(std::string_view key, Args&&... args);
+
+  CVariant& operator[](std::string_view key);
+
+private:
+  struct Block;
+
+  //! Returns the position in m_order where the key is or would be inserted.
+  std::vector<value_type*>::const_iterator LowerBound(std::string_view key) const;
+  //! Returns unused member storage, allocating a new block if needed.
+  value_type* AllocateMember();
+  void ReleaseMember(value_type* member);
+  //! Allocates a block with at least the given number of members.
+  void AllocateBlock(size_t count);
+  void Destroy();
+
+  //! members sorted by key
+  std::vector<value_type*> m_order;
+  //! last allocated block, which links to the ones allocated before it
+  Block* m_lastBlock = nullptr;
+  //! first erased member storage to reuse, the next one is stored in it
+  value_type* m_free = nullptr;
+  //! number of members all blocks can hold
+  uint32_t m_capacity = 0;
+  //! number of members used in the last block
+  uint32_t m_lastBlockUsed = 0;
+};
+
 class CVariant
 {
 public:
@@ -124,7 +267,7 @@ public:
 
 private:
   typedef std::vector<CVariant> VariantArray;
-  typedef std::map<std::string, CVariant> VariantMap;
+  typedef CVariantMap VariantMap;
 
 public:
   typedef VariantArray::iterator        iterator_array;
@@ -182,6 +325,37 @@ private:
   static VariantMap EMPTY_MAP;
 };
 
+inline CVariant& CVariantMap::operator[](std::string_view key)
+{
+  return emplace(key).first->second;
+}
+
+template<typename... Args>
+std::pair<CVariantMap::iterator, bool> CVariantMap::emplace(std::string_view key, Args&&... args)
+{
+  auto position = LowerBound(key);
+  if (position != m_order.cend() && (*position)->first == key)
+    return {iterator(&*position), false};
+
+  // AllocateMember() may reserve more space in m_order
+  const auto offset = position - m_order.cbegin();
+  value_type* member = AllocateMember();
+  try
+  {
+    new (member) value_type(std::piecewise_construct, std::forward_as_tuple(key),
+                            std::forward_as_tuple(std::forward<Args>(args)...));
+  }
+  catch (...)
+  {
+    ReleaseMember(member);
+    throw;
+  }
+
+  // AllocateMember() reserved the space for it
+  position = m_order.insert(m_order.cbegin() + offset, member);
+  return {iterator(&*position), true};
+}
+
 #ifdef TARGET_WINDOWS_STORE
 #pragma pack(pop)
 #endif
@@ -0,0 +1,285 @@
+/*
+ *  Copyright (C) 2026 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "XMLStreamReader.h"
+
+#include "URL.h"
+#include "utils/StringUtils.h"
+#include "utils/XBMCTinyXML.h"
+#include "utils/log.h"
+
+#include <string_view>
+
+namespace
+{
+constexpr size_t READ_CHUNK_SIZE = 64 * 1024;
+// length of the longest token prefix we need to look at to tell the kind of token ("<![CDATA[")
+constexpr size_t TOKEN_LOOKAHEAD = 9;
+} // unnamed namespace
+
+bool CXMLStreamReader::Open(const std::string& file)
+{
+  Close();
+
+  if (!m_file.Open(file))
+  {
+    CLog::Log(LOGERROR, "CXMLStreamReader: unable to open {}", CURL::GetRedacted(file));
+    return false;
+  }
+
+  const int64_t length = m_file.GetLength();
+  m_length = length > 0 ? static_cast<uint64_t>(length) : 0;
+
+  // read up to and including the start tag of the root element
+  while (true)
+  {
+    const size_t start = m_buffer.find('<', m_pos);
+    if (start == std::string::npos)
+    {
+      m_pos = m_buffer.size();
+      if (!FillBuffer())
+        break;
+      continue;
+    }
+
+    m_pos = start;
+    TokenType type;
+    size_t end = ScanToken(m_pos, type);
+    if (end == std::string::npos)
+    {
+      if (FillBuffer())
+        continue;
+      end = ScanToken(m_pos, type);
+      if (end == std::string::npos)
+        break;
+    }
+
+    if (type == TokenType::DECLARATION)
+      ParseDeclaration(m_pos, end);
+    else if (type == TokenType::START_TAG || type == TokenType::EMPTY_TAG)
+    {
+      m_rootName = GetTagName(m_pos);
+      m_depth = type == TokenType::START_TAG ? 1 : 0;
+      m_pos = end;
+      return true;
+    }
+    else if (type == TokenType::END_TAG)
+      break;
+
+    m_pos = end;
+  }
+
+  CLog::Log(LOGERROR, "CXMLStreamReader: no root element found in {}", CURL::GetRedacted(file));
+  m_error = true;
+  return false;
+}
+
+void CXMLStreamReader::Close()
+{
+  m_file.Close();
+  m_buffer.clear();
+  m_pos = 0;
+  m_elementStart = std::string::npos;
+  m_consumed = 0;
+  m_length = 0;
+  m_depth = 0;
+  m_eof = false;
+  m_error = false;
+  m_rootName.clear();
+  m_charset.clear();
+}
+
+bool CXMLStreamReader::ReadNextElement(CXBMCTinyXML& element, std::string_view name /* = {} */)
+{
+  while (m_depth > 0)
+  {
+    const size_t start = m_buffer.find('<', m_pos);
+    if (start == std::string::npos)
+    {
+      m_pos = m_buffer.size();
+      if (!FillBuffer())
+        break;
+      continue;
+    }
+
+    m_pos = start;
+    TokenType type;
+    size_t end = ScanToken(m_pos, type);
+    if (end == std::string::npos)
+    {
+      if (FillBuffer())
+        continue;
+      end = ScanToken(m_pos, type);
+      if (end == std::string::npos)
+        break;
+    }
+    // the buffer may have been shifted while reading more data
+    const size_t tokenStart = m_pos;
+    m_pos = end;
+
+    if (type == TokenType::START_TAG)
+    {
+      if (m_depth == 1)
+        m_elementStart = tokenStart;
+      m_depth++;
+      continue;
+    }
+    else if (type == TokenType::EMPTY_TAG)
+    {
+      if (m_depth != 1)
+        continue;
+      m_elementStart = tokenStart;
+    }
+    else if (type == TokenType::END_TAG)
+    {
+      m_depth--;
+      if (m_depth == 0)
+        return false; // end of the root element
+      if (m_depth != 1 || m_elementStart == std::string::npos)
+        continue;
+    }
+    else
+      continue;
+
+    // got a complete child element of the root element
+    if (!name.empty() && GetTagName(m_elementStart) != name)
+    {
+      m_elementStart = std::string::npos;
+      continue;
+    }
+
+    const std::string data = m_buffer.substr(m_elementStart, end - m_elementStart);
+    m_elementStart = std::string::npos;
+
+    element.Clear();
+    const bool parsed = m_charset.empty() || StringUtils::EqualsNoCase(m_charset, "UTF-8")
+                            ? element.Parse(data, TIXML_ENCODING_UTF8)
+                            : element.Parse(data, m_charset);
+    if (!parsed || !element.RootElement())
+    {
+      CLog::Log(LOGERROR, "CXMLStreamReader: failed to parse element at offset {}: {}",
+                GetPosition() - data.size(), element.ErrorDesc());
+      m_error = true;
+      return false;
+    }
+    return true;
+  }
+
+  if (m_depth > 0)
+  {
+    CLog::Log(LOGERROR, "CXMLStreamReader: unexpected end of document in <{}>", m_rootName);
+    m_error = true;
+    m_depth = 0;
+  }
+  return false;
+}
+
+bool CXMLStreamReader::FillBuffer()
+{
+  if (m_eof)
+    return false;
+
+  // drop everything that has been processed and isn't part of the current element
+  const size_t processed = m_elementStart != std::string::npos ? m_elementStart : m_pos;
+  if (processed > 0)
+  {
+    m_buffer.erase(0, processed);
+    m_consumed += processed;
+    m_pos -= processed;
+    if (m_elementStart != std::string::npos)
+      m_elementStart = 0;
+  }
+
+  const size_t size = m_buffer.size();
+  m_buffer.resize(size + READ_CHUNK_SIZE);
+  const ssize_t read = m_file.Read(m_buffer.data() + size, READ_CHUNK_SIZE);
+  if (read <= 0)
+  {
+    m_buffer.resize(size);
+    m_eof = true;
+    return false;
+  }
+
+  m_buffer.resize(size + static_cast<size_t>(read));
+  return true;
+}
+
+size_t CXMLStreamReader::ScanToken(size_t pos, TokenType& type) const
+{
+  const std::string_view data{m_buffer};
+  if (data.size() - pos < TOKEN_LOOKAHEAD && !m_eof)
+    return std::string::npos;
+
+  const auto findEnd = [&data](size_t from, std::string_view terminator)
+  {
+    const size_t end = data.find(terminator, from);
+    return end == std::string_view::npos ? std::string::npos : end + terminator.size();
+  };
+
+  const std::string_view token{data.substr(pos)};
+  type = TokenType::OTHER;
+  if (token.starts_with("<!--"))
+    return findEnd(pos + 4, "-->");
+  if (token.starts_with("<![CDATA["))
+    return findEnd(pos + 9, "]]>");
+  if (token.starts_with("<?"))
+  {
+    if (token.starts_with("<?xml"))
+      type = TokenType::DECLARATION;
+    return findEnd(pos + 2, "?>");
+  }
+  if (token.starts_with("<!"))
+    return findEnd(pos + 2, ">");
+  if (token.starts_with("</"))
+  {
+    type = TokenType::END_TAG;
+    return findEnd(pos + 2, ">");
+  }
+
+  // start tag, attribute values may contain '>'
+  char quote = 0;
+  for (size_t i = pos + 1; i < data.size(); ++i)
+  {
+    const char c = data[i];
+    if (quote)
+    {
+      if (c == quote)
+        quote = 0;
+    }
+    else if (c == '"' || c == '\'')
+      quote = c;
+    else if (c == '>')
+    {
+      type = data[i - 1] == '/' ? TokenType::EMPTY_TAG : TokenType::START_TAG;
+      return i + 1;
+    }
+  }
+  return std::string::npos;
+}
+
+std::string CXMLStreamReader::GetTagName(size_t pos) const
+{
+  const size_t end = m_buffer.find_first_of(" \t\r\n/>", pos + 1);
+  return m_buffer.substr(pos + 1, end == std::string::npos ? end : end - pos - 1);
+}
+
+void CXMLStreamReader::ParseDeclaration(size_t pos, size_t end)
+{
+  const std::string_view declaration{std::string_view{m_buffer}.substr(pos, end - pos)};
+  const size_t encoding = declaration.find("encoding");
+  if (encoding == std::string_view::npos)
+    return;
+
+  const size_t start = declaration.find_first_of("\"'", encoding);
+  if (start == std::string_view::npos)
+    return;
+
+  const size_t stop = declaration.find(declaration[start], start + 1);
+  if (stop != std::string_view::npos)
+    m_charset = declaration.substr(start + 1, stop - start - 1);
+}
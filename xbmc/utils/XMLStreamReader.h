@@ -0,0 +1,95 @@
+/*
+ *  Copyright (C) 2026 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "filesystem/File.h"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+class CXBMCTinyXML;
+
+/*!
+ \brief Incremental reader for large XML documents such as library exports.
+
+ Instead of loading the whole document into a DOM, the file is read in chunks and each child
+ element of the root element is parsed on its own. Only a single child element (including its
+ descendants) is held in memory at any time.
+
+ \code
+ CXMLStreamReader reader;
+ if (reader.Open(file))
+ {
+   CXBMCTinyXML element;
+   while (reader.ReadNextElement(element))
+     Process(element.RootElement());
+ }
+ \endcode
+ */
+class CXMLStreamReader
+{
+public:
+  CXMLStreamReader() = default;
+
+  /*! \brief Open a file and read up to the start of its root element.
+   \param file the file to read.
+   \return true if the root element was found, false otherwise.
+   */
+  bool Open(const std::string& file);
+
+  void Close();
+
+  /*! \brief Read and parse the next child element of the root element.
+   \param element the document the child element is parsed into, its root element is the child.
+   \param name if not empty, child elements with a different name are skipped without parsing them.
+   \return true if a child element was read, false at the end of the root element or on error.
+   \sa HasError
+   */
+  bool ReadNextElement(CXBMCTinyXML& element, std::string_view name = {});
+
+  /*! \brief Whether reading failed because of a truncated or malformed document. */
+  bool HasError() const { return m_error; }
+
+  /*! \brief Name of the root element, available after Open(). */
+  const std::string& GetRootName() const { return m_rootName; }
+
+  /*! \brief Number of bytes of the file that have been processed. */
+  uint64_t GetPosition() const { return m_consumed + m_pos; }
+
+  /*! \brief Size of the file in bytes, 0 if unknown. */
+  uint64_t GetLength() const { return m_length; }
+
+private:
+  enum class TokenType
+  {
+    START_TAG,
+    END_TAG,
+    EMPTY_TAG,
+    DECLARATION,
+    OTHER
+  };
+
+  bool FillBuffer();
+  size_t ScanToken(size_t pos, TokenType& type) const;
+  std::string GetTagName(size_t pos) const;
+  void ParseDeclaration(size_t pos, size_t end);
+
+  XFILE::CFile m_file;
+  std::string m_buffer;
+  size_t m_pos{0};
+  size_t m_elementStart{std::string::npos};
+  uint64_t m_consumed{0};
+  uint64_t m_length{0};
+  int m_depth{0};
+  bool m_eof{false};
+  bool m_error{false};
+  std::string m_rootName;
+  std::string m_charset;
+};
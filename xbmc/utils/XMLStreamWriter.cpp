@@ -0,0 +1,97 @@
+/*
+ *  Copyright (C) 2026 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "XMLStreamWriter.h"
+
+#include "URL.h"
+#include "utils/XBMCTinyXML.h"
+#include "utils/log.h"
+
+CXMLStreamWriter::~CXMLStreamWriter()
+{
+  if (m_open)
+    Abort();
+}
+
+bool CXMLStreamWriter::Open(const std::string& file, const std::string& rootName)
+{
+  if (m_open)
+    Close();
+
+  m_bytesWritten = 0;
+  m_error = false;
+  if (!m_file.OpenForWrite(file, true))
+  {
+    CLog::Log(LOGERROR, "CXMLStreamWriter: unable to create {}", CURL::GetRedacted(file));
+    return false;
+  }
+
+  m_open = true;
+  m_fileName = file;
+  m_rootName = rootName;
+
+  const std::string header{"<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\" ?>\n<" +
+                           m_rootName + ">\n"};
+  return Write(header.c_str(), header.size());
+}
+
+bool CXMLStreamWriter::Flush(TiXmlNode& node)
+{
+  for (const TiXmlNode* child = node.FirstChild(); child; child = child->NextSibling())
+  {
+    TiXmlPrinter printer;
+    child->Accept(&printer);
+    Write(printer.CStr(), printer.Size());
+  }
+  node.Clear();
+
+  return !m_error;
+}
+
+bool CXMLStreamWriter::Close()
+{
+  if (!m_open)
+    return false;
+
+  const std::string footer{"</" + m_rootName + ">\n"};
+  Write(footer.c_str(), footer.size());
+  m_file.Flush();
+  m_file.Close();
+  m_open = false;
+
+  return !m_error;
+}
+
+void CXMLStreamWriter::Abort()
+{
+  if (!m_open)
+    return;
+
+  m_file.Close();
+  m_open = false;
+
+  if (!XFILE::CFile::Delete(m_fileName))
+    CLog::Log(LOGWARNING, "CXMLStreamWriter: unable to delete incomplete {}",
+              CURL::GetRedacted(m_fileName));
+}
+
+bool CXMLStreamWriter::Write(const char* data, size_t size)
+{
+  if (!m_open || m_error)
+    return false;
+
+  if (m_file.Write(data, size) != static_cast<ssize_t>(size))
+  {
+    CLog::Log(LOGERROR, "CXMLStreamWriter: failed to write {} bytes", size);
+    m_error = true;
+    return false;
+  }
+
+  m_bytesWritten += size;
+  return true;
+}
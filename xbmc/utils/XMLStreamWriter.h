@@ -0,0 +1,84 @@
+/*
+ *  Copyright (C) 2026 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "filesystem/File.h"
+
+#include <cstdint>
+#include <string>
+
+class TiXmlNode;
+
+/*!
+ \brief Incremental writer for large XML documents such as library exports.
+
+ Writes the XML declaration and the start tag of the root element when opened. The children of
+ the root element are then built in a small scratch DOM node and written out with Flush(), which
+ removes them from the node again, so the whole document never has to be kept in memory.
+
+ \code
+ CXMLStreamWriter writer;
+ TiXmlElement root("videodb");
+ if (writer.Open(file, root.ValueStr()))
+ {
+   for (const auto& item : items)
+   {
+     item.Save(&root);
+     writer.Flush(root);
+   }
+   writer.Close();
+ }
+ \endcode
+
+ A document which hasn't been closed, e.g. because the export was cancelled or failed, is aborted
+ when the writer is destroyed so that no truncated but well-formed file is left behind.
+ */
+class CXMLStreamWriter
+{
+public:
+  CXMLStreamWriter() = default;
+  ~CXMLStreamWriter();
+
+  /*! \brief Create the file and write the XML declaration and the root start tag.
+   \param file the file to write, an existing file is overwritten.
+   \param rootName the name of the root element.
+   \return true on success, false otherwise.
+   */
+  bool Open(const std::string& file, const std::string& rootName);
+
+  /*! \brief Write all children of the given node and remove them from it.
+   \param node the scratch node holding the children of the root element to write.
+   \return true on success, false if writing failed.
+   */
+  bool Flush(TiXmlNode& node);
+
+  /*! \brief Write the root end tag and close the file.
+   \return true if the whole document has been written successfully, false otherwise.
+   */
+  bool Close();
+
+  /*! \brief Close the file without writing the root end tag and delete it.
+   */
+  void Abort();
+
+  bool IsOpen() const { return m_open; }
+
+  /*! \brief Number of bytes written to the file so far. */
+  uint64_t GetBytesWritten() const { return m_bytesWritten; }
+
+private:
+  bool Write(const char* data, size_t size);
+
+  XFILE::CFile m_file;
+  std::string m_fileName;
+  std::string m_rootName;
+  uint64_t m_bytesWritten{0};
+  bool m_open{false};
+  bool m_error{false};
+};
@@ -19,10 +19,14 @@
 #include "settings/SettingsContainer.h"
 #include "settings/lib/Setting.h"
 #include "settings/lib/SettingsManager.h"
+#include "utils/AsyncLogSink.h"
+#include "utils/BinaryLogSink.h"
 #include "utils/Map.h"
 #include "utils/StringUtils.h"
 #include "utils/URIUtils.h"
 
+#include <bit>
+#include <chrono>
 #include <cstring>
 #include <set>
 
@@ -34,6 +38,7 @@ namespace
 {
 constexpr unsigned char Utf8Bom[3] = {0xEF, 0xBB, 0xBF};
 const std::string LogFileExtension = ".log";
+const std::string BinaryLogFileExtension = ".binlog";
 const std::string LogPattern = "%Y-%m-%d %T.%e T:%-5t %7l <%n>: %v";
 
 struct ComponentInfo
@@ -91,6 +96,7 @@ CLog::CLog()
 {
   // add platform-specific debug sinks
   m_platform->AddSinks(m_sinks);
+  m_hasPlatformSinks = !m_sinks->sinks().empty();
 
   // register the default logger with spdlog
   spdlog::set_default_logger(m_defaultLogger);
@@ -153,6 +159,7 @@ void CLog::Initialize(const std::string& path)
   const std::string filePathBase = URIUtils::AddFileToFolder(path, appName);
   const std::string filePath = filePathBase + LogFileExtension;
   const std::string oldFilePath = filePathBase + ".old" + LogFileExtension;
+  m_filePathBase = filePathBase;
 
   // handle old.log by deleting an existing old.log and renaming the last log to old.log
   XFILE::CFile::Delete(oldFilePath);
@@ -175,7 +182,12 @@ void CLog::Initialize(const std::string& path)
   m_fileSink = duplicateFilterSink;
 
   // add it to the existing sinks
-  m_sinks->add_sink(m_fileSink);
+  std::unique_lock lock(m_fileSinkMutex);
+  if (m_textFile)
+    AddFileSink();
+  if (m_binaryFile)
+    AddBinarySink();
+  UpdateTextLogging();
 }
 
 void CLog::UnregisterFromSettings()
@@ -193,15 +205,147 @@ void CLog::Deinitialize()
   if (m_fileSink == nullptr)
     return;
 
+  if (const Stats stats = GetStats(); stats.dropped > 0 || stats.rateLimited > 0)
+    Log(LOGINFO, "Log messages dropped: {} by a full queue, {} by the rate limit", stats.dropped,
+        stats.rateLimited);
+
   // flush all loggers
   spdlog::apply_all([](const std::shared_ptr<spdlog::logger>& logger) { logger->flush(); });
 
-  // flush the file sink
-  m_fileSink->flush();
+  // remove the file sink, which writes out anything still queued
+  std::unique_lock lock(m_fileSinkMutex);
+  if (m_textFile)
+    RemoveFileSink();
+  if (m_binarySink)
+    RemoveBinarySink();
 
-  // remove and destroy the file sink
-  m_sinks->remove_sink(m_fileSink);
+  // flush and destroy the file sink
+  m_fileSink->flush();
   m_fileSink.reset();
+  m_filePathBase.clear();
+  UpdateTextLogging();
+}
+
+void CLog::SetAsyncLogging(bool enabled, size_t queueSize, LogOverflowPolicy policy)
+{
+  std::unique_lock lock(m_fileSinkMutex);
+  if (enabled == m_asyncLogging &&
+      (!enabled || (queueSize == m_asyncQueueSize && policy == m_asyncOverflowPolicy)))
+    return;
+
+  const bool attached = m_fileSink != nullptr && m_textFile;
+  if (attached)
+    RemoveFileSink();
+
+  m_asyncLogging = enabled;
+  m_asyncQueueSize = queueSize;
+  m_asyncOverflowPolicy = policy;
+
+  if (attached)
+    AddFileSink();
+}
+
+void CLog::SetLogFileFormats(bool text, bool binary)
+{
+  std::unique_lock lock(m_fileSinkMutex);
+  if (text != m_textFile)
+  {
+    m_textFile = text;
+    if (m_fileSink != nullptr)
+    {
+      if (text)
+        AddFileSink();
+      else
+        RemoveFileSink();
+    }
+  }
+
+  if (binary != m_binaryFile)
+  {
+    m_binaryFile = binary;
+    if (m_fileSink != nullptr)
+    {
+      if (binary)
+        AddBinarySink();
+      else
+        RemoveBinarySink();
+    }
+  }
+
+  UpdateTextLogging();
+}
+
+CLog::Stats CLog::GetStats() const
+{
+  Stats stats;
+  {
+    std::unique_lock lock(m_fileSinkMutex);
+    stats.dropped = m_asyncDropped + (m_asyncSink ? m_asyncSink->GetDroppedCount() : 0);
+  }
+  stats.rateLimited = m_rateLimited;
+  return stats;
+}
+
+void CLog::AddFileSink()
+{
+  if (m_asyncLogging)
+  {
+    m_asyncSink =
+        std::make_shared<CAsyncLogSink>(m_fileSink, m_asyncQueueSize, m_asyncOverflowPolicy);
+    m_sinks->add_sink(m_asyncSink);
+  }
+  else
+    m_sinks->add_sink(m_fileSink);
+}
+
+void CLog::RemoveFileSink()
+{
+  if (m_asyncSink)
+  {
+    m_sinks->remove_sink(m_asyncSink);
+    m_asyncDropped += m_asyncSink->GetDroppedCount();
+    // writes the queued messages
+    m_asyncSink.reset();
+  }
+  else
+    m_sinks->remove_sink(m_fileSink);
+}
+
+void CLog::AddBinarySink()
+{
+  const std::string filePath = m_filePathBase + BinaryLogFileExtension;
+  const std::string oldFilePath = m_filePathBase + ".old" + BinaryLogFileExtension;
+
+  // keep the previous binary log, like the text log
+  XFILE::CFile::Delete(oldFilePath);
+  XFILE::CFile::Rename(filePath, oldFilePath);
+
+  try
+  {
+    m_binarySink = std::make_shared<CBinaryLogSink>(m_platform->GetLogFilename(filePath));
+  }
+  catch (const spdlog::spdlog_ex& ex)
+  {
+    m_defaultLogger->error("Unable to create binary log {}: {}", filePath, ex.what());
+    return;
+  }
+
+  m_sinks->add_sink(m_binarySink);
+  m_binaryLogging = true;
+}
+
+void CLog::RemoveBinarySink()
+{
+  m_binaryLogging = false;
+  m_sinks->remove_sink(m_binarySink);
+  m_binarySink.reset();
+}
+
+void CLog::UpdateTextLogging()
+{
+  // without a text sink formatting the messages is wasted work
+  m_textLogging = m_binarySink == nullptr || m_hasPlatformSinks ||
+                  (m_fileSink != nullptr && m_textFile);
 }
 
 void CLog::SetLogLevel(int level)
@@ -316,9 +460,10 @@ void CLog::FormatAndLogInternal(spdlog::level::level_enum level,
   if (level < m_defaultLogger->level())
     return;
 
-  auto message = fmt::vformat(format, args);
-  FormatLineBreaks(message);
-  GetLoggerById(component)->log(level, message);
+  if (component != LOG_COMPONENT_GENERAL && !IsWithinRateLimit(component))
+    return;
+
+  LogMessage(GetLoggerById(component), level, format, args);
 }
 
 void CLog::FormatAndLogInternal(const std::string& loggerName,
@@ -329,9 +474,32 @@ void CLog::FormatAndLogInternal(const std::string& loggerName,
   if (level < m_defaultLogger->level())
     return;
 
-  auto message = fmt::vformat(format, args);
-  FormatLineBreaks(message);
-  GetLogger(loggerName)->log(level, message);
+  LogMessage(GetLogger(loggerName), level, format, args);
+}
+
+void CLog::LogMessage(const Logger& logger,
+                      spdlog::level::level_enum level,
+                      fmt::string_view format,
+                      fmt::format_args args)
+{
+  if (!m_binaryLogging)
+  {
+    auto message = fmt::vformat(format, args);
+    FormatLineBreaks(message);
+    logger->log(level, message);
+    return;
+  }
+
+  // the binary sink stores the format and arguments instead of the message
+  const CBinaryLogSink::CStructuredMessage structured(format, args);
+  if (m_textLogging)
+  {
+    auto message = fmt::vformat(format, args);
+    FormatLineBreaks(message);
+    logger->log(level, message);
+  }
+  else
+    logger->log(level, std::string_view());
 }
 
 Logger CLog::CreateLogger(const std::string& loggerName)
@@ -357,6 +525,33 @@ void CLog::SetComponentLogLevel(const std::vector<CVariant>& components)
   }
 }
 
+bool CLog::IsWithinRateLimit(uint32_t component)
+{
+  const uint32_t limit = m_componentRateLimit;
+  if (limit == 0)
+    return true;
+
+  // approximate under contention, which is good enough to keep a chatty component in check
+  ComponentRate& rate = m_componentRates[std::countr_zero(component) & 31];
+  const int64_t now = std::chrono::duration_cast<std::chrono::seconds>(
+                          std::chrono::steady_clock::now().time_since_epoch())
+                          .count();
+  int64_t second = rate.second;
+  if (second != now && rate.second.compare_exchange_strong(second, now))
+  {
+    rate.count = 0;
+    if (const uint32_t suppressed = rate.suppressed.exchange(0); suppressed > 0)
+      GetLoggerById(component)->warn("{} messages dropped by the rate limit", suppressed);
+  }
+
+  if (++rate.count <= limit)
+    return true;
+
+  ++rate.suppressed;
+  ++m_rateLimited;
+  return false;
+}
+
 void CLog::FormatLineBreaks(std::string& message) const
 {
   // fixup newline alignment, number of spaces should equal prefix length
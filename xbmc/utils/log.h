@@ -30,6 +30,9 @@
 #include "utils/IPlatformLog.h"
 #include "utils/logtypes.h"
 
+#include <array>
+#include <atomic>
+#include <mutex>
 #include <source_location>
 #include <string>
 #include <vector>
@@ -44,6 +47,8 @@ template<typename Mutex>
 class dist_sink;
 } // namespace spdlog::sinks
 
+class CAsyncLogSink;
+
 #if FMT_VERSION >= 100000
 using fmt::enums::format_as;
 
@@ -80,6 +85,41 @@ public:
   bool IsLogLevelLogged(int loglevel) const;
 
   bool CanLogComponent(uint32_t component) const;
+
+  /*!
+   \brief Write the log file from a background thread.
+   Logging threads then only queue their messages and never wait for file I/O, at the cost of
+   losing the messages still queued on a crash.
+   \param enabled true to write the log file asynchronously, false to write it directly.
+   \param queueSize the maximum number of queued messages.
+   \param policy what to do with messages logged while the queue is full.
+   */
+  void SetAsyncLogging(bool enabled, size_t queueSize, LogOverflowPolicy policy);
+
+  /*!
+   \brief Choose the formats the log file is written in.
+   The binary log (kodi.binlog) stores format strings and arguments instead of formatted text,
+   which makes it smaller and saves formatting the messages when no text is written at all. It's
+   decoded with tools/binlog/binlog.py.
+   \param text true to write the text log.
+   \param binary true to write the binary log.
+   \sa CBinaryLogSink
+   */
+  void SetLogFileFormats(bool text, bool binary);
+
+  /*!
+   \brief Limit the number of messages per second every log component may log.
+   Messages over the limit are dropped, their number is logged at the start of the next second.
+   \param messagesPerSecond the limit, 0 for no limit.
+   */
+  void SetComponentRateLimit(uint32_t messagesPerSecond) { m_componentRateLimit = messagesPerSecond; }
+
+  struct Stats
+  {
+    uint64_t dropped{0}; ///< messages dropped because the queue of the asynchronous log was full
+    uint64_t rateLimited{0}; ///< component messages dropped by the rate limit
+  };
+  Stats GetStats() const;
   static void SettingOptionsLoggingComponentsFiller(const std::shared_ptr<const CSetting>& setting,
                                                     std::vector<IntegerSettingOption>& list,
                                                     int& current);
@@ -158,6 +198,11 @@ private:
                             fmt::string_view format,
                             fmt::format_args args);
 
+  void LogMessage(const Logger& logger,
+                  spdlog::level::level_enum level,
+                  fmt::string_view format,
+                  fmt::format_args args);
+
   Logger CreateLogger(const std::string& loggerName);
 
   Logger GetLoggerById(uint32_t component);
@@ -166,14 +211,48 @@ private:
 
   void FormatLineBreaks(std::string& message) const;
 
+  bool IsWithinRateLimit(uint32_t component);
+
+  void AddFileSink();
+  void RemoveFileSink();
+  void AddBinarySink();
+  void RemoveBinarySink();
+  void UpdateTextLogging();
+
   std::unique_ptr<IPlatformLog> m_platform;
   std::shared_ptr<spdlog::sinks::dist_sink<std::mutex>> m_sinks;
   Logger m_defaultLogger;
 
   std::shared_ptr<spdlog::sinks::sink> m_fileSink;
+  std::string m_filePathBase;
+  bool m_hasPlatformSinks{false};
+
+  mutable std::mutex m_fileSinkMutex;
+  std::shared_ptr<CAsyncLogSink> m_asyncSink; ///< wraps m_fileSink when logging asynchronously
+  bool m_asyncLogging{false};
+  size_t m_asyncQueueSize{8192};
+  LogOverflowPolicy m_asyncOverflowPolicy{LogOverflowPolicy::DROP};
+  uint64_t m_asyncDropped{0}; ///< dropped by previous asynchronous sinks
+
+  bool m_textFile{true};
+  bool m_binaryFile{false};
+  std::shared_ptr<spdlog::sinks::sink> m_binarySink;
+  std::atomic_bool m_binaryLogging{false}; ///< m_binarySink is attached
+  std::atomic_bool m_textLogging{true}; ///< any attached sink needs the formatted message
 
   int m_logLevel{LOG_LEVEL_DEBUG};
 
   bool m_componentLogEnabled{false};
   uint32_t m_componentLogLevels{0};
+
+  struct ComponentRate
+  {
+    std::atomic<int64_t> second{0};
+    std::atomic<uint32_t> count{0};
+    std::atomic<uint32_t> suppressed{0};
+  };
+  // one per component bit
+  std::array<ComponentRate, 32> m_componentRates;
+  std::atomic<uint32_t> m_componentRateLimit{0};
+  std::atomic<uint64_t> m_rateLimited{0};
 };
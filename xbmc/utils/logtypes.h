@@ -16,3 +16,12 @@ class logger;
 }
 
 using Logger = std::shared_ptr<spdlog::logger>;
+
+/*!
+ \brief What to do with messages logged while the queue of the asynchronous log is full.
+ */
+enum class LogOverflowPolicy
+{
+  DROP, ///< Drop the message and count it
+  BLOCK, ///< Wait until the writer thread made room
+};
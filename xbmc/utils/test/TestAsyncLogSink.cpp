@@ -0,0 +1,97 @@
+/*
+ *  Copyright (C) 2026 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "utils/AsyncLogSink.h"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <spdlog/details/log_msg.h>
+#include <spdlog/sinks/base_sink.h>
+
+namespace
+{
+class CCollectingSink : public spdlog::sinks::base_sink<std::mutex>
+{
+public:
+  std::vector<std::string> messages;
+  std::atomic_bool blocked{false};
+
+protected:
+  void sink_it_(const spdlog::details::log_msg& msg) override
+  {
+    while (blocked)
+      std::this_thread::yield();
+    messages.emplace_back(msg.payload.data(), msg.payload.size());
+  }
+  void flush_() override {}
+};
+
+void Log(CAsyncLogSink& sink, const std::string& text)
+{
+  sink.log(spdlog::details::log_msg("test", spdlog::level::info, text));
+}
+} // unnamed namespace
+
+TEST(TestAsyncLogSink, WritesInOrder)
+{
+  auto collector = std::make_shared<CCollectingSink>();
+  {
+    CAsyncLogSink sink(collector, 16, LogOverflowPolicy::BLOCK);
+    for (int i = 0; i < 1000; ++i)
+      Log(sink, std::to_string(i));
+  }
+
+  ASSERT_EQ(1000u, collector->messages.size());
+  for (int i = 0; i < 1000; ++i)
+    EXPECT_EQ(std::to_string(i), collector->messages[i]);
+}
+
+TEST(TestAsyncLogSink, BlockKeepsAllMessages)
+{
+  auto collector = std::make_shared<CCollectingSink>();
+  {
+    CAsyncLogSink sink(collector, 8, LogOverflowPolicy::BLOCK);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t)
+      threads.emplace_back(
+          [&sink]
+          {
+            for (int i = 0; i < 500; ++i)
+              Log(sink, "message");
+          });
+    for (auto& thread : threads)
+      thread.join();
+    EXPECT_EQ(0u, sink.GetDroppedCount());
+  }
+
+  EXPECT_EQ(2000u, collector->messages.size());
+}
+
+TEST(TestAsyncLogSink, DropCountsAndReports)
+{
+  auto collector = std::make_shared<CCollectingSink>();
+  collector->blocked = true;
+  {
+    CAsyncLogSink sink(collector, 4, LogOverflowPolicy::DROP);
+    // the writer takes at most one message out of the queue while blocked
+    for (int i = 0; i < 10; ++i)
+      Log(sink, "message");
+    EXPECT_GE(sink.GetDroppedCount(), 5u);
+    collector->blocked = false;
+  }
+
+  ASSERT_FALSE(collector->messages.empty());
+  const std::string& report = collector->messages.back();
+  EXPECT_NE(std::string::npos, report.find("log messages dropped"));
+}
@@ -0,0 +1,205 @@
+/*
+ *  Copyright (C) 2026 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "utils/BinaryLogSink.h"
+
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <spdlog/logger.h>
+
+namespace
+{
+struct DecodedMessage
+{
+  int level{0};
+  std::string logger;
+  std::string format;
+  std::vector<std::string> args;
+};
+
+class CReader
+{
+public:
+  explicit CReader(const std::string& data) : m_data(data) {}
+
+  bool AtEnd() const { return m_pos >= m_data.size(); }
+  uint8_t Byte() { return static_cast<uint8_t>(m_data.at(m_pos++)); }
+  uint64_t Varint()
+  {
+    uint64_t value = 0;
+    for (int shift = 0;; shift += 7)
+    {
+      const uint8_t byte = Byte();
+      value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+      if (!(byte & 0x80))
+        return value;
+    }
+  }
+  int64_t Signed()
+  {
+    const uint64_t value = Varint();
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+  }
+  std::string String()
+  {
+    const size_t length = Varint();
+    std::string value = m_data.substr(m_pos, length);
+    m_pos += length;
+    return value;
+  }
+  void Skip(size_t count) { m_pos += count; }
+
+private:
+  const std::string& m_data;
+  size_t m_pos{0};
+};
+
+std::vector<DecodedMessage> Decode(const std::string& data)
+{
+  using ArgType = CBinaryLogSink::ArgType;
+  using RecordType = CBinaryLogSink::RecordType;
+
+  std::vector<DecodedMessage> messages;
+  EXPECT_EQ(CBinaryLogSink::MAGIC, data.substr(0, CBinaryLogSink::MAGIC.size()));
+  CReader reader(data);
+  reader.Skip(CBinaryLogSink::MAGIC.size());
+  EXPECT_EQ(CBinaryLogSink::VERSION, reader.Byte());
+
+  std::map<uint64_t, std::string> strings;
+  while (!reader.AtEnd())
+  {
+    const auto type = static_cast<RecordType>(reader.Byte());
+    if (type == RecordType::STRING)
+    {
+      const uint64_t id = reader.Varint();
+      strings[id] = reader.String();
+      continue;
+    }
+
+    EXPECT_EQ(RecordType::MESSAGE, type);
+    DecodedMessage& message = messages.emplace_back();
+    reader.Signed(); // time
+    reader.Varint(); // thread
+    message.level = reader.Byte();
+    message.logger = strings[reader.Varint()];
+    message.format = strings[reader.Varint()];
+    for (uint64_t count = reader.Varint(); count > 0; --count)
+    {
+      switch (static_cast<ArgType>(reader.Byte()))
+      {
+        case ArgType::INT:
+          message.args.emplace_back(std::to_string(reader.Signed()));
+          break;
+        case ArgType::UINT:
+          message.args.emplace_back(std::to_string(reader.Varint()));
+          break;
+        case ArgType::BOOL:
+          message.args.emplace_back(reader.Byte() ? "true" : "false");
+          break;
+        case ArgType::STRING:
+          message.args.emplace_back(reader.String());
+          break;
+        case ArgType::DOUBLE:
+          reader.Skip(8);
+          message.args.emplace_back("double");
+          break;
+        default:
+          ADD_FAILURE() << "unexpected argument type";
+          return messages;
+      }
+    }
+  }
+  return messages;
+}
+
+std::string ReadFile(const std::string& path)
+{
+  std::ifstream stream(path, std::ios::binary);
+  return std::string(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+}
+} // unnamed namespace
+
+TEST(TestBinaryLogSink, StructuredAndPlainMessages)
+{
+  const std::string path =
+      (std::filesystem::temp_directory_path() / "TestBinaryLogSink.binlog").string();
+  {
+    auto sink = std::make_shared<CBinaryLogSink>(path);
+    spdlog::logger logger("video", sink);
+    logger.set_level(spdlog::level::trace);
+
+    for (int i = 0; i < 2; ++i)
+    {
+      const std::string name = "movie.mkv";
+      const int64_t position = -1234567;
+      const unsigned int streams = 3;
+      const bool paused = true;
+      const double speed = 1.5;
+      const auto args = fmt::make_format_args(name, position, streams, paused, speed);
+      CBinaryLogSink::CStructuredMessage message(
+          "Opening {} at {} with {} streams, paused {}, speed {}", args);
+      logger.log(spdlog::level::debug, "not stored");
+    }
+
+    // logged without CLog
+    logger.log(spdlog::level::warn, "plain message");
+  }
+
+  const std::vector<DecodedMessage> messages = Decode(ReadFile(path));
+  ASSERT_EQ(3u, messages.size());
+
+  for (int i = 0; i < 2; ++i)
+  {
+    EXPECT_EQ(spdlog::level::debug, messages[i].level);
+    EXPECT_EQ("video", messages[i].logger);
+    EXPECT_EQ("Opening {} at {} with {} streams, paused {}, speed {}", messages[i].format);
+    EXPECT_EQ((std::vector<std::string>{"movie.mkv", "-1234567", "3", "true", "double"}),
+              messages[i].args);
+  }
+
+  EXPECT_EQ(spdlog::level::warn, messages[2].level);
+  EXPECT_EQ("{}", messages[2].format);
+  EXPECT_EQ(std::vector<std::string>{"plain message"}, messages[2].args);
+
+  std::remove(path.c_str());
+}
+
+TEST(TestBinaryLogSink, WritesBufferedMessagesWhenIdle)
+{
+  const std::string path =
+      (std::filesystem::temp_directory_path() / "TestBinaryLogSinkIdle.binlog").string();
+  {
+    auto sink = std::make_shared<CBinaryLogSink>(path);
+    spdlog::logger logger("general", sink);
+    logger.log(spdlog::level::info, "last message before going idle");
+
+    // nothing flushes the logger, the sink writes the message by itself
+    std::vector<DecodedMessage> messages;
+    for (int i = 0; i < 50 && messages.empty(); ++i)
+    {
+      std::this_thread::sleep_for(std::chrono::milliseconds(100));
+      const std::string data = ReadFile(path);
+      if (data.size() > CBinaryLogSink::MAGIC.size() + 1)
+        messages = Decode(data);
+    }
+    ASSERT_EQ(1u, messages.size());
+    EXPECT_EQ(std::vector<std::string>{"last message before going idle"}, messages[0].args);
+  }
+
+  std::remove(path.c_str());
+}
@@ -0,0 +1,47 @@
+/*
+ *  Copyright (C) 2026 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "utils/InternedString.h"
+
+#include <string>
+
+#include <gtest/gtest.h>
+
+TEST(TestInternedString, Empty)
+{
+  CInternedString value;
+  EXPECT_TRUE(value.empty());
+  EXPECT_EQ(value.Get(), "");
+
+  value = "";
+  EXPECT_TRUE(value.empty());
+  EXPECT_EQ(value, CInternedString());
+}
+
+TEST(TestInternedString, SharesValues)
+{
+  const CInternedString a("video/x-matroska");
+  const CInternedString b(std::string("video/x-") + "matroska");
+  const CInternedString c("audio/flac");
+
+  EXPECT_EQ(a, b);
+  EXPECT_EQ(&a.Get(), &b.Get());
+  EXPECT_FALSE(a == c);
+  EXPECT_TRUE(a == std::string_view("video/x-matroska"));
+  EXPECT_EQ(c.Get(), "audio/flac");
+}
+
+TEST(TestInternedString, Assign)
+{
+  CInternedString value("image/jpeg");
+  value = "image/png";
+  EXPECT_EQ(value.Get(), "image/png");
+
+  value.clear();
+  EXPECT_TRUE(value.empty());
+}
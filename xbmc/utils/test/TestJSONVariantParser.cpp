@@ -7,9 +7,91 @@
  */
 
 #include "utils/JSONVariantParser.h"
+#include "utils/JSONVariantWriter.h"
 #include "utils/Variant.h"
 
+#include <chrono>
+#include <random>
+#include <string>
+
 #include <gtest/gtest.h>
+#include <nlohmann/json.hpp>
+
+namespace
+{
+// the values created by the nlohmann::json based parser used before
+CVariant FromJson(const nlohmann::json& json)
+{
+  switch (json.type())
+  {
+    case nlohmann::json::value_t::boolean:
+      return json.get<bool>();
+    case nlohmann::json::value_t::number_integer:
+      return json.get<int64_t>();
+    case nlohmann::json::value_t::number_unsigned:
+      return json.get<uint64_t>();
+    case nlohmann::json::value_t::number_float:
+      return json.get<double>();
+    case nlohmann::json::value_t::string:
+      return json.get<std::string>();
+    case nlohmann::json::value_t::array:
+    {
+      CVariant array(CVariant::VariantTypeArray);
+      for (const auto& item : json)
+        array.push_back(FromJson(item));
+      return array;
+    }
+    case nlohmann::json::value_t::object:
+    {
+      CVariant object(CVariant::VariantTypeObject);
+      for (const auto& item : json.items())
+        object[item.key()] = FromJson(item.value());
+      return object;
+    }
+    default:
+      return CVariant::ConstNullVariant;
+  }
+}
+
+std::string CreateRandomJson(std::mt19937& random, int depth)
+{
+  static const char* const STRINGS[] = {
+      "", "plain", "with \\\"escapes\\\" and \\/ \\b\\f\\n\\r\\t", "\\u00e9\\u20AC",
+      "\\ud83c\\udfac", "caf\xc3\xa9 \xe2\x82\xac \xf0\x9f\x8e\xac", "a somewhat longer plain string"};
+  static const char* const NUMBERS[] = {"0",   "-0",   "12",    "-12",
+                                        "1.5", "-1e5", "2E-3",  "18446744073709551615",
+                                        "18446744073709551616", "-9223372036854775808",
+                                        "-9223372036854775809", "3.141592653589793"};
+
+  switch (random() % (depth > 4 ? 5 : 7))
+  {
+    case 0:
+      return "null";
+    case 1:
+      return random() % 2 ? "true" : "false";
+    case 2:
+      return NUMBERS[random() % std::size(NUMBERS)];
+    case 3:
+    case 4:
+      return std::string("\"") + STRINGS[random() % std::size(STRINGS)] + "\"";
+    case 5:
+    {
+      std::string array = "[ ";
+      for (unsigned int i = random() % 4; i > 0; --i)
+        array += CreateRandomJson(random, depth + 1) + (i > 1 ? ", " : "");
+      return array + "]";
+    }
+    default:
+    {
+      std::string object = "{";
+      for (unsigned int i = random() % 4; i > 0; --i)
+        object += "\"key" + std::to_string(i) + "\":\n\t" + CreateRandomJson(random, depth + 1) +
+                  (i > 1 ? "," : "");
+      return object + "}";
+    }
+  }
+}
+} // unnamed namespace
 
 TEST(TestJSONVariantParser, CannotParseNullptr)
 {
@@ -187,3 +269,137 @@ TEST(TestJSONVariantParser, CanParseArray)
   ASSERT_TRUE(variant[0]["foo"].isString());
   ASSERT_STREQ("bar", variant[0]["foo"].asString().c_str());
 }
+
+TEST(TestJSONVariantParser, CanParseEscapes)
+{
+  CVariant variant;
+  ASSERT_TRUE(CJSONVariantParser::Parse(R"("\"\\\/\b\f\n\r\t")", variant));
+  EXPECT_EQ("\"\\/\b\f\n\r\t", variant.asString());
+
+  ASSERT_TRUE(CJSONVariantParser::Parse(R"("caf\u00e9 \u20AC \ud83c\udfac")", variant));
+  EXPECT_EQ("caf\xc3\xa9 \xe2\x82\xac \xf0\x9f\x8e\xac", variant.asString());
+
+  ASSERT_FALSE(CJSONVariantParser::Parse(R"("\ud83c")", variant));
+  ASSERT_FALSE(CJSONVariantParser::Parse(R"("\udfac")", variant));
+  ASSERT_FALSE(CJSONVariantParser::Parse(R"("\x")", variant));
+  ASSERT_FALSE(CJSONVariantParser::Parse("\"tab\tinside\"", variant));
+  ASSERT_FALSE(CJSONVariantParser::Parse("\"caf\xe9\"", variant));
+}
+
+TEST(TestJSONVariantParser, CanParseLargeNumbers)
+{
+  CVariant variant;
+  ASSERT_TRUE(CJSONVariantParser::Parse("18446744073709551615", variant));
+  EXPECT_TRUE(variant.isUnsignedInteger());
+  ASSERT_TRUE(CJSONVariantParser::Parse("18446744073709551616", variant));
+  EXPECT_TRUE(variant.isDouble());
+  ASSERT_TRUE(CJSONVariantParser::Parse("-9223372036854775809", variant));
+  EXPECT_TRUE(variant.isDouble());
+
+  ASSERT_FALSE(CJSONVariantParser::Parse("01", variant));
+  ASSERT_FALSE(CJSONVariantParser::Parse("1.", variant));
+  ASSERT_FALSE(CJSONVariantParser::Parse("-", variant));
+  ASSERT_FALSE(CJSONVariantParser::Parse("1e", variant));
+}
+
+TEST(TestJSONVariantParser, CannotParseTooDeepNesting)
+{
+  CVariant variant;
+  ASSERT_TRUE(CJSONVariantParser::Parse(std::string(100, '[') + std::string(100, ']'), variant));
+  ASSERT_FALSE(
+      CJSONVariantParser::Parse(std::string(100000, '[') + std::string(100000, ']'), variant));
+}
+
+TEST(TestJSONVariantParser, ParsesLikeJsonLibrary)
+{
+  // random documents and mutations of them must be accepted or rejected like nlohmann::json does
+  // and give the same values
+  std::mt19937 random(4711);
+  for (int i = 0; i < 20000; ++i)
+  {
+    std::string json = CreateRandomJson(random, 0);
+    if (i % 2)
+    {
+      const size_t position = random() % json.size();
+      switch (random() % 3)
+      {
+        case 0:
+          json[position] = static_cast<char>(random() % 256);
+          break;
+        case 1:
+          json.erase(position, 1);
+          break;
+        default:
+          json.insert(position, 1, "{}[]\",:\\ 0e.-"[random() % 14]);
+          break;
+      }
+    }
+
+    CVariant variant;
+    const bool parsed = CJSONVariantParser::Parse(json, variant);
+    ASSERT_EQ(nlohmann::json::accept(json), parsed) << json;
+    if (parsed)
+      ASSERT_EQ(FromJson(nlohmann::json::parse(json)), variant) << json;
+  }
+}
+
+TEST(TestJSONVariantParser, DISABLED_ParseBenchmark)
+{
+  // an addon repository index and a JSON-RPC batch request
+  CVariant addons(CVariant::VariantTypeArray);
+  for (int i = 0; i < 5000; ++i)
+  {
+    CVariant addon;
+    addon["id"] = "plugin.video.example" + std::to_string(i);
+    addon["name"] = "Example add-on " + std::to_string(i);
+    addon["version"] = "1.2." + std::to_string(i % 30);
+    addon["provider"] = "Team Kodi";
+    addon["summary"]["en_GB"] = "Watch the example videos";
+    addon["summary"]["de_DE"] = "Beispielvideos ansehen, schöne Grüße";
+    addon["description"]["en_GB"] =
+        "A long description of the add-on.\nIt has several lines, \"quotes\" and a link to "
+        "https://kodi.tv/ which make it a bit more realistic.";
+    addon["platform"] = "all";
+    addon["license"] = "GPL-2.0-or-later";
+    addon["size"] = 123456 + i;
+    addon["requires"].push_back("xbmc.python");
+    addon["requires"].push_back("script.module.requests");
+    addon["assets"]["icon"] = "resources/icon.png";
+    addon["assets"]["fanart"] = "resources/fanart.jpg";
+    addons.push_back(std::move(addon));
+  }
+  CVariant batch(CVariant::VariantTypeArray);
+  for (int i = 0; i < 5000; ++i)
+  {
+    CVariant request;
+    request["jsonrpc"] = "2.0";
+    request["id"] = i;
+    request["method"] = "VideoLibrary.GetMovieDetails";
+    request["params"]["movieid"] = i;
+    request["params"]["properties"].push_back("title");
+    request["params"]["properties"].push_back("rating");
+    request["params"]["properties"].push_back("art");
+    batch.push_back(std::move(request));
+  }
+
+  for (const auto& [name, document] : {std::pair{"addons", addons}, std::pair{"jsonrpc", batch}})
+  {
+    std::string json;
+    ASSERT_TRUE(CJSONVariantWriter::Write(document, json, false));
+
+    const auto start = std::chrono::steady_clock::now();
+    CVariant parsed;
+    ASSERT_TRUE(CJSONVariantParser::Parse(json, parsed));
+    const auto duration = std::chrono::steady_clock::now() - start;
+
+    // numbers are parsed as unsigned integers, compare the JSON instead of the values
+    std::string written;
+    ASSERT_TRUE(CJSONVariantWriter::Write(parsed, written, false));
+    EXPECT_EQ(json, written);
+
+    const double seconds = std::chrono::duration<double>(duration).count();
+    RecordProperty(std::string(name) + "_bytes", static_cast<int>(json.size()));
+    RecordProperty(std::string(name) + "_mb_per_s",
+                   static_cast<int>(json.size() / 1000000.0 / seconds));
+  }
+}
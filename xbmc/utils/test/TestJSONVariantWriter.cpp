@@ -8,8 +8,58 @@
 
 #include "utils/JSONVariantWriter.h"
 #include "utils/Variant.h"
+#include "utils/test/TestVariantUtils.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
 
 #include <gtest/gtest.h>
+#include <nlohmann/json.hpp>
+
+using KODI::TEST::CreateMovieList;
+
+namespace
+{
+// the conversion used before CJSONVariantWriter wrote the JSON itself
+nlohmann::json ToJson(const CVariant& value)
+{
+  switch (value.type())
+  {
+    case CVariant::VariantTypeInteger:
+      return value.asInteger();
+    case CVariant::VariantTypeUnsignedInteger:
+      return value.asUnsignedInteger();
+    case CVariant::VariantTypeDouble:
+      return value.asDouble();
+    case CVariant::VariantTypeBoolean:
+      return value.asBoolean();
+    case CVariant::VariantTypeString:
+      return std::string(value.c_str(), value.size());
+    case CVariant::VariantTypeArray:
+    {
+      nlohmann::json json = nlohmann::json::array();
+      for (CVariant::const_iterator_array itr = value.begin_array(); itr != value.end_array();
+           ++itr)
+        json.emplace_back(ToJson(*itr));
+      return json;
+    }
+    case CVariant::VariantTypeObject:
+    {
+      nlohmann::json json = nlohmann::json::object();
+      for (CVariant::const_iterator_map itr = value.begin_map(); itr != value.end_map(); ++itr)
+        json[itr->first] = ToJson(itr->second);
+      return json;
+    }
+    default:
+      return nullptr;
+  }
+}
+} // unnamed namespace
 
 TEST(TestJSONVariantWriter, CanWriteNull)
 {
@@ -149,3 +199,127 @@ TEST(TestJSONVariantWriter, CanWriteArray)
   ASSERT_TRUE(CJSONVariantWriter::Write(variant, str, false));
   ASSERT_STREQ("[\n\t{\n\t\t\"foo\": \"bar\"\n\t}\n]", str.c_str());
 }
+
+TEST(TestJSONVariantWriter, CanWriteCompact)
+{
+  CVariant variant(CVariant::VariantTypeObject);
+  variant["foo"].push_back(1);
+  variant["foo"].push_back(CVariant(CVariant::VariantTypeObject));
+  variant["bar"] = CVariant(CVariant::VariantTypeArray);
+  std::string str;
+  ASSERT_TRUE(CJSONVariantWriter::Write(variant, str, true));
+  ASSERT_STREQ("{\"bar\":[],\"foo\":[1,{}]}", str.c_str());
+}
+
+TEST(TestJSONVariantWriter, CanWriteDoubleNotation)
+{
+  std::string str;
+  ASSERT_TRUE(CJSONVariantWriter::Write(CVariant(0.5), str, true));
+  ASSERT_STREQ("0.5", str.c_str());
+
+  ASSERT_TRUE(CJSONVariantWriter::Write(CVariant(1234.25), str, true));
+  ASSERT_STREQ("1234.25", str.c_str());
+
+  ASSERT_TRUE(CJSONVariantWriter::Write(CVariant(0.001), str, true));
+  ASSERT_STREQ("0.001", str.c_str());
+
+  ASSERT_TRUE(CJSONVariantWriter::Write(CVariant(0.00001), str, true));
+  ASSERT_STREQ("1e-05", str.c_str());
+
+  ASSERT_TRUE(CJSONVariantWriter::Write(CVariant(1e20), str, true));
+  ASSERT_STREQ("1e+20", str.c_str());
+
+  ASSERT_TRUE(CJSONVariantWriter::Write(CVariant(-1.5e-300), str, true));
+  ASSERT_STREQ("-1.5e-300", str.c_str());
+
+  ASSERT_TRUE(CJSONVariantWriter::Write(CVariant(0.1), str, true));
+  ASSERT_STREQ("0.1", str.c_str());
+}
+
+TEST(TestJSONVariantWriter, WritesDoublesLikeJsonLibrary)
+{
+  std::vector<double> values = {1.0,     -2.5,    1e15,  1e16,  123456789012345.0, 1e-4,
+                                1.5e-5,  1e-6,    1e21,  1e22,  5e-324,            1.7976931348623157e308,
+                                0.30000000000000004, 100.0, 2.0 / 3.0, -1e-300};
+
+  std::mt19937_64 random(42);
+  while (values.size() < 10000)
+  {
+    const uint64_t bits = random();
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    if (std::isfinite(value))
+      values.push_back(value);
+  }
+
+  // the json library doesn't always pick the shortest digits, so only the notation must match
+  // and the value must read back the same
+  std::string str;
+  for (const double value : values)
+  {
+    ASSERT_TRUE(CJSONVariantWriter::Write(CVariant(value), str, true));
+    const std::string expected = nlohmann::json(value).dump();
+    const size_t exponent = expected.find('e');
+    if (exponent == std::string::npos)
+      EXPECT_EQ(std::string::npos, str.find('e')) << expected << " " << str;
+    else
+      EXPECT_EQ(expected.substr(exponent), str.substr(str.find('e'))) << expected << " " << str;
+    EXPECT_EQ(value, nlohmann::json::parse(str).get<double>()) << str;
+  }
+}
+
+TEST(TestJSONVariantWriter, CanEscapeString)
+{
+  std::string str;
+  ASSERT_TRUE(CJSONVariantWriter::Write(CVariant("\"a\\b\"\n\t\x01"), str, true));
+  ASSERT_STREQ("\"\\\"a\\\\b\\\"\\n\\t\\u0001\"", str.c_str());
+
+  // UTF-8 is not escaped
+  ASSERT_TRUE(CJSONVariantWriter::Write(CVariant("caf\xc3\xa9 \xf0\x9f\x8e\xac"), str, true));
+  ASSERT_STREQ("\"caf\xc3\xa9 \xf0\x9f\x8e\xac\"", str.c_str());
+}
+
+TEST(TestJSONVariantWriter, CannotWriteInvalidUTF8)
+{
+  std::string str;
+  ASSERT_FALSE(CJSONVariantWriter::Write(CVariant("caf\xe9"), str, true));
+  ASSERT_TRUE(str.empty());
+
+  CVariant variant(CVariant::VariantTypeObject);
+  variant["foo"].push_back("\xc3");
+  ASSERT_FALSE(CJSONVariantWriter::Write(variant, str, false));
+}
+
+TEST(TestJSONVariantWriter, WritesLikeJsonLibrary)
+{
+  const CVariant variant = CreateMovieList(20);
+  std::string str;
+
+  ASSERT_TRUE(CJSONVariantWriter::Write(variant, str, true));
+  EXPECT_EQ(ToJson(variant).dump(), str);
+
+  ASSERT_TRUE(CJSONVariantWriter::Write(variant, str, false));
+  EXPECT_EQ(ToJson(variant).dump(1, '\t'), str);
+}
+
+TEST(TestJSONVariantWriter, DISABLED_WriteLargeResultBenchmark)
+{
+  const CVariant variant = CreateMovieList(20000);
+
+  const auto start = std::chrono::steady_clock::now();
+  const std::string expected = ToJson(variant).dump();
+  const auto converted = std::chrono::steady_clock::now();
+  std::string str;
+  ASSERT_TRUE(CJSONVariantWriter::Write(variant, str, true));
+  const auto written = std::chrono::steady_clock::now();
+
+  EXPECT_EQ(expected, str);
+
+  using std::chrono::duration_cast;
+  using std::chrono::microseconds;
+  RecordProperty("bytes", static_cast<int>(str.size()));
+  RecordProperty("json_library_us",
+                 static_cast<int>(duration_cast<microseconds>(converted - start).count()));
+  RecordProperty("writer_us",
+                 static_cast<int>(duration_cast<microseconds>(written - converted).count()));
+}
@@ -7,13 +7,18 @@
  */
 
 #include "ServiceBroker.h"
+#include "jobs/IJobCallback.h"
 #include "jobs/Job.h"
 #include "jobs/JobManager.h"
 #include "test/MtTestUtils.h"
 #include "utils/XTimeUtils.h"
 
+#include <algorithm>
 #include <atomic>
+#include <chrono>
+#include <cstring>
 #include <mutex>
+#include <string>
 
 #include <gtest/gtest.h>
 
@@ -211,3 +216,196 @@ TEST_F(TestJobManager, IsProcessing)
 
   job->FinishAndStopBlocking();
 }
+
+namespace
+{
+class NamedJob : public CJob
+{
+public:
+  NamedJob(std::string name, std::atomic<int>& runs, std::atomic<int>& destroyed)
+    : m_name(std::move(name)),
+      m_runs(runs),
+      m_destroyed(destroyed)
+  {
+  }
+  ~NamedJob() override { ++m_destroyed; }
+
+  const char* GetType() const override { return "NamedJob"; }
+  bool Equals(const CJob* job) const override
+  {
+    if (strcmp(job->GetType(), GetType()) != 0)
+      return false;
+    const auto* namedJob = dynamic_cast<const NamedJob*>(job);
+    return namedJob && namedJob->m_name == m_name;
+  }
+  bool DoWork() override
+  {
+    ++m_runs;
+    return true;
+  }
+
+private:
+  std::string m_name;
+  std::atomic<int>& m_runs;
+  std::atomic<int>& m_destroyed;
+};
+
+class CountingCallback : public IJobCallback
+{
+public:
+  void OnJobComplete(unsigned int jobID, bool success, CJob* job) override { ++completed; }
+  void OnJobAbort(unsigned int jobID, CJob* job) override { ++aborted; }
+
+  std::atomic<int> completed{0};
+  std::atomic<int> aborted{0};
+};
+} // namespace
+
+TEST_F(TestJobManager, AddEqualJobs)
+{
+  std::atomic<int> runs{0};
+  std::atomic<int> destroyed{0};
+  CountingCallback first;
+  CountingCallback second;
+
+  // keep the jobs queued
+  CServiceBroker::GetJobManager()->PauseJobs();
+  const unsigned int id = CServiceBroker::GetJobManager()->AddJob(
+      new NamedJob("a", runs, destroyed), &first, CJob::PRIORITY_LOW_PAUSABLE);
+  EXPECT_EQ(id, CServiceBroker::GetJobManager()->AddJob(new NamedJob("a", runs, destroyed), &second,
+                                                        CJob::PRIORITY_LOW_PAUSABLE));
+  EXPECT_NE(id, CServiceBroker::GetJobManager()->AddJob(new NamedJob("b", runs, destroyed), nullptr,
+                                                        CJob::PRIORITY_LOW_PAUSABLE));
+  CServiceBroker::GetJobManager()->UnPauseJobs();
+
+  ASSERT_TRUE(poll([&destroyed]() -> bool { return destroyed == 3; }));
+  EXPECT_EQ(2, runs);
+  EXPECT_EQ(1, first.completed);
+  EXPECT_EQ(1, second.completed);
+}
+
+TEST_F(TestJobManager, CancelQueuedJob)
+{
+  std::atomic<int> runs{0};
+  std::atomic<int> destroyed{0};
+  CountingCallback callback;
+
+  CServiceBroker::GetJobManager()->PauseJobs();
+  const unsigned int id = CServiceBroker::GetJobManager()->AddJob(
+      new NamedJob("a", runs, destroyed), &callback, CJob::PRIORITY_LOW_PAUSABLE);
+  CServiceBroker::GetJobManager()->CancelJob(id);
+  EXPECT_EQ(1, destroyed);
+  CServiceBroker::GetJobManager()->AddJob(new NamedJob("b", runs, destroyed), nullptr,
+                                          CJob::PRIORITY_LOW_PAUSABLE);
+  CServiceBroker::GetJobManager()->UnPauseJobs();
+
+  ASSERT_TRUE(poll([&destroyed]() -> bool { return destroyed == 2; }));
+  EXPECT_EQ(1, runs);
+  EXPECT_EQ(0, callback.completed);
+}
+
+TEST_F(TestJobManager, CancelJobsAbortsQueuedJobs)
+{
+  std::atomic<int> runs{0};
+  std::atomic<int> destroyed{0};
+  CountingCallback callback;
+
+  CServiceBroker::GetJobManager()->PauseJobs();
+  for (int i = 0; i < 10; ++i)
+    CServiceBroker::GetJobManager()->AddJob(new NamedJob(std::to_string(i), runs, destroyed),
+                                            &callback, CJob::PRIORITY_LOW_PAUSABLE);
+  CServiceBroker::GetJobManager()->CancelJobs();
+
+  EXPECT_EQ(10, destroyed);
+  EXPECT_EQ(10, callback.aborted);
+  EXPECT_EQ(0, runs);
+  CServiceBroker::GetJobManager()->UnPauseJobs();
+}
+
+namespace
+{
+struct WorkloadStats
+{
+  std::atomic<int> done{0};
+  std::atomic<int64_t> totalLatency{0};
+  std::atomic<int64_t> maxLatency{0};
+
+  void Record(std::chrono::steady_clock::time_point queued)
+  {
+    const int64_t latency = std::chrono::duration_cast<std::chrono::microseconds>(
+                                std::chrono::steady_clock::now() - queued)
+                                .count();
+    totalLatency += latency;
+    int64_t max = maxLatency;
+    while (latency > max && !maxLatency.compare_exchange_weak(max, latency))
+      ;
+    ++done;
+  }
+};
+
+// a thumbnail extraction, a little work per job
+class ThumbJob : public CJob
+{
+public:
+  explicit ThumbJob(WorkloadStats& stats) : m_stats(stats) {}
+
+  bool DoWork() override
+  {
+    m_stats.Record(m_queued);
+    volatile unsigned int hash = 0;
+    for (unsigned int i = 0; i < 2000; ++i)
+      hash = hash * 31 + i;
+    return true;
+  }
+
+private:
+  WorkloadStats& m_stats;
+  const std::chrono::steady_clock::time_point m_queued{std::chrono::steady_clock::now()};
+};
+
+// a library scan, which queues a thumbnail job for every item it finds
+class ScanJob : public CJob
+{
+public:
+  ScanJob(WorkloadStats& stats, int items) : m_stats(stats), m_items(items) {}
+
+  bool DoWork() override
+  {
+    for (int i = 0; i < m_items; ++i)
+      CServiceBroker::GetJobManager()->AddJob(new ThumbJob(m_stats), nullptr,
+                                              CJob::PRIORITY_LOW_PAUSABLE);
+    return true;
+  }
+
+private:
+  WorkloadStats& m_stats;
+  const int m_items;
+};
+} // namespace
+
+TEST_F(TestJobManager, DISABLED_StressThroughput)
+{
+  constexpr int SCANS = 8;
+  constexpr int ITEMS_PER_SCAN = 2500;
+  constexpr int THUMBS = 10000;
+
+  WorkloadStats stats;
+  const auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < SCANS; ++i)
+    CServiceBroker::GetJobManager()->AddJob(new ScanJob(stats, ITEMS_PER_SCAN), nullptr,
+                                            CJob::PRIORITY_NORMAL);
+  for (int i = 0; i < THUMBS; ++i)
+    CServiceBroker::GetJobManager()->AddJob(new ThumbJob(stats), nullptr, CJob::PRIORITY_LOW);
+
+  constexpr int total = SCANS * ITEMS_PER_SCAN + THUMBS;
+  ASSERT_TRUE(poll([&stats]() -> bool { return stats.done == total; }));
+  const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+                           std::chrono::steady_clock::now() - start)
+                           .count();
+
+  const int64_t jobsPerSecond =
+      static_cast<int64_t>(total) * 1000000 / std::max<int64_t>(elapsed, 1);
+  RecordProperty("jobs_per_second", std::to_string(jobsPerSecond));
+  RecordProperty("mean_latency_us", std::to_string(stats.totalLatency / total));
+  RecordProperty("max_latency_us", std::to_string(stats.maxLatency.load()));
+}
@@ -6,9 +6,17 @@
  *  See LICENSES/README.md for more information.
  */
 
+#include "utils/CharsetConverter.h"
 #include "utils/SortUtils.h"
+#include "utils/StringUtils.h"
 #include "utils/Variant.h"
 
+#include <algorithm>
+#include <array>
+#include <random>
+#include <string>
+#include <vector>
+
 #include <gtest/gtest.h>
 
 TEST(TestSortUtils, Sort_SortBy)
@@ -121,3 +129,70 @@ TEST(TestSortUtils, GetFieldsForSorting)
   EXPECT_EQ(Field::TRACK_NUMBER, *it);
   EXPECT_EQ(5U, fields.size());
 }
+
+TEST(TestSortUtils, GetFieldsForSQLSort)
+{
+  FieldList fields;
+
+  EXPECT_TRUE(SortUtils::GetFieldsForSQLSort(MediaTypeMovie, SortBy::DATE_ADDED, fields));
+  ASSERT_EQ(2U, fields.size());
+  EXPECT_EQ(Field::DATE_ADDED, fields[0]);
+  EXPECT_EQ(Field::ID, fields[1]);
+
+  EXPECT_TRUE(SortUtils::GetFieldsForSQLSort(MediaTypeTvShow, SortBy::NUMBER_OF_EPISODES, fields));
+  ASSERT_EQ(2U, fields.size());
+  EXPECT_EQ(Field::NUMBER_OF_EPISODES, fields[0]);
+
+  // sorting by label or title depends on ignored articles and sort titles
+  EXPECT_FALSE(SortUtils::GetFieldsForSQLSort(MediaTypeMovie, SortBy::TITLE, fields));
+  EXPECT_FALSE(SortUtils::GetFieldsForSQLSort(MediaTypeEpisode, SortBy::LABEL, fields));
+  EXPECT_FALSE(SortUtils::GetFieldsForSQLSort(MediaTypeMusicVideo, SortBy::RATING, fields));
+  EXPECT_FALSE(SortUtils::GetFieldsForSQLSort(MediaTypeNone, SortBy::DATE_ADDED, fields));
+
+  EXPECT_TRUE(SortUtils::GetFieldsForSQLSort(MediaTypeEpisode, SortBy::NONE, fields));
+  ASSERT_EQ(1U, fields.size());
+  EXPECT_EQ(Field::ID, fields[0]);
+}
+
+TEST(TestSortUtils, Sort_SameOrderAsAlphaNumericCompare)
+{
+  // numbers, symbols, case, accents and superscript digits, which are no digits to the sorter
+  static constexpr std::array<const char*, 24> fragments = {
+      "0", "1", "2", "9", "10", "007", " ", "a", "A", "b", "Z", "z",
+      ".", "-", "_", "(", "é", "É", "ö", "Ö", "²", "³", "¹", "ß"};
+
+  std::mt19937 generator(1234);
+  for (int round = 0; round < 20; ++round)
+  {
+    SortItems items;
+    std::vector<std::string> labels;
+    for (int i = 0; i < 200; ++i)
+    {
+      std::string label;
+      for (size_t length = generator() % 6; length > 0; --length)
+        label += fragments[generator() % fragments.size()];
+
+      auto item = std::make_shared<SortItem>();
+      (*item)[Field::LABEL] = label;
+      items.emplace_back(std::move(item));
+      labels.emplace_back(std::move(label));
+    }
+
+    // the comparator the sorter used before it sorted by keys
+    std::ranges::stable_sort(labels,
+                             [](const std::string& left, const std::string& right)
+                             {
+                               std::wstring leftW;
+                               std::wstring rightW;
+                               g_charsetConverter.utf8ToW(left, leftW, false);
+                               g_charsetConverter.utf8ToW(right, rightW, false);
+                               return StringUtils::AlphaNumericCompare(leftW, rightW) < 0;
+                             });
+
+    SortUtils::Sort(SortBy::LABEL, SortOrder::ASCENDING, SortAttributeNone, items);
+    ASSERT_EQ(labels.size(), items.size());
+    for (size_t i = 0; i < labels.size(); ++i)
+      EXPECT_EQ(labels[i], (*items[i])[Field::LABEL].asString()) << "at " << i;
+  }
+}
+
@@ -6,12 +6,16 @@
  *  See LICENSES/README.md for more information.
  */
 
+#include "LangInfo.h"
 #include "utils/StringUtils.h"
 
 #include <algorithm>
 #include <limits>
+#include <locale>
+#include <random>
 #include <string>
 #include <string_view>
+#include <vector>
 
 #include <gtest/gtest.h>
 enum class ECG
@@ -431,6 +435,82 @@ TEST(TestStringUtils, AlphaNumericCompare)
   EXPECT_EQ(StringUtils::AlphaNumericCompare(L"12345678901234567890", L"12345678901234567890"), 0);
 }
 
+TEST(TestStringUtils, AlphaNumericSortKey)
+{
+  // numbers, symbols, case, control characters, accents and superscript digits
+  static constexpr std::wstring_view alphabet = L"0129 aAbzZ.-_(\t²³¹éÉÿĀあ";
+
+  std::mt19937 generator(1234);
+  const auto randomString = [&generator]()
+  {
+    std::wstring str;
+    for (size_t length = generator() % 6; length > 0; --length)
+      str += alphabet[generator() % alphabet.size()];
+    return str;
+  };
+
+  for (int i = 0; i < 100000; ++i)
+  {
+    const std::wstring left = randomString();
+    const std::wstring right = randomString();
+
+    std::vector<std::wstring_view> strings{left, right};
+    StringUtils::CollationWeights weights;
+    const StringUtils::CollationWeights* collation = nullptr;
+    if (g_langInfo.UseLocaleCollation())
+    {
+      if (!StringUtils::GetLocaleCollationWeights(g_langInfo.GetSystemLocale(), strings, weights))
+        continue;
+      collation = &weights;
+    }
+
+    const int64_t compare = StringUtils::AlphaNumericCompare(left, right);
+    const std::string leftKey = StringUtils::AlphaNumericSortKey(left, collation);
+    const std::string rightKey = StringUtils::AlphaNumericSortKey(right, collation);
+    EXPECT_EQ(compare < 0, leftKey < rightKey);
+    EXPECT_EQ(compare > 0, rightKey < leftKey);
+  }
+
+  // numbers of up to 15 digits compare by value, ignoring leading zeros
+  EXPECT_EQ(StringUtils::AlphaNumericSortKey(L"abc007"), StringUtils::AlphaNumericSortKey(L"abc7"));
+  EXPECT_LT(StringUtils::AlphaNumericSortKey(L"Episode 9"),
+            StringUtils::AlphaNumericSortKey(L"episode 10"));
+}
+
+namespace
+{
+// collates superscript two like the digit two
+class SuperscriptCollate : public std::collate<wchar_t>
+{
+protected:
+  string_type do_transform(const wchar_t* low, const wchar_t* high) const override
+  {
+    string_type result(low, high);
+    std::ranges::replace(result, L'²', L'2');
+    return result;
+  }
+};
+} // namespace
+
+TEST(TestStringUtils, GetLocaleCollationWeights)
+{
+  const std::vector<std::wstring_view> strings{L"Track 2", L"Track é", L"Track ²"};
+  StringUtils::CollationWeights weights;
+
+  // the classic locale collates by code point
+  ASSERT_TRUE(StringUtils::GetLocaleCollationWeights(std::locale::classic(), strings, weights));
+  EXPECT_EQ(weights[L'0'], weights[L'9']);
+  EXPECT_LT(weights[L'9'], weights[L'r']);
+  EXPECT_LT(weights[L'r'], weights[L't']);
+  EXPECT_LT(weights[L't'], weights[L'²']);
+  EXPECT_LT(weights[L'²'], weights[L'é']);
+  EXPECT_FALSE(weights.contains(L'T'));
+
+  // a character that collates among the digits can't be sorted by keys
+  const std::locale locale(std::locale::classic(), new SuperscriptCollate);
+  EXPECT_FALSE(StringUtils::GetLocaleCollationWeights(locale, strings, weights));
+}
+
 TEST(TestStringUtils, TimeStringToSeconds)
 {
   EXPECT_EQ(77455, StringUtils::TimeStringToSeconds("21:30:55"));
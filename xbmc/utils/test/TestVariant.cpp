@@ -6,8 +6,12 @@
  *  See LICENSES/README.md for more information.
  */
 
+#include "utils/JSONVariantParser.h"
+#include "utils/JSONVariantWriter.h"
 #include "utils/Variant.h"
+#include "utils/test/TestVariantUtils.h"
 
+#include <chrono>
 #include <map>
 #include <string>
 #include <vector>
@@ -415,3 +419,78 @@ TEST(TestVariant, ConstNullVariant_cant_be_changed)
   EXPECT_EQ(CVariant::VariantTypeConstNull, CVariant::ConstNullVariant.type());
   EXPECT_EQ(CVariant::VariantTypeConstNull, c3.type());
 }
+
+TEST(TestVariant, ReferencesStayValidOnInsert)
+{
+  CVariant a;
+  CVariant& first = a["m"];
+  first = 1;
+  for (int i = 0; i < 100; ++i)
+    a["key" + std::to_string(i)] = i;
+  first = 2;
+  EXPECT_EQ(2, a["m"].asInteger());
+
+  a.erase("key50");
+  a["key50"] = "again";
+  EXPECT_EQ(2, first.asInteger());
+  EXPECT_EQ(101u, a.size());
+}
+
+TEST(TestVariant, MapIsSortedByKey)
+{
+  CVariant a;
+  a["c"] = 3;
+  a["a"] = 1;
+  a["d"] = 4;
+  a["b"] = 2;
+  a.erase("d");
+  a["e"] = 5;
+
+  std::string keys;
+  int64_t sum = 0;
+  for (auto it = a.begin_map(); it != a.end_map(); ++it)
+  {
+    keys += it->first;
+    sum += it->second.asInteger();
+  }
+  EXPECT_EQ("abce", keys);
+  EXPECT_EQ(11, sum);
+
+  CVariant b(a);
+  EXPECT_EQ(a, b);
+  b["a"] = 0;
+  EXPECT_NE(a, b);
+  b = a;
+  b.erase("a");
+  EXPECT_FALSE(b.isMember("a"));
+  EXPECT_TRUE(a.isMember("a"));
+}
+
+TEST(TestVariant, DISABLED_RoundTripBenchmark)
+{
+  const CVariant result = KODI::TEST::CreateMovieList(5000);
+  std::string json;
+  ASSERT_TRUE(CJSONVariantWriter::Write(result, json, true));
+
+  const auto start = std::chrono::steady_clock::now();
+  std::string output;
+  for (int round = 0; round < 10; ++round)
+  {
+    CVariant parsed;
+    ASSERT_TRUE(CJSONVariantParser::Parse(json, parsed));
+    for (auto it = parsed["movies"].begin_array(); it != parsed["movies"].end_array(); ++it)
+    {
+      CVariant& movie = *it;
+      movie["label"] = movie["title"].asString() + " (" + movie["year"].asString() + ")";
+      movie["playcount"] = movie["playcount"].asInteger() + 1;
+      movie.erase("file");
+    }
+    ASSERT_TRUE(CJSONVariantWriter::Write(parsed, output, true));
+  }
+  const auto duration = std::chrono::steady_clock::now() - start;
+
+  EXPECT_EQ(std::string::npos, output.find("smb://"));
+  RecordProperty(
+      "round_trip_us",
+      static_cast<int>(std::chrono::duration_cast<std::chrono::microseconds>(duration).count()));
+}
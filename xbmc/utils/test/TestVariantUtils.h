@@ -0,0 +1,52 @@
+/*
+ *  Copyright (C) 2026 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "utils/Variant.h"
+
+#include <string>
+#include <utility>
+
+namespace KODI::TEST
+{
+//! Creates a result like the one of VideoLibrary.GetMovies with the given number of movies.
+inline CVariant CreateMovieList(unsigned int count)
+{
+  CVariant movies(CVariant::VariantTypeArray);
+  for (unsigned int i = 0; i < count; ++i)
+  {
+    CVariant movie(CVariant::VariantTypeObject);
+    movie["movieid"] = i;
+    movie["label"] = "Movie \"" + std::to_string(i) + "\"";
+    movie["title"] = "Movie \"" + std::to_string(i) + "\"";
+    movie["plot"] = "A plot\nspanning two lines with an \u00e9 in it.";
+    movie["rating"] = (i % 40) * 0.25;
+    movie["year"] = 1950 + i % 70;
+    movie["runtime"] = 5400;
+    movie["playcount"] = 0;
+    movie["file"] = "smb://server/movies/Movie " + std::to_string(i) + ".mkv";
+    movie["genre"].push_back("Drama");
+    movie["genre"].push_back("Comedy");
+    movie["art"]["poster"] = "image://smb%3a%2f%2fserver%2fposter.jpg/";
+    movie["art"]["fanart"] = "image://smb%3a%2f%2fserver%2ffanart.jpg/";
+    movie["resume"]["position"] = 0.0;
+    movie["resume"]["total"] = 0.0;
+    movie["tag"] = CVariant(CVariant::VariantTypeArray);
+    movie["set"] = CVariant();
+    movies.push_back(std::move(movie));
+  }
+
+  CVariant result(CVariant::VariantTypeObject);
+  result["movies"] = std::move(movies);
+  result["limits"]["start"] = 0;
+  result["limits"]["end"] = count;
+  result["limits"]["total"] = count;
+  return result;
+}
+} // namespace KODI::TEST
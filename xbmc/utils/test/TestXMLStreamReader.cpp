@@ -0,0 +1,188 @@
+/*
+ *  Copyright (C) 2026 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "filesystem/File.h"
+#include "test/TestUtils.h"
+#include "utils/StringUtils.h"
+#include "utils/XBMCTinyXML.h"
+#include "utils/XMLStreamReader.h"
+#include "utils/XMLStreamWriter.h"
+#include "utils/XMLUtils.h"
+
+#include <string>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+bool WriteFile(XFILE::CFile* file, const std::string& data)
+{
+  file->Close();
+  if (!file->OpenForWrite(XBMC_TEMPFILEPATH(file), true))
+    return false;
+  const bool result = file->Write(data.c_str(), data.size()) == static_cast<ssize_t>(data.size());
+  file->Close();
+  return result;
+}
+} // unnamed namespace
+
+TEST(TestXMLStreamReader, ReadElements)
+{
+  XFILE::CFile* file;
+  ASSERT_NE(nullptr, file = XBMC_CREATETEMPFILE(".xml"));
+  ASSERT_TRUE(WriteFile(file, "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+                              "<!-- export -->\n"
+                              "<videodb>\n"
+                              "  <version>2</version>\n"
+                              "  <movie id=\"1\" note=\"a > b\"><title>One</title><empty/></movie>\n"
+                              "  <!-- <movie><title>Commented</title></movie> -->\n"
+                              "  <movie><title><![CDATA[<Two>]]></title></movie>\n"
+                              "  <paths/>\n"
+                              "</videodb>\n"));
+
+  CXMLStreamReader reader;
+  ASSERT_TRUE(reader.Open(XBMC_TEMPFILEPATH(file)));
+  EXPECT_EQ("videodb", reader.GetRootName());
+
+  CXBMCTinyXML element;
+  ASSERT_TRUE(reader.ReadNextElement(element));
+  int version = 0;
+  EXPECT_TRUE(XMLUtils::GetInt(&element, "version", version));
+  EXPECT_EQ(2, version);
+
+  ASSERT_TRUE(reader.ReadNextElement(element));
+  EXPECT_EQ("movie", element.RootElement()->ValueStr());
+  EXPECT_STREQ("a > b", element.RootElement()->Attribute("note"));
+  EXPECT_EQ("One", XMLUtils::GetString(element.RootElement(), "title"));
+
+  ASSERT_TRUE(reader.ReadNextElement(element));
+  EXPECT_EQ("<Two>", XMLUtils::GetString(element.RootElement(), "title"));
+
+  ASSERT_TRUE(reader.ReadNextElement(element));
+  EXPECT_EQ("paths", element.RootElement()->ValueStr());
+
+  EXPECT_FALSE(reader.ReadNextElement(element));
+  EXPECT_FALSE(reader.HasError());
+  EXPECT_EQ(reader.GetLength(), reader.GetPosition() + 1);
+
+  reader.Close();
+  EXPECT_TRUE(XBMC_DELETETEMPFILE(file));
+}
+
+TEST(TestXMLStreamReader, SkipElements)
+{
+  XFILE::CFile* file;
+  ASSERT_NE(nullptr, file = XBMC_CREATETEMPFILE(".xml"));
+  ASSERT_TRUE(WriteFile(file, "<musicdb><album><title>A</title></album><song><title>S</title>"
+                              "</song><artist/><song><title>T</title></song></musicdb>"));
+
+  CXMLStreamReader reader;
+  ASSERT_TRUE(reader.Open(XBMC_TEMPFILEPATH(file)));
+
+  CXBMCTinyXML element;
+  ASSERT_TRUE(reader.ReadNextElement(element, "song"));
+  EXPECT_EQ("S", XMLUtils::GetString(element.RootElement(), "title"));
+  ASSERT_TRUE(reader.ReadNextElement(element, "song"));
+  EXPECT_EQ("T", XMLUtils::GetString(element.RootElement(), "title"));
+  EXPECT_FALSE(reader.ReadNextElement(element, "song"));
+  EXPECT_FALSE(reader.HasError());
+
+  reader.Close();
+  EXPECT_TRUE(XBMC_DELETETEMPFILE(file));
+}
+
+TEST(TestXMLStreamReader, TruncatedDocument)
+{
+  XFILE::CFile* file;
+  ASSERT_NE(nullptr, file = XBMC_CREATETEMPFILE(".xml"));
+  ASSERT_TRUE(WriteFile(file, "<videodb><movie><title>One</title></movie><movie><title>Tw"));
+
+  CXMLStreamReader reader;
+  ASSERT_TRUE(reader.Open(XBMC_TEMPFILEPATH(file)));
+
+  CXBMCTinyXML element;
+  EXPECT_TRUE(reader.ReadNextElement(element));
+  EXPECT_FALSE(reader.ReadNextElement(element));
+  EXPECT_TRUE(reader.HasError());
+
+  reader.Close();
+  EXPECT_TRUE(XBMC_DELETETEMPFILE(file));
+}
+
+TEST(TestXMLStreamReader, WriteAndReadLargeDocument)
+{
+  XFILE::CFile* file;
+  ASSERT_NE(nullptr, file = XBMC_CREATETEMPFILE(".xml"));
+  file->Close();
+
+  // large enough to span several read chunks
+  constexpr int count = 5000;
+  const std::string plot(100, 'x');
+
+  CXMLStreamWriter writer;
+  ASSERT_TRUE(writer.Open(XBMC_TEMPFILEPATH(file), "videodb"));
+  TiXmlElement root("videodb");
+  for (int i = 0; i < count; ++i)
+  {
+    TiXmlElement movie("movie");
+    TiXmlNode* node = root.InsertEndChild(movie);
+    XMLUtils::SetInt(node, "id", i);
+    XMLUtils::SetString(node, "plot", plot);
+    EXPECT_TRUE(writer.Flush(root));
+    EXPECT_EQ(nullptr, root.FirstChild());
+  }
+  EXPECT_TRUE(writer.Close());
+  EXPECT_GT(writer.GetBytesWritten(), static_cast<uint64_t>(count * plot.size()));
+
+  CXMLStreamReader reader;
+  ASSERT_TRUE(reader.Open(XBMC_TEMPFILEPATH(file)));
+  EXPECT_EQ("videodb", reader.GetRootName());
+  EXPECT_EQ(writer.GetBytesWritten(), reader.GetLength());
+
+  CXBMCTinyXML element;
+  int read = 0;
+  while (reader.ReadNextElement(element))
+  {
+    int id = -1;
+    EXPECT_TRUE(XMLUtils::GetInt(element.RootElement(), "id", id));
+    EXPECT_EQ(read, id);
+    read++;
+  }
+  EXPECT_FALSE(reader.HasError());
+  EXPECT_EQ(count, read);
+
+  reader.Close();
+  EXPECT_TRUE(XBMC_DELETETEMPFILE(file));
+}
+
+TEST(TestXMLStreamReader, UnclosedDocumentIsDeleted)
+{
+  XFILE::CFile* file;
+  ASSERT_NE(nullptr, file = XBMC_CREATETEMPFILE(".xml"));
+  file->Close();
+  const std::string path = XBMC_TEMPFILEPATH(file);
+
+  {
+    // e.g. an export which has been cancelled half way
+    CXMLStreamWriter writer;
+    ASSERT_TRUE(writer.Open(path, "videodb"));
+    TiXmlElement root("videodb");
+    TiXmlElement movie("movie");
+    root.InsertEndChild(movie);
+    EXPECT_TRUE(writer.Flush(root));
+  }
+  EXPECT_FALSE(XFILE::CFile::Exists(path));
+
+  CXMLStreamWriter writer;
+  ASSERT_TRUE(writer.Open(path, "videodb"));
+  writer.Abort();
+  EXPECT_FALSE(writer.IsOpen());
+  EXPECT_FALSE(XFILE::CFile::Exists(path));
+
+  XBMC_DELETETEMPFILE(file);
+}
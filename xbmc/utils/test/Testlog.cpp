@@ -92,3 +92,36 @@ TEST_F(Testlog, SetLogLevel)
   CServiceBroker::GetLogging().Deinitialize();
   EXPECT_TRUE(XFILE::CFile::Delete(logfile));
 }
+
+TEST_F(Testlog, AsyncLogging)
+{
+  std::string logfile, logstring;
+  char buf[100];
+  ssize_t bytesread;
+  XFILE::CFile file;
+
+  std::string appName = CCompileInfo::GetAppName();
+  StringUtils::ToLower(appName);
+  logfile = CSpecialProtocol::TranslatePath("special://temp/") + appName + ".log";
+  CServiceBroker::GetLogging().SetAsyncLogging(true, 1024, LogOverflowPolicy::BLOCK);
+  CServiceBroker::GetLogging().Initialize(CSpecialProtocol::TranslatePath("special://temp/"));
+
+  for (int i = 0; i < 100; ++i)
+    CLog::Log(LOGINFO, "async log message {}", i);
+  CServiceBroker::GetLogging().Deinitialize();
+  CServiceBroker::GetLogging().SetAsyncLogging(false, 0, LogOverflowPolicy::DROP);
+  EXPECT_EQ(0u, CServiceBroker::GetLogging().GetStats().dropped);
+
+  // everything queued is written when the log is closed
+  EXPECT_TRUE(file.Open(logfile));
+  while ((bytesread = file.Read(buf, sizeof(buf) - 1)) > 0)
+  {
+    buf[bytesread] = '\0';
+    logstring.append(buf);
+  }
+  file.Close();
+  EXPECT_NE(std::string::npos, logstring.find("async log message 0"));
+  EXPECT_NE(std::string::npos, logstring.find("async log message 99"));
+
+  EXPECT_TRUE(XFILE::CFile::Delete(logfile));
+}
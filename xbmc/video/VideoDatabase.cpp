@@ -14,6 +14,7 @@
 #include "GUIPassword.h"
 #include "ServiceBroker.h"
 #include "TextureCache.h"
+#include "TextureExportQueue.h"
 #include "URL.h"
 #include "Util.h"
 #include "VideoInfoScanner.h"
@@ -54,6 +55,8 @@
 #include "utils/StringUtils.h"
 #include "utils/URIUtils.h"
 #include "utils/Variant.h"
+#include "utils/XMLStreamReader.h"
+#include "utils/XMLStreamWriter.h"
 #include "utils/XMLUtils.h"
 #include "utils/i18n/TableLanguageCodes.h"
 #include "utils/log.h"
@@ -300,6 +303,60 @@ int CVideoDatabase::RunQuery(const std::string &sql)
   return rows;
 }
 
+bool CVideoDatabase::ApplySortAndLimit(const MediaType& mediaType,
+                                       const std::string& strSQL,
+                                       const Filter& filter,
+                                       const SortDescription& sorting,
+                                       std::string& strSQLExtra,
+                                       int& total)
+{
+  if (!filter.limit.empty())
+    return false;
+
+  std::string order;
+  if (sorting.sortBy == SortBy::NONE)
+  {
+    // no special sorting, only apply the limiting
+    if (sorting.limitStart <= 0 && sorting.limitEnd <= 0 &&
+        (sorting.limitStart != 0 || sorting.limitEnd != 0))
+      return false;
+  }
+  else
+  {
+    // Without a limit all rows have to be fetched anyway, leave the sorting to SortUtils then
+    // as it breaks ties on the sort value by label
+    if (!filter.order.empty() || (sorting.limitStart <= 0 && sorting.limitEnd <= 0))
+      return false;
+
+    FieldList fields;
+    if (!SortUtils::GetFieldsForSQLSort(mediaType, sorting.sortBy, fields))
+      return false;
+
+    std::vector<std::string> orderFields;
+    for (const auto& field : fields)
+    {
+      std::string name = DatabaseUtils::GetField(field, mediaType, DatabaseQueryPart::ORDER_BY);
+      if (name.empty())
+        return false;
+
+      if (field == Field::RANDOM)
+        name = PrepareSQL(name); // Adjusts syntax for MySQL
+      else if (field == Field::RATING || field == Field::VOTES || field == Field::USER_RATING ||
+               field == Field::PLAYCOUNT)
+        name = "COALESCE(" + name + ", 0)"; // SortUtils treats missing values as 0
+
+      if (sorting.sortOrder == SortOrder::DESCENDING)
+        name += " DESC";
+      orderFields.emplace_back(std::move(name));
+    }
+    order = " ORDER BY " + StringUtils::Join(orderFields, ", ");
+  }
+
+  total = GetSingleValueInt(PrepareSQL(strSQL, "COUNT(1)") + strSQLExtra, *m_pDS);
+  strSQLExtra += order + DatabaseUtils::BuildLimitClause(sorting.limitEnd, sorting.limitStart);
+  return true;
+}
+
 bool CVideoDatabase::GetSubPaths(const std::string &basepath, std::vector<std::pair<int, std::string>>& subpaths)
 {
   std::string sql;
@@ -7466,13 +7523,7 @@ bool CVideoDatabase::GetSeasonsByWhere(const std::string& strBaseDir, const Filt
       return false;
 
     // Apply the limiting directly here if there's no special sorting but limiting
-    if (extFilter.limit.empty() && sorting.sortBy == SortBy::NONE &&
-        (sorting.limitStart > 0 || sorting.limitEnd > 0 ||
-         (sorting.limitStart == 0 && sorting.limitEnd == 0)))
-    {
-      total = GetSingleValueInt(PrepareSQL(strSQL, "COUNT(1)") + strSQLExtra, *m_pDS);
-      strSQLExtra += DatabaseUtils::BuildLimitClause(sorting.limitEnd, sorting.limitStart);
-    }
+    ApplySortAndLimit(MediaTypeSeason, strSQL, extFilter, sorting, strSQLExtra, total);
 
     strSQL = PrepareSQL(strSQL, !extFilter.fields.empty() ? extFilter.fields.c_str() : "*") + strSQLExtra;
 
@@ -7817,14 +7868,9 @@ bool CVideoDatabase::GetMoviesByWhere(const std::string& strBaseDir, const Filte
     if (!CDatabase::BuildSQL(strSQLExtra, extFilter, strSQLExtra))
       return false;
 
-    // Apply the limiting directly here if there's no special sorting but limiting
-    if (extFilter.limit.empty() && sorting.sortBy == SortBy::NONE &&
-        (sorting.limitStart > 0 || sorting.limitEnd > 0 ||
-         (sorting.limitStart == 0 && sorting.limitEnd == 0)))
-    {
-      total = GetSingleValueInt(PrepareSQL(strSQL, "COUNT(1)") + strSQLExtra, *m_pDS);
-      strSQLExtra += DatabaseUtils::BuildLimitClause(sorting.limitEnd, sorting.limitStart);
-    }
+    // Apply the sorting and limiting directly here if the database can do it
+    const bool sortedInSQL =
+        ApplySortAndLimit(MediaTypeMovie, strSQL, extFilter, sorting, strSQLExtra, total);
 
     strSQL = PrepareSQL(strSQL, !extFilter.fields.empty() ? extFilter.fields.c_str() : "*") + strSQLExtra;
 
@@ -7838,10 +7884,18 @@ bool CVideoDatabase::GetMoviesByWhere(const std::string& strBaseDir, const Filte
     if (iRowsFound <= 0)
       return iRowsFound == 0;
 
+    // the page returned by the database only needs to be put in the final order
+    SortDescription sortingInMemory{sortDescription};
+    if (sortedInSQL)
+    {
+      sortingInMemory.limitStart = 0;
+      sortingInMemory.limitEnd = -1;
+    }
+
     DatabaseResults results;
     results.reserve(iRowsFound);
 
-    if (!SortUtils::SortFromDataset(sortDescription, MediaTypeMovie, *m_pDS, results))
+    if (!SortUtils::SortFromDataset(sortingInMemory, MediaTypeMovie, *m_pDS, results))
       return false;
 
     // get data from returned rows
@@ -7963,14 +8017,9 @@ bool CVideoDatabase::GetTvShowsByWhere(const std::string& strBaseDir, const Filt
     if (!BuildSQL(strBaseDir, strSQLExtra, extFilter, strSQLExtra, videoUrl, sorting))
       return false;
 
-    // Apply the limiting directly here if there's no special sorting but limiting
-    if (extFilter.limit.empty() && sorting.sortBy == SortBy::NONE &&
-        (sorting.limitStart > 0 || sorting.limitEnd > 0 ||
-         (sorting.limitStart == 0 && sorting.limitEnd == 0)))
-    {
-      total = GetSingleValueInt(PrepareSQL(strSQL, "COUNT(1)") + strSQLExtra, *m_pDS);
-      strSQLExtra += DatabaseUtils::BuildLimitClause(sorting.limitEnd, sorting.limitStart);
-    }
+    // Apply the sorting and limiting directly here if the database can do it
+    const bool sortedInSQL =
+        ApplySortAndLimit(MediaTypeTvShow, strSQL, extFilter, sorting, strSQLExtra, total);
 
     strSQL = PrepareSQL(strSQL, !extFilter.fields.empty() ? extFilter.fields.c_str() : "*") + strSQLExtra;
 
@@ -7984,9 +8033,17 @@ bool CVideoDatabase::GetTvShowsByWhere(const std::string& strBaseDir, const Filt
     if (iRowsFound <= 0)
       return iRowsFound == 0;
 
+    // the page returned by the database only needs to be put in the final order
+    SortDescription sortingInMemory{sorting};
+    if (sortedInSQL)
+    {
+      sortingInMemory.limitStart = 0;
+      sortingInMemory.limitEnd = -1;
+    }
+
     DatabaseResults results;
     results.reserve(iRowsFound);
-    if (!SortUtils::SortFromDataset(sorting, MediaTypeTvShow, *m_pDS, results))
+    if (!SortUtils::SortFromDataset(sortingInMemory, MediaTypeTvShow, *m_pDS, results))
       return false;
 
     // get data from returned rows
@@ -8092,14 +8149,9 @@ bool CVideoDatabase::GetEpisodesByWhere(const std::string& strBaseDir, const Fil
     if (!BuildSQL(strBaseDir, strSQLExtra, extFilter, strSQLExtra, videoUrl, sorting))
       return false;
 
-    // Apply the limiting directly here if there's no special sorting but limiting
-    if (extFilter.limit.empty() && sorting.sortBy == SortBy::NONE &&
-        (sorting.limitStart > 0 || sorting.limitEnd > 0 ||
-         (sorting.limitStart == 0 && sorting.limitEnd == 0)))
-    {
-      total = GetSingleValueInt(PrepareSQL(strSQL, "COUNT(1)") + strSQLExtra, *m_pDS);
-      strSQLExtra += DatabaseUtils::BuildLimitClause(sorting.limitEnd, sorting.limitStart);
-    }
+    // Apply the sorting and limiting directly here if the database can do it
+    const bool sortedInSQL =
+        ApplySortAndLimit(MediaTypeEpisode, strSQL, extFilter, sorting, strSQLExtra, total);
 
     strSQL = PrepareSQL(strSQL, !extFilter.fields.empty() ? extFilter.fields.c_str() : "*") + strSQLExtra;
 
@@ -8113,9 +8165,17 @@ bool CVideoDatabase::GetEpisodesByWhere(const std::string& strBaseDir, const Fil
     if (iRowsFound <= 0)
       return iRowsFound == 0;
 
+    // the page returned by the database only needs to be put in the final order
+    SortDescription sortingInMemory{sorting};
+    if (sortedInSQL)
+    {
+      sortingInMemory.limitStart = 0;
+      sortingInMemory.limitEnd = -1;
+    }
+
     DatabaseResults results;
     results.reserve(iRowsFound);
-    if (!SortUtils::SortFromDataset(sorting, MediaTypeEpisode, *m_pDS, results))
+    if (!SortUtils::SortFromDataset(sortingInMemory, MediaTypeEpisode, *m_pDS, results))
       return false;
 
     // get data from returned rows
@@ -9074,14 +9134,9 @@ bool CVideoDatabase::GetMusicVideosByWhere(const std::string &baseDir, const Fil
     if (!BuildSQL(baseDir, strSQLExtra, extFilter, strSQLExtra, videoUrl, sorting))
       return false;
 
-    // Apply the limiting directly here if there's no special sorting but limiting
-    if (extFilter.limit.empty() && sorting.sortBy == SortBy::NONE &&
-        (sorting.limitStart > 0 || sorting.limitEnd > 0 ||
-         (sorting.limitStart == 0 && sorting.limitEnd == 0)))
-    {
-      total = GetSingleValueInt(PrepareSQL(strSQL, "COUNT(1)") + strSQLExtra, *m_pDS);
-      strSQLExtra += DatabaseUtils::BuildLimitClause(sorting.limitEnd, sorting.limitStart);
-    }
+    // Apply the sorting and limiting directly here if the database can do it
+    const bool sortedInSQL =
+        ApplySortAndLimit(MediaTypeMusicVideo, strSQL, extFilter, sorting, strSQLExtra, total);
 
     strSQL = PrepareSQL(strSQL, !extFilter.fields.empty() ? extFilter.fields.c_str() : "*") + strSQLExtra;
 
@@ -9095,9 +9150,17 @@ bool CVideoDatabase::GetMusicVideosByWhere(const std::string &baseDir, const Fil
     if (iRowsFound <= 0)
       return iRowsFound == 0;
 
+    // the page returned by the database only needs to be put in the final order
+    SortDescription sortingInMemory{sorting};
+    if (sortedInSQL)
+    {
+      sortingInMemory.limitStart = 0;
+      sortingInMemory.limitEnd = -1;
+    }
+
     DatabaseResults results;
     results.reserve(iRowsFound);
-    if (!SortUtils::SortFromDataset(sorting, MediaTypeMusicVideo, *m_pDS, results))
+    if (!SortUtils::SortFromDataset(sortingInMemory, MediaTypeMusicVideo, *m_pDS, results))
       return false;
 
     // get data from returned rows
@@ -10299,6 +10362,22 @@ void CVideoDatabase::ExportToXML(const std::string &path, bool singleFile /* = t
       CDirectory::Create(tvshowsDir);
     }
 
+    // the single file export is written incrementally, each item is flushed once it's complete
+    CXMLStreamWriter xmlWriter;
+    if (singleFile && !xmlWriter.Open(xmlFile, "videodb"))
+    {
+      CGUIDialogKaiToast::QueueNotification(
+          CGUIDialogKaiToast::Error,
+          CServiceBroker::GetResourcesComponent().GetLocalizeStrings().Get(20302),
+          CURL::GetRedacted(xmlFile));
+      return;
+    }
+
+    // artwork is copied out of the texture cache in the background
+    CTextureExportQueue artQueue;
+    const auto startTime = std::chrono::steady_clock::now();
+    unsigned int itemCount = 0;
+
     // Need this due to query clashes in GetFile/GetPath
     std::unique_ptr<Dataset> pDS3;
     pDS3.reset(m_pDB->CreateDataset());
@@ -10355,6 +10434,7 @@ void CVideoDatabase::ExportToXML(const std::string &path, bool singleFile /* = t
       TiXmlElement xmlMainElement("videodb");
       pMain = xmlDoc.InsertEndChild(xmlMainElement);
       XMLUtils::SetInt(pMain,"version", GetExportVersion());
+      xmlWriter.Flush(*pMain);
     }
 
     // Save information for each version
@@ -10421,6 +10501,7 @@ void CVideoDatabase::ExportToXML(const std::string &path, bool singleFile /* = t
         }
         else
           movie.Save(pMain, "movie", singleFile);
+        itemCount++;
 
         if (progress)
         {
@@ -10488,19 +10569,21 @@ void CVideoDatabase::ExportToXML(const std::string &path, bool singleFile /* = t
           for (const auto& [type, url] : artwork)
           {
             std::string savedThumb = ART::GetLocalArt(item, type, false);
-            CServiceBroker::GetTextureCache()->Export(url, savedThumb, overwrite);
+            artQueue.Export(url, savedThumb, overwrite);
             CLog::Log(LOGDEBUG, "Exported artwork '{}' to '{}' - overwrite {}", type, savedThumb,
                       overwrite);
           }
           if (actorThumbs)
-            ExportActorThumbs(actorsDir, singlePath, movie, !singleFile, overwrite);
+            ExportActorThumbs(artQueue, actorsDir, singlePath, movie, !singleFile, overwrite);
         }
 
         pDS3->next();
         current++;
       } while (!singleFile && !pDS3->eof() && versions[current - 1].hash == versions[current].hash);
 
-      if (!singleFile)
+      if (singleFile)
+        xmlWriter.Flush(*pMain);
+      else
       {
         if (CUtil::SupportsWriteFileOperations(nfoFile) &&
             (overwrite || !CFile::Exists(nfoFile, false)))
@@ -10569,6 +10652,7 @@ void CVideoDatabase::ExportToXML(const std::string &path, bool singleFile /* = t
             set.SetArt(artwork);
           }
           set.Save(pMain, "set");
+          itemCount++;
 
           // write set.nfo
           if (!singleFile && CUtil::SupportsWriteFileOperations(itemPath))
@@ -10591,7 +10675,9 @@ void CVideoDatabase::ExportToXML(const std::string &path, bool singleFile /* = t
               }
             }
           }
-          if (!singleFile)
+          if (singleFile)
+            xmlWriter.Flush(*pMain);
+          else
           {
             xmlDoc.Clear();
             TiXmlDeclaration decl1("1.0", "UTF-8", "yes");
@@ -10606,7 +10692,7 @@ void CVideoDatabase::ExportToXML(const std::string &path, bool singleFile /* = t
             for (const auto& [arttype, arturl] : aw)
             {
               const std::string savedThumb = URIUtils::AddFileToFolder(itemPath, arttype);
-              CServiceBroker::GetTextureCache()->Export(arturl, savedThumb, overwrite);
+              artQueue.Export(arturl, savedThumb, overwrite);
               CLog::Log(LOGDEBUG, "Exported artwork '{}' to '{}' - overwrite {}", arturl,
                         savedThumb, overwrite);
             }
@@ -10642,6 +10728,7 @@ void CVideoDatabase::ExportToXML(const std::string &path, bool singleFile /* = t
       }
       else
         movie.Save(pMain, "musicvideo", singleFile);
+      itemCount++;
 
       // reset old skip state
       bool bSkip = false;
@@ -10689,7 +10776,9 @@ void CVideoDatabase::ExportToXML(const std::string &path, bool singleFile /* = t
           }
         }
       }
-      if (!singleFile)
+      if (singleFile)
+        xmlWriter.Flush(*pMain);
+      else
       {
         xmlDoc.Clear();
         TiXmlDeclaration decl2("1.0", "UTF-8", "yes");
@@ -10707,7 +10796,7 @@ void CVideoDatabase::ExportToXML(const std::string &path, bool singleFile /* = t
         for (const auto& [type, url] : artwork)
         {
           const std::string savedThumb = ART::GetLocalArt(item, type, false);
-          CServiceBroker::GetTextureCache()->Export(url, savedThumb, overwrite);
+          artQueue.Export(url, savedThumb, overwrite);
           CLog::Log(LOGDEBUG, "Exported artwork '{}' to '{}' - overwrite {}", url, savedThumb,
                     overwrite);
         }
@@ -10750,6 +10839,7 @@ void CVideoDatabase::ExportToXML(const std::string &path, bool singleFile /* = t
       }
       else
         tvshow.Save(pMain, "tvshow", singleFile);
+      itemCount++;
 
       // reset old skip state
       bool bSkip = false;
@@ -10814,12 +10904,12 @@ void CVideoDatabase::ExportToXML(const std::string &path, bool singleFile /* = t
         for (const auto& [type, url] : artwork)
         {
           const std::string savedThumb = ART::GetLocalArt(item, type, true);
-          CServiceBroker::GetTextureCache()->Export(url, savedThumb, overwrite);
+          artQueue.Export(url, savedThumb, overwrite);
         }
 
         tvshowDir = tvshow.m_strPath;
         if (actorThumbs)
-          ExportActorThumbs(actorsDir, singlePath, tvshow, !singleFile, overwrite);
+          ExportActorThumbs(artQueue, actorsDir, singlePath, tvshow, !singleFile, overwrite);
 
         // export season thumbs
         for (const auto& [seasonNumber, art] : seasonArt)
@@ -10835,7 +10925,7 @@ void CVideoDatabase::ExportToXML(const std::string &path, bool singleFile /* = t
           {
             const std::string savedThumb(ART::GetLocalArt(item, seasonThumb + "-" + type, true));
             if (!art.empty())
-              CServiceBroker::GetTextureCache()->Export(url, savedThumb, overwrite);
+              artQueue.Export(url, savedThumb, overwrite);
             CLog::Log(LOGDEBUG, "Exported artwork '{}' to '{}' - overwrite {}", url, savedThumb,
                       overwrite);
           }
@@ -10864,6 +10954,7 @@ void CVideoDatabase::ExportToXML(const std::string &path, bool singleFile /* = t
         CVideoInfoTag episode{GetDetailsForEpisode(*pDS, VideoDbDetailsAll)};
         ART::Artwork episodeArtwork;
         GetArtForItem(episode.m_iDbId, MediaTypeEpisode, episodeArtwork);
+        itemCount++;
 
         if (!singleFile)
         {
@@ -10936,12 +11027,17 @@ void CVideoDatabase::ExportToXML(const std::string &path, bool singleFile /* = t
         // Write art/actor images
         if (images)
         {
-          ExportArt(fileItem, episodeArtwork, overwrite);
+          ExportArt(artQueue, fileItem, episodeArtwork, overwrite);
           if (actorThumbs)
-            ExportActorThumbs(actorsDir, singlePath, episode, !singleFile, overwrite, tvshowDir);
+            ExportActorThumbs(artQueue, actorsDir, singlePath, episode, !singleFile, overwrite,
+                              tvshowDir);
         }
       }
 
+      // the tvshow element including its episodes is complete now
+      if (singleFile)
+        xmlWriter.Flush(*pMain);
+
       pDS->close();
       pDS2->next();
       current++;
@@ -10977,8 +11073,24 @@ void CVideoDatabase::ExportToXML(const std::string &path, bool singleFile /* = t
           XMLUtils::SetString(pPath,"scraperpath", info->ID());
         }
       }
-      xmlDoc.SaveFile(xmlFile);
+      xmlWriter.Flush(*pMain);
+      if (!xmlWriter.Close())
+      {
+        CLog::Log(LOGERROR, "Video library export failed! ('{}')", xmlFile);
+        iFailCount++;
+      }
     }
+
+    artQueue.Wait();
+    const std::chrono::duration<double> elapsed{std::chrono::steady_clock::now() - startTime};
+    const double seconds = std::max(elapsed.count(), 0.001);
+    CLog::Log(LOGINFO,
+              "Video library export: {} items, {} images exported ({} skipped), {} bytes of XML "
+              "in {:.1f} s ({:.1f} items/s, {:.2f} MB/s)",
+              itemCount, artQueue.GetExportedCount(), artQueue.GetSkippedCount(),
+              xmlWriter.GetBytesWritten(), elapsed.count(), itemCount / seconds,
+              xmlWriter.GetBytesWritten() / 1048576.0 / seconds);
+
     CVariant data;
 
     CLog::LogF(LOGDEBUG, "... Finished");
@@ -11009,7 +11121,8 @@ void CVideoDatabase::ExportToXML(const std::string &path, bool singleFile /* = t
             CServiceBroker::GetResourcesComponent().GetLocalizeStrings().Get(15011), iFailCount)});
 }
 
-void CVideoDatabase::ExportArt(const CFileItem& item,
+void CVideoDatabase::ExportArt(CTextureExportQueue& artQueue,
+                               const CFileItem& item,
                                const ART::Artwork& artwork,
                                bool overwrite) const
 {
@@ -11020,13 +11133,14 @@ void CVideoDatabase::ExportArt(const CFileItem& item,
                          item.GetProperty(MULTIPLE_EPISODES).asBoolean(false)
                              ? ART::AdditionalIdentifiers::SEASON_AND_EPISODE
                              : ART::AdditionalIdentifiers::NONE)};
-    CServiceBroker::GetTextureCache()->Export(artPath, savedThumb, overwrite);
+    artQueue.Export(artPath, savedThumb, overwrite);
     CLog::Log(LOGDEBUG, "Exported artwork '{}' to '{}' - overwrite {}", artPath, savedThumb,
               overwrite);
   }
 }
 
-void CVideoDatabase::ExportActorThumbs(const std::string& path,
+void CVideoDatabase::ExportActorThumbs(CTextureExportQueue& artQueue,
+                                       const std::string& path,
                                        const std::string& singlePath,
                                        const CVideoInfoTag& tag,
                                        bool singleFiles,
@@ -11053,7 +11167,7 @@ void CVideoDatabase::ExportActorThumbs(const std::string& path,
     if (!i.thumb.empty())
     {
       std::string thumbFile(GetSafeFile(strPath, i.strName));
-      CServiceBroker::GetTextureCache()->Export(i.thumb, thumbFile, overwrite);
+      artQueue.Export(i.thumb, thumbFile, overwrite);
       CLog::Log(LOGDEBUG, "Exported actor thumb '{}' to '{}' - overwrite {}", i.thumb, thumbFile,
                 overwrite);
     }
@@ -11070,13 +11184,12 @@ void CVideoDatabase::ImportFromXML(const std::string &path)
     if (nullptr == m_pDS)
       return;
 
-    CXBMCTinyXML xmlDoc;
-    if (!xmlDoc.LoadFile(URIUtils::AddFileToFolder(path, "videodb.xml")))
+    // the file is read one top level element at a time instead of loading it as a whole
+    const std::string xmlFile{URIUtils::AddFileToFolder(path, "videodb.xml")};
+    CXMLStreamReader reader;
+    if (!reader.Open(xmlFile))
       return;
 
-    TiXmlElement *root = xmlDoc.RootElement();
-    if (!root) return;
-
     progress = CServiceBroker::GetGUI()->GetWindowManager().GetWindow<CGUIDialogProgress>(WINDOW_DIALOG_PROGRESS);
     if (progress)
     {
@@ -11089,23 +11202,9 @@ void CVideoDatabase::ImportFromXML(const std::string &path)
       progress->ShowProgressBar(true);
     }
 
-    int iVersion = 0;
-    XMLUtils::GetInt(root, "version", iVersion);
-
-    CLog::Log(LOGINFO, "Starting import (export version = {})", iVersion);
-
-    TiXmlElement *movie = root->FirstChildElement();
+    CXBMCTinyXML xmlDoc;
+    const auto startTime = std::chrono::steady_clock::now();
     int current = 0;
-    int total = 0;
-    // first count the number of items...
-    while (movie)
-    {
-      if (StringUtils::CompareNoCase(movie->Value(), MediaTypeMovie, 5) == 0 ||
-          StringUtils::CompareNoCase(movie->Value(), MediaTypeTvShow, 6) == 0 ||
-          StringUtils::CompareNoCase(movie->Value(), MediaTypeMusicVideo, 10) == 0)
-        total++;
-      movie = movie->NextSiblingElement();
-    }
 
     std::string actorsDir(URIUtils::AddFileToFolder(path, "actors"));
     std::string moviesDir(URIUtils::AddFileToFolder(path, "movies"));
@@ -11113,9 +11212,11 @@ void CVideoDatabase::ImportFromXML(const std::string &path)
     std::string musicvideosDir(URIUtils::AddFileToFolder(path, "musicvideos"));
     std::string tvshowsDir(URIUtils::AddFileToFolder(path, "tvshows"));
     CVideoInfoScanner scanner;
-    // add paths first (so we have scraper settings available)
-    TiXmlElement* pathElem = root->FirstChildElement("paths");
-    pathElem = pathElem->FirstChildElement();
+    // add paths first (so we have scraper settings available), they are exported last so
+    // skip over everything else
+    const TiXmlElement* pathElem = nullptr;
+    if (reader.ReadNextElement(xmlDoc, "paths"))
+      pathElem = xmlDoc.RootElement()->FirstChildElement();
     while (pathElem)
     {
       std::string strPath;
@@ -11141,14 +11242,24 @@ void CVideoDatabase::ImportFromXML(const std::string &path)
       }
       pathElem = pathElem->NextSiblingElement();
     }
-    movie = root->FirstChildElement();
+
+    if (!reader.Open(xmlFile))
+      return;
+
     std::string lastTitle;
     int lastMovieId{-1};
     KODI::REGEXP::RegExpCache regexpCache;
-    while (movie)
+    while (reader.ReadNextElement(xmlDoc))
     {
+      const TiXmlElement* movie = xmlDoc.RootElement();
       std::string currentTitle{};
-      if (StringUtils::CompareNoCase(movie->Value(), MediaTypeMovie, 5) == 0)
+      if (movie->ValueStr() == "version")
+      {
+        int iVersion = 0;
+        XMLUtils::GetInt(&xmlDoc, "version", iVersion);
+        CLog::Log(LOGINFO, "Starting import (export version = {})", iVersion);
+      }
+      else if (StringUtils::CompareNoCase(movie->Value(), MediaTypeMovie, 5) == 0)
       {
         CVideoInfoTag info;
         info.Load(movie);
@@ -11255,7 +11366,7 @@ void CVideoDatabase::ImportFromXML(const std::string &path)
         }
         current++;
         // now load the episodes
-        TiXmlElement *episode = movie->FirstChildElement("episodedetails");
+        const TiXmlElement* episode = movie->FirstChildElement("episodedetails");
         while (episode)
         {
           // no need to delete the episode info, due to the above deletion
@@ -11281,10 +11392,9 @@ void CVideoDatabase::ImportFromXML(const std::string &path)
         currentTitle = info.GetTitle();
         current++;
       }
-      movie = movie->NextSiblingElement();
-      if (progress && total)
+      if (progress && reader.GetLength() > 0)
       {
-        progress->SetPercentage(current * 100 / total);
+        progress->SetPercentage(static_cast<int>(reader.GetPosition() * 100 / reader.GetLength()));
         progress->SetLine(2, CVariant{currentTitle});
         progress->Progress();
         if (progress->IsCanceled())
@@ -11294,6 +11404,15 @@ void CVideoDatabase::ImportFromXML(const std::string &path)
         }
       }
     }
+
+    if (reader.HasError())
+      CLog::Log(LOGERROR, "Video library import from '{}' is incomplete", xmlFile);
+
+    const std::chrono::duration<double> elapsed{std::chrono::steady_clock::now() - startTime};
+    CLog::Log(LOGINFO,
+              "Video library import: {} items, {} bytes of XML in {:.1f} s ({:.1f} items/s)",
+              current, reader.GetPosition(), elapsed.count(),
+              current / std::max(elapsed.count(), 0.001));
   }
   catch (...)
   {
@@ -35,6 +35,7 @@ class CStreamDetails;
 class CVideoSettings;
 class CGUIDialogProgress;
 class CGUIDialogProgressBarHandle;
+class CTextureExportQueue;
 class TiXmlNode;
 
 struct VideoAssetInfo;
@@ -774,8 +775,12 @@ public:
   void UpdateFileDateAdded(CVideoInfoTag& details);
 
   void ExportToXML(const std::string &path, bool singleFile = true, bool images=false, bool actorThumbs=false, bool overwrite=false);
-  void ExportArt(const CFileItem& item, const KODI::ART::Artwork& artwork, bool overwrite) const;
-  void ExportActorThumbs(const std::string& path,
+  void ExportArt(CTextureExportQueue& artQueue,
+                 const CFileItem& item,
+                 const KODI::ART::Artwork& artwork,
+                 bool overwrite) const;
+  void ExportActorThumbs(CTextureExportQueue& artQueue,
+                         const std::string& path,
                          const std::string& singlePath,
                          const CVideoInfoTag& tag,
                          bool singleFiles,
@@ -1187,6 +1192,25 @@ private:
    */
   int RunQuery(const std::string &sql);
 
+  /*! \brief Apply the sorting and limiting of a library listing in SQL where possible
+   Limits are applied in SQL if no sorting is requested, or if only a page of the results is
+   requested and the sort method can be expressed in SQL. All other sort methods (e.g. by label
+   ignoring articles) are left to SortUtils::SortFromDataset() on the complete result set.
+   \param mediaType the media type of the listing
+   \param strSQL the query of the listing with a placeholder for the selected fields
+   \param filter the filter of the listing
+   \param sorting the requested sorting and limits
+   \param strSQLExtra the clauses of the listing, ORDER BY and LIMIT clauses are appended to it
+   \param total set to the total number of items in the listing if the limits are applied
+   \return true if sorting and limits have been applied in SQL, false otherwise
+   */
+  bool ApplySortAndLimit(const MediaType& mediaType,
+                         const std::string& strSQL,
+                         const Filter& filter,
+                         const SortDescription& sorting,
+                         std::string& strSQLExtra,
+                         int& total);
+
   void AppendIdLinkFilter(const char* field,
                           const char* table,
                           const MediaType& mediaType,
@@ -12,6 +12,8 @@
 #include "FileItemList.h"
 #include "GUIInfoManager.h"
 #include "GUIUserMessages.h"
+#include "InfoScannerWorkerPool.h"
+#include "LibraryChangeJournal.h"
 #include "ServiceBroker.h"
 #include "SetInfoTag.h"
 #include "TextureCache.h"
@@ -42,12 +44,14 @@
 #include "settings/SettingsComponent.h"
 #include "tags/SetInfoTagLoaderFactory.h"
 #include "tags/VideoInfoTagLoaderFactory.h"
+#include "threads/Event.h"
 #include "utils/ArtUtils.h"
 #include "utils/Digest.h"
 #include "utils/DiscsUtils.h"
 #include "utils/EpisodeUtils.h"
 #include "utils/FileExtensionProvider.h"
 #include "utils/RegExp.h"
+#include "utils/StreamDetails.h"
 #include "utils/StringUtils.h"
 #include "utils/URIUtils.h"
 #include "utils/Variant.h"
@@ -78,6 +82,9 @@ using KODI::UTILITY::CDigest;
 
 namespace
 {
+// Upper bound for directory listings read ahead of the scan
+constexpr size_t MAX_PREFETCHED_DIRECTORIES = 256;
+
 /*! \brief Retrieve the art type for an image from the given size.
  \param width the width of the image.
  \param height the height of the image.
@@ -171,6 +178,19 @@ void OnDirectoryScanned(const std::string& strDirectory)
 namespace KODI::VIDEO
 {
 
+struct CVideoInfoScanner::DirectoryListing : CInfoScannerPrefetch
+{
+  std::string fastHash;
+  CFileItemList items;
+  bool listed{false};
+};
+
+struct CVideoInfoScanner::StreamDetailsProbe : CInfoScannerPrefetch
+{
+  CStreamDetails details;
+  bool found{false};
+};
+
 CVideoInfoScanner::CVideoInfoScanner()
   : m_advancedSettings(CServiceBroker::GetSettingsComponent()->GetAdvancedSettings())
 {
@@ -226,6 +246,17 @@ CVideoInfoScanner::~CVideoInfoScanner()
 
       m_database.Open();
 
+      // watch local sources, so the next update only needs to look at folders that changed
+      CLibraryChangeJournal& journal = CServiceBroker::GetLibraryChangeJournal();
+      for (const auto& path : m_pathsToScan)
+        journal.Watch(path);
+
+      // Directory listings and media probing are latency bound on network shares, run them on a
+      // pool of workers. The database is only written from this thread.
+      m_workers = std::make_unique<CInfoScannerWorkerPool>(
+          "VideoScanWorker", m_advancedSettings->m_videoLibraryScannerThreads,
+          m_advancedSettings->m_videoLibraryScannerThreadsPerShare);
+
       m_bCanInterrupt = true;
 
       CLog::Log(LOGINFO, "VideoInfoScanner: Starting scan ..");
@@ -279,6 +310,11 @@ CVideoInfoScanner::~CVideoInfoScanner()
         }
       }
 
+      m_workers.reset();
+      m_prefetchedDirs.clear();
+      m_streamDetailsProbes.clear();
+      journal.Save();
+
       CServiceBroker::GetGUI()->GetInfoManager().GetInfoProviders().GetLibraryInfoProvider().ResetLibraryBools();
       m_database.Close();
 
@@ -291,6 +327,9 @@ CVideoInfoScanner::~CVideoInfoScanner()
     catch (...)
     {
       CLog::Log(LOGERROR, "VideoInfoScanner: Exception while scanning.");
+      m_workers.reset();
+      m_prefetchedDirs.clear();
+      m_streamDetailsProbes.clear();
     }
 
     m_bRunning = false;
@@ -377,15 +416,19 @@ CVideoInfoScanner::~CVideoInfoScanner()
         content == ContentType::TVSHOWS ? m_advancedSettings->m_tvshowExcludeFromScanRegExps
                                         : m_advancedSettings->m_moviesExcludeFromScanRegExps;
 
-    if (CUtil::ExcludeFileOrFolder(strDirectory, regexps, &m_regexpCache))
-      return true;
-
-    if (HasNoMedia(strDirectory))
+    if (CUtil::ExcludeFileOrFolder(strDirectory, regexps, &m_regexpCache) ||
+        HasNoMedia(strDirectory))
+    {
+      ReleasePrefetchedListing(strDirectory);
       return true;
+    }
 
     bool ignoreFolder = !m_scanAll && settings.noupdate;
     if (content == ContentType::NONE || ignoreFolder)
+    {
+      ReleasePrefetchedListing(strDirectory);
       return true;
+    }
 
     if (URIUtils::IsPlugin(strDirectory) && !CPluginDirectory::IsMediaLibraryScanningAllowed(TranslateContent(content), strDirectory))
     {
@@ -396,6 +439,10 @@ CVideoInfoScanner::~CVideoInfoScanner()
       return true;
     }
 
+    CLibraryChangeJournal& journal = CServiceBroker::GetLibraryChangeJournal();
+    const uint64_t sequence = journal.GetSequence();
+    bool unchanged = false;
+
     std::string hash, dbHash;
     if (content == ContentType::MOVIES || content == ContentType::MUSICVIDEOS)
     {
@@ -407,38 +454,51 @@ CVideoInfoScanner::~CVideoInfoScanner()
       }
 
       std::string fastHash;
-      if (m_advancedSettings->m_bVideoLibraryUseFastHash && !URIUtils::IsPlugin(strDirectory))
-        fastHash = GetFastHash(strDirectory, regexps);
-
-      if (m_database.GetPathHash(strDirectory, dbHash) && !fastHash.empty() && StringUtils::EqualsNoCase(fastHash, dbHash))
-      { // fast hashes match - no need to process anything
-        hash = fastHash;
+      CLibraryChangeJournal::DirectoryState state;
+      if (m_database.GetPathHash(strDirectory, dbHash) && journal.GetUnchanged(strDirectory, state) &&
+          StringUtils::EqualsNoCase(state.hash, dbHash))
+      { // not changed since it was last scanned - no need to touch the folder
+        hash = dbHash;
+        unchanged = true;
+        for (const auto& subdirectory : state.subdirectories)
+          items.Add(std::make_shared<CFileItem>(subdirectory, true));
       }
       else
-      { // need to fetch the folder
-        CDirectory::GetDirectory(strDirectory, items, CServiceBroker::GetFileExtensionProvider().GetVideoExtensions(),
-                                 DIR_FLAG_DEFAULTS);
-        // do not consider inner folders with .nomedia
-        items.erase(std::remove_if(items.begin(), items.end(), [](const CFileItemPtr& item)
-                                   { return item->IsFolder() && HasNoMedia(item->GetPath()); }),
-                    items.end());
-        items.Stack();
+      {
+        // the fast hash and listing may have been read ahead when scanning the parent folder
+        const std::shared_ptr<DirectoryListing> listing = GetPrefetchedListing(strDirectory);
+        if (m_bStop)
+          return false;
 
-        // force sorting consistency to avoid hash mismatch between platforms
-        // sort by filename as always present for any files, but keep case sensitivity
-        items.Sort(SortBy::FILE, SortOrder::ASCENDING, SortAttributeNone);
+        if (listing)
+          fastHash = listing->fastHash;
+        else if (m_advancedSettings->m_bVideoLibraryUseFastHash && !URIUtils::IsPlugin(strDirectory))
+          fastHash = GetFastHash(strDirectory, regexps);
 
-        // check whether to re-use previously computed fast hash
-        if (!CanFastHash(items, regexps) || fastHash.empty())
-          GetPathHash(items, hash);
-        else
+        if (!fastHash.empty() && StringUtils::EqualsNoCase(fastHash, dbHash))
+        { // fast hashes match - no need to process anything
           hash = fastHash;
+        }
+        else
+        { // need to fetch the folder
+          if (listing && listing->listed)
+            items.Assign(listing->items);
+          else
+            GetMediaDirectory(strDirectory, items);
+
+          // check whether to re-use previously computed fast hash
+          if (!CanFastHash(items, regexps) || fastHash.empty())
+            GetPathHash(items, hash);
+          else
+            hash = fastHash;
+        }
       }
 
       if (StringUtils::EqualsNoCase(hash, dbHash))
       { // hash matches - skipping
         CLog::Log(LOGDEBUG, "VideoInfoScanner: Skipping dir '{}' due to no change{}",
-                  CURL::GetRedacted(strDirectory), !fastHash.empty() ? " (fasthash)" : "");
+                  CURL::GetRedacted(strDirectory),
+                  unchanged ? " (journal)" : (!fastHash.empty() ? " (fasthash)" : ""));
         bSkip = true;
       }
       else if (hash.empty())
@@ -494,6 +554,10 @@ CVideoInfoScanner::~CVideoInfoScanner()
         items.SetPath(URIUtils::GetParentPath(item->GetPath()));
       }
     }
+
+    // the folder wasn't listed, e.g. as it's unchanged according to the journal
+    ReleasePrefetchedListing(strDirectory);
+
     bool foundSomething = false;
     if (!bSkip)
     {
@@ -523,9 +587,26 @@ CVideoInfoScanner::~CVideoInfoScanner()
       m_database.SetPathHash(strDirectory, hash);
     }
 
+    if (!unchanged && !m_bStop && !hash.empty() &&
+        (content == ContentType::MOVIES || content == ContentType::MUSICVIDEOS))
+    {
+      CLibraryChangeJournal::DirectoryState scanned{hash};
+      for (const auto& pItem : items)
+      {
+        if (pItem->IsFolder() && !pItem->IsParentFolder() && !PLAYLIST::IsPlayList(*pItem))
+          scanned.subdirectories.emplace_back(pItem->GetPath());
+      }
+      journal.SetScanned(strDirectory, sequence, std::move(scanned));
+    }
+
     if (m_handle)
       OnDirectoryScanned(strDirectory);
 
+    // start reading the subfolders while this one is processed
+    if (!m_bStop && (content == ContentType::MOVIES || content == ContentType::MUSICVIDEOS) &&
+        settings.recurse > 0)
+      PrefetchDirectories(items, regexps);
+
     for (int i = 0; i < items.Size(); ++i)
     {
       CFileItemPtr pItem = items[i];
@@ -646,6 +727,9 @@ CVideoInfoScanner::~CVideoInfoScanner()
 
     m_database.Open();
 
+    if (content == ContentType::MOVIES || content == ContentType::MUSICVIDEOS)
+      PrefetchStreamDetails(items, content);
+
     bool FoundSomeInfo = false;
     std::vector<int> seenPaths;
     seenPaths.reserve(items.Size());
@@ -750,6 +834,11 @@ CVideoInfoScanner::~CVideoInfoScanner()
     if(pDlgProgress)
       pDlgProgress->ShowProgressBar(false);
 
+    // results of probes for items that weren't added aren't needed anymore
+    for (const auto& [path, probe] : m_streamDetailsProbes)
+      probe->Start();
+    m_streamDetailsProbes.clear();
+
     m_database.Close();
     return FoundSomeInfo;
   }
@@ -1247,6 +1336,9 @@ CVideoInfoScanner::~CVideoInfoScanner()
       if (HasNoMedia(item->GetPath()))
         return true;
 
+      CLibraryChangeJournal& journal = CServiceBroker::GetLibraryChangeJournal();
+      const uint64_t sequence = journal.GetSequence();
+
       std::string hash, dbHash;
       bool allowEmptyHash = false;
       if (item->IsPlugin())
@@ -1259,6 +1351,9 @@ CVideoInfoScanner::~CVideoInfoScanner()
           allowEmptyHash = true;
         }
       }
+      else if (m_database.GetPathHash(item->GetPath(), dbHash) &&
+               IsTreeUnchanged(item->GetPath(), dbHash))
+        hash = dbHash; // no folder of the show changed since it was last scanned
       else if (m_advancedSettings->m_bVideoLibraryUseFastHash)
         hash = GetRecursiveFastHash(item->GetPath(), regexps);
 
@@ -1276,9 +1371,16 @@ CVideoInfoScanner::~CVideoInfoScanner()
           flags |= DIR_FLAG_NO_FILE_INFO;
 
         // Listing that ignores files inside and below folders containing .nomedia files.
+        std::vector<std::string> folders;
         CDirectory::EnumerateDirectory(
             item->GetPath(), [&items](const std::shared_ptr<CFileItem>& item) { items.Add(item); },
-            [](const std::shared_ptr<CFileItem>& folder) { return !HasNoMedia(folder->GetPath()); },
+            [&folders](const std::shared_ptr<CFileItem>& folder)
+            {
+              if (HasNoMedia(folder->GetPath()))
+                return false;
+              folders.emplace_back(folder->GetPath());
+              return true;
+            },
             true, CServiceBroker::GetFileExtensionProvider().GetVideoExtensions(), flags);
 
         // fast hash failed - compute slow one
@@ -1294,6 +1396,11 @@ CVideoInfoScanner::~CVideoInfoScanner()
             bSkip = true;
           }
         }
+
+        // the show is unchanged as long as none of its folders changes
+        for (const auto& folder : folders)
+          journal.SetScanned(folder, sequence, {});
+        journal.SetScanned(item->GetPath(), sequence, {hash, std::move(folders)});
       }
 
       if (bSkip)
@@ -1594,7 +1701,8 @@ CVideoInfoScanner::~CVideoInfoScanner()
             CSettings::SETTING_MYVIDEOS_EXTRACTFLAGS) &&
         !movieDetails.HasStreamDetails())
     {
-      CDVDFileInfo::GetFileStreamDetails(pItem);
+      if (!GetProbedStreamDetails(*pItem))
+        CDVDFileInfo::GetFileStreamDetails(pItem);
       CLog::Log(LOGDEBUG, "VideoInfoScanner: Extracted filestream details from video file {}",
                 CURL::GetRedacted(path));
     }
@@ -2365,7 +2473,7 @@ CVideoInfoScanner::~CVideoInfoScanner()
   }
 
   std::string CVideoInfoScanner::GetFastHash(const std::string &directory,
-      const std::vector<std::string> &excludes) const
+      const std::vector<std::string> &excludes)
   {
     CDigest digest{CDigest::Type::MD5};
 
@@ -2387,6 +2495,183 @@ CVideoInfoScanner::~CVideoInfoScanner()
     return "";
   }
 
+  bool CVideoInfoScanner::IsTreeUnchanged(const std::string& directory,
+                                          const std::string& dbHash)
+  {
+    CLibraryChangeJournal& journal = CServiceBroker::GetLibraryChangeJournal();
+    CLibraryChangeJournal::DirectoryState state;
+    if (!journal.GetUnchanged(directory, state) || !StringUtils::EqualsNoCase(state.hash, dbHash))
+      return false;
+
+    return std::ranges::all_of(state.subdirectories,
+                               [&journal](const std::string& subdirectory)
+                               {
+                                 CLibraryChangeJournal::DirectoryState subdirectoryState;
+                                 return journal.GetUnchanged(subdirectory, subdirectoryState);
+                               });
+  }
+
+  void CVideoInfoScanner::GetMediaDirectory(const std::string& strDirectory, CFileItemList& items)
+  {
+    CDirectory::GetDirectory(strDirectory, items, CServiceBroker::GetFileExtensionProvider().GetVideoExtensions(),
+                             DIR_FLAG_DEFAULTS);
+    // do not consider inner folders with .nomedia
+    items.erase(std::remove_if(items.begin(), items.end(), [](const CFileItemPtr& item)
+                               { return item->IsFolder() && HasNoMedia(item->GetPath()); }),
+                items.end());
+    items.Stack();
+
+    // force sorting consistency to avoid hash mismatch between platforms
+    // sort by filename as always present for any files, but keep case sensitivity
+    items.Sort(SortBy::FILE, SortOrder::ASCENDING, SortAttributeNone);
+  }
+
+  void CVideoInfoScanner::PrefetchDirectories(const CFileItemList& items,
+                                              const std::vector<std::string>& excludes)
+  {
+    if (!m_workers)
+      return;
+
+    const bool useFastHash = m_advancedSettings->m_bVideoLibraryUseFastHash;
+    for (const auto& pItem : items)
+    {
+      if (m_prefetchedDirs.size() >= MAX_PREFETCHED_DIRECTORIES)
+        break;
+
+      if (!pItem->IsFolder() || pItem->IsParentFolder() || PLAYLIST::IsPlayList(*pItem) ||
+          pItem->IsPlugin() || IsVideoExtrasFolder(*pItem))
+        continue;
+
+      const std::string& path = pItem->GetPath();
+      if (m_prefetchedDirs.contains(path) ||
+          CUtil::ExcludeFileOrFolder(path, excludes, &m_regexpCache))
+        continue;
+
+      // the listing is only needed if the folder changed since the last scan
+      std::string dbHash;
+      CLibraryChangeJournal::DirectoryState state;
+      if (m_database.GetPathHash(path, dbHash) &&
+          CServiceBroker::GetLibraryChangeJournal().GetUnchanged(path, state) &&
+          StringUtils::EqualsNoCase(state.hash, dbHash))
+        continue;
+
+      auto listing = std::make_shared<DirectoryListing>();
+      m_prefetchedDirs.try_emplace(path, listing);
+      m_workers->Submit(path,
+                        [listing, path, excludes, dbHash, useFastHash]()
+                        {
+                          if (!listing->Start())
+                            return;
+                          if (useFastHash)
+                            listing->fastHash = GetFastHash(path, excludes);
+                          if (listing->fastHash.empty() ||
+                              !StringUtils::EqualsNoCase(listing->fastHash, dbHash))
+                          {
+                            GetMediaDirectory(path, listing->items);
+                            listing->listed = true;
+                          }
+                          listing->Finish();
+                        });
+    }
+  }
+
+  std::shared_ptr<CVideoInfoScanner::DirectoryListing> CVideoInfoScanner::GetPrefetchedListing(
+      const std::string& strDirectory)
+  {
+    const auto it = m_prefetchedDirs.find(strDirectory);
+    if (it == m_prefetchedDirs.end())
+      return {};
+
+    std::shared_ptr<DirectoryListing> listing = it->second;
+    m_prefetchedDirs.erase(it);
+
+    // read it here if no worker got to it yet
+    if (listing->Start() || !listing->Wait([this]() { return m_bStop; }))
+      return {};
+    return listing;
+  }
+
+  void CVideoInfoScanner::ReleasePrefetchedListing(const std::string& strDirectory)
+  {
+    const auto it = m_prefetchedDirs.find(strDirectory);
+    if (it == m_prefetchedDirs.end())
+      return;
+
+    // a worker that didn't start reading it yet skips it
+    it->second->Start();
+    m_prefetchedDirs.erase(it);
+  }
+
+  void CVideoInfoScanner::PrefetchStreamDetails(const CFileItemList& items, ContentType content)
+  {
+    if (!m_workers || !CServiceBroker::GetSettingsComponent()->GetSettings()->GetBool(
+                          CSettings::SETTING_MYVIDEOS_EXTRACTFLAGS))
+      return;
+
+    // only probe the files RetrieveVideoInfo() is going to add
+    const ScraperPtr info = m_database.GetScraperForPath(items.GetPath(), &m_scraperCache);
+    if (!info || info->Content() != content)
+      return;
+
+    const std::vector<std::string>& excludes = m_advancedSettings->m_moviesExcludeFromScanRegExps;
+    for (const auto& pItem : items)
+    {
+      if (pItem->IsFolder() || pItem->IsPlugin() || !IsVideo(*pItem) ||
+          PLAYLIST::IsPlayList(*pItem) || pItem->IsNFO() ||
+          CUtil::ExcludeFileOrFolder(pItem->GetPath(), excludes, &m_regexpCache))
+        continue;
+
+      // disc images get their stream details from the selected playlist
+      const std::string& path = pItem->GetDynPath();
+      if (::UTILS::DISCS::IsBlurayDiscImage(path) || URIUtils::IsBDFile(path) ||
+          m_streamDetailsProbes.contains(path))
+        continue;
+
+      // items already in the library are skipped by the scan
+      if (content == ContentType::MOVIES ? m_database.HasMovieInfo(path)
+                                         : m_database.HasMusicVideoInfo(pItem->GetPath()))
+        continue;
+
+      auto probe = std::make_shared<StreamDetailsProbe>();
+      m_streamDetailsProbes.try_emplace(path, probe);
+      m_workers->Submit(path,
+                        [probe, path]()
+                        {
+                          if (!probe->Start())
+                            return;
+                          CFileItem item(path, false);
+                          if (CDVDFileInfo::GetFileStreamDetails(&item))
+                          {
+                            probe->details = item.GetVideoInfoTag()->m_streamDetails;
+                            probe->found = true;
+                          }
+                          probe->Finish();
+                        });
+    }
+  }
+
+  bool CVideoInfoScanner::GetProbedStreamDetails(CFileItem& item)
+  {
+    // use the same path GetFileStreamDetails() would open
+    std::string path = item.GetVideoInfoTag()->m_strFileNameAndPath;
+    if (path.empty())
+      path = item.GetDynPath();
+
+    const auto it = m_streamDetailsProbes.find(path);
+    if (it == m_streamDetailsProbes.end())
+      return false;
+
+    const std::shared_ptr<StreamDetailsProbe> probe = it->second;
+    m_streamDetailsProbes.erase(it);
+
+    // probe it here if no worker got to it yet
+    if (probe->Start() || !probe->Wait([this]() { return m_bStop; }) || !probe->found)
+      return false;
+
+    item.GetVideoInfoTag()->m_streamDetails = probe->details;
+    return true;
+  }
+
   std::string CVideoInfoScanner::GetRecursiveFastHash(const std::string &directory,
       const std::vector<std::string> &excludes) const
   {
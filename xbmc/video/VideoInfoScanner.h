@@ -15,11 +15,14 @@
 #include "utils/Artwork.h"
 #include "utils/RegExp.h"
 
+#include <map>
+#include <memory>
 #include <set>
 #include <string>
 #include <vector>
 
 class CAdvancedSettings;
+class CInfoScannerWorkerPool;
 class CRegExp;
 class CFileItem;
 class CFileItemList;
@@ -273,7 +276,8 @@ namespace KODI::VIDEO
      \param excludes string array of exclude expressions
      \return the md5 hash of the folder"
      */
-    std::string GetFastHash(const std::string &directory, const std::vector<std::string> &excludes) const;
+    static std::string GetFastHash(const std::string& directory,
+                                   const std::vector<std::string>& excludes);
 
     /*! \brief Retrieve a "fast" hash of the given directory recursively (if available)
      Performs a stat() on the directory, and uses modified time to create a "fast"
@@ -297,6 +301,56 @@ namespace KODI::VIDEO
      */
     bool CanFastHash(const CFileItemList &items, const std::vector<std::string> &excludes) const;
 
+    /*! \brief Check whether no folder of a tv show changed since it was last scanned
+     \param directory the folder of the show
+     \param dbHash the path hash of the show stored in the database
+     \return true if the show and all its folders are unchanged according to the change journal
+     */
+    static bool IsTreeUnchanged(const std::string& directory, const std::string& dbHash);
+
+    /*! \brief List a folder to scan
+     Lists the video files and subfolders, skipping subfolders containing a .nomedia file, stacks
+     the items and sorts them by filename, as needed for the path hash.
+     \param strDirectory folder to list
+     \param items the directory listing
+     */
+    static void GetMediaDirectory(const std::string& strDirectory, CFileItemList& items);
+
+    /*! \brief Start reading the fast hash and, if needed, the listing of the subfolders on the scan
+     workers while the current folder is processed.
+     \param items the listing of the current folder
+     \param excludes string array of exclude expressions
+     */
+    void PrefetchDirectories(const CFileItemList& items, const std::vector<std::string>& excludes);
+
+    struct DirectoryListing;
+
+    /*! \brief Take the result of PrefetchDirectories() for a folder, waiting for it if needed.
+     \param strDirectory folder to get the result for
+     \return the prefetched listing or nullptr if the folder hasn't been read ahead, a worker didn't
+     start reading it yet or the scan was stopped meanwhile
+     */
+    std::shared_ptr<DirectoryListing> GetPrefetchedListing(const std::string& strDirectory);
+
+    /*! \brief Drop the result of PrefetchDirectories() for a folder that isn't going to be listed.
+     \param strDirectory folder to drop the result for
+     */
+    void ReleasePrefetchedListing(const std::string& strDirectory);
+
+    /*! \brief Start extracting the stream details of the new video files of a folder on the scan
+     workers, so media probing overlaps scraping and adding the items to the database. Only files
+     that are going to be scanned, with the scraper of the folder and not excluded, are probed.
+     \param items the items to scan
+     \param content the content of the items
+     */
+    void PrefetchStreamDetails(const CFileItemList& items, ADDON::ContentType content);
+
+    /*! \brief Set the stream details extracted by PrefetchStreamDetails() on an item.
+     \param item the item to set the stream details on
+     \return true if stream details have been set, false if the item hasn't been probed (yet)
+     */
+    bool GetProbedStreamDetails(CFileItem& item);
+
     /*! \brief Process a series folder, filling in episode details and adding them to the database.
      @todo Ideally we would return InfoRet:HAVE_ALREADY if we don't have to update any episodes
      and we should return InfoRet::NOT_FOUND only if no information is found for any of
@@ -332,5 +386,10 @@ namespace KODI::VIDEO
     std::shared_ptr<CAdvancedSettings> m_advancedSettings;
     CVideoDatabase::ScraperCache m_scraperCache;
     mutable KODI::REGEXP::RegExpCache m_regexpCache;
+
+    struct StreamDetailsProbe;
+    std::unique_ptr<CInfoScannerWorkerPool> m_workers;
+    std::map<std::string, std::shared_ptr<DirectoryListing>, std::less<>> m_prefetchedDirs;
+    std::map<std::string, std::shared_ptr<StreamDetailsProbe>, std::less<>> m_streamDetailsProbes;
   };
   } // namespace KODI::VIDEO
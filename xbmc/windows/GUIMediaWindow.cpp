@@ -59,6 +59,7 @@
 #include "settings/Settings.h"
 #include "settings/SettingsComponent.h"
 #include "storage/MediaManager.h"
+#include "utils/ArtUtils.h"
 #include "utils/FileUtils.h"
 #include "utils/LabelFormatter.h"
 #include "utils/SortUtils.h"
@@ -95,6 +96,8 @@ CGUIMediaWindow::CGUIMediaWindow(int id, const char *xmlFile)
   m_vecItems->SetPath("?");
   m_iLastControl = -1;
   m_canFilterAdvanced = false;
+  // browsing may show listings of slow network sources from disk
+  m_rootDir.SetFlags(XFILE::DIR_FLAG_ALLOW_PROMPT | XFILE::DIR_FLAG_PERSISTENT_CACHE);
 
   m_guiState.reset(CGUIViewState::GetViewState(GetID(), *m_vecItems));
 }
@@ -2196,27 +2199,22 @@ bool CGUIMediaWindow::GetDirectoryItems(CURL &url, CFileItemList &items, bool us
 {
   if (m_backgroundLoad)
   {
-    bool ret = true;
-    XFILE::CGetDirectoryItems getItems(m_rootDir, url, items, useDir, true);
+    m_listing = m_rootDir.GetDirectoryAsync(url, useDir);
+    if (!m_listing)
+      return m_rootDir.GetDirectory(url, items, useDir, false);
 
-    if (!CGUIDialogBusy::Wait(&getItems, 100, true))
-    {
-      // cancelled
-      ret = false;
-    }
-    else if (!getItems.GetResult())
+    bool ret = WaitForListing(items);
+    if (!ret && !m_listing->IsCancelled())
     {
       if (CServiceBroker::GetAppMessenger()->IsProcessThread() && m_rootDir.GetDirImpl() &&
-          !m_rootDir.GetDirImpl()->ProcessRequirements())
+          m_rootDir.GetDirImpl()->ProcessRequirements())
       {
-        ret = false;
-      }
-      else if (!CGUIDialogBusy::Wait(&getItems, 100, true) || !getItems.GetResult())
-      {
-        ret = false;
+        m_listing = m_rootDir.GetDirectoryAsync(url, useDir);
+        ret = WaitForListing(items);
       }
     }
 
+    m_listing.reset();
     m_rootDir.ReleaseDirImpl();
     return ret;
   }
@@ -2225,3 +2223,38 @@ bool CGUIMediaWindow::GetDirectoryItems(CURL &url, CFileItemList &items, bool us
     return m_rootDir.GetDirectory(url, items, useDir, false);
   }
 }
+
+bool CGUIMediaWindow::WaitForListing(CFileItemList& items)
+{
+  // the busy dialog keeps rendering, FrameMove() shows the items while they arrive
+  const bool completed = CGUIDialogBusy::WaitOnEvent(m_listing->GetDoneEvent(), 100, true);
+  if (!completed)
+    m_listing->Cancel();
+
+  if (m_partialItems)
+  {
+    m_viewControl.SetItems(*m_vecItems);
+    m_partialItems.reset();
+  }
+
+  return completed && m_listing->GetResult(items);
+}
+
+void CGUIMediaWindow::FrameMove()
+{
+  if (m_listing)
+  {
+    std::vector<CFileItemPtr> items = m_listing->TakeItems();
+    if (!items.empty())
+    {
+      if (!m_partialItems)
+        m_partialItems = std::make_unique<CFileItemList>();
+      for (const auto& item : items)
+        ART::FillInDefaultIcon(*item);
+      m_partialItems->AddItems(std::move(items));
+      m_viewControl.SetItems(*m_partialItems);
+    }
+  }
+
+  CGUIWindow::FrameMove();
+}
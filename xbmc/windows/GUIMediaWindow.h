@@ -16,6 +16,7 @@
 #include "view/GUIViewControl.h"
 
 #include <atomic>
+#include <memory>
 
 class CFileItemList;
 class CGUIViewState;
@@ -34,6 +35,7 @@ public:
   bool OnAction(const CAction &action) override;
   bool OnBack(int actionID) override;
   bool OnMessage(CGUIMessage& message) override;
+  void FrameMove() override;
 
   // specializations of CGUIWindow
   void OnWindowLoaded() override;
@@ -159,6 +161,7 @@ protected:
   void OnRenameItem(int iItem);
   bool WaitForNetwork() const;
   bool GetDirectoryItems(CURL& url, CFileItemList& items, bool useDir);
+  bool WaitForListing(CFileItemList& items);
 
   /*! \brief Translate the folder to start in from the given quick path
    \param url the folder the user wants
@@ -218,4 +221,7 @@ protected:
    */
   std::string m_strFilterPath;
   bool m_backgroundLoad = false;
+
+  std::shared_ptr<XFILE::CDirectory::CAsyncListing> m_listing; ///< listing being read in the background
+  std::unique_ptr<CFileItemList> m_partialItems; ///< items of m_listing shown while it's read
 };